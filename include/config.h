@@ -1,7 +1,9 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#endif
 
 // Version
 #define FLUIDTOUCH_VERSION "1.0.5"
@@ -46,6 +48,42 @@
 #define SPLASH_DURATION_MS 2500
 #define LIMIT_SWITCH_HOLD_MS 500  // Duration to keep limit switch indicators visible after trigger clears
 
+// Connection bring-up timeouts (per stage, see ConnectionManager)
+#define CONN_WIFI_TIMEOUT_MS      10000  // WiFi association and DHCP
+#define CONN_RESOLVE_TIMEOUT_MS   5000   // Hostname resolution (all attempts)
+#define CONN_MDNS_QUERY_MS        1000   // Single mDNS query window
+#define CONN_WEBSOCKET_TIMEOUT_MS 10000  // WebSocket open until first status report
+#define CONN_CACHED_IP_TIMEOUT_MS 3000   // WebSocket stage when trying a cached IP (falls back to mDNS)
+#define CONN_TCP_CONNECT_TIMEOUT_MS 750  // Single TCP connect (blocks the main loop at most this long)
+
+// Automatic reconnect (jittered exponential backoff after an established link drops)
+#define CONN_RECONNECT_BASE_MS     500    // First retry delay
+#define CONN_RECONNECT_MAX_MS      30000  // Backoff cap
+#define CONN_RECONNECT_MAX_ATTEMPTS 20    // Give up and show the error dialog after this many
+
+// Auto-report interval policy (see ReportPolicy)
+#define REPORT_INTERVAL_MOTION_MS  50     // Jogging (joystick or $J)
+#define REPORT_INTERVAL_DEFAULT_MS 250    // Other motion/states, or idle on Status/Control tab
+#define REPORT_INTERVAL_IDLE_MS    1000   // Idle on other tabs, or display dimmed
+#define REPORT_POLICY_SETTLE_MS    2000   // Target must hold this long before slowing down
+#define REPORT_PAUSED_POLL_MS      5000   // '?' heartbeat while reports are paused (screen off)
+
+// Work coordinate table (FluidNCClient, $#)
+#define WCS_REFRESH_TIMEOUT_MS     3000   // Send $# again if its closing [PRB:] line hasn't arrived by then
+
+// Multi-machine dashboard (see MachineSessions)
+#define SESSION_REPORT_INTERVAL_MS 1000   // Auto-report rate of background sessions
+#define SESSION_RETRY_MS           30000  // Wait before reopening a failed/closed session
+#define SESSION_RETRY_MAX_MS       600000 // Backoff cap for a machine that keeps failing to connect
+#define SESSION_CONNECT_SPACING_MS 2000   // At most one (blocking) session connect per this period
+#define SESSION_HEAP_BUDGET        16384  // Expected heap per open session - logged when exceeded
+#define SESSION_MIN_FREE_HEAP      65536  // No new sessions below this much free internal heap
+#define SESSION_STATS_MS           60000  // Memory/CPU summary log period
+
+// DRO motion interpolation (see MotionEstimator)
+#define MOTION_DISPLAY_INTERVAL_MS 33     // DRO refresh between reports while moving (~30 fps)
+#define MOTION_SAMPLE_MAX_GAP_MS   600    // Samples further apart than this are not extrapolated
+
 // Preferences namespaces
 #define PREFS_NAMESPACE "fluidtouch"        // Machine configurations
 #define PREFS_SYSTEM_NAMESPACE "ft_system"  // System flags (clean_shutdown, etc.)
@@ -68,6 +106,77 @@
 #define SD_CS    10
 #endif
 
+// Write-behind settings persistence (SettingsStore)
+#define SETTINGS_COMMIT_DELAY_MS      1500   // Quiet period after the last edit before writing NVS
+#define SETTINGS_COMMIT_MAX_DELAY_MS  10000  // Longest a pending edit waits during continuous changes
+
+// Settings backup file (SettingsManager export/import)
+#define SETTINGS_IO_BUFFER_SIZE       512    // SD read/write buffer
+#define SETTINGS_MAX_RECORD_BYTES     8192   // Largest single JSON value (one machine) accepted on import
+
+// Display SD directory listing
+#define DIR_SCAN_SLICE_MS       8         // Time per main loop pass spent reading directory entries
+
+// Display SD clock probe and read cache (SDCard)
+#define SD_PROBE_MAX_HZ         40000000  // Fastest SPI clock tried at mount (falls back step by step)
+#define SD_PROBE_SECTORS        64        // Sectors compared against a 4 MHz reference read
+#define SD_BLOCK_SIZE           4096      // Cache block size (bytes)
+#define SD_CACHE_BLOCKS         32        // Shared PSRAM block cache (128KB)
+#define SD_READAHEAD_BLOCKS     4         // Blocks prefetched ahead of each sequential reader
+#define SD_MAX_READERS          4         // Concurrently open SDReaders that get read-ahead
+
+// Terminal log on Display SD (optional, see TerminalLog)
+#define TERMINAL_LOG_PATH        "/fluidtouch_terminal.log"
+#define TERMINAL_LOG_INDEX_PATH  "/fluidtouch_terminal.idx"
+#define TERMINAL_LOG_OLD_PATH    "/fluidtouch_terminal.old.log"  // Previous log, kept across one rotation
+#define TERMINAL_LOG_OLD_INDEX_PATH "/fluidtouch_terminal.old.idx"
+#define TERMINAL_LOG_BLOCK_SIZE  4096              // Lines are written to the card one block at a time
+#define TERMINAL_LOG_FLUSH_MS    10000             // Partial blocks are written after this long
+#define TERMINAL_LOG_MAX_BYTES   (4 * 1024 * 1024) // Log is moved to the .old files when it reaches this size
+
+// G-code preview (FluidNC machine limits are not queried - these drive the time estimate)
+#define PREVIEW_RAPID_RATE_MM_MIN 5000.0f   // G0 rate and cap for G1 feeds
+#define PREVIEW_ACCEL_MM_S2       500.0f    // Acceleration used for every move
+#define PREVIEW_JUNCTION_FACTOR   1.0f      // Fraction of feed kept through straight junctions
+#define PREVIEW_CHUNK_BYTES       8192      // Bytes analyzed per main loop iteration
+#define PREVIEW_HTTP_TIMEOUT_MS   3000      // FluidNC file download timeout
+
+// G-code dry run (GCodeDryRun)
+#define DRY_RUN_CHUNK_BYTES       8192      // Bytes simulated per main loop iteration
+#define DRY_RUN_QUERY_TIMEOUT_MS  3000      // Wait for $# and axis settings before simulating without them
+
+// Display SD streaming (GCodeSender)
+#define SENDER_RX_BUFFER_SIZE   127     // FluidNC line buffer - unacknowledged characters never exceed this
+#define SENDER_RATE_WINDOW_MS   1000    // Lines/s and buffer fill sampling window
+#define SENDER_PENDING_TIMEOUT_MS 5000  // Earlier commands still unanswered after this are taken as lost
+
+// Probe routines (ProbeSequencer)
+#define PROBE_HISTORY_SIZE          16       // [PRB:] reports kept
+#define PROBE_STEP_TIMEOUT_MS       10000    // Wait for "ok" (probing moves add their travel time at the probe feed)
+#define PROBE_CORNER_CLEARANCE_MM   10.0f    // Corner start must be within this of both edges (plus tip radius)
+#define PROBE_CORNER_DEPTH_MM       5.0f     // Edge probing depth below the stock top (corner with Z touch)
+
+// Height map probing and surface compensation (HeightMapStore, GCodeLeveler)
+#define HEIGHTMAP_PATH              "/fluidtouch_heightmap.bin"
+#define HEIGHTMAP_CLEARANCE_MM      2.0f     // Work Z for moves between grid points
+#define HEIGHTMAP_SEGMENT_MM        2.0f     // Longest G1 segment when compensating a stream
+
+// SD job time estimate (JobEta)
+#define ETA_CALIBRATION_SEC     120.0f  // Model time after which the measured speed ratio is fully trusted
+#define ETA_WINDOW_SEC          20.0f   // Model time per speed ratio sample (drives the band)
+#define ETA_MODEL_UNCERTAINTY   0.15f   // Relative band of an uncalibrated profile estimate
+#define ETA_LINEAR_UNCERTAINTY  0.5f    // Relative band of the percent-based fallback
+
+// G-code analysis cache (LittleFS)
+#define GCODE_CACHE_PATH             "/gcode_cache.bin"
+#define GCODE_CACHE_SLOTS            32     // Cached files (~2.2KB each), least recently used is replaced
+#define GCODE_CACHE_HASH_BLOCK       4096   // Head and tail bytes hashed to detect changed files
+#define GCODE_CACHE_BACKGROUND_CHUNK 2048   // Bytes analyzed per loop by idle-time precompute
+
+// Machine catalog (LittleFS) - see MachineConfigManager
+#define MACHINE_CATALOG_PATH         "/machines.bin"
+#define MACHINE_RECENT_COUNT         4      // Most recently used machines listed first on the select screen
+
 // Upload Configuration
 #define FLUIDNC_UPLOAD_PATH "/fluidtouch/uploads/"  // Automatically created if missing
 
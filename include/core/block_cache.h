@@ -0,0 +1,66 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+
+// Where a BlockCache reads missing blocks from (an open file)
+class BlockSource {
+public:
+    virtual ~BlockSource() = default;
+
+    // Read exactly len bytes starting at offset
+    virtual bool readAt(uint32_t offset, uint8_t *buf, size_t len) = 0;
+};
+
+// Read cache of SD_CACHE_BLOCKS blocks of SD_BLOCK_SIZE bytes, keyed by path hash,
+// file size and block number, evicting the least recently used block. The storage
+// is attached by the owner (PSRAM on the device). Anything that writes, renames or
+// deletes a file must invalidate() its path: a rewrite of the same size would
+// otherwise be served from the old blocks. Plain C++ (no Arduino dependencies) so
+// it can be built on a host.
+class BlockCache {
+public:
+    struct Stats {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+    };
+
+    // SD_CACHE_BLOCKS * SD_BLOCK_SIZE bytes - nullptr leaves the cache unusable
+    void attach(uint8_t *storage) { data = storage; clear(); }
+    bool isReady() const { return data != nullptr; }
+
+    void clear();
+    void invalidate(uint32_t path_hash);
+    static uint32_t hashPath(const char *path);   // Never 0
+
+    // Copy up to len bytes from pos, loading missing blocks from source.
+    // Bytes copied, 0 at end of file, -1 if the first block could not be read.
+    int read(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t pos,
+             uint8_t *buf, size_t len, Stats &stats);
+
+    // Load the first missing block of [pos, pos + SD_READAHEAD_BLOCKS blocks].
+    // 1 = loaded one, 0 = all present, -1 = read error.
+    int prefetch(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t pos);
+
+    int usedBlocks() const;
+
+private:
+    struct Block {
+        uint32_t path_hash;    // 0 = free
+        uint32_t file_size;    // Part of the key - a resized file gets new blocks
+        uint32_t index;        // Block number within the file
+        uint32_t last_used;
+        uint16_t length;       // Valid bytes (last block of a file may be short)
+    };
+
+    uint8_t *data = nullptr;
+    Block blocks[SD_CACHE_BLOCKS] = {};
+    uint32_t use_counter = 0;
+
+    int findBlock(uint32_t path_hash, uint32_t file_size, uint32_t index) const;
+    int loadBlock(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t index);
+};
+
+#endif // BLOCK_CACHE_H
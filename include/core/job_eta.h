@@ -0,0 +1,46 @@
+#ifndef JOB_ETA_H
+#define JOB_ETA_H
+
+#include <cstdint>
+#include "network/fluidnc_client.h"
+#include "ui/gcode_cache.h"
+
+// Job time estimate for SD runs. When the file has been analyzed (GCodeCache),
+// byte progress from SD: is mapped through the file's per-byte time profile, scaled
+// by the live feed override and by how fast the machine has actually been running
+// compared to the model. Without a profile it falls back to elapsed / percent.
+// Also reports a +/- band that narrows as the model gets calibrated.
+class JobEta {
+public:
+    // Feed the current status - call every loop iteration (only new reports are sampled)
+    static void update(const FluidNCStatus &status);
+
+    static bool isActive() { return active; }
+    static bool hasProfile() { return has_profile; }
+    static uint32_t getTotalSec() { return total_sec; }    // Estimated total job time
+    static uint32_t getBandSec() { return band_sec; }      // Uncertainty of the total (+/-)
+
+private:
+    static bool active;
+    static char job_name[64];
+    static bool has_profile;
+    static float profile[GCodeCacheEntry::PROFILE_POINTS + 1];
+
+    static uint32_t last_report_ms;
+    static uint32_t last_sample_ms;
+    static float run_sec;             // Time spent in Run (holds excluded)
+    static float model_sec;           // Model time covered so far, scaled by the override in effect
+    static float last_model_t;        // Profile time at the last sample
+    static float window_run_sec;      // Current calibration window
+    static float window_model_sec;
+    static float ratio_dev;           // Smoothed relative deviation of window speed ratios
+
+    static uint32_t total_sec;
+    static uint32_t band_sec;
+
+    static void start(const FluidNCStatus &status);
+    static bool loadProfile(const char *filename);
+    static float profileTime(float fraction);
+};
+
+#endif // JOB_ETA_H
@@ -0,0 +1,35 @@
+#ifndef MOTION_ESTIMATOR_H
+#define MOTION_ESTIMATOR_H
+
+#include <cstdint>
+#include "network/fluidnc_status.h"
+
+// Extrapolates machine position between status reports so the DROs move smoothly
+// at display frame rate. Direction comes from the last two MPos samples, speed from
+// the FS: feed rate. Every real report snaps the estimate back to the reported
+// position; outside of motion states the estimate is frozen at the last report.
+class MotionEstimator {
+public:
+    // Feed the current status - call every loop iteration (only new reports are sampled)
+    static void update(const FluidNCStatus &status);
+
+    // Offset to add to the last reported MPos/WPos (X, Y, Z, A) at time now_ms
+    static void getOffset(uint32_t now_ms, float offset[4]);
+
+    // True while the estimate is moving between reports
+    static bool isMoving() { return moving; }
+
+    // Drop all samples (e.g. on disconnect)
+    static void reset();
+
+private:
+    static float prev_pos[4];       // Second-to-last reported MPos
+    static float last_pos[4];       // Last reported MPos
+    static uint32_t prev_ms;        // Report timestamps (millis())
+    static uint32_t last_ms;
+    static bool have_prev;
+    static float velocity[4];       // Units per ms along each axis
+    static bool moving;
+};
+
+#endif // MOTION_ESTIMATOR_H
@@ -19,7 +19,7 @@ public:
     // Load settings from preferences
     static void loadSettings();
     
-    // Save settings to preferences
+    // Save settings to preferences (deferred, see SystemPrefs)
     static void saveSettings();
     
     // Getters for current settings
@@ -0,0 +1,88 @@
+#ifndef SD_CARD_H
+#define SD_CARD_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "core/block_cache.h"
+
+// Display SD access layer. mount() probes the fastest SPI clock that reads the
+// card reliably, and SDReader serves sequential file reads from a shared block
+// cache in PSRAM. loop() prefetches the blocks just ahead of every open reader so
+// streaming consumers (GCodeSender, GCodeCache jobs) mostly copy from memory.
+// All I/O runs on the main loop, like every other SD user in the firmware.
+// Writes, renames and deletes go through SDCard too, so the cache drops the old
+// blocks of a changed file; a remount flushes the whole cache. Existence checks and
+// directory listings, which read no file data, are SDCard calls as well.
+class SDCard {
+public:
+    // Mount the card (probing the clock on first mount) - cheap when already mounted
+    static bool mount();
+
+    // Prefetch one block for the readers - call from the main loop
+    static void loop();
+
+    static uint32_t getClockHz() { return clock_hz; }
+
+    // Changes to Display SD files (each drops the cached blocks of the paths involved)
+    static File openForWrite(const char *path, const char *mode = FILE_WRITE);
+    static bool remove(const char *path);
+    static bool rename(const char *from, const char *to);
+    static void invalidate(const char *path);
+
+    // Lookups that read no file data (mount the card first, like SDReader::open)
+    static bool exists(const char *path);
+    static File openDir(const char *path);   // Invalid File if path is not a directory
+
+private:
+    friend class SDReader;
+
+    static uint32_t clock_hz;             // 0 = not mounted
+    static BlockCache cache;              // Storage in PSRAM
+    static class SDReader *readers[SD_MAX_READERS];  // Open readers (prefetch targets)
+
+    static bool probeClock();
+    static void addReader(SDReader *reader);
+    static void removeReader(SDReader *reader);
+};
+
+// BlockSource over an open Display SD file
+class SDFileSource : public BlockSource {
+public:
+    File file;
+    bool readAt(uint32_t offset, uint8_t *buf, size_t len) override;
+};
+
+// Sequential/random reader over the block cache (replaces File::read for streams)
+class SDReader {
+public:
+    SDReader() = default;
+    ~SDReader() { close(); }
+    SDReader(const SDReader&) = delete;
+    SDReader& operator=(const SDReader&) = delete;
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return open_; }
+
+    int read(uint8_t *buf, size_t len);   // Bytes read, 0 at end of file, -1 on error
+    bool seek(uint32_t pos);
+    uint32_t size() const { return file_size; }
+    uint32_t position() const { return pos; }
+
+private:
+    friend class SDCard;
+
+    SDFileSource source;
+    bool open_ = false;
+    uint32_t path_hash = 0;
+    uint32_t file_size = 0;
+    uint32_t pos = 0;
+
+    // Throughput statistics, logged on close
+    BlockCache::Stats stats;
+    uint32_t open_ms = 0;
+    uint32_t bytes_read = 0;
+};
+
+#endif // SD_CARD_H
@@ -0,0 +1,123 @@
+#ifndef GCODE_ANALYZER_H
+#define GCODE_ANALYZER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Machine limits used for the time estimate (FluidNC values are not queried)
+struct GCodeMachineLimits {
+    float rapid_rate_mm_min;   // G0 feed rate
+    float accel_mm_s2;         // Linear acceleration used for every move
+    float junction_factor;     // Fraction of feed kept through a straight junction (0-1)
+
+    GCodeMachineLimits() : rapid_rate_mm_min(5000.0f), accel_mm_s2(500.0f), junction_factor(1.0f) {}
+};
+
+// Result of analyzing one G-code program
+struct GCodeAnalysis {
+    bool has_motion;           // At least one move seen (extents are valid)
+    float min_x, min_y, min_z;
+    float max_x, max_y, max_z;
+    float cut_length_mm;       // G1/G2/G3 path length
+    float rapid_length_mm;     // G0 path length
+    float est_time_sec;        // Acceleration-aware run time estimate (incl. dwells)
+    uint32_t line_count;
+    uint32_t move_count;
+    uint32_t bytes;            // Bytes processed
+
+    GCodeAnalysis() { reset(); }
+    void reset() {
+        has_motion = false;
+        min_x = min_y = min_z = 0.0f;
+        max_x = max_y = max_z = 0.0f;
+        cut_length_mm = rapid_length_mm = est_time_sec = 0.0f;
+        line_count = move_count = bytes = 0;
+    }
+};
+
+// Copy of the analyzer's toolpath bitmap (fixed size, safe to write to storage as-is)
+struct GCodeThumbnail {
+    static const int GRID = 128;
+    float x0, y0;              // Position of cell (0,0) (mm)
+    float cell;                // Cell size (mm)
+    uint8_t bits[GRID][GRID / 8];
+
+    bool get(int gx, int gy) const { return (bits[gy][gx >> 3] >> (gx & 7)) & 1; }
+};
+
+// Streaming G-code analyzer with a fixed memory budget (no heap use).
+// Feed the file in arbitrary chunks, then call finish(). Computes extents,
+// cut/rapid lengths and a trapezoidal-profile time estimate, and rasterizes
+// the XY toolpath into a small self-growing bitmap for thumbnails.
+// Plain C++ (no Arduino dependencies) so it can be built on a host.
+class GCodeAnalyzer {
+public:
+    static const int GRID = GCodeThumbnail::GRID;  // Thumbnail bitmap is GRID x GRID cells
+    static const int MAX_LINE = 256;   // Longer lines are truncated
+
+    GCodeAnalyzer();
+
+    void begin(const GCodeMachineLimits &limits = GCodeMachineLimits());
+    void feed(const char *data, size_t len);
+    void finish();
+
+    const GCodeAnalysis &result() const { return analysis; }
+
+    // Thumbnail bitmap: cut moves, cell (0,0) is at grid origin (min X, min Y)
+    bool cell(int gx, int gy) const { return (grid[gy][gx >> 3] >> (gx & 7)) & 1; }
+    float gridOriginX() const { return grid_x0; }
+    float gridOriginY() const { return grid_y0; }
+    float gridCellSize() const { return grid_cell; }
+    void getThumbnail(GCodeThumbnail &out) const;
+
+    // Called after each move with the byte offset of the end of its line and the
+    // estimated time so far (used to build per-byte time profiles)
+    typedef void (*ProgressHook)(uint32_t byte_offset, float time_sec, void *ctx);
+    void setProgressHook(ProgressHook hook, void *ctx) { progress_hook = hook; progress_ctx = ctx; }
+
+private:
+    GCodeMachineLimits limits;
+    GCodeAnalysis analysis;
+
+    // Line assembly
+    char line[MAX_LINE];
+    int line_len;
+
+    // Modal state
+    float pos[3];
+    float feed_mm_min;
+    int motion;            // 0, 1, 2, 3 (G0-G3), starts in G0
+    bool absolute;         // G90/G91
+    bool inches;           // G20/G21
+
+    // One-move lookahead for junction speeds
+    bool pending;
+    float pending_len;
+    float pending_v;       // mm/s
+    float pending_dir[3];  // Unit direction at the end of the pending move
+    float pending_entry_v; // mm/s
+    uint32_t pending_bytes;
+
+    // Thumbnail grid (1 bit per cell)
+    uint8_t grid[GRID][GRID / 8];
+    bool grid_init;
+    float grid_x0, grid_y0, grid_cell;
+
+    ProgressHook progress_hook;
+    void *progress_ctx;
+
+    void processLine(char *s);
+    void addMove(const float target[3], bool rapid, const float dir_start[3], const float dir_end[3], float length);
+    void linearMove(const float target[3], bool rapid);
+    void arcMove(const float target[3], bool clockwise, bool has_ij, float i, float j, bool has_r, float r);
+    void flushPending(float exit_v);
+    float trapezoidTime(float len, float v_in, float v, float v_out) const;
+    void extend(const float p[3]);
+
+    // Thumbnail helpers
+    void gridEnsure(float x, float y);
+    void gridGrow(int dir_x, int dir_y);
+    void gridLine(float x0, float y0, float x1, float y1);
+};
+
+#endif // GCODE_ANALYZER_H
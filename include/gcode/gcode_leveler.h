@@ -0,0 +1,60 @@
+#ifndef GCODE_LEVELER_H
+#define GCODE_LEVELER_H
+
+#include <cstdint>
+#include <cstddef>
+
+class HeightMap;
+
+// Streaming G-code transformer for surface compensation: adds the height map's Z offset
+// (bilinear, work coordinates) to every move. G1 moves are split into segments no longer
+// than the segment length so the tool follows the surface between grid points; arcs keep
+// their shape and get the offset at their end point (helical Z in between). Lines go in
+// one at a time and come out one segment at a time, so memory use doesn't depend on the
+// file or grid size. Lines that move the coordinate system in ways that aren't tracked
+// (G10, G28/G30, G38.x, G43.1/G49, G53, G54-G59, G92) pass through unchanged and leave the
+// position unknown until X, Y and Z are given again in absolute mode - moves are only
+// compensated while the position is known. Plain C++ so it can be built on a host.
+class GCodeLeveler {
+public:
+    static const int MAX_LINE = 256;
+
+    void begin(const HeightMap *map, float segment_mm);
+
+    // Take the next input line (no '\n'). false: the line can't be compensated (too long)
+    bool setLine(const char *line);
+
+    // Next output line for the current input line (no '\n'); false once it is used up
+    bool next(char *out, size_t cap);
+
+    uint32_t getCompensatedMoves() const { return compensated_moves; }
+
+private:
+    const HeightMap *map;
+    float segment_mm;
+
+    // Modal state
+    bool absolute;             // G90/G91
+    bool inches;               // G20/G21
+    bool inverse_time;         // G93 - moves aren't split (F is per move)
+    int motion;                // 0-3 = G0-G3, -1 = other (G38.x, G80)
+    float pos[3];              // Programmed position (work coordinates, program units)
+    bool known[3];             // pos is valid for the axis
+    float emitted[3];          // Compensated position sent last (as printed)
+
+    // Current line
+    bool passthrough;
+    bool pass_pending;
+    char pass[MAX_LINE];       // Line sent unchanged
+    char prefix[MAX_LINE];     // Line without X/Y/Z words (first segment)
+    float from[3], to[3];
+    int seg_count;
+    int seg_index;
+
+    uint32_t compensated_moves;
+
+    float offsetAt(float x, float y) const;     // Program units
+    float quantize(float v) const;              // Rounded as printed
+};
+
+#endif // GCODE_LEVELER_H
@@ -0,0 +1,57 @@
+#ifndef GCODE_MODAL_H
+#define GCODE_MODAL_H
+
+#include <cstdint>
+
+// Modal groups as small codes, in the order the [GC:] report lists them
+enum class ModalMotion : uint8_t { G0, G1, G2, G3, G38_2, G38_3, G38_4, G38_5, G80 };
+enum class ModalPlane : uint8_t { G17, G18, G19 };
+enum class ModalUnits : uint8_t { G20, G21 };
+enum class ModalDistance : uint8_t { G90, G91 };
+enum class ModalFeedMode : uint8_t { G93, G94, G95 };
+enum class ModalSpindle : uint8_t { M3, M4, M5 };
+
+// Coolant bits (none = M9)
+static const uint8_t COOLANT_MIST = 0x01;      // M7
+static const uint8_t COOLANT_FLOOD = 0x02;     // M8
+
+// FluidNC parser state from a [GC:...] report. parse() reads the report word by word
+// (letter + number, the same way FluidNC reads G-code), so "G0" never matches inside
+// "G90". Groups missing from a report keep their value; coolant is reported in full
+// every time. Compare with == and format with the *Name() helpers only on change.
+// Plain C++ (no Arduino dependencies) so it can be built on a host.
+struct GCodeModal {
+    ModalMotion motion;
+    uint8_t wcs;               // 0-5 = G54-G59
+    ModalPlane plane;
+    ModalUnits units;
+    ModalDistance distance;
+    ModalFeedMode feed_mode;
+    ModalSpindle spindle;
+    uint8_t coolant;           // COOLANT_* bits
+    uint16_t tool;
+    float feed;                // Programmed F
+    float speed;               // Programmed S
+
+    GCodeModal();
+
+    // Parse "[GC:G0 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]" (the brackets are optional)
+    bool parse(const char *report);
+
+    bool isIncremental() const { return distance == ModalDistance::G91; }
+    bool isInches() const { return units == ModalUnits::G20; }
+
+    const char *motionName() const;
+    const char *wcsName() const;
+    const char *planeName() const;
+    const char *unitsName() const;
+    const char *distanceName() const;
+    const char *feedModeName() const;
+    const char *spindleName() const;
+    const char *coolantName() const;   // "M9", "M7", "M8" or "M7 M8"
+
+    bool operator==(const GCodeModal &other) const;
+    bool operator!=(const GCodeModal &other) const { return !(*this == other); }
+};
+
+#endif // GCODE_MODAL_H
@@ -0,0 +1,29 @@
+#ifndef GCODE_NUMBER_H
+#define GCODE_NUMBER_H
+
+// Decimal number as FluidNC reads it: sign, digits, optional fraction. strtof would take
+// "0X1" (G0X1 once spaces are stripped) as hex and "1E5" as an exponent.
+inline bool gcodeReadNumber(const char *&p, float &value) {
+    const char *s = p;
+    bool negative = false;
+    if (*s == '-' || *s == '+') negative = *s++ == '-';
+    double v = 0.0, scale = 1.0;
+    bool digits = false, fraction = false;
+    for (; *s; s++) {
+        if (*s >= '0' && *s <= '9') {
+            digits = true;
+            if (fraction) scale *= 0.1;
+            v = v * 10.0 + (*s - '0');
+        } else if (*s == '.' && !fraction) {
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (!digits) return false;
+    value = (float)(negative ? -v * scale : v * scale);
+    p = s;
+    return true;
+}
+
+#endif // GCODE_NUMBER_H
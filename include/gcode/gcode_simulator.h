@@ -0,0 +1,103 @@
+#ifndef GCODE_SIMULATOR_H
+#define GCODE_SIMULATOR_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Machine state a simulation starts from. Positions and offsets are in mm, machine coordinates.
+struct GCodeSimSetup {
+    float wcs[6][3];           // G54-G59 offsets ($#)
+    float g28[3], g30[3];      // Stored G28/G30 positions ($#)
+    float g92[3];              // G92 offset ($#)
+    float tlo;                 // Tool length offset ($# TLO)
+    int active_wcs;            // 0-5 = G54-G59
+    float start[3];            // Machine position the job starts from
+    bool has_envelope[3];      // Axis travel is known - moves are checked against min/max
+    float min[3], max[3];      // Soft limit envelope
+
+    GCodeSimSetup() { reset(); }
+    void reset();
+};
+
+enum GCodeSimIssueKind {
+    SIM_ENVELOPE = 0,          // Move leaves the soft limit envelope
+    SIM_UNSUPPORTED,           // Word, G/M code or syntax FluidNC rejects (or that isn't simulated)
+    SIM_NO_SPINDLE,            // Cutting move with the spindle off or at S0
+    SIM_NO_FEED,               // Cutting move without a feed rate
+    SIM_BAD_ARC,               // Arc FluidNC would reject (radius mismatch, impossible R)
+    SIM_KIND_COUNT
+};
+
+struct GCodeSimIssue {
+    uint32_t line;             // 1-based line number in the file
+    char text[44];
+};
+
+// Result of simulating one G-code program. Every issue is counted; the first
+// ISSUES_PER_KIND of each kind are kept with their line numbers.
+struct GCodeSimReport {
+    static const int ISSUES_PER_KIND = 4;
+
+    uint32_t counts[SIM_KIND_COUNT];
+    GCodeSimIssue issues[SIM_KIND_COUNT][ISSUES_PER_KIND];
+    bool has_motion;           // At least one move seen (extents are valid)
+    float min[3], max[3];      // Extents in machine coordinates
+    uint32_t line_count;       // Lines in the file
+    uint32_t move_count;
+    uint32_t bytes;            // Bytes processed
+
+    GCodeSimReport() { reset(); }
+    void reset();
+    uint32_t total() const;
+    int stored(int kind) const { return counts[kind] < (uint32_t)ISSUES_PER_KIND ? (int)counts[kind] : ISSUES_PER_KIND; }
+};
+
+// Streaming G-code interpreter that dry-runs a program against a machine setup (no heap use).
+// Feed the file in arbitrary chunks, then call finish(). Tracks the modal state, work
+// offsets (G10, G92, G43.1) and machine position the way FluidNC does, and reports
+// moves outside the envelope, words and codes FluidNC doesn't support, and cuts without
+// spindle or feed. Plain C++ (no Arduino dependencies) so it can be built on a host.
+class GCodeSimulator {
+public:
+    static const int MAX_LINE = 256;   // FluidNC line limit - longer lines are reported and truncated
+
+    GCodeSimulator();
+
+    void begin(const GCodeSimSetup &setup);
+    void feed(const char *data, size_t len);
+    void finish();
+
+    const GCodeSimReport &report() const { return result; }
+
+private:
+    GCodeSimSetup setup;
+    GCodeSimReport result;
+
+    // Line assembly
+    char line[MAX_LINE];
+    int line_len;
+    bool line_overflow;        // Current line was truncated
+    bool line_started;         // Bytes seen since the last newline
+    uint32_t line_number;      // Line being assembled
+
+    // Modal state
+    float pos[3];              // Machine position
+    int motion;                // 0-3 (G0-G3), 4 = probe, -1 = G80
+    int plane;                 // 0 = G17, 1 = G18, 2 = G19
+    bool absolute;             // G90/G91
+    bool inches;               // G20/G21
+    bool inverse_time;         // G93
+    bool feed_set;             // F seen (units/min mode)
+    bool spindle_on;           // M3/M4
+    float spindle_speed;       // Modal S
+
+    void processLine(char *s);
+    void flag(int kind, const char *fmt, ...);
+    float offset(int axis) const;
+    void linearMove(const float target[3]);
+    void arcMove(const float target[3], bool clockwise, bool has_r, float r, const bool has_ijk[3], const float ijk[3]);
+    bool checkPoint(const float p[3]);
+    void programEnd();
+};
+
+#endif // GCODE_SIMULATOR_H
@@ -0,0 +1,59 @@
+#ifndef HEIGHT_MAP_H
+#define HEIGHT_MAP_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Probed surface heights on a regular nx x ny grid, in work coordinates (mm). Heights
+// are relative to the first grid point (x0, y0). zAt() interpolates bilinearly and
+// holds the edge values outside the grid. Plain C++ (no Arduino dependencies) so it
+// can be built on a host.
+class HeightMap {
+public:
+    static const int MAX_SIDE = 64;         // Points per axis
+    static const int MIN_SIDE = 2;
+    static const size_t HEADER_SIZE = 28;   // Encoded header: "FTHM", version, nx, ny, flags, x0, y0, dx, dy
+
+    HeightMap();
+    ~HeightMap();
+
+    // Allocate an unprobed grid covering x0..x0+width, y0..y0+height
+    bool setup(float x0, float y0, float width, float height, int nx, int ny);
+    void clear();
+
+    bool isValid() const { return z != nullptr; }
+    bool isComplete() const { return z != nullptr && probed == nx * ny; }
+    int getNX() const { return nx; }
+    int getNY() const { return ny; }
+    int getProbedCount() const { return probed; }
+    float getX0() const { return x0; }
+    float getY0() const { return y0; }
+    float getWidth() const { return dx * (nx - 1); }
+    float getHeight() const { return dy * (ny - 1); }
+    float pointX(int i) const { return x0 + dx * i; }
+    float pointY(int j) const { return y0 + dy * j; }
+
+    float get(int i, int j) const { return z[j * nx + i]; }
+    void set(int i, int j, float height);   // Counts towards isComplete() the first time
+    void normalize();                       // Make heights relative to point (0, 0)
+    void range(float &min, float &max) const;
+
+    float zAt(float x, float y) const;
+
+    // Compact file image: HEADER_SIZE bytes, then int16 micrometers per point (row by row)
+    size_t encodedSize() const;
+    size_t encode(uint8_t *buf, size_t cap) const;
+    bool decode(const uint8_t *buf, size_t len);
+
+private:
+    float x0, y0, dx, dy;
+    int nx, ny;
+    int probed;
+    float *z;                  // nx * ny heights, row by row
+    uint8_t *set_mask;         // One bit per point already probed
+
+    HeightMap(const HeightMap&) = delete;
+    HeightMap& operator=(const HeightMap&) = delete;
+};
+
+#endif // HEIGHT_MAP_H
@@ -0,0 +1,108 @@
+#ifndef CONNECTION_MANAGER_H
+#define CONNECTION_MANAGER_H
+
+#include <Arduino.h>
+#include "ui/machine_config.h"
+
+// Connection bring-up stages (WiFi -> mDNS -> resolve -> WebSocket)
+enum ConnectionStage {
+    CONN_STAGE_IDLE = 0,       // Nothing in progress
+    CONN_STAGE_WIFI = 1,       // Waiting for WL_CONNECTED
+    CONN_STAGE_MDNS = 2,       // Starting mDNS client stack
+    CONN_STAGE_RESOLVE = 3,    // Resolving hostname (mDNS or DNS)
+    CONN_STAGE_WEBSOCKET = 4,  // WebSocket opened, waiting for first status report
+    CONN_STAGE_CONNECTED = 5,  // First status report received
+    CONN_STAGE_FAILED = 6,     // A stage timed out (error dialog shown)
+    CONN_STAGE_BACKOFF = 7     // Link lost, waiting before the next reconnect attempt
+};
+
+// Non-blocking connection state machine, driven from the main loop.
+// Each stage has its own timeout and reports progress to the connecting popup.
+// After a successful connection, a dropped link is retried automatically with
+// jittered exponential backoff, reusing the resolved IP to skip mDNS.
+// The last good IP of each mDNS/DNS machine is kept in NVS and tried first on
+// the next boot; mDNS is only queried if it fails, or in the background once connected.
+class ConnectionManager {
+public:
+    // Start connecting to a machine (returns immediately)
+    static void begin(const MachineConfig &config);
+
+    // Advance the state machine - call every loop iteration
+    static void loop();
+
+    // Abort any bring-up in progress (does not close an established connection)
+    static void cancel();
+
+    // Take over an already open connection (focus switch from the dashboard)
+    static void adopt(const MachineConfig &config, int index, const char *host);
+
+    // Current stage
+    static ConnectionStage getStage() { return stage; }
+
+    // True while a bring-up is in progress (WiFi through first status report)
+    static bool isConnecting();
+
+    // True while recovering a previously established connection
+    static bool isReconnecting() { return reconnecting; }
+
+    // Called when an established WebSocket closes (starts automatic reconnect)
+    static void onConnectionLost();
+
+    // Address the WebSocket was opened to (IP or hostname), empty until resolved
+    static const char* getResolvedHost() { return resolved_host; }
+
+    // Address to open a WebSocket to for any machine without resolving: the URL itself
+    // for IPs, else the last good IP from the address cache (false if none)
+    static bool getKnownAddress(int index, const MachineSummary &machine, char *host, size_t len);
+
+private:
+    static ConnectionStage stage;
+    static MachineConfig config;
+    static uint32_t stage_start_ms;     // millis() when the current stage started
+    static uint32_t begin_ms;           // millis() when begin() was called
+    static uint8_t resolve_attempt;     // mDNS query attempts in current resolve stage
+    static char resolved_host[64];
+    static bool mdns_started;           // MDNS.begin() succeeded (kept across reconnects)
+    static int machine_index;           // Selected machine slot (key for the address cache)
+    static bool using_cached_ip;        // resolved_host came from the NVS address cache
+    static bool refresh_pending;        // Re-resolve in the background once connected
+
+    // Automatic reconnect
+    static bool reconnecting;           // Recovering a previously established connection
+    static uint8_t reconnect_attempt;   // Attempts made since the link was lost
+    static uint32_t lost_ms;            // millis() when the link was lost
+    static uint32_t backoff_until_ms;   // millis() when the next attempt starts
+
+    static void enterStage(ConnectionStage next);
+    static void fail(const char *title, const char *message);
+
+    // Stage handlers
+    static void processWiFi();
+    static void processMDNS();
+    static void processResolve();
+    static void processWebSocket();
+    static void processBackoff();
+    static void processLinkWatch();
+    static void processAddressRefresh();
+
+    // Reconnect helpers
+    static void scheduleReconnect();
+    static void startReconnectAttempt();
+
+    // Resolution helpers
+    static bool needsResolution(const char *url);
+    static void startMDNSQuery();
+    static bool pollMDNSQuery(bool &found);
+    static void stopMDNSQuery();
+    static void startDNSQuery();
+    static bool pollDNSQuery(bool &found);
+    static void stopDNSQuery();
+
+    // Persistent resolved-address cache (per machine index)
+    static bool loadCachedAddress(char *ip, size_t len);
+    static bool readCachedAddress(int index, const char *url, char *ip, size_t len);
+    static void storeCachedAddress(const char *ip);
+    static void clearCachedAddress();
+};
+
+#endif // CONNECTION_MANAGER_H
@@ -4,108 +4,20 @@
 #include <Arduino.h>
 #include <ArduinoWebsockets.h>
 #include "ui/machine_config.h"
+#include "network/fluidnc_status.h"
 #include <functional>
 
 // Callback type for receiving FluidNC messages (renamed to avoid conflict with ArduinoWebsockets::MessageCallback)
 typedef std::function<void(const char* message)> FluidNCMessageCallback;
 
-// FluidNC machine states
-enum MachineState {
-    STATE_IDLE = 0,
-    STATE_RUN = 1,
-    STATE_HOLD = 2,
-    STATE_JOG = 3,
-    STATE_ALARM = 4,
-    STATE_DOOR = 5,
-    STATE_CHECK = 6,
-    STATE_HOME = 7,
-    STATE_SLEEP = 8,
-    STATE_DISCONNECTED = 9
-};
-
-// FluidNC status report structure
-struct FluidNCStatus {
-    // Machine state
-    MachineState state;
-    
-    // Positions (X, Y, Z, A) in mm (or degrees for A)
-    float mpos_x, mpos_y, mpos_z, mpos_a;  // Machine position
-    float wpos_x, wpos_y, wpos_z, wpos_a;  // Work position
-    float wco_x, wco_y, wco_z, wco_a;      // Work coordinate offset (WPos = MPos - WCO)
-    
-    // Feed and spindle
-    float feed_rate;        // Current feed rate (mm/min)
-    float feed_override;    // Feed override percentage (0-200)
-    float rapid_override;   // Rapid override percentage (0-200)
-    float spindle_speed;    // Current spindle speed (RPM)
-    float spindle_override; // Spindle override percentage (0-200)
-    
-    // Modal states (Grbl parser state)
-    char modal_motion[8];    // G0, G1, G2, G3, etc.
-    char modal_wcs[8];       // G54, G55, G56, etc.
-    char modal_plane[8];     // G17, G18, G19
-    char modal_units[8];     // G20 (inches), G21 (mm)
-    char modal_distance[8];  // G90 (absolute), G91 (relative)
-    char modal_feedrate[8];  // G93 (inverse time), G94 (units/min), G95 (units/rev)
-    char modal_spindle[8];   // M3, M4, M5
-    char modal_coolant[8];   // M7, M8, M9
-    char modal_tool[8];      // T0, T1, T2, etc.
-    
-    // Last message from FluidNC
-    char last_message[128]; // Store last [MSG:...] or feedback message
-    
-    // SD card file progress (when running from SD)
-    bool is_sd_printing;        // True if running a file from SD card
-    float sd_percent;           // Progress percentage (0.0-100.0)
-    char sd_filename[64];       // Current file being run
-    uint32_t sd_start_time_ms;  // Timestamp when file started (millis())
-    uint32_t sd_elapsed_ms;     // Elapsed time since file started
-    
-    // Connection status
-    bool is_connected;
-    uint32_t last_update_ms;
-    char fluidnc_version[32];  // FluidNC firmware version, e.g. "3.9.5" (parsed from $Build/Info)
-
-    // Pin states (Pn: field)
-    bool pin_limit_x;
-    bool pin_limit_y;
-    bool pin_limit_z;
-    bool pin_limit_a;
-    bool pin_probe;
-    
-    // Constructor
-    FluidNCStatus() : state(STATE_DISCONNECTED),
-                     mpos_x(0), mpos_y(0), mpos_z(0), mpos_a(0),
-                     wpos_x(0), wpos_y(0), wpos_z(0), wpos_a(0),
-                     wco_x(0), wco_y(0), wco_z(0), wco_a(0),
-                     feed_rate(0), feed_override(100), rapid_override(100),
-                     spindle_speed(0), spindle_override(100),
-                     is_sd_printing(false), sd_percent(0), sd_start_time_ms(0), sd_elapsed_ms(0),
-                     is_connected(false), last_update_ms(0),
-                     pin_limit_x(false), pin_limit_y(false), pin_limit_z(false), pin_limit_a(false),
-                     pin_probe(false) {
-        strcpy(modal_motion, "G0");
-        strcpy(modal_wcs, "G54");
-        strcpy(modal_plane, "G17");
-        strcpy(modal_units, "G21");
-        strcpy(modal_distance, "G90");
-        strcpy(modal_feedrate, "G94");
-        strcpy(modal_spindle, "M5");
-        strcpy(modal_coolant, "M9");
-        strcpy(modal_tool, "T0");
-        last_message[0] = '\0';  // Empty message initially
-        sd_filename[0] = '\0';   // No file initially
-        fluidnc_version[0] = '\0';  // Unknown until $Build/Info response received
-    }
-};
-
 class FluidNCClient {
 public:
     // Initialize the client
     static void init();
     
     // Connect to FluidNC using machine config
-    static bool connect(const MachineConfig &config);
+    // host: address to open the WebSocket to (already resolved IP), or nullptr to use config.fluidnc_url
+    static bool connect(const MachineConfig &config, const char *host = nullptr);
     
     // Disconnect from FluidNC
     static void disconnect();
@@ -119,6 +31,10 @@ public:
     // Check if using auto-reporting (true) or fallback polling (false)
     static bool isAutoReporting();
     
+    // Renegotiate the auto-report interval (0 pauses reports); sent only if it changed
+    static void setReportInterval(uint16_t interval_ms);
+    static uint16_t getReportInterval() { return reportIntervalMs; }
+    
     // Main loop - call regularly to handle WebSocket events
     static void loop();
     
@@ -128,6 +44,9 @@ public:
     // Send a command to FluidNC (e.g., "G0 X10", "$H", "!")
     static void sendCommand(const char* command);
     
+    // Send G-code stream data (no logging - flow control is done by GCodeSender)
+    static void sendStreamData(const char* data);
+    
     // Clear the stored last message
     static void clearLastMessage();
     
@@ -137,6 +56,9 @@ public:
     // Get machine IP address (extracted from WebSocket URL)
     static String getMachineIP();
     
+    // WebSocket URL of the focused machine's config (kept after a disconnect)
+    static const char* getMachineURL() { return currentConfig.fluidnc_url; }
+    
     // Set callback for receiving raw messages (for file list, etc.)
     static void setMessageCallback(FluidNCMessageCallback callback);
     
@@ -149,8 +71,33 @@ public:
     // Clear terminal callback
     static void clearTerminalCallback();
     
+    // Work coordinate offsets: fetched with $# on connect and again after G10/G92/G43.1/G49
+    // commands sent through sendCommand(), probe routines and jobs. The table stays usable
+    // while a refresh is outstanding - watch its revision for updates.
+    static const WCSTable& getWCSTable() { return wcsTable; }
+    
+    // Fetch $# again as soon as the machine is idle
+    static void requestWCSRefresh();
+    static bool isWCSRefreshing() { return wcsRefreshWanted || wcsRefreshSentMs != 0; }
+    
+    // $# sent and its report not complete yet - the report ends with the last probe
+    // result ([PRB:...]), which is not a new probe contact
+    static bool isWCSReplyPending() { return wcsRefreshSentMs != 0; }
+    
+    // Swap the focused connection with another open one (MachineSessions focus switch).
+    // On return socket, status and config hold the previously focused machine's.
+    static void exchangeConnection(websockets::WebsocketsClient *&socket, FluidNCStatus &status, MachineConfig &config);
+    
+    // Parse state, positions, feed/spindle, overrides, pins and SD: of a status report
+    // into status. Returns true if the report carried an SD: field.
+    static bool parseStatusFields(const char* message, FluidNCStatus &status);
+    
+    // Reset the SD job fields of status
+    static void clearSDProgress(FluidNCStatus &status);
+    
 private:
-    static websockets::WebsocketsClient webSocket;
+    static websockets::WebsocketsClient primarySocket;
+    static websockets::WebsocketsClient *webSocket;   // Focused connection (swapped on focus switch)
     static FluidNCStatus currentStatus;
     static MachineConfig currentConfig;
     static uint32_t lastStatusRequestMs;
@@ -164,6 +111,12 @@ private:
     static uint32_t lastPollingMs;        // Last time we sent "?" for fallback polling
     static uint32_t lastGCodePollMs;      // Last time we sent "$G" for GCode state
     static uint32_t lastAutoReportAttemptMs; // Last time we tried to enable auto-reporting
+    static uint16_t reportIntervalMs;     // Auto-report interval, re-sent on every (re)connect
+    
+    // Work coordinate table
+    static WCSTable wcsTable;
+    static bool wcsRefreshWanted;         // $# due once the machine is idle
+    static uint32_t wcsRefreshSentMs;     // $# outstanding since (0 = none)
     
     // Connection tracking
     static bool everConnectedSuccessfully; // True once first status report received, never reset
@@ -182,10 +135,19 @@ private:
     // Parse realtime feedback
     static void parseRealtimeFeedback(const char* message);
     
+    // Store a $# line ([G54:...] .. [TLO:...]) in the WCS table; false if it isn't one
+    static bool parseWCSOffsets(const char* message);
+    static void resetWCSTable();
+    static void checkWCSRefresh();
+    
     // Auto-reporting and polling helpers
     static void attemptEnableAutoReporting();
     static void performFallbackPolling();
     
+    // Send a line of our own (handshake, polls), counted by GCodeSender and
+    // ProbeSequencer so its ok/error: doesn't get matched to one of their lines
+    static void sendInternal(const char* line);
+    
     // Helper to extract float value from status report
     static float extractFloat(const char* str, const char* key);
     
@@ -0,0 +1,110 @@
+#ifndef FLUIDNC_STATUS_H
+#define FLUIDNC_STATUS_H
+
+#include <cstdint>
+#include <cstring>
+#include "gcode/gcode_modal.h"
+
+// Machine state types shared by FluidNCClient, MachineSessions and the UI.
+// Plain C++ (no Arduino dependencies) so consumers like MotionEstimator can be
+// built on a host.
+
+// FluidNC machine states
+enum MachineState {
+    STATE_IDLE = 0,
+    STATE_RUN = 1,
+    STATE_HOLD = 2,
+    STATE_JOG = 3,
+    STATE_ALARM = 4,
+    STATE_DOOR = 5,
+    STATE_CHECK = 6,
+    STATE_HOME = 7,
+    STATE_SLEEP = 8,
+    STATE_DISCONNECTED = 9
+};
+
+// FluidNC status report structure
+struct FluidNCStatus {
+    // Machine state
+    MachineState state;
+    
+    // Positions (X, Y, Z, A) in mm (or degrees for A)
+    float mpos_x, mpos_y, mpos_z, mpos_a;  // Machine position
+    float wpos_x, wpos_y, wpos_z, wpos_a;  // Work position
+    float wco_x, wco_y, wco_z, wco_a;      // Work coordinate offset (WPos = MPos - WCO)
+    
+    // Feed and spindle
+    float feed_rate;        // Current feed rate (mm/min)
+    float feed_override;    // Feed override percentage (0-200)
+    float rapid_override;   // Rapid override percentage (0-200)
+    float spindle_speed;    // Current spindle speed (RPM)
+    float spindle_override; // Spindle override percentage (0-200)
+    
+    // Modal states (Grbl parser state from [GC:...])
+    GCodeModal modal;
+    
+    // Last message from FluidNC
+    char last_message[128]; // Store last [MSG:...] or feedback message
+    
+    // SD card file progress (when running from SD)
+    bool is_sd_printing;        // True if running a file from SD card
+    float sd_percent;           // Progress percentage (0.0-100.0)
+    char sd_filename[64];       // Current file being run
+    uint32_t sd_start_time_ms;  // Timestamp when file started (millis())
+    uint32_t sd_elapsed_ms;     // Elapsed time since file started
+    
+    // Connection status
+    bool is_connected;
+    uint32_t last_update_ms;
+    char fluidnc_version[32];  // FluidNC firmware version, e.g. "3.9.5" (parsed from $Build/Info)
+
+    // Pin states (Pn: field)
+    bool pin_limit_x;
+    bool pin_limit_y;
+    bool pin_limit_z;
+    bool pin_limit_a;
+    bool pin_probe;
+    
+    // Constructor
+    FluidNCStatus() : state(STATE_DISCONNECTED),
+                     mpos_x(0), mpos_y(0), mpos_z(0), mpos_a(0),
+                     wpos_x(0), wpos_y(0), wpos_z(0), wpos_a(0),
+                     wco_x(0), wco_y(0), wco_z(0), wco_a(0),
+                     feed_rate(0), feed_override(100), rapid_override(100),
+                     spindle_speed(0), spindle_override(100),
+                     is_sd_printing(false), sd_percent(0), sd_start_time_ms(0), sd_elapsed_ms(0),
+                     is_connected(false), last_update_ms(0),
+                     pin_limit_x(false), pin_limit_y(false), pin_limit_z(false), pin_limit_a(false),
+                     pin_probe(false) {
+        last_message[0] = '\0';  // Empty message initially
+        sd_filename[0] = '\0';   // No file initially
+        fluidnc_version[0] = '\0';  // Unknown until $Build/Info response received
+    }
+};
+
+// Work coordinate table slots, in $# report order
+enum WCSSlot {
+    WCS_SLOT_G54 = 0,       // G54-G59 are slots 0-5
+    WCS_SLOT_G59 = 5,
+    WCS_SLOT_G28 = 6,
+    WCS_SLOT_G30 = 7,
+    WCS_SLOT_G92 = 8,
+    WCS_SLOT_TLO = 9,       // Tool length offset (Z only)
+    WCS_SLOT_COUNT = 10
+};
+
+// Offsets reported by $# (machine units), kept by FluidNCClient
+struct WCSTable {
+    float offsets[WCS_SLOT_COUNT][4];   // X, Y, Z, A (TLO in Z)
+    uint16_t valid;                     // Bit per slot received from the connected machine
+    uint32_t revision;                  // Bumped whenever a value changes
+    uint32_t updated_ms;                // Last $# line received
+
+    WCSTable() : valid(0), revision(0), updated_ms(0) {
+        memset(offsets, 0, sizeof(offsets));
+    }
+    bool has(int slot) const { return (valid & (1 << slot)) != 0; }
+    bool hasCoordinateSystems() const { return (valid & 0x3F) == 0x3F; }    // G54-G59
+};
+
+#endif // FLUIDNC_STATUS_H
@@ -0,0 +1,87 @@
+#ifndef GCODE_SENDER_H
+#define GCODE_SENDER_H
+
+#include <Arduino.h>
+
+// Streams a G-code file from the Display SD to FluidNC over the WebSocket
+// (drip feed), without uploading it first. Uses character-counting flow control:
+// lines are sent as long as the unacknowledged characters fit in FluidNC's receive
+// buffer, and every "ok"/"error:" response frees the oldest line. Commands sent by
+// the rest of the UI while streaming are counted too so the responses stay aligned.
+// Streaming stops on an error response (with a feed hold), alarm, soft reset or
+// disconnect; the existing Stop/Pause controls work on the streamed job as usual.
+// With a height map enabled, every line goes through GCodeLeveler first. A stream
+// only starts once every earlier command has been answered, and a line that can't
+// fit in the receive buffer at all fails the job instead of stalling it.
+class GCodeSender {
+public:
+    enum class State {
+        IDLE,
+        STREAMING,
+        DONE,
+        FAILED
+    };
+
+    // Start streaming a Display SD file (machine must be connected and idle)
+    static bool start(const char *path);
+
+    // Send as much as the receive buffer allows - call from the main loop
+    static void loop();
+
+    // Hooks from FluidNCClient
+    static void onResponse(const char *payload);       // Every non-status message
+    static void onCommandSent(const char *command);    // Every line sent outside the stream
+
+    static bool isActive() { return state == State::STREAMING; }
+    static State getState() { return state; }
+    static float getPercent();                          // Acknowledged bytes of the file
+    static const char* getPath() { return path; }
+    static float getLinesPerSecond() { return lines_per_sec; }
+    static bool isLeveling() { return leveling; }       // Height map applied (HeightMapStore)
+    static const char* getError() { return error; }
+
+private:
+    // Unacknowledged lines, oldest first
+    struct InFlight {
+        uint16_t length;      // Characters including '\n'
+        bool ours;            // false = command sent by the UI
+        uint32_t end_offset;  // File offset after this line (ours only)
+    };
+    static const int MAX_IN_FLIGHT = 128;
+
+    static State state;
+    static char path[128];
+    static char error[64];
+    static uint32_t file_size;
+    static uint32_t acked_offset;
+    static bool eof;
+
+    static InFlight in_flight[MAX_IN_FLIGHT];
+    static int in_flight_head;
+    static int in_flight_count;
+    static uint32_t in_flight_chars;
+
+    static char next_line[256];        // Next line to send (read ahead, waiting for buffer space)
+    static uint16_t next_len;          // 0 = none
+    static uint32_t next_end_offset;
+
+    // Throughput
+    static uint32_t rate_window_ms;
+    static uint32_t rate_window_lines;
+    static float lines_per_sec;
+    static bool leveling;              // Lines go through GCodeLeveler
+    static uint32_t lines_acked;
+    static uint32_t fill_samples;
+    static uint64_t fill_sum;
+
+    // Lines sent outside a stream (or left over from a stopped one) still waiting for
+    // their ok - a new stream would take their responses as its own
+    static uint16_t pending_responses;
+    static uint32_t pending_since_ms;
+
+    static bool readNextLine();
+    static void push(uint16_t length, bool ours, uint32_t end_offset);
+    static void finish(State final_state, const char *message);
+};
+
+#endif // GCODE_SENDER_H
@@ -0,0 +1,88 @@
+#ifndef MACHINE_SESSIONS_H
+#define MACHINE_SESSIONS_H
+
+#include <Arduino.h>
+#include <ArduinoWebsockets.h>
+#include "network/fluidnc_client.h"
+#include "network/timed_tcp_client.h"
+#include "ui/machine_config.h"
+
+// Status-only WebSocket session to a machine that is not the focused one. Only status
+// reports are parsed (with FluidNCClient::parseStatusFields), at SESSION_REPORT_INTERVAL_MS.
+// Heap and poll time are measured per session for the budget log.
+class MachineSession {
+public:
+    MachineSession() = default;
+    MachineSession(const MachineSession&) = delete;
+    MachineSession& operator=(const MachineSession&) = delete;
+
+    bool open(int machine_index, const MachineSummary &machine, const char *host);
+    void close();
+    void poll();
+
+    bool isOpen() const { return ws->available(); }
+    bool isConnected() const { return status.is_connected && ws->available(); }
+    bool hasAddress() const { return has_address; }
+    const FluidNCStatus& getStatus() const { return status; }
+
+private:
+    friend class MachineSessions;
+
+    websockets::WebsocketsClient socket{std::make_shared<TimedTcpClient>()};
+    websockets::WebsocketsClient *ws = &socket;   // Swapped with FluidNCClient on focus switch
+    int machine_index = -1;
+    char host[64] = "";
+    bool has_address = true;
+    FluidNCStatus status;
+    uint32_t closed_ms = 0;       // 0 = never failed/closed (retry immediately)
+    uint8_t failures = 0;         // Failed connects in a row (retry backoff)
+
+    // Budget measurements
+    uint32_t heap_bytes = 0;      // Heap taken by connect (socket, buffers)
+    uint32_t poll_us = 0;         // Poll time since the last stats log
+    uint32_t poll_count = 0;
+    uint32_t reports = 0;         // Status reports since the last stats log
+
+    uint32_t retryDelayMs() const;
+    void attach();                // Register callbacks on ws
+    void requestReports();
+    void onMessage(websockets::WebsocketsMessage message);
+    void onEvent(websockets::WebsocketsEvent event);
+};
+
+// Background sessions to every configured machine reachable on the current network,
+// kept open once the dashboard has been opened. focus() hands an open session's socket
+// to FluidNCClient and takes the previously focused connection in exchange, so switching
+// machines needs no reconnect on either side. Sessions connect one at a time (the
+// WebSocket connect blocks for up to CONN_TCP_CONNECT_TIMEOUT_MS), only while the
+// dashboard is on screen and never during a Display SD stream, a jog or a probe routine.
+// A machine that doesn't answer is retried with exponential backoff.
+class MachineSessions {
+public:
+    // Start watching the other machines (first dashboard open)
+    static void start();
+
+    // Poll open sessions and open missing ones - call from the main loop
+    static void loop();
+
+    // Session of a machine, nullptr for the focused machine or before start()
+    static const MachineSession* getSession(int machine_index);
+
+    // Machine is on the network the display is connected to
+    static bool isReachable(const MachineSummary &machine);
+
+    // Make a machine with a connected session the focused one and rebuild the main UI
+    // (refused while a Display SD stream or a probe routine is running)
+    static bool focus(int machine_index);
+
+private:
+    static MachineSession sessions[MAX_MACHINES];
+    static bool started;
+    static uint32_t last_connect_ms;
+    static uint32_t last_stats_ms;
+
+    static void openNext();
+    static void logStats();
+};
+
+#endif // MACHINE_SESSIONS_H
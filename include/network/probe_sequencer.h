@@ -0,0 +1,132 @@
+#ifndef PROBE_SEQUENCER_H
+#define PROBE_SEQUENCER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "network/reply_tracker.h"
+
+class HeightMap;
+
+// One [PRB:x,y,z:success] report (machine coordinates)
+struct ProbeResult {
+    float x, y, z;
+    bool success;
+    uint32_t time_ms;          // millis() when it arrived
+};
+
+// Settings a routine runs with (mm, mm/min)
+struct ProbeParams {
+    float feed_rate;
+    float max_distance;        // Longest probing move
+    float retract;             // Back-off after each contact
+    float thickness;           // Touch plate thickness (Z)
+    float tip_diameter;        // Probe tip or tool diameter (X/Y edges)
+};
+
+// Corner of the stock, seen from the front of the machine
+enum class ProbeCorner : uint8_t { FRONT_LEFT, FRONT_RIGHT, BACK_LEFT, BACK_RIGHT };
+
+// Runs probe routines one line at a time: a line is sent only after FluidNC answered the
+// previous one with "ok", and a G38.2 also needs its [PRB:] report. Moves of compound
+// routines (corner, bore center) are computed from earlier contacts, and the work offset
+// of the active WCS is set with G10 L20 right after each contact. Commands sent by the
+// rest of the UI and by FluidNCClient itself are counted (also between routines) so
+// the responses stay aligned. The routine stops on an
+// error, alarm, feed hold, soft reset or disconnect. Every [PRB:] report - also from
+// macros and the terminal - is kept in a history ring buffer.
+class ProbeSequencer {
+public:
+    enum class State { IDLE, RUNNING, DONE, FAILED };
+
+    // Routines (machine must be connected and idle, no stream running)
+    static bool probeAxis(char axis, char direction, const ProbeParams &params);
+    static bool probeCorner(ProbeCorner corner, bool touch_z, const ProbeParams &params);
+    static bool probeBore(const ProbeParams &params);
+    // Z at every point of the map's grid (set up, in work coordinates); heights are made
+    // relative to the first point when the grid is complete
+    static bool probeGrid(HeightMap &map, const ProbeParams &params);
+
+    // Send the next step once the previous one is acknowledged - call from the main loop
+    static void loop();
+
+    // Hooks from FluidNCClient
+    static void onResponse(const char *payload);       // Every non-status message
+    static void onCommandSent(const char *command);    // Every line the UI sends
+
+    static State getState() { return state; }
+    static bool isRunning() { return state == State::RUNNING; }
+    static const char* getMessage() { return message; }      // Progress, result or error (2 lines)
+    static uint32_t getChangeCount() { return changes; }     // Increments when the message or history changes
+
+    // [PRB:] history, newest first
+    static int getHistoryCount() { return history_count; }
+    static const ProbeResult& getHistory(int index);
+    static void clearHistory();
+
+private:
+    enum class StepKind : uint8_t {
+        SEND,     // Fixed line
+        PROBE,    // Fixed G38.2 line, contact stored in a slot
+        MOVE      // G53 G0 to a position computed when the step is sent
+    };
+    enum class Base : uint8_t {
+        START,    // Machine position when the routine started
+        SLOT,     // Contact in slot_a
+        MID       // Midpoint of the contacts in slot_a and slot_b
+    };
+    struct Step {
+        StepKind kind;
+        char axis;                 // MOVE (and PROBE for the summary)
+        Base base;                 // MOVE
+        int8_t slot_a, slot_b;     // PROBE stores into slot_a
+        float offset;              // MOVE: added to the base position
+        char line[40];             // SEND / PROBE
+    };
+    enum class Routine : uint8_t { AXIS, CORNER, BORE, GRID };
+
+    static const int MAX_STEPS = 40;
+    static const int MAX_SLOTS = 6;
+
+    static State state;
+    static Routine routine;
+    static Step steps[MAX_STEPS];
+    static int step_count;
+    static int step_index;             // Step sent last / to send next
+    static float start_pos[3];
+    static float slots[MAX_SLOTS][3];
+    static ProbeParams params;
+    static char restore_line[8];       // Distance mode (G90/G91) to put back at the end
+
+    // Grid routine: steps are generated one point at a time
+    static HeightMap *grid_map;
+    static int grid_point;             // Point being probed (serpentine order)
+
+    // Response accounting (FIFO: lines sent before our step are answered first)
+    static ReplyTracker replies;
+    static bool got_contact;           // [PRB:] seen for the PROBE step in flight
+    static uint32_t sent_ms;
+    static uint32_t step_timeout_ms;
+
+    static char message[96];
+    static uint32_t changes;
+
+    static ProbeResult history[PROBE_HISTORY_SIZE];
+    static int history_head;           // Next slot to write
+    static int history_count;
+
+    static bool begin(Routine kind, const ProbeParams &p);
+    static void addSend(const char *fmt, ...);
+    static void addProbe(char axis, float distance, int slot, float thickness = 0.0f);
+    static void addMove(char axis, Base base, int slot_a, int slot_b, float offset);
+    static void addCornerLegs(int sx, int sy, float cx, float cy);
+    static void addGridPoint();
+    static void gridIndex(int point, int &i, int &j);
+    static void sendStep();
+    static void handleLine(const char *line, size_t len);
+    static void onContact(const ProbeResult &result);
+    static void finish(State final_state, const char *text, bool restore);
+    static void setMessage(const char *fmt, ...);
+    static float axisValue(const float pos[3], char axis);
+};
+
+#endif // PROBE_SEQUENCER_H
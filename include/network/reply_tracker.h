@@ -0,0 +1,43 @@
+#ifndef REPLY_TRACKER_H
+#define REPLY_TRACKER_H
+
+#include <cstdint>
+
+// Matches FluidNC's "ok"/"error:" replies to the lines they answer. Replies come back
+// in send order, so it is enough to count the lines other senders put before and after
+// our own line (one in flight at a time). Foreign lines are also counted while nothing
+// of ours is in flight, so a reply still outstanding when a routine starts isn't taken
+// for the answer to its first line. Plain C++ so it can be built on a host.
+class ReplyTracker {
+public:
+    void reset();
+
+    // Our line went out - everything sent before it is answered first
+    void sentOwn();
+
+    // Another sender's lines went out
+    void sentForeign(int lines, uint32_t now_ms);
+
+    // An ok or error: arrived - true if it answers our line
+    bool onReply();
+
+    // Stop waiting for our line; a reply still due for it is skipped like a foreign one
+    void cancelOwn(uint32_t now_ms);
+
+    // Forget foreign replies due for longer than max_age_ms (lost to a reset)
+    void dropStale(uint32_t now_ms, uint32_t max_age_ms);
+
+    bool isAwaiting() const { return awaiting; }
+    int getForeignPending() const { return ahead + behind; }
+
+    // Lines in a command as sent (empty lines get no reply)
+    static int countLines(const char *command);
+
+private:
+    bool awaiting = false;
+    int ahead = 0;                 // Foreign lines sent before ours, unanswered
+    int behind = 0;                // Foreign lines sent after ours, unanswered
+    uint32_t foreign_ms = 0;       // When the newest foreign line went out
+};
+
+#endif // REPLY_TRACKER_H
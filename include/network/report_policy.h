@@ -0,0 +1,25 @@
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <Arduino.h>
+
+// Chooses the FluidNC auto-report interval from what the user can currently see:
+// fast while jogging, normal during other motion, slow when idle off the DRO tabs
+// or dimmed, and paused (with a slow '?' heartbeat) while the screen is off.
+class ReportPolicy {
+public:
+    // Re-evaluate the policy - call every loop iteration (sends only on change)
+    static void update();
+
+    // Interval the UI should refresh status at (follows the negotiated report rate)
+    static uint32_t getDisplayIntervalMs();
+
+private:
+    static uint16_t pending_interval;   // Candidate waiting out the settle time
+    static uint32_t pending_since_ms;   // millis() when the candidate was first chosen
+    static uint32_t last_heartbeat_ms;  // Last '?' sent while reports are paused
+
+    static uint16_t chooseInterval();
+};
+
+#endif // REPORT_POLICY_H
@@ -0,0 +1,21 @@
+#ifndef TIMED_TCP_CLIENT_H
+#define TIMED_TCP_CLIENT_H
+
+#include <ArduinoWebsockets.h>
+#include "config.h"
+
+// WebSocket transport whose TCP connect gives up after CONN_TCP_CONNECT_TIMEOUT_MS
+// instead of the WiFiClient default, so a powered-off machine stalls the main loop
+// for a fraction of a second at most. Hosts are IP addresses by the time a socket
+// connects (ConnectionManager resolves names asynchronously), so no lookup blocks here.
+// Every WebsocketsClient that FluidNCClient and MachineSessions swap is built on one.
+class TimedTcpClient : public websockets::network::Esp32TcpClient {
+public:
+    bool connect(const websockets::WSString &host, const int port) override {
+        bool connected = client.connect(host.c_str(), port, CONN_TCP_CONNECT_TIMEOUT_MS);
+        client.setNoDelay(true);
+        return connected;
+    }
+};
+
+#endif // TIMED_TCP_CLIENT_H
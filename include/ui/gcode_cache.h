@@ -0,0 +1,107 @@
+#ifndef GCODE_CACHE_H
+#define GCODE_CACHE_H
+
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "gcode/gcode_analyzer.h"
+
+class HTTPClient;
+class WiFiClient;
+
+// Cached analysis of one file (fixed-size record header in the cache file)
+struct GCodeCacheEntry {
+    static const int PROFILE_POINTS = 32;
+
+    uint32_t path_hash;       // FNV-1a of the full path, machine URL first for FluidNC files (0 = empty slot)
+    uint32_t size;            // File size in bytes
+    uint32_t content_hash;    // Hash of the first and last GCODE_CACHE_HASH_BLOCK bytes
+    uint32_t last_used;       // Replacement counter (least recently used slot is reused)
+    GCodeAnalysis analysis;
+    float profile[PROFILE_POINTS + 1];  // Estimated time (s) at byte offset k/PROFILE_POINTS of the file
+};
+
+// Persistent cache of G-code analysis results (stats + thumbnail) on LittleFS.
+// Entries are keyed by path (plus the machine URL for FluidNC files) and size, and
+// store a hash of the head and tail of the file. lookup() matches path and size only;
+// Display SD files are re-hashed when analyze() is called and when the background
+// queue reaches them. FluidNC files can't be checked without downloading them.
+// Also runs the analysis jobs themselves: one at a time, a chunk per loop(), reading
+// from the Display SD or streaming from FluidNC over HTTP. Display SD files queued
+// with queueBackground() are analyzed while the machine is idle; FluidNC files only
+// in the foreground, since opening the HTTP connection blocks the main loop.
+class GCodeCache {
+public:
+    // Cached result for a file (path + size match - content is checked by analyze() and the background queue)
+    // FluidNC files (display_sd false) are looked up for the focused machine
+    static const GCodeCacheEntry* lookup(const char *path, bool display_sd, uint32_t size);
+
+    // Most recently stored result for a path, whatever its size (running jobs only report the path)
+    static const GCodeCacheEntry* lookupPath(const char *path, bool display_sd);
+
+    // Cached or last analyzed result including the thumbnail
+    static bool get(const char *path, bool display_sd, uint32_t size, GCodeAnalysis &analysis, GCodeThumbnail &thumbnail);
+
+    // Analyze a file now (preempts background work). Returns true if a job was started,
+    // false if a valid result is already cached (Display SD files are re-hashed to check)
+    // or the file could not be opened - get() tells the two apart.
+    static bool analyze(const char *path, bool display_sd, uint32_t size);
+
+    // Background precompute list of Display SD files (replaced whenever the file list is shown).
+    // Files with a cached result are re-hashed and analyzed again if they changed.
+    static void clearBackground();
+    static void queueBackground(const char *path, uint32_t size);
+
+    // Job state
+    static bool isAnalyzing(const char *path);
+    static int getProgress();                          // 0-100 for the running job
+    static const GCodeAnalyzer& getAnalyzer();         // Partial result of the running job
+
+    // True once after a job stored a new result (file list refreshes its estimates)
+    static bool takeChanged();
+
+    // Process the running job / start the next background job - call from the main loop
+    static void loop();
+
+    // HTTP URL of a FluidNC /sd/ or /localfs/ file on the focused machine (empty without an address)
+    static String fileURL(const char *path);
+
+private:
+    struct PendingFile {
+        std::string path;
+        uint32_t size;
+        bool cached;       // Had a result when queued (counted apart from new files)
+    };
+
+    static bool loaded;
+    static bool fs_ok;
+    static GCodeCacheEntry *entries;   // In-memory copy of all record headers
+    static uint32_t entry_count;       // Records in the cache file
+    static uint32_t use_counter;
+    static bool changed;
+    static std::vector<PendingFile> background;
+
+    // Running job
+    static bool job_active;
+    static bool job_foreground;
+    static bool job_display_sd;
+    static char job_path[256];
+    static uint32_t job_size;
+    static uint32_t job_head_hash;
+    static uint32_t job_key;           // hashPath() of the running job
+    static uint32_t last_key;          // hashPath() of the last finished job (result held in the analyzer), 0 = none
+    static HTTPClient *http;
+    static WiFiClient *stream;
+
+    static void ensureLoaded();
+    static int findSlot(uint32_t path_hash, uint32_t size);
+    static void store(uint32_t path_hash);
+    static bool startJob(const char *path, bool display_sd, uint32_t size, bool foreground);
+    static void endJob(bool complete);
+    static bool hashDisplaySDFile(const char *path, uint32_t &hash);
+    static uint32_t finishHash();
+    static uint32_t hashPath(const char *path, bool display_sd);
+    static void profileHook(uint32_t byte_offset, float time_sec, void *ctx);
+};
+
+#endif // GCODE_CACHE_H
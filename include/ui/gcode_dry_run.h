@@ -0,0 +1,54 @@
+#ifndef GCODE_DRY_RUN_H
+#define GCODE_DRY_RUN_H
+
+#include <Arduino.h>
+#include "gcode/gcode_simulator.h"
+
+class HTTPClient;
+class WiFiClient;
+
+// Dry run of a G-code file on the panel with GCodeSimulator. Asks the focused machine for
+// its work offsets ($#) and axis travel ($/axes/<axis>/...), then simulates the file a
+// chunk per loop(), reading from the Display SD or streaming from FluidNC over HTTP.
+// The controller only answers the queries - nothing runs in $C check mode.
+class GCodeDryRun {
+public:
+    enum class State { IDLE, QUERYING, RUNNING, DONE, FAILED };
+
+    // Start a dry run (path is a Display SD path, or a FluidNC /sd/ or /localfs/ path)
+    static bool start(const char *path, bool display_sd);
+    static void cancel();
+
+    // Collect query responses / simulate the next chunk - call from the main loop
+    static void loop();
+
+    static State getState() { return state; }
+    static bool isRunning() { return state == State::QUERYING || state == State::RUNNING; }
+    static int getProgress();                       // 0-100 while simulating
+    static const GCodeSimReport& getReport();
+    static bool hasMachineSetup() { return machine_setup; }  // Offsets and envelope came from $# and the axis settings
+
+private:
+    static State state;
+    static char path[256];
+    static bool display_sd;
+    static uint32_t file_size;
+    static uint32_t file_read;
+    static GCodeSimSetup setup;
+    static bool machine_setup;
+    static int pending_responses;      // ok/error lines still expected for the queries
+    static uint32_t query_start_ms;
+    static float travel[3];            // $/axes/<axis>/max_travel_mm (0 = unknown)
+    static float home_mpos[3];         // $/axes/<axis>/homing/mpos_mm
+    static bool home_positive[3];      // $/axes/<axis>/homing/positive_direction
+    static HTTPClient *http;
+    static WiFiClient *stream;
+
+    static void onMessage(const char *message);
+    static void parseResponse(const char *line);
+    static void startSimulation();
+    static bool openFile();
+    static void end(State final_state);
+};
+
+#endif // GCODE_DRY_RUN_H
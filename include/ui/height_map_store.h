@@ -0,0 +1,38 @@
+#ifndef HEIGHT_MAP_STORE_H
+#define HEIGHT_MAP_STORE_H
+
+#include <Arduino.h>
+#include "gcode/height_map.h"
+#include "network/probe_sequencer.h"
+
+// The surface height map: probed with ProbeSequencer::probeGrid(), saved to the Display SD
+// (HEIGHTMAP_PATH, HeightMap's compact image) when the grid completes, and applied to
+// Display SD streams by GCodeSender while compensation is enabled. Compensation is off
+// after every restart so a map from another job is never applied by accident.
+class HeightMapStore {
+public:
+    static HeightMap& getMap() { return map; }
+
+    // Load HEIGHTMAP_PATH (once, or again with force)
+    static bool load(bool force = false);
+
+    // Probe a new grid (in work coordinates) - replaces the map when it completes
+    static bool startProbe(float x0, float y0, float width, float height, int nx, int ny, const ProbeParams &params);
+    static bool isProbing() { return probing; }
+
+    // Save the finished grid / restore the saved map after a failed one - call from the main loop
+    static void loop();
+
+    static bool isEnabled() { return enabled && map.isComplete(); }
+    static void setEnabled(bool enable) { enabled = enable; }
+
+private:
+    static HeightMap map;
+    static bool loaded;
+    static bool probing;
+    static bool enabled;
+
+    static bool save();
+};
+
+#endif // HEIGHT_MAP_STORE_H
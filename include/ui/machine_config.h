@@ -3,7 +3,7 @@
 
 #include <Arduino.h>
 
-#define MAX_MACHINES 4
+#define MAX_MACHINES 32
 
 enum ConnectionType {
     CONN_WIRED = 0,
@@ -60,18 +60,30 @@ struct MachineConfig {
     }
 };
 
+// Fields needed to list a machine. Kept in RAM for every slot - the full
+// MachineConfig is read from the catalog only when it is needed.
+struct MachineSummary {
+    char name[32];
+    char ssid[33];
+    char fluidnc_url[128];
+    uint16_t websocket_port;
+    ConnectionType connection_type;
+    bool is_configured;
+    bool has_password;       // Wireless machines can't connect without one
+};
+
+// Machines live in a catalog file on LittleFS: a header, a table of summaries (read
+// in one go on first use) and one CRC-checked record per slot, read with a seek.
+// The last machine read or saved is cached; saving is write-behind via SettingsStore.
 class MachineConfigManager {
 public:
-    // Load all machines from Preferences (with caching)
-    static void loadMachines(MachineConfig machines[MAX_MACHINES]);
-    
-    // Force reload from NVS (clears cache)
-    static void reloadMachines();
+    // Summary of a slot (is_configured == false for empty or invalid slots)
+    static const MachineSummary& getSummary(int index);
     
-    // Save all machines to Preferences
-    static void saveMachines(const MachineConfig machines[MAX_MACHINES]);
+    // Number of configured machines
+    static int getMachineCount();
     
-    // Get a specific machine by index
+    // Get a specific machine by index (one catalog read unless it is the cached one)
     static bool getMachine(int index, MachineConfig &config);
     
     // Save a specific machine by index
@@ -80,10 +92,19 @@ public:
     // Delete a machine (mark as unconfigured)
     static bool deleteMachine(int index);
     
+    // Exchange two slots (list reordering) - written immediately
+    static bool swapMachines(int index1, int index2);
+    
+    // Remove every machine and the catalog file
+    static void clearMachines();
+    
+    // Recently used machines, most recent first (at most MACHINE_RECENT_COUNT)
+    static int getRecentMachines(int *indexes, int max);
+    
     // Get the currently selected machine index
     static int getSelectedMachineIndex();
     
-    // Set the currently selected machine index
+    // Set the currently selected machine index (also moves it to the front of the recent list)
     static void setSelectedMachineIndex(int index);
     
     // Get currently selected machine config
@@ -93,8 +114,27 @@ public:
     static bool hasConfiguredMachines();
     
 private:
-    static MachineConfig cached_machines[MAX_MACHINES];
-    static bool cache_valid;
+    static MachineSummary *summaries;   // MAX_MACHINES entries
+    static MachineConfig *ram_records;  // Only when LittleFS can't be mounted
+    static bool loaded;
+    static bool fs_ok;
+    static MachineConfig cached_config; // Last machine read or saved
+    static int cached_index;
+    static bool cached_dirty;           // cached_config not yet written
+    static uint32_t dirty_summaries;    // Slots whose summary changed since the last write
+    static uint8_t recent[];            // Slot indexes, most recent first (NVS "m_recent")
+    static int recent_count;
+    
+    static void ensureLoaded();
+    static bool writeCatalog(const MachineConfig *configs, int count);
+    static void migrateFromNVS();
+    static bool convertCatalog(uint16_t old_slots);
+    static bool readRecord(int index, MachineConfig &config);
+    static void writeSlots(const int *indexes, const MachineConfig *configs, int count);
+    static void setSummary(int index, const MachineConfig &config);
+    static void commitMachines();
+    static void commitRecent();
+    static void forgetRecent(int index);
 };
 
 #endif // MACHINE_CONFIG_H
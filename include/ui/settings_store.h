@@ -0,0 +1,47 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <Arduino.h>
+
+// Write-behind persistence for settings edited from the UI. Owners keep the live
+// values in RAM (their in-memory copy is the shadow) and call schedule() with the
+// function that writes them to NVS. Commits run from the main loop once edits have
+// been quiet for SETTINGS_COMMIT_DELAY_MS, so rapid changes coalesce into a single
+// write per owner and no flash erase happens inside an LVGL event callback.
+// flush() must be called before restart or deep sleep.
+class SettingsStore {
+public:
+    using CommitFn = void (*)();
+
+    // Mark an owner's settings dirty (repeated calls before the commit are merged)
+    static void schedule(CommitFn commit);
+
+    // Commit when the quiet period has passed - call from the main loop
+    static void loop();
+
+    // Commit everything pending right now
+    static void flush();
+
+    static bool isPending() { return pending_count > 0; }
+
+    // Instrumentation
+    static uint32_t getCommitCount() { return commit_count; }      // Owner commits written
+    static uint32_t getCoalescedCount() { return coalesced_count; } // schedule() calls merged into a pending commit
+    static uint32_t getLastCommitUs() { return last_commit_us; }
+    static uint32_t getMaxCommitUs() { return max_commit_us; }
+
+private:
+    static const int MAX_PENDING = 8;
+
+    static CommitFn pending[MAX_PENDING];
+    static int pending_count;
+    static uint32_t first_change_ms;
+    static uint32_t last_change_ms;
+
+    static uint32_t commit_count;
+    static uint32_t coalesced_count;
+    static uint32_t last_commit_us;
+    static uint32_t max_commit_us;
+};
+
+#endif // SETTINGS_STORE_H
@@ -0,0 +1,84 @@
+#ifndef SETTINGS_STREAM_H
+#define SETTINGS_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+
+// Byte streams a settings backup is written to and read from (a Display SD file
+// on the device)
+class SettingsSink {
+public:
+    virtual ~SettingsSink() = default;
+    virtual size_t write(const uint8_t *data, size_t len) = 0;
+};
+
+class SettingsSource {
+public:
+    virtual ~SettingsSource() = default;
+    virtual int read(uint8_t *buf, size_t len) = 0;   // 0 at end, -1 on error
+};
+
+// Buffered output for the export (one sink write per SETTINGS_IO_BUFFER_SIZE bytes).
+// Also an ArduinoJson writer, so serializeJson() can stream straight into it.
+class SettingsFileWriter {
+public:
+    explicit SettingsFileWriter(SettingsSink &s) : sink(s) {}
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *data, size_t size);
+    void print(const char *s);
+    void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    // Write out what is buffered - false once any write has failed
+    bool flushBuffer();
+
+    bool failed = false;
+    size_t total = 0;
+
+private:
+    SettingsSink &sink;
+    uint8_t buf[SETTINGS_IO_BUFFER_SIZE];
+    size_t len = 0;
+};
+
+// Buffered input for the import. deserializeJson() stops at the end of each value,
+// so the top-level object is walked by hand with next()/consume()/readKey() and only
+// one member (one machine) is parsed into memory at a time. Between beginRecord()
+// and endRecord() read() cuts a value off after SETTINGS_MAX_RECORD_BYTES, which
+// keeps the JsonDocument bounded whatever the file contains. Also an ArduinoJson
+// reader (read() and readBytes()). Plain C++ so it can be built on a host.
+class SettingsFileReader {
+public:
+    explicit SettingsFileReader(SettingsSource &s) : source(s) {}
+
+    int read();
+    size_t readBytes(char *out, size_t length);
+    int peek() { return fill() ? buf[pos] : -1; }
+
+    // Next non-whitespace character (not consumed), -1 at end of file
+    int next();
+
+    // Consume c if it is the next non-whitespace character
+    bool consume(char c);
+
+    // "key": - returns false on malformed input
+    bool readKey(char *key, size_t key_size);
+
+    // Bound the reads of one value; endRecord() is false if it was cut off
+    void beginRecord();
+    bool endRecord();
+
+private:
+    SettingsSource &source;
+    uint8_t buf[SETTINGS_IO_BUFFER_SIZE];
+    size_t pos = 0;
+    size_t len = 0;
+    bool limited = false;
+    bool too_large = false;
+    size_t record_bytes = 0;
+
+    bool fill();
+};
+
+#endif // SETTINGS_STREAM_H
@@ -0,0 +1,38 @@
+#ifndef SYSTEM_PREF_KEYS_H
+#define SYSTEM_PREF_KEYS_H
+
+#include <cstdint>
+
+// Keys of PREFS_SYSTEM_NAMESPACE
+enum class SysPref : uint8_t {
+    SHOW_MACHINE_SELECT,    // "show_mach_sel"  bool
+    FOLDERS_ON_TOP,         // "folders_on_top" bool
+    DISPLAY_ROTATION,       // "display_rot"    uint8 (0 = normal, 2 = 180 degrees)
+    TERMINAL_LOG,           // "term_log"       bool
+    CLEAN_SHUTDOWN,         // "clean_shutdown" bool
+    PM_ENABLED,             // "pm_enabled"     bool
+    PM_DIM_TIMEOUT,         // "pm_dim_to"      uint32 seconds
+    PM_SLEEP_TIMEOUT,       // "pm_sleep_to"    uint32 seconds
+    PM_DEEP_SLEEP_TIMEOUT,  // "pm_deepsleep"   uint32 seconds
+    PM_NORMAL_BRIGHTNESS,   // "pm_norm_bri"    uint8 percent
+    PM_DIM_BRIGHTNESS,      // "pm_dim_bri"     uint8 percent
+    PROBE_TIP_DIAMETER,     // "probe_tip_um"   uint32 microns (probe routines)
+    COUNT
+};
+
+// NVS storage type of each key (matches what older firmware wrote)
+enum class PrefType : uint8_t { BOOL, U8, U32 };
+
+struct PrefDef {
+    const char *key;
+    PrefType type;
+    uint32_t def;
+};
+
+// Key table behind SystemPrefs, kept apart from the NVS code so it can be built
+// on a host. sysPrefValue() is a value as the key's type stores it (bools 0/1,
+// uint8 clamped to 255).
+const PrefDef &sysPrefDef(SysPref pref);
+uint32_t sysPrefValue(SysPref pref, uint32_t value);
+
+#endif // SYSTEM_PREF_KEYS_H
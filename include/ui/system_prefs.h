@@ -0,0 +1,36 @@
+#ifndef SYSTEM_PREFS_H
+#define SYSTEM_PREFS_H
+
+#include <Arduino.h>
+#include "ui/system_pref_keys.h"
+
+// In-memory copy of the system preferences. Loaded once at boot; reads never touch
+// NVS. set*() updates the value, notifies listeners and schedules one SettingsStore
+// commit that writes every changed key.
+class SystemPrefs {
+public:
+    using Listener = void (*)(SysPref pref);
+
+    // Read all keys from NVS (boot, or after the namespace was cleared)
+    static void load();
+
+    static bool getBool(SysPref pref) { return values[(int)pref] != 0; }
+    static uint32_t getUInt(SysPref pref) { return values[(int)pref]; }
+
+    static void setBool(SysPref pref, bool value) { setUInt(pref, value ? 1 : 0); }
+    static void setUInt(SysPref pref, uint32_t value);
+
+    // Called after a value changes (up to MAX_LISTENERS)
+    static void subscribe(Listener listener);
+
+private:
+    static const int MAX_LISTENERS = 4;
+
+    static uint32_t values[(int)SysPref::COUNT];
+    static uint32_t dirty_mask;
+    static Listener listeners[MAX_LISTENERS];
+
+    static void commit();
+};
+
+#endif // SYSTEM_PREFS_H
@@ -6,6 +6,9 @@
 class UITabControlJoystick {
 public:
     static void create(lv_obj_t *tab);
+    
+    // True while any joystick is held and sending jog commands
+    static bool isActive();
 };
 
 #endif // UI_TAB_CONTROL_JOYSTICK_H
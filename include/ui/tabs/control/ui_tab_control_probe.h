@@ -2,17 +2,23 @@
 #define UI_TAB_CONTROL_PROBE_H
 
 #include <lvgl.h>
+#include "network/probe_sequencer.h"
 
 class UITabControlProbe {
 public:
     static void create(lv_obj_t *tab);
     static void updateResult(const char* message);
-    static void updateResult(float x, float y, float z, bool success);
     static void updateProbe(bool triggered);
     
+    // Show routine progress/results and the probe history - call from the main loop
+    static void update();
+    
     // Keyboard support
     static void showKeyboard(lv_obj_t *ta);
     static void hideKeyboard();
+    
+    // Feed, distance, retract and thickness from the tab plus the tip diameter preference
+    static bool readParams(ProbeParams &params);
 
 private:
     static lv_obj_t* results_text;
@@ -20,8 +26,13 @@ private:
     static lv_obj_t* keyboard;
     static lv_obj_t* parent_tab;
     
-    // Track which axis was last probed (for filtering results)
-    static char last_probed_axis;
+    // Probe routines dialog
+    static lv_obj_t* routines_dialog;
+    static lv_obj_t* routines_keyboard;
+    static lv_obj_t* touch_z_switch;
+    static lv_obj_t* tip_input;
+    static lv_obj_t* history_label;
+    static uint32_t shown_changes;      // ProbeSequencer change count on screen
     
     // Event handlers for probe buttons
     static void probe_x_minus_handler(lv_event_t* e);
@@ -29,9 +40,16 @@ private:
     static void probe_y_minus_handler(lv_event_t* e);
     static void probe_y_plus_handler(lv_event_t* e);
     static void probe_z_minus_handler(lv_event_t* e);
+    static void routines_handler(lv_event_t* e);
     
     // Helper to execute probe command
     static void executeProbe(char axis, char direction, bool checkWcsLock = true);
+    
+    // Corner (0-3 = ProbeCorner) or bore routine from the routines dialog
+    static void executeRoutine(int routine, bool touch_z, bool checkWcsLock = true);
+    static void showRoutinesDialog();
+    static void closeRoutinesDialog();
+    static void updateHistory();
 };
 
 #endif // UI_TAB_CONTROL_PROBE_H
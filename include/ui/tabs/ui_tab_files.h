@@ -18,7 +18,10 @@ public:
     static void refreshFileList(const std::string &path);  // Overload for specific path
     static void listDisplaySDFiles(const std::string &path);
     static void requestRefresh();  // Request a refresh (called from callbacks)
+    static void onReconnected();   // Drop FluidNC listings (files may have changed meanwhile)
     static void checkPendingRefresh();  // Check and execute pending refresh (called from main loop)
+    static void updateEstimates();      // Show new or re-analyzed run time estimates in the file rows
+    static void scanLoop();             // Continue a Display SD directory scan (called from main loop)
     static StorageSource current_storage;
     
     // Cache for each storage source
@@ -57,6 +60,9 @@ private:
     static void upload_button_event_cb(lv_event_t *e);
     static void parseFileList(const std::string &response);
     static void updateFileListUI();
+    static void createFileRow(size_t i, const FileInfo &file);
+    static void cancelScan();
+    static void finishScan();
     static std::string getParentPath(const std::string &path);
     static void showUploadDialog(const char* filename, const char* fullPath, size_t fileSize);
     static void showUploadProgress(const char* filename);
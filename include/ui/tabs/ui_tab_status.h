@@ -4,6 +4,7 @@
 #include <lvgl.h>
 #include <Arduino.h>
 #include "config.h"
+#include "gcode/gcode_modal.h"
 
 class UITabStatus {
 public:
@@ -17,13 +18,15 @@ public:
     static void updateFeedRate(float rate, float override_pct);
     static void updateRapidOverride(float override_pct);
     static void updateSpindle(float speed, float override_pct);
-    static void updateModalStates(const char *wcs, const char *plane, const char *dist, 
-                                  const char *units, const char *motion, const char *feedrate,
-                                  const char *spindle, const char *coolant, const char *tool);
+    static void updateModalStates(const GCodeModal &modal);
+    static void clearModalStates();     // Show "---" (disconnected)
     static void updateControlButtons(int machine_state);
     static void updateLimitSwitches(bool x, bool y, bool z, bool a = false);
     static void updateProbe(bool triggered);
     
+    // Refresh the WCS popup offsets when FluidNCClient's table changes - call from the main loop
+    static void updateWCSPopup();
+    
 private:
     static lv_obj_t *lbl_message;
     static lv_obj_t *lbl_state;
@@ -92,15 +95,8 @@ private:
     static float last_rapid_override;
     static float last_spindle_speed, last_spindle_override;
     static char last_state[16];
-    static char last_modal_wcs[8];
-    static char last_modal_plane[8];
-    static char last_modal_dist[8];
-    static char last_modal_units[8];
-    static char last_modal_motion[8];
-    static char last_modal_feedrate[8];
-    static char last_modal_spindle[8];
-    static char last_modal_coolant[8];
-    static char last_modal_tool[8];
+    static GCodeModal last_modal;      // Modal state on screen
+    static bool modal_shown;           // false: labels show "---"
     
     // WCS selection popup
     static lv_obj_t *wcs_popup;
@@ -110,7 +106,8 @@ private:
     static lv_obj_t *wcs_buttons[6];  // Store WCS button references for highlighting
     static int selected_wcs_index;  // Track which WCS is selected (-1 = none)
     static int current_wcs_index;  // Track which WCS is currently active (-1 = none)
-    static char wcs_offsets[10][64];  // Store parsed WCS offsets (G54-G59, G28, G30, G92, TLO)
+    static lv_obj_t *wcs_coord_labels[6];  // Offset line of each WCS button
+    static uint32_t wcs_shown_revision;  // FluidNCClient WCS table revision on screen
     
     // Event handlers for control buttons
     static void onPauseResumeClicked(lv_event_t *e);
@@ -124,7 +121,7 @@ private:
     static void onWCSCancelClicked(lv_event_t *e);
     static void showWCSPopup();
     static void hideWCSPopup();
-    static void parseWCSOffsetsResponse(const char* response);
+    static void setWCSCoordText(int index);
 };
 
 #endif // UI_TAB_STATUS_H
@@ -3,21 +3,41 @@
 
 #include <lvgl.h>
 #include <Arduino.h>
+#include "ui/terminal_log.h"
 
 class UITabTerminal {
 public:
     static void create(lv_obj_t *tab);
     static void appendMessage(const char *message);  // Add WebSocket messages to terminal
+    static uint32_t rowsForLength(size_t len);  // Display rows a line of len characters wraps into
+    static bool scrollToRow(uint32_t seq);  // Show row seq (this boot) if still in scrollback
 
 private:
-    static lv_obj_t *terminal_text;
     static lv_obj_t *terminal_cont;
     static lv_obj_t *input_field;
     static lv_obj_t *keyboard;
     static lv_obj_t *auto_scroll_switch;
+    static lv_obj_t *search_popup;
+    static lv_obj_t *search_result_label;
+    static lv_obj_t *search_log_switch;
 
-    static String terminal_buffer;  // Buffer to store terminal text
-    static const size_t MAX_BUFFER_SIZE = 8192;  // Limit buffer to 8KB
+    // Scrollback: PSRAM ring of fixed-size line slots, one display row per slot
+    static const uint16_t MAX_LINES = 10000;     // Scrollback depth (rows)
+    static const size_t LINE_SLOT = 96;          // Bytes per row slot (incl. null)
+    static const int VIEW_ROWS = 16;             // Row labels recycled by the virtualized view
+    static char *line_ring;          // ring_capacity * LINE_SLOT bytes
+    static uint16_t ring_capacity;   // Rows the ring holds (MAX_LINES unless PSRAM alloc failed)
+    static uint16_t ring_count;      // Rows currently held
+    static uint32_t total_lines;     // Rows ever appended (sequence number of the next row)
+    static uint32_t dropped_pending; // Rows evicted since the last display update
+    static uint8_t line_cols;        // Characters per display row (long lines are hard-wrapped)
+    static int32_t row_height;       // Pixel height of one row
+    static lv_obj_t *spacer;         // Sized to ring_count rows so the container scrolls natively
+    static lv_obj_t *row_labels[VIEW_ROWS];
+    static uint32_t row_seq[VIEW_ROWS];  // Row sequence number shown by each label
+    static const char *search_token;     // Token being searched (nullptr = none)
+    static uint32_t search_before_seq;   // Scrollback search continues above this row
+    static bool search_using_log;        // Searching the SD log index instead of the scrollback
     static bool auto_scroll_enabled;  // Auto-scroll toggle state
     static bool buffer_dirty;  // Flag to indicate buffer needs UI update
     static uint32_t last_update_ms;  // Timestamp of last UI update
@@ -38,9 +58,20 @@ private:
     static void clear_btn_event_cb(lv_event_t *e);
     static void hist_up_event_cb(lv_event_t *e);
     static void hist_down_event_cb(lv_event_t *e);
+    static void terminal_scroll_event_cb(lv_event_t *e);
+    static void search_btn_event_cb(lv_event_t *e);
+    static void search_kind_event_cb(lv_event_t *e);
+    static void search_older_event_cb(lv_event_t *e);
+    static void search_log_event_cb(lv_event_t *e);
+    static void search_close_event_cb(lv_event_t *e);
+    static void showNoMoreMatches();
+    static bool findInScrollback(TerminalLogMatch &match);  // Fallback when the SD log is off
     static void send_command();
-    static void trimBuffer();  // Remove old lines if buffer is too large
-    static void updateDisplay();  // Update the UI from buffer
+    static void allocRing();  // Allocate the scrollback ring (PSRAM, smaller internal fallback)
+    static void appendLine(const char *text, size_t len);  // Store one line, wrapping into rows
+    static const char* getRow(uint32_t seq);  // Row text by sequence number (nullptr if evicted)
+    static void refreshRows();  // Fill the recycled labels for the visible scroll window
+    static void updateDisplay();  // Update the UI from the ring
 
 public:
     static void update();  // Call periodically from main loop to update display
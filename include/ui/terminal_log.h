@@ -0,0 +1,91 @@
+#ifndef TERMINAL_LOG_H
+#define TERMINAL_LOG_H
+
+#include <Arduino.h>
+
+// One indexed block of the terminal log (fixed 24-byte record in the .idx file)
+struct TerminalLogBlock {
+    uint32_t offset;      // Byte offset of the block in the .log file
+    uint16_t length;      // Block length in bytes
+    uint16_t lines;       // Lines in the block
+    uint32_t first_ms;    // Uptime (millis()) when the first line was logged
+    uint32_t boot_id;     // Boot session the block was written in
+    uint32_t first_seq;   // Terminal row sequence number of the first line (this boot)
+    uint32_t token_mask;  // One bit per first-token hash of the lines in the block
+};
+
+// A line found by TerminalLog::findPrevious()
+struct TerminalLogMatch {
+    char text[96];        // Line text (truncated)
+    uint32_t first_ms;    // Block timestamp (uptime)
+    uint32_t seq;         // Terminal row sequence number of the line
+    bool this_boot;       // Logged during the current boot session (seq/first_ms are comparable)
+};
+
+// Optional append-only log of terminal output on the Display SD card.
+// Lines are collected into RAM blocks and written one block at a time from loop();
+// each block gets an index record with its timestamp and a bitmask of first-token
+// hashes, so searches for ALARM:/error:/[MSG: only read blocks that can match.
+// Lines that arrive while both blocks are full are counted and logged as a
+// "[N lines dropped]" marker. A full log is renamed to the .old files, replacing the
+// previous ones, so one log's worth of history survives each rotation.
+class TerminalLog {
+public:
+    // Load the enable preference and open the log if enabled (mounts the Display SD)
+    static void init();
+
+    // Enable/disable logging (persisted in ft_system "term_log")
+    static void setEnabled(bool enable);
+    static bool isEnabled() { return enabled; }
+
+    // Record one terminal line (seq = row sequence number of its first terminal row)
+    static void append(const char *text, size_t len, uint32_t seq);
+
+    // Write out a sealed block if one is pending - call from the main loop
+    static void loop();
+
+    // Search backwards for lines starting with token (e.g. "ALARM:").
+    // Call beginSearch() once (writes out pending lines), then findPrevious() repeatedly
+    // for older matches. Returns false when logging is off or nothing older matches.
+    static void beginSearch(const char *token);
+    static bool findPrevious(TerminalLogMatch &match);
+
+private:
+    static bool enabled;
+    static bool file_ok;                 // Log/index files open and writable
+    static uint32_t boot_id;
+    static uint32_t log_size;            // Bytes in the .log file
+
+    // Block being filled and block waiting to be written
+    static char *active_buf;
+    static TerminalLogBlock active;
+    static char *sealed_buf;
+    static TerminalLogBlock sealed;
+    static bool sealed_pending;
+    static uint32_t dropped_lines;       // Lines lost since the last marker
+
+    // In-memory copy of the index (PSRAM)
+    static TerminalLogBlock *index;
+    static uint32_t index_count;
+    static uint32_t index_capacity;
+
+    // Search state
+    static char search_token[16];
+    static uint32_t search_bit;
+    static int32_t search_block;         // Index record being searched (-1 = done)
+    static int32_t search_line;          // Search lines before this one in search_block
+    static char *read_buf;               // Block read back from SD
+    static int32_t read_block;           // Index record held in read_buf (-1 = none)
+
+    static bool openFiles();
+    static void loadIndex();
+    static void sealActive();
+    static void appendDropMarker(uint32_t seq);
+    static bool isDropMarker(const char *text, size_t len);
+    static void rotate();
+    static bool writeBlock(const char *buf, TerminalLogBlock &block);
+    static uint32_t tokenBit(const char *text, size_t len);
+    static bool searchBlock(const char *buf, const TerminalLogBlock &block, bool this_boot, TerminalLogMatch &match);
+};
+
+#endif // TERMINAL_LOG_H
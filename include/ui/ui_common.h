@@ -13,6 +13,7 @@ public:
     static void init(lv_display_t *disp);
     static void setDisplayDriver(DisplayDriver* driver);  // Set display driver reference
     static void createMainUI();  // Creates main UI screen, status bar, and tabs
+    static void rebuildMainUI();  // Recreates them for a newly focused machine (connection already open)
     static void createStatusBar();
     
     // Update functions for status bar
@@ -21,6 +22,7 @@ public:
     static void updateWorkPosition(float x, float y, float z, float a = -9999.0f);
     static void updateMachineState(const char *state);
     static void updateConnectionStatus(bool machine_connected, bool wifi_connected);
+    static void updateWiFiName(const char *ssid);
     static void updateFileProgress(bool is_printing, float percent, const char *filename, uint32_t elapsed_ms);
     
     // Dialog functions
@@ -28,10 +30,10 @@ public:
     static void hideMachineSelectConfirmDialog();
     static void showPowerOffConfirmDialog();
     static void showConnectingPopup(const char *machine_name, const char *ssid);
+    static void updateConnectingPopup(const char *text, const char *detail, int step, int total_steps);
     static void hideConnectingPopup();
     static void showConnectionErrorDialog(const char *title, const char *message);
     static void hideConnectionErrorDialog();
-    static void checkConnectionTimeout();  // Non-blocking timeout check
     
     // State popup functions (HOLD and ALARM)
     static void showHoldPopup(const char *message);
@@ -61,6 +63,9 @@ private:
     static lv_obj_t *status_bar_right_area;  // Clickable area for machine selection
     static lv_obj_t *machine_select_dialog;  // Confirmation dialog
     static lv_obj_t *connecting_popup;       // Connecting popup
+    static lv_obj_t *connecting_popup_label;  // Main text inside connecting popup
+    static lv_obj_t *connecting_popup_detail; // Stage detail inside connecting popup
+    static lv_obj_t *connecting_popup_bar;    // Stage progress bar inside connecting popup
     static lv_obj_t *connection_error_dialog; // Connection error dialog
     static lv_obj_t *hold_popup;             // HOLD state popup
     static lv_obj_t *hold_popup_msg_label;   // Message label inside HOLD popup (for live updates)
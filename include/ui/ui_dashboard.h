@@ -0,0 +1,32 @@
+#ifndef UI_DASHBOARD_H
+#define UI_DASHBOARD_H
+
+#include <lvgl.h>
+#include "ui/machine_config.h"
+
+// Full-screen overlay with a live card per configured machine (state, work position,
+// job progress). The focused machine comes from FluidNCClient, the others from
+// MachineSessions. Tapping a card makes that machine the focused one without a reconnect.
+class UIDashboard {
+public:
+    static void show();
+    static void hide();
+    static bool isVisible() { return overlay != nullptr; }
+
+    // Refresh the cards - call from the main loop (throttled internally)
+    static void update();
+
+private:
+    static lv_obj_t *overlay;
+    static lv_obj_t *lbl_message;
+    static lv_obj_t *cards[MAX_MACHINES];
+    static lv_obj_t *lbl_state[MAX_MACHINES];
+    static lv_obj_t *lbl_position[MAX_MACHINES];
+    static lv_obj_t *lbl_info[MAX_MACHINES];
+    static uint32_t last_update_ms;
+
+    static void onCardClicked(lv_event_t *e);
+    static void onCloseClicked(lv_event_t *e);
+};
+
+#endif // UI_DASHBOARD_H
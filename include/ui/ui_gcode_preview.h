@@ -0,0 +1,45 @@
+#ifndef UI_GCODE_PREVIEW_H
+#define UI_GCODE_PREVIEW_H
+
+#include <lvgl.h>
+#include "gcode/gcode_analyzer.h"
+
+// G-code preview dialog: toolpath thumbnail, extents, lengths and estimated run time.
+// Results come from GCodeCache; uncached files are analyzed by a GCodeCache job
+// (a chunk per main-loop iteration) while the dialog shows its progress.
+// "Dry Run" checks the file against the machine with GCodeDryRun and lists the problems.
+class UIGCodePreview {
+public:
+    // Open the dialog for a file (path is a Display SD path, or a FluidNC /sd/ or /localfs/ path)
+    static void show(const char *path, bool display_sd, uint32_t size);
+
+    // Follow the analysis job - call from the main loop
+    static void update();
+
+    static bool isOpen() { return dialog != nullptr; }
+
+private:
+    static lv_obj_t *dialog;
+    static lv_obj_t *canvas;
+    static lv_obj_t *stats_label;
+    static lv_obj_t *progress_bar;
+    static lv_obj_t *btn_dry_run;
+    static uint16_t *canvas_buf;
+
+    static char preview_path[256];
+    static uint32_t preview_size;
+    static bool preview_display_sd;
+    static bool waiting;                // Analysis job still running
+    static bool dry_running;            // Dry run started from this dialog
+    static uint32_t last_render_bytes;
+
+    static void showResult();
+    static void renderThumbnail(const GCodeAnalysis &analysis, const GCodeThumbnail &thumbnail);
+    static void updateStats(const GCodeAnalysis &analysis, bool complete);
+    static void updateDryRun();
+    static void showDryRunReport();
+    static void dry_run_event_cb(lv_event_t *e);
+    static void close_event_cb(lv_event_t *e);
+};
+
+#endif // UI_GCODE_PREVIEW_H
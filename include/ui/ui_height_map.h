@@ -0,0 +1,38 @@
+#ifndef UI_HEIGHT_MAP_H
+#define UI_HEIGHT_MAP_H
+
+#include <lvgl.h>
+
+// Height map dialog (opened from the probe routines dialog): grid setup, grid probing
+// through HeightMapStore, a heat map of the stored surface and the switch that applies
+// it to Display SD jobs.
+class UIHeightMap {
+public:
+    static void show();
+
+    // Follow grid probing - call from the main loop after HeightMapStore::loop()
+    static void update();
+
+    static bool isOpen() { return dialog != nullptr; }
+
+private:
+    static const int FIELD_COUNT = 6;   // X/Y start, width, height, points X/Y
+
+    static lv_obj_t *dialog;
+    static lv_obj_t *keyboard;
+    static lv_obj_t *fields[FIELD_COUNT];
+    static lv_obj_t *enable_switch;
+    static lv_obj_t *status_label;
+    static lv_obj_t *range_label;
+    static lv_obj_t *canvas;
+    static uint16_t *canvas_buf;
+    static uint32_t shown_changes;      // ProbeSequencer change count on screen
+    static bool was_probing;
+
+    static void renderMap();
+    static void updateMapInfo();
+    static void probe_event_cb(lv_event_t *e);
+    static void close_event_cb(lv_event_t *e);
+};
+
+#endif // UI_HEIGHT_MAP_H
@@ -12,20 +12,23 @@ public:
 private:
     static lv_obj_t *screen;
     static lv_display_t *display;
-    static MachineConfig machines[MAX_MACHINES];
     
     // Edit mode state
     static bool edit_mode;
     static lv_obj_t *edit_mode_button;
     static lv_obj_t *list_container;  // Reference to machine list container
     
-    // Machine button widgets
-    static lv_obj_t *machine_buttons[MAX_MACHINES];
-    static lv_obj_t *edit_buttons[MAX_MACHINES];
-    static lv_obj_t *move_up_buttons[MAX_MACHINES];
-    static lv_obj_t *move_down_buttons[MAX_MACHINES];
-    static lv_obj_t *delete_buttons[MAX_MACHINES];
+    // Virtualized machine list: a small pool of row widgets is rebound to list
+    // positions as the list scrolls, so the widget count doesn't grow with the catalog.
+    // The slot index of a machine is kept in each button's user data.
+    static const int ROW_POOL = 8;
+    static lv_obj_t *rows[ROW_POOL];
+    static int row_bound[ROW_POOL];      // List row shown by each pool row (-1 = none)
+    static int row_count;                // Pool rows in use for the current mode
+    static int visible[MAX_MACHINES];    // Slots shown, in display order
+    static int visible_count;
     static lv_obj_t *add_button;  // Single add button
+    static lv_obj_t *ta_search;   // Name/URL filter (normal mode only)
     
     // Configuration dialog
     static lv_obj_t *config_dialog;
@@ -57,9 +60,18 @@ private:
     static void onConfigCancel(lv_event_t *e);
     static void onConnectionTypeChanged(lv_event_t *e);
     static void onTextareaFocused(lv_event_t *e);
+    static void onListScroll(lv_event_t *e);
+    static void onSearchChanged(lv_event_t *e);
+    static void onSearchFocused(lv_event_t *e);
+    static void onSearchReady(lv_event_t *e);
     
     // Helper functions
     static void refreshMachineList();
+    static void selectMachine(int index);
+    static void buildVisibleList();
+    static lv_obj_t* createRow();
+    static void bindRow(int pool_index, int row);
+    static void updateRows();
     static void showConfigDialog(int index);
     static void hideConfigDialog();
     static void showDeleteConfirmDialog(int index);
@@ -21,6 +21,9 @@ public:
     // Getters for tab objects (for external access if needed)
     static lv_obj_t* getTabview() { return tabview; }
     
+    // Active tab index (0=Status, 1=Control, 2=Files, 3=Macros, 4=Terminal, 5=Settings)
+    static uint32_t getActiveTab() { return tabview ? lv_tabview_get_tab_active(tabview) : 0; }
+    
 private:
     static lv_obj_t *tabview;
     static lv_obj_t *tab_status;
@@ -0,0 +1,96 @@
+#include "core/block_cache.h"
+#include <cstring>
+
+static const uint32_t FNV_OFFSET = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+void BlockCache::clear() {
+    memset(blocks, 0, sizeof(blocks));
+}
+
+void BlockCache::invalidate(uint32_t path_hash) {
+    for (Block &b : blocks) {
+        if (b.path_hash == path_hash) b.path_hash = 0;
+    }
+}
+
+uint32_t BlockCache::hashPath(const char *path) {
+    uint32_t hash = FNV_OFFSET;
+    for (const char *p = path; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * FNV_PRIME;
+    }
+    return hash ? hash : 1;  // 0 marks a free block
+}
+
+int BlockCache::usedBlocks() const {
+    int n = 0;
+    for (const Block &b : blocks) {
+        if (b.path_hash != 0) n++;
+    }
+    return n;
+}
+
+int BlockCache::findBlock(uint32_t path_hash, uint32_t file_size, uint32_t index) const {
+    for (int i = 0; i < SD_CACHE_BLOCKS; i++) {
+        const Block &b = blocks[i];
+        if (b.path_hash == path_hash && b.file_size == file_size && b.index == index) return i;
+    }
+    return -1;
+}
+
+int BlockCache::loadBlock(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t index) {
+    // Free slot, otherwise the least recently used one
+    int slot = 0;
+    for (int i = 0; i < SD_CACHE_BLOCKS; i++) {
+        if (blocks[i].path_hash == 0) { slot = i; break; }
+        if (blocks[i].last_used < blocks[slot].last_used) slot = i;
+    }
+
+    uint32_t offset = index * SD_BLOCK_SIZE;
+    uint32_t length = file_size - offset < SD_BLOCK_SIZE ? file_size - offset : SD_BLOCK_SIZE;
+    Block &b = blocks[slot];
+    b.path_hash = 0;
+    if (!source.readAt(offset, data + (size_t)slot * SD_BLOCK_SIZE, length)) return -1;
+
+    b.path_hash = path_hash;
+    b.file_size = file_size;
+    b.index = index;
+    b.length = length;
+    b.last_used = ++use_counter;
+    return slot;
+}
+
+int BlockCache::read(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t pos,
+                     uint8_t *buf, size_t len, Stats &stats) {
+    size_t total = 0;
+    while (total < len && pos < file_size) {
+        uint32_t index = pos / SD_BLOCK_SIZE;
+        int slot = findBlock(path_hash, file_size, index);
+        if (slot >= 0) {
+            stats.hits++;
+            blocks[slot].last_used = ++use_counter;
+        } else {
+            slot = loadBlock(source, path_hash, file_size, index);
+            if (slot < 0) return total > 0 ? (int)total : -1;
+            stats.misses++;
+        }
+
+        const Block &b = blocks[slot];
+        uint32_t offset = pos - index * SD_BLOCK_SIZE;
+        size_t n = b.length - offset < len - total ? b.length - offset : len - total;
+        memcpy(buf + total, data + (size_t)slot * SD_BLOCK_SIZE + offset, n);
+        total += n;
+        pos += n;
+    }
+    return (int)total;
+}
+
+int BlockCache::prefetch(BlockSource &source, uint32_t path_hash, uint32_t file_size, uint32_t pos) {
+    uint32_t first = pos / SD_BLOCK_SIZE;
+    for (uint32_t index = first; index <= first + SD_READAHEAD_BLOCKS; index++) {
+        if (index * SD_BLOCK_SIZE >= file_size) break;
+        if (findBlock(path_hash, file_size, index) >= 0) continue;
+        return loadBlock(source, path_hash, file_size, index) >= 0 ? 1 : -1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "core/job_eta.h"
+#include "network/gcode_sender.h"
+#include "config.h"
+#include <Arduino.h>
+#include <math.h>
+
+// Static member initialization
+bool JobEta::active = false;
+char JobEta::job_name[64] = "";
+bool JobEta::has_profile = false;
+float JobEta::profile[GCodeCacheEntry::PROFILE_POINTS + 1] = {0};
+uint32_t JobEta::last_report_ms = 0;
+uint32_t JobEta::last_sample_ms = 0;
+float JobEta::run_sec = 0.0f;
+float JobEta::model_sec = 0.0f;
+float JobEta::last_model_t = 0.0f;
+float JobEta::window_run_sec = 0.0f;
+float JobEta::window_model_sec = 0.0f;
+float JobEta::ratio_dev = 0.0f;
+uint32_t JobEta::total_sec = 0;
+uint32_t JobEta::band_sec = 0;
+
+bool JobEta::loadProfile(const char *filename) {
+    // A Display SD stream reports its own path. SD: reports the name the job was
+    // started with - try it as-is and under /sd/ and /localfs/ of the focused machine
+    char path[96];
+    bool display_sd = GCodeSender::isActive();
+    const char *rel = filename[0] == '/' ? filename + 1 : filename;
+    const char *candidates[] = {"%s", "/sd/%s", "/localfs/%s"};
+    for (int i = 0; i < (display_sd ? 1 : 3); i++) {
+        snprintf(path, sizeof(path), candidates[i], i == 0 ? filename : rel);
+        const GCodeCacheEntry *entry = GCodeCache::lookupPath(path, display_sd);
+        if (entry && entry->analysis.est_time_sec > 0.0f) {
+            memcpy(profile, entry->profile, sizeof(profile));
+            Serial.printf("[JobEta] Using time profile of %s (%.0f s)\n", path, entry->analysis.est_time_sec);
+            return true;
+        }
+    }
+    Serial.printf("[JobEta] No analysis for %s - linear estimate\n", filename);
+    return false;
+}
+
+void JobEta::start(const FluidNCStatus &status) {
+    active = true;
+    strncpy(job_name, status.sd_filename, sizeof(job_name) - 1);
+    job_name[sizeof(job_name) - 1] = '\0';
+    has_profile = loadProfile(job_name);
+
+    last_report_ms = 0;
+    last_sample_ms = millis();
+    run_sec = model_sec = last_model_t = 0.0f;
+    window_run_sec = window_model_sec = 0.0f;
+    ratio_dev = 0.0f;
+    total_sec = band_sec = 0;
+}
+
+float JobEta::profileTime(float fraction) {
+    const int N = GCodeCacheEntry::PROFILE_POINTS;
+    float pos = constrain(fraction, 0.0f, 1.0f) * N;
+    int k = (int)pos;
+    if (k >= N) return profile[N];
+    return profile[k] + (profile[k + 1] - profile[k]) * (pos - k);
+}
+
+void JobEta::update(const FluidNCStatus &status) {
+    if (!status.is_sd_printing) {
+        active = false;
+        return;
+    }
+    if (!active || strcmp(job_name, status.sd_filename) != 0) {
+        start(status);
+    }
+    if (status.last_update_ms == last_report_ms) return;
+    last_report_ms = status.last_update_ms;
+
+    uint32_t now = millis();
+    float dt = (now - last_sample_ms) / 1000.0f;
+    last_sample_ms = now;
+    bool running = (status.state == STATE_RUN);
+    if (running) run_sec += dt;
+
+    float fraction = constrain(status.sd_percent / 100.0f, 0.0f, 1.0f);
+    float elapsed = status.sd_elapsed_ms / 1000.0f;
+    float remaining;
+    float band;
+
+    if (has_profile) {
+        // Feed override speeds up or slows down the model (rapids are treated the same)
+        float override_scale = status.feed_override > 1.0f ? 100.0f / status.feed_override : 1.0f;
+        float t = profileTime(fraction);
+        float d_model = t > last_model_t ? (t - last_model_t) * override_scale : 0.0f;
+        last_model_t = t;
+        model_sec += d_model;
+
+        // Measured machine/model speed ratio per window - its spread drives the band
+        float ratio = model_sec > 1.0f ? run_sec / model_sec : 1.0f;
+        if (running) window_run_sec += dt;
+        window_model_sec += d_model;
+        if (window_model_sec >= ETA_WINDOW_SEC) {
+            float dev = fabsf(window_run_sec / window_model_sec - ratio) / (ratio > 0.01f ? ratio : 1.0f);
+            ratio_dev = ratio_dev == 0.0f ? dev : ratio_dev * 0.8f + dev * 0.2f;
+            window_run_sec = window_model_sec = 0.0f;
+        }
+
+        // Trust the measured ratio more as more of the job has been observed
+        float weight = constrain(model_sec / ETA_CALIBRATION_SEC, 0.0f, 1.0f);
+        float scale = 1.0f + (ratio - 1.0f) * weight;
+        remaining = (profile[GCodeCacheEntry::PROFILE_POINTS] - t) * override_scale * scale;
+        band = remaining * (ETA_MODEL_UNCERTAINTY * (1.0f - weight) + ratio_dev);
+    } else if (fraction > 0.001f) {
+        remaining = elapsed / fraction - elapsed;
+        band = remaining * ETA_LINEAR_UNCERTAINTY;
+    } else {
+        total_sec = band_sec = 0;
+        return;
+    }
+
+    if (remaining < 0.0f) remaining = 0.0f;
+    total_sec = (uint32_t)(elapsed + remaining + 0.5f);
+    band_sec = (uint32_t)(band + 0.5f);
+}
@@ -0,0 +1,83 @@
+#include "core/motion_estimator.h"
+#include "config.h"
+#include <math.h>
+
+// Static member initialization
+float MotionEstimator::prev_pos[4] = {0, 0, 0, 0};
+float MotionEstimator::last_pos[4] = {0, 0, 0, 0};
+uint32_t MotionEstimator::prev_ms = 0;
+uint32_t MotionEstimator::last_ms = 0;
+bool MotionEstimator::have_prev = false;
+float MotionEstimator::velocity[4] = {0, 0, 0, 0};
+bool MotionEstimator::moving = false;
+
+void MotionEstimator::reset() {
+    have_prev = false;
+    moving = false;
+    last_ms = 0;
+    for (int i = 0; i < 4; i++) velocity[i] = 0.0f;
+}
+
+void MotionEstimator::update(const FluidNCStatus &status) {
+    if (!status.is_connected) {
+        if (have_prev || moving) reset();
+        return;
+    }
+
+    // Hold, Idle, Alarm etc. - freeze on the reported position
+    bool in_motion = (status.state == STATE_RUN || status.state == STATE_JOG || status.state == STATE_HOME);
+
+    if (status.last_update_ms == last_ms) {
+        if (!in_motion) moving = false;
+        return;
+    }
+
+    // New report - shift samples
+    for (int i = 0; i < 4; i++) prev_pos[i] = last_pos[i];
+    prev_ms = last_ms;
+    last_pos[0] = status.mpos_x;
+    last_pos[1] = status.mpos_y;
+    last_pos[2] = status.mpos_z;
+    last_pos[3] = status.mpos_a;
+    last_ms = status.last_update_ms;
+
+    bool had_prev = have_prev;
+    have_prev = true;
+    moving = false;
+    for (int i = 0; i < 4; i++) velocity[i] = 0.0f;
+
+    uint32_t dt = last_ms - prev_ms;
+    if (!in_motion || !had_prev || dt == 0 || dt > MOTION_SAMPLE_MAX_GAP_MS) return;
+
+    // Direction from the last two samples
+    float delta[4];
+    for (int i = 0; i < 4; i++) delta[i] = last_pos[i] - prev_pos[i];
+    float linear = sqrtf(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]);
+    if (linear < 1e-4f && fabsf(delta[3]) < 1e-4f) return;
+
+    // Speed from the reported feed (current programmed rate) when available; it reacts to
+    // acceleration and overrides faster than the averaged displacement. Rotary-only moves
+    // keep the measured rate since F is not in degrees.
+    float scale = 1.0f / dt;
+    if (status.feed_rate > 0.0f && linear >= 1e-4f) {
+        scale = (status.feed_rate / 60000.0f) / linear;
+    }
+    for (int i = 0; i < 4; i++) velocity[i] = delta[i] * scale;
+    moving = true;
+}
+
+void MotionEstimator::getOffset(uint32_t now_ms, float offset[4]) {
+    if (!moving) {
+        for (int i = 0; i < 4; i++) offset[i] = 0.0f;
+        return;
+    }
+
+    // Never extrapolate further than one nominal report gap past the last sample, so a
+    // stalled or stopping machine overshoots by at most feed * horizon before the next snap
+    uint32_t elapsed = now_ms - last_ms;
+    uint32_t horizon = last_ms - prev_ms;
+    if (horizon > MOTION_SAMPLE_MAX_GAP_MS) horizon = MOTION_SAMPLE_MAX_GAP_MS;
+    if (elapsed > horizon) elapsed = horizon;
+
+    for (int i = 0; i < 4; i++) offset[i] = velocity[i] * elapsed;
+}
@@ -1,7 +1,8 @@
 #include "core/power_manager.h"
 #include "network/fluidnc_client.h"
 #include "config.h"
-#include <Preferences.h>
+#include "ui/settings_store.h"
+#include "ui/system_prefs.h"
 #include <Arduino.h>
 #include <WiFi.h>
 #include <esp_sleep.h>
@@ -98,17 +99,12 @@ void PowerManager::update(int machine_state) {
 }
 
 void PowerManager::loadSettings() {
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
-    
-    enabled = prefs.getBool("pm_enabled", true);
-    dim_timeout_sec = prefs.getUInt("pm_dim_to", 30);
-    sleep_timeout_sec = prefs.getUInt("pm_sleep_to", 300);
-    deep_sleep_timeout_sec = prefs.getUInt("pm_deepsleep", 900);
-    normal_brightness = prefs.getUChar("pm_norm_bri", 100);  // 0-100 percentage
-    dim_brightness = prefs.getUChar("pm_dim_bri", 25);       // 0-100 percentage
-    
-    prefs.end();
+    enabled = SystemPrefs::getBool(SysPref::PM_ENABLED);
+    dim_timeout_sec = SystemPrefs::getUInt(SysPref::PM_DIM_TIMEOUT);
+    sleep_timeout_sec = SystemPrefs::getUInt(SysPref::PM_SLEEP_TIMEOUT);
+    deep_sleep_timeout_sec = SystemPrefs::getUInt(SysPref::PM_DEEP_SLEEP_TIMEOUT);
+    normal_brightness = SystemPrefs::getUInt(SysPref::PM_NORMAL_BRIGHTNESS);  // 0-100 percentage
+    dim_brightness = SystemPrefs::getUInt(SysPref::PM_DIM_BRIGHTNESS);        // 0-100 percentage
     
     // Validate ranges (0 = disabled is valid)
     if (dim_timeout_sec > 0 && dim_timeout_sec < 10) dim_timeout_sec = 10;
@@ -126,17 +122,13 @@ void PowerManager::loadSettings() {
 }
 
 void PowerManager::saveSettings() {
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, false);  // Read-write
-    
-    prefs.putBool("pm_enabled", enabled);
-    prefs.putUInt("pm_dim_to", dim_timeout_sec);
-    prefs.putUInt("pm_sleep_to", sleep_timeout_sec);
-    prefs.putUInt("pm_deepsleep", deep_sleep_timeout_sec);
-    prefs.putUChar("pm_norm_bri", normal_brightness);
-    prefs.putUChar("pm_dim_bri", dim_brightness);
-    
-    prefs.end();
+    // Settings are live already - SystemPrefs writes the changed keys once edits settle
+    SystemPrefs::setBool(SysPref::PM_ENABLED, enabled);
+    SystemPrefs::setUInt(SysPref::PM_DIM_TIMEOUT, dim_timeout_sec);
+    SystemPrefs::setUInt(SysPref::PM_SLEEP_TIMEOUT, sleep_timeout_sec);
+    SystemPrefs::setUInt(SysPref::PM_DEEP_SLEEP_TIMEOUT, deep_sleep_timeout_sec);
+    SystemPrefs::setUInt(SysPref::PM_NORMAL_BRIGHTNESS, normal_brightness);
+    SystemPrefs::setUInt(SysPref::PM_DIM_BRIGHTNESS, dim_brightness);
     
     Serial.println("\n=== Power Manager Settings Saved ===");
     Serial.printf("Enabled: %s\n", enabled ? "YES" : "NO");
@@ -246,11 +238,9 @@ void PowerManager::enterScreenOff() {
 void PowerManager::enterDeepSleep() {
     Serial.println("PowerManager: Entering DEEP SLEEP due to inactivity");
     
-    // Save clean shutdown flag
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, false);
-    prefs.putBool("clean_shutdown", true);
-    prefs.end();
+    // Save clean shutdown flag (with any pending settings writes)
+    SystemPrefs::setBool(SysPref::CLEAN_SHUTDOWN, true);
+    SettingsStore::flush();
     
     // Power down display (backlight only - see display_driver.cpp for details)
     display_driver->powerDown();
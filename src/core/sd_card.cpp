@@ -0,0 +1,227 @@
+#include "core/sd_card.h"
+#include <SD.h>
+#include <SPI.h>
+#include <esp_heap_caps.h>
+
+// Static member initialization
+uint32_t SDCard::clock_hz = 0;
+BlockCache SDCard::cache;
+SDReader *SDCard::readers[SD_MAX_READERS] = {nullptr};
+
+static const uint32_t REFERENCE_HZ = 4000000;   // Known-good clock (the previous fixed rate)
+static const uint32_t PROBE_HZ[] = {40000000, 26000000, 20000000, 16000000, 10000000, 8000000};
+
+static const uint32_t FNV_OFFSET = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+static bool beginAt(uint32_t hz) {
+    return SD.begin(SD_CS, SPI, hz, "/sd", 5, false) && SD.cardType() != CARD_NONE;
+}
+
+// Hash of the first SD_PROBE_SECTORS raw sectors, with the read rate in KB/s
+static bool readProbeSectors(uint32_t &hash, uint32_t &kb_per_sec) {
+    static uint8_t sector[512];
+    uint32_t start = micros();
+    hash = FNV_OFFSET;
+    for (uint32_t s = 0; s < SD_PROBE_SECTORS; s++) {
+        if (!SD.readRAW(sector, s)) return false;
+        for (size_t i = 0; i < sizeof(sector); i++) {
+            hash = (hash ^ sector[i]) * FNV_PRIME;
+        }
+    }
+    uint32_t us = micros() - start;
+    kb_per_sec = us > 0 ? (uint32_t)((uint64_t)SD_PROBE_SECTORS * 512 * 1000000 / 1024 / us) : 0;
+    return true;
+}
+
+bool SDCard::probeClock() {
+    // Reference read at the known-good clock
+    if (!beginAt(REFERENCE_HZ)) return false;
+    uint32_t reference, rate;
+    if (!readProbeSectors(reference, rate)) {
+        Serial.println("[SDCard] Raw sector read failed - staying at 4 MHz");
+        clock_hz = REFERENCE_HZ;
+        return true;
+    }
+    Serial.printf("[SDCard] 4 MHz: %u KB/s\n", rate);
+
+    // Fastest clock that reads the same data twice
+    for (uint32_t hz : PROBE_HZ) {
+        if (hz > SD_PROBE_MAX_HZ) continue;
+        SD.end();
+        uint32_t h1, h2;
+        if (beginAt(hz) && readProbeSectors(h1, rate) && h1 == reference &&
+            readProbeSectors(h2, rate) && h2 == reference) {
+            Serial.printf("[SDCard] %u MHz: %u KB/s - using it\n", hz / 1000000, rate);
+            clock_hz = hz;
+            return true;
+        }
+        Serial.printf("[SDCard] %u MHz: unreliable\n", hz / 1000000);
+    }
+
+    SD.end();
+    if (!beginAt(REFERENCE_HZ)) return false;
+    clock_hz = REFERENCE_HZ;
+    return true;
+}
+
+bool SDCard::mount() {
+    if (clock_hz != 0) {
+        if (SD.cardType() != CARD_NONE) return true;
+
+        // Card removed - mount again (and re-probe, it may be a different card)
+        Serial.println("[SDCard] Card gone - remounting");
+        SD.end();
+        clock_hz = 0;
+        cache.clear();
+    }
+
+    Serial.println("[SDCard] Initializing SD card...");
+#ifdef HARDWARE_ADVANCE
+    Serial.println("[SDCard] Advance: SPI mode (MOSI=6, MISO=4, CLK=5, CS=0/GND)");
+    // CS is GPIO 0 per Elecrow example, though physically tied to GND
+#else
+    Serial.println("[SDCard] Basic: SPI mode (MOSI=11, MISO=13, CLK=12, CS=10)");
+#endif
+    SPI.begin(SD_CLK, SD_MISO, SD_MOSI, SD_CS);
+    if (!probeClock()) {
+        Serial.println("[SDCard] SD Card mount failed");
+        return false;
+    }
+
+    uint8_t cardType = SD.cardType();
+    Serial.printf("[SDCard] SD Card Type: %s, Size: %lluMB, Clock: %u MHz\n",
+                  cardType == CARD_MMC ? "MMC" :
+                  cardType == CARD_SD ? "SDSC" :
+                  cardType == CARD_SDHC ? "SDHC" : "UNKNOWN",
+                  SD.cardSize() / (1024 * 1024), clock_hz / 1000000);
+
+    if (!cache.isReady()) {
+        cache.attach((uint8_t*)heap_caps_malloc((size_t)SD_CACHE_BLOCKS * SD_BLOCK_SIZE, MALLOC_CAP_SPIRAM));
+        if (!cache.isReady()) {
+            Serial.println("[SDCard] No PSRAM for the block cache - reading directly");
+        }
+    }
+    cache.clear();
+    return true;
+}
+
+File SDCard::openForWrite(const char *path, const char *mode) {
+    invalidate(path);
+    return SD.open(path, mode);
+}
+
+bool SDCard::remove(const char *path) {
+    invalidate(path);
+    return SD.remove(path);
+}
+
+bool SDCard::rename(const char *from, const char *to) {
+    invalidate(from);
+    invalidate(to);
+    return SD.rename(from, to);
+}
+
+void SDCard::invalidate(const char *path) {
+    cache.invalidate(BlockCache::hashPath(path));
+}
+
+bool SDCard::exists(const char *path) {
+    return mount() && SD.exists(path);
+}
+
+File SDCard::openDir(const char *path) {
+    if (!mount()) return File();
+    File dir = SD.open(path);
+    if (dir && !dir.isDirectory()) dir.close();
+    return dir;
+}
+
+void SDCard::addReader(SDReader *reader) {
+    for (int i = 0; i < SD_MAX_READERS; i++) {
+        if (!readers[i]) { readers[i] = reader; return; }
+    }
+}
+
+void SDCard::removeReader(SDReader *reader) {
+    for (int i = 0; i < SD_MAX_READERS; i++) {
+        if (readers[i] == reader) readers[i] = nullptr;
+    }
+}
+
+void SDCard::loop() {
+    if (!cache.isReady()) return;
+
+    // One block per call, readers in turn
+    static int next_reader = 0;
+    for (int n = 0; n < SD_MAX_READERS; n++) {
+        SDReader *r = readers[(next_reader + n) % SD_MAX_READERS];
+        if (!r) continue;
+
+        // A read error is left for the reader to report
+        if (cache.prefetch(r->source, r->path_hash, r->file_size, r->pos) > 0) {
+            next_reader = (next_reader + n + 1) % SD_MAX_READERS;
+            return;
+        }
+    }
+}
+
+bool SDFileSource::readAt(uint32_t offset, uint8_t *buf, size_t len) {
+    if (file.position() != offset && !file.seek(offset)) return false;
+    return file.read(buf, len) == len;
+}
+
+bool SDReader::open(const char *path) {
+    close();
+    if (!SDCard::mount()) return false;
+    source.file = SD.open(path, FILE_READ);
+    if (!source.file) return false;
+
+    open_ = true;
+    path_hash = BlockCache::hashPath(path);
+    file_size = source.file.size();
+    pos = 0;
+    stats = BlockCache::Stats();
+    bytes_read = 0;
+    open_ms = millis();
+    SDCard::addReader(this);
+    return true;
+}
+
+void SDReader::close() {
+    if (!open_) return;
+    SDCard::removeReader(this);
+    source.file.close();
+    open_ = false;
+
+    if (bytes_read >= 64 * 1024) {
+        uint32_t ms = millis() - open_ms;
+        Serial.printf("[SDCard] Read %u KB in %u ms (%u KB/s), %u%% of blocks from cache\n",
+                      bytes_read / 1024, ms, ms > 0 ? bytes_read / ms * 1000 / 1024 : 0,
+                      stats.hits + stats.misses > 0 ? stats.hits * 100 / (stats.hits + stats.misses) : 0);
+    }
+}
+
+bool SDReader::seek(uint32_t new_pos) {
+    if (!open_ || new_pos > file_size) return false;
+    pos = new_pos;
+    return true;
+}
+
+int SDReader::read(uint8_t *buf, size_t len) {
+    if (!open_) return -1;
+
+    int n;
+    if (SDCard::cache.isReady()) {
+        n = SDCard::cache.read(source, path_hash, file_size, pos, buf, len, stats);
+    } else {
+        // No cache - plain file reads
+        if (source.file.position() != pos && !source.file.seek(pos)) return -1;
+        n = source.file.read(buf, len);
+    }
+    if (n > 0) {
+        pos += n;
+        bytes_read += n;
+    }
+    return n;
+}
@@ -0,0 +1,394 @@
+#include "gcode/gcode_analyzer.h"
+#include "gcode/gcode_number.h"
+#include <cmath>
+#include <cstring>
+
+static const float MM_PER_INCH = 25.4f;
+static const float ARC_SEGMENT_RAD = 0.1745f;  // ~10 degrees per thumbnail/extent segment
+
+GCodeAnalyzer::GCodeAnalyzer() : progress_hook(nullptr), progress_ctx(nullptr) {
+    begin();
+}
+
+void GCodeAnalyzer::begin(const GCodeMachineLimits &machine_limits) {
+    limits = machine_limits;
+    analysis.reset();
+    line_len = 0;
+    pos[0] = pos[1] = pos[2] = 0.0f;
+    feed_mm_min = 0.0f;
+    motion = 0;
+    absolute = true;
+    inches = false;
+    pending = false;
+    pending_len = pending_v = pending_entry_v = 0.0f;
+    pending_bytes = 0;
+    memset(grid, 0, sizeof(grid));
+    grid_init = false;
+    grid_x0 = grid_y0 = 0.0f;
+    grid_cell = 1.0f;
+}
+
+void GCodeAnalyzer::feed(const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        analysis.bytes++;
+        if (c == '\n' || c == '\r') {
+            if (line_len > 0) {
+                line[line_len] = '\0';
+                processLine(line);
+                line_len = 0;
+            }
+        } else if (line_len < MAX_LINE - 1) {
+            line[line_len++] = c;
+        }
+    }
+}
+
+void GCodeAnalyzer::finish() {
+    if (line_len > 0) {
+        line[line_len] = '\0';
+        processLine(line);
+        line_len = 0;
+    }
+    flushPending(0.0f);  // Machine stops at the end of the program
+}
+
+void GCodeAnalyzer::processLine(char *s) {
+    analysis.line_count++;
+
+    // Strip comments: (...) and ;... - uppercase the rest in place
+    int out = 0;
+    bool in_paren = false;
+    for (int i = 0; s[i]; i++) {
+        char c = s[i];
+        if (in_paren) {
+            if (c == ')') in_paren = false;
+            continue;
+        }
+        if (c == '(') { in_paren = true; continue; }
+        if (c == ';') break;
+        if (c == ' ' || c == '\t') continue;
+        if (c >= 'a' && c <= 'z') c -= 32;
+        s[out++] = c;
+    }
+    s[out] = '\0';
+    if (out == 0 || s[0] == '$' || s[0] == '%') return;
+
+    // Collect words
+    bool has_axis[3] = {false, false, false};
+    float axis[3] = {0, 0, 0};
+    bool has_i = false, has_j = false, has_r = false, has_p = false;
+    float val_i = 0, val_j = 0, val_r = 0, val_p = 0;
+    bool non_motion_axes = false;   // G10/G28/G30/G92 use axis words without moving
+    bool machine_coords = false;    // G53
+    bool dwell = false;
+    bool arc_plane_xy = true;
+    int new_motion = -2;            // -2 = unchanged
+
+    const char *p = s;
+    while (*p) {
+        char letter = *p++;
+        if (letter < 'A' || letter > 'Z') continue;
+        float v;
+        if (!gcodeReadNumber(p, v)) continue;
+
+        switch (letter) {
+            case 'G': {
+                int g10 = (int)lroundf(v * 10.0f);
+                switch (g10) {
+                    case 0:   new_motion = 0; break;
+                    case 10:  new_motion = 1; break;
+                    case 20:  new_motion = 2; break;
+                    case 30:  new_motion = 3; break;
+                    case 40:  dwell = true; break;
+                    case 170: arc_plane_xy = true; break;
+                    case 180: case 190: arc_plane_xy = false; break;
+                    case 200: inches = true; break;
+                    case 210: inches = false; break;
+                    case 530: machine_coords = true; break;
+                    case 900: absolute = true; break;
+                    case 910: absolute = false; break;
+                    case 382: case 383: case 384: case 385: new_motion = 1; break;  // Probe moves
+                    case 100: case 280: case 300: case 920: non_motion_axes = true; break;
+                    default: break;
+                }
+                break;
+            }
+            case 'X': has_axis[0] = true; axis[0] = v; break;
+            case 'Y': has_axis[1] = true; axis[1] = v; break;
+            case 'Z': has_axis[2] = true; axis[2] = v; break;
+            case 'I': has_i = true; val_i = v; break;
+            case 'J': has_j = true; val_j = v; break;
+            case 'R': has_r = true; val_r = v; break;
+            case 'P': has_p = true; val_p = v; break;
+            case 'F': feed_mm_min = inches ? v * MM_PER_INCH : v; break;
+            default: break;
+        }
+    }
+
+    if (new_motion != -2) motion = new_motion;
+
+    if (dwell && has_p && val_p > 0.0f) {
+        flushPending(0.0f);
+        analysis.est_time_sec += val_p;  // P is seconds in FluidNC
+        return;
+    }
+    if (non_motion_axes) return;
+    if (!has_axis[0] && !has_axis[1] && !has_axis[2]) return;
+    if (motion < 0) return;
+
+    // Work positions are not tracked - G53 moves are treated as absolute in the same frame
+    float scale = inches ? MM_PER_INCH : 1.0f;
+    float target[3];
+    for (int a = 0; a < 3; a++) {
+        if (!has_axis[a]) {
+            target[a] = pos[a];
+        } else if (absolute || machine_coords) {
+            target[a] = axis[a] * scale;
+        } else {
+            target[a] = pos[a] + axis[a] * scale;
+        }
+    }
+
+    if ((motion == 2 || motion == 3) && arc_plane_xy && (has_i || has_j || has_r)) {
+        arcMove(target, motion == 2, has_i || has_j, val_i * scale, val_j * scale, has_r, val_r * scale);
+    } else {
+        // G18/G19 arcs are approximated as straight moves
+        linearMove(target, motion == 0);
+    }
+}
+
+void GCodeAnalyzer::extend(const float p[3]) {
+    if (!analysis.has_motion) {
+        analysis.min_x = analysis.max_x = p[0];
+        analysis.min_y = analysis.max_y = p[1];
+        analysis.min_z = analysis.max_z = p[2];
+        analysis.has_motion = true;
+        return;
+    }
+    if (p[0] < analysis.min_x) analysis.min_x = p[0];
+    if (p[0] > analysis.max_x) analysis.max_x = p[0];
+    if (p[1] < analysis.min_y) analysis.min_y = p[1];
+    if (p[1] > analysis.max_y) analysis.max_y = p[1];
+    if (p[2] < analysis.min_z) analysis.min_z = p[2];
+    if (p[2] > analysis.max_z) analysis.max_z = p[2];
+}
+
+void GCodeAnalyzer::linearMove(const float target[3], bool rapid) {
+    float d[3] = {target[0] - pos[0], target[1] - pos[1], target[2] - pos[2]};
+    float length = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    if (!std::isfinite(length) || length < 1e-6f) return;
+
+    float dir[3] = {d[0] / length, d[1] / length, d[2] / length};
+    if (!analysis.has_motion) extend(pos);
+    extend(target);
+    if (!rapid) gridLine(pos[0], pos[1], target[0], target[1]);
+
+    addMove(target, rapid, dir, dir, length);
+}
+
+void GCodeAnalyzer::arcMove(const float target[3], bool clockwise, bool has_ij, float i, float j, bool has_r, float r) {
+    float dx = target[0] - pos[0];
+    float dy = target[1] - pos[1];
+
+    if (!has_ij && has_r) {
+        // Radius format - same center construction as Grbl
+        float h = 4.0f * r * r - dx * dx - dy * dy;
+        float chord = sqrtf(dx * dx + dy * dy);
+        if (h < 0.0f || chord < 1e-6f) {
+            linearMove(target, false);
+            return;
+        }
+        h = -sqrtf(h) / chord;
+        if (!clockwise) h = -h;
+        if (r < 0.0f) h = -h;
+        i = 0.5f * (dx - dy * h);
+        j = 0.5f * (dy + dx * h);
+    }
+
+    float cx = pos[0] + i;
+    float cy = pos[1] + j;
+    float radius = sqrtf(i * i + j * j);
+    if (radius < 1e-6f) {
+        linearMove(target, false);
+        return;
+    }
+
+    float a0 = atan2f(pos[1] - cy, pos[0] - cx);
+    float a1 = atan2f(target[1] - cy, target[0] - cx);
+    float sweep = clockwise ? (a0 - a1) : (a1 - a0);
+    if (sweep <= 1e-6f) sweep += 2.0f * (float)M_PI;  // Full circle when start == end
+
+    float dz = target[2] - pos[2];
+    float arc_xy = radius * sweep;
+    float length = sqrtf(arc_xy * arc_xy + dz * dz);
+
+    // Tangent directions at start and end
+    float sgn = clockwise ? -1.0f : 1.0f;
+    float a_end = a0 + sgn * sweep;
+    float dir_start[3] = {-sinf(a0) * sgn, cosf(a0) * sgn, 0.0f};
+    float dir_end[3] = {-sinf(a_end) * sgn, cosf(a_end) * sgn, 0.0f};
+    if (length > 1e-6f) {
+        float kxy = arc_xy / length;
+        float kz = dz / length;
+        for (int a = 0; a < 2; a++) { dir_start[a] *= kxy; dir_end[a] *= kxy; }
+        dir_start[2] = dir_end[2] = kz;
+    }
+
+    // Segment for extents and thumbnail
+    int segments = (int)ceilf(sweep / ARC_SEGMENT_RAD);
+    if (segments < 1) segments = 1;
+    if (!analysis.has_motion) extend(pos);
+    float prev[3] = {pos[0], pos[1], pos[2]};
+    for (int s = 1; s <= segments; s++) {
+        float t = (float)s / segments;
+        float a = a0 + sgn * sweep * t;
+        float pt[3] = {cx + radius * cosf(a), cy + radius * sinf(a), pos[2] + dz * t};
+        if (s == segments) { pt[0] = target[0]; pt[1] = target[1]; pt[2] = target[2]; }
+        extend(pt);
+        gridLine(prev[0], prev[1], pt[0], pt[1]);
+        prev[0] = pt[0]; prev[1] = pt[1]; prev[2] = pt[2];
+    }
+
+    addMove(target, false, dir_start, dir_end, length);
+}
+
+void GCodeAnalyzer::addMove(const float target[3], bool rapid, const float dir_start[3], const float dir_end[3], float length) {
+    float rate = rapid ? limits.rapid_rate_mm_min : (feed_mm_min > 0.0f ? feed_mm_min : limits.rapid_rate_mm_min);
+    if (!rapid && rate > limits.rapid_rate_mm_min) rate = limits.rapid_rate_mm_min;
+    float v = rate / 60.0f;
+
+    // Junction speed with the previous move: full speed when collinear, zero at 90 degrees or more
+    float v_junction = 0.0f;
+    if (pending) {
+        float cos_theta = pending_dir[0] * dir_start[0] + pending_dir[1] * dir_start[1] + pending_dir[2] * dir_start[2];
+        if (cos_theta > 0.0f) {
+            float vmax = pending_v < v ? pending_v : v;
+            v_junction = vmax * cos_theta * limits.junction_factor;
+        }
+    }
+    flushPending(v_junction);
+
+    if (rapid) {
+        analysis.rapid_length_mm += length;
+    } else {
+        analysis.cut_length_mm += length;
+    }
+    analysis.move_count++;
+
+    pending = true;
+    pending_len = length;
+    pending_v = v;
+    pending_entry_v = v_junction;
+    pending_bytes = analysis.bytes;
+    for (int a = 0; a < 3; a++) {
+        pending_dir[a] = dir_end[a];
+        pos[a] = target[a];
+    }
+}
+
+void GCodeAnalyzer::flushPending(float exit_v) {
+    if (!pending) return;
+    pending = false;
+
+    // Exit speed can't exceed what the move can reach from its entry speed
+    float reachable = sqrtf(pending_entry_v * pending_entry_v + 2.0f * limits.accel_mm_s2 * pending_len);
+    if (exit_v > reachable) exit_v = reachable;
+
+    analysis.est_time_sec += trapezoidTime(pending_len, pending_entry_v, pending_v, exit_v);
+    if (progress_hook) progress_hook(pending_bytes, analysis.est_time_sec, progress_ctx);
+}
+
+float GCodeAnalyzer::trapezoidTime(float len, float v_in, float v, float v_out) const {
+    float a = limits.accel_mm_s2;
+    if (v <= 0.0f) return 0.0f;
+    if (a <= 0.0f) return len / v;
+    if (v_in > v) v_in = v;
+    if (v_out > v) v_out = v;
+
+    float d_acc = (v * v - v_in * v_in) / (2.0f * a);
+    float d_dec = (v * v - v_out * v_out) / (2.0f * a);
+    if (d_acc + d_dec <= len) {
+        return (v - v_in) / a + (v - v_out) / a + (len - d_acc - d_dec) / v;
+    }
+
+    // Triangle profile - never reaches programmed feed
+    float vp = sqrtf((2.0f * a * len + v_in * v_in + v_out * v_out) * 0.5f);
+    float t = 0.0f;
+    if (vp > v_in) t += (vp - v_in) / a;
+    if (vp > v_out) t += (vp - v_out) / a;
+    if (t <= 0.0f) {
+        float v_avg = 0.5f * (v_in + v_out);
+        t = v_avg > 0.0f ? len / v_avg : 0.0f;
+    }
+    return t;
+}
+
+void GCodeAnalyzer::getThumbnail(GCodeThumbnail &out) const {
+    out.x0 = grid_x0;
+    out.y0 = grid_y0;
+    out.cell = grid_cell;
+    memcpy(out.bits, grid, sizeof(out.bits));
+}
+
+void GCodeAnalyzer::gridEnsure(float x, float y) {
+    if (!grid_init) {
+        grid_cell = 0.1f;
+        grid_x0 = x - (GRID / 2) * grid_cell;
+        grid_y0 = y - (GRID / 2) * grid_cell;
+        grid_init = true;
+    }
+
+    // Double the cell size until the point fits (bounded for absurd coordinates)
+    for (int guard = 0; guard < 48; guard++) {
+        float span = GRID * grid_cell;
+        bool left = x < grid_x0, right = x >= grid_x0 + span;
+        bool below = y < grid_y0, above = y >= grid_y0 + span;
+        if (!left && !right && !below && !above) return;
+        gridGrow(left ? -1 : 1, below ? -1 : 1);
+    }
+}
+
+void GCodeAnalyzer::gridGrow(int dir_x, int dir_y) {
+    // Old grid shrinks into one quadrant of the new one
+    int off_x = dir_x < 0 ? GRID / 2 : 0;
+    int off_y = dir_y < 0 ? GRID / 2 : 0;
+
+    uint8_t old[GRID][GRID / 8];
+    memcpy(old, grid, sizeof(grid));
+    memset(grid, 0, sizeof(grid));
+    for (int gy = 0; gy < GRID; gy++) {
+        for (int gx = 0; gx < GRID; gx++) {
+            if ((old[gy][gx >> 3] >> (gx & 7)) & 1) {
+                int nx = off_x + gx / 2;
+                int ny = off_y + gy / 2;
+                grid[ny][nx >> 3] |= (uint8_t)(1 << (nx & 7));
+            }
+        }
+    }
+
+    float span = GRID * grid_cell;
+    if (dir_x < 0) grid_x0 -= span;
+    if (dir_y < 0) grid_y0 -= span;
+    grid_cell *= 2.0f;
+}
+
+void GCodeAnalyzer::gridLine(float x0, float y0, float x1, float y1) {
+    if (!std::isfinite(x0) || !std::isfinite(y0) || !std::isfinite(x1) || !std::isfinite(y1)) return;
+    gridEnsure(x0, y0);
+    gridEnsure(x1, y1);
+
+    float fx0 = (x0 - grid_x0) / grid_cell, fy0 = (y0 - grid_y0) / grid_cell;
+    float fx1 = (x1 - grid_x0) / grid_cell, fy1 = (y1 - grid_y0) / grid_cell;
+    float dx = fx1 - fx0, dy = fy1 - fy0;
+    int steps = (int)ceilf(fmaxf(fabsf(dx), fabsf(dy)));
+    if (steps < 1) steps = 1;
+
+    for (int s = 0; s <= steps; s++) {
+        float t = (float)s / steps;
+        int gx = (int)(fx0 + dx * t);
+        int gy = (int)(fy0 + dy * t);
+        if (gx < 0 || gx >= GRID || gy < 0 || gy >= GRID) continue;
+        grid[gy][gx >> 3] |= (uint8_t)(1 << (gx & 7));
+    }
+}
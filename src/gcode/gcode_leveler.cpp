@@ -0,0 +1,202 @@
+#include "gcode/gcode_leveler.h"
+#include "gcode/height_map.h"
+#include "gcode/gcode_number.h"
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+static const float MM_PER_INCH = 25.4f;
+static const int MAX_SEGMENTS = 10000;     // Per line - a 2 m move at 0.2 mm
+
+void GCodeLeveler::begin(const HeightMap *height_map, float segment) {
+    map = height_map;
+    segment_mm = segment > 0.01f ? segment : 0.01f;
+    absolute = true;
+    inches = false;
+    inverse_time = false;
+    motion = 0;
+    for (int a = 0; a < 3; a++) {
+        pos[a] = emitted[a] = 0.0f;
+        known[a] = false;
+    }
+    passthrough = true;
+    pass_pending = false;
+    seg_count = seg_index = 0;
+    compensated_moves = 0;
+}
+
+float GCodeLeveler::offsetAt(float x, float y) const {
+    if (inches) return map->zAt(x * MM_PER_INCH, y * MM_PER_INCH) / MM_PER_INCH;
+    return map->zAt(x, y);
+}
+
+float GCodeLeveler::quantize(float v) const {
+    float scale = inches ? 10000.0f : 1000.0f;
+    return roundf(v * scale) / scale;
+}
+
+bool GCodeLeveler::setLine(const char *line) {
+    size_t len = strlen(line);
+    if (len >= sizeof(pass)) return false;
+    memcpy(pass, line, len + 1);
+    passthrough = true;
+    pass_pending = true;
+    seg_count = seg_index = 0;
+
+    // Strip comments and spaces, uppercase
+    char s[MAX_LINE];
+    int n = 0;
+    bool in_paren = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = line[i];
+        if (in_paren) {
+            if (c == ')') in_paren = false;
+            continue;
+        }
+        if (c == '(') { in_paren = true; continue; }
+        if (c == ';') break;
+        if (c == ' ' || c == '\t' || c == '\r') continue;
+        if (c >= 'a' && c <= 'z') c -= 32;
+        s[n++] = c;
+    }
+    s[n] = '\0';
+    if (n == 0 || s[0] == '$' || s[0] == '%') return true;
+
+    // Collect words; everything but X/Y/Z goes into the prefix
+    bool has_axis[3] = {false, false, false};
+    float axis[3] = {0, 0, 0};
+    bool untracked = false;         // Coordinate system or position changes we don't follow
+    bool other_axes = false;        // A/B/C words - not split
+    int new_motion = -2;
+    int prefix_len = 0;
+    prefix[0] = '\0';
+
+    const char *p = s;
+    while (*p) {
+        const char *word = p;
+        char letter = *p++;
+        float v;
+        if (letter < 'A' || letter > 'Z' || !gcodeReadNumber(p, v)) {
+            // Expressions, parameters, flow control - nothing we can follow
+            for (int a = 0; a < 3; a++) known[a] = false;
+            return true;
+        }
+
+        int axis_index = (letter == 'X') ? 0 : (letter == 'Y') ? 1 : (letter == 'Z') ? 2 : -1;
+        if (axis_index >= 0) {
+            has_axis[axis_index] = true;
+            axis[axis_index] = v;
+            continue;
+        }
+
+        if (letter == 'G') {
+            int g10 = (int)lroundf(v * 10.0f);
+            switch (g10) {
+                case 0: case 10: case 20: case 30: new_motion = g10 / 10; break;
+                case 382: case 383: case 384: case 385: new_motion = -1; untracked = true; break;
+                case 800: new_motion = -1; break;
+                case 900: absolute = true; break;
+                case 910: absolute = false; break;
+                case 200: inches = true; break;
+                case 210: inches = false; break;
+                case 930: inverse_time = true; break;
+                case 940: inverse_time = false; break;
+                case 100: case 280: case 300: case 431: case 490: case 530: case 920: case 921:
+                case 540: case 550: case 560: case 570: case 580: case 590:
+                    untracked = true;
+                    break;
+                default: break;
+            }
+        } else if (letter == 'A' || letter == 'B' || letter == 'C') {
+            other_axes = true;
+        }
+
+        int word_len = (int)(p - word);
+        if (prefix_len + word_len + 2 >= (int)sizeof(prefix)) return false;
+        if (prefix_len > 0) prefix[prefix_len++] = ' ';
+        memcpy(prefix + prefix_len, word, word_len);
+        prefix_len += word_len;
+        prefix[prefix_len] = '\0';
+    }
+    if (new_motion != -2) motion = new_motion;
+
+    bool any_axis = has_axis[0] || has_axis[1] || has_axis[2];
+    if (untracked) {
+        // G53 moves and G28/G30 go elsewhere, G92/G10/G43.1/WCS change what the numbers mean
+        for (int a = 0; a < 3; a++) known[a] = false;
+        return true;
+    }
+    if (!any_axis) return true;
+
+    float target[3];
+    for (int a = 0; a < 3; a++) {
+        if (!has_axis[a]) {
+            target[a] = pos[a];
+        } else if (absolute) {
+            target[a] = axis[a];
+        } else {
+            target[a] = pos[a] + axis[a];
+        }
+    }
+
+    bool all_known = known[0] && known[1] && known[2];
+    if (motion < 0 || !all_known) {
+        // Pass through - the machine ends up where the line says
+        for (int a = 0; a < 3; a++) {
+            if (has_axis[a] && absolute) known[a] = true;
+            pos[a] = target[a];
+            if (has_axis[a]) emitted[a] = absolute ? axis[a] : emitted[a] + axis[a];
+        }
+        return true;
+    }
+
+    // Room for the three axis words after the prefix
+    if (prefix_len + 3 * 16 >= MAX_LINE) return false;
+
+    for (int a = 0; a < 3; a++) {
+        from[a] = pos[a];
+        to[a] = target[a];
+        pos[a] = target[a];
+    }
+    seg_count = 1;
+    if (motion == 1 && !inverse_time && !other_axes) {
+        float scale = inches ? MM_PER_INCH : 1.0f;
+        float dist = hypotf(to[0] - from[0], to[1] - from[1]) * scale;
+        seg_count = (int)ceilf(dist / segment_mm);
+        if (seg_count < 1) seg_count = 1;
+        if (seg_count > MAX_SEGMENTS) seg_count = MAX_SEGMENTS;
+    }
+    passthrough = false;
+    compensated_moves++;
+    return true;
+}
+
+bool GCodeLeveler::next(char *out, size_t cap) {
+    if (passthrough) {
+        if (!pass_pending) return false;
+        pass_pending = false;
+        snprintf(out, cap, "%s", pass);
+        return true;
+    }
+    if (seg_index >= seg_count) return false;
+    seg_index++;
+
+    float p[3];
+    float t = (float)seg_index / seg_count;
+    for (int a = 0; a < 3; a++) {
+        p[a] = (seg_index == seg_count) ? to[a] : from[a] + (to[a] - from[a]) * t;
+    }
+    p[2] += offsetAt(p[0], p[1]);
+
+    float v[3];
+    for (int a = 0; a < 3; a++) {
+        p[a] = quantize(p[a]);
+        v[a] = absolute ? p[a] : p[a] - emitted[a];
+        emitted[a] = p[a];
+    }
+
+    const char *fmt = inches ? "%s%sX%.4f Y%.4f Z%.4f" : "%s%sX%.3f Y%.3f Z%.3f";
+    bool first = seg_index == 1;
+    snprintf(out, cap, fmt, first ? prefix : "", first && prefix[0] ? " " : "", v[0], v[1], v[2]);
+    return true;
+}
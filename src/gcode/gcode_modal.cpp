@@ -0,0 +1,99 @@
+#include "gcode/gcode_modal.h"
+#include "gcode/gcode_number.h"
+#include <cmath>
+
+static const char *MOTION_NAMES[] = {"G0", "G1", "G2", "G3", "G38.2", "G38.3", "G38.4", "G38.5", "G80"};
+static const char *WCS_NAMES[] = {"G54", "G55", "G56", "G57", "G58", "G59"};
+static const char *PLANE_NAMES[] = {"G17", "G18", "G19"};
+static const char *UNITS_NAMES[] = {"G20", "G21"};
+static const char *DISTANCE_NAMES[] = {"G90", "G91"};
+static const char *FEED_MODE_NAMES[] = {"G93", "G94", "G95"};
+static const char *SPINDLE_NAMES[] = {"M3", "M4", "M5"};
+static const char *COOLANT_NAMES[] = {"M9", "M7", "M8", "M7 M8"};
+
+GCodeModal::GCodeModal()
+    : motion(ModalMotion::G0), wcs(0), plane(ModalPlane::G17), units(ModalUnits::G21),
+      distance(ModalDistance::G90), feed_mode(ModalFeedMode::G94), spindle(ModalSpindle::M5),
+      coolant(0), tool(0), feed(0.0f), speed(0.0f) {}
+
+bool GCodeModal::parse(const char *report) {
+    const char *p = report;
+    if (p[0] == '[' && p[1] == 'G' && p[2] == 'C' && p[3] == ':') p += 4;
+
+    uint8_t new_coolant = 0;
+    bool any = false;
+    while (*p && *p != ']') {
+        char letter = *p++;
+        if (letter == ' ') continue;
+        float v;
+        if (!gcodeReadNumber(p, v)) {
+            // Skip a word we can't read
+            while (*p && *p != ' ' && *p != ']') p++;
+            continue;
+        }
+        any = true;
+
+        // Codes in tenths so G38.2 and G38 can't be confused
+        int code = (int)lroundf(v * 10.0f);
+        switch (letter) {
+            case 'G':
+                switch (code) {
+                    case 0:   motion = ModalMotion::G0; break;
+                    case 10:  motion = ModalMotion::G1; break;
+                    case 20:  motion = ModalMotion::G2; break;
+                    case 30:  motion = ModalMotion::G3; break;
+                    case 382: motion = ModalMotion::G38_2; break;
+                    case 383: motion = ModalMotion::G38_3; break;
+                    case 384: motion = ModalMotion::G38_4; break;
+                    case 385: motion = ModalMotion::G38_5; break;
+                    case 800: motion = ModalMotion::G80; break;
+                    case 170: plane = ModalPlane::G17; break;
+                    case 180: plane = ModalPlane::G18; break;
+                    case 190: plane = ModalPlane::G19; break;
+                    case 200: units = ModalUnits::G20; break;
+                    case 210: units = ModalUnits::G21; break;
+                    case 900: distance = ModalDistance::G90; break;
+                    case 910: distance = ModalDistance::G91; break;
+                    case 930: feed_mode = ModalFeedMode::G93; break;
+                    case 940: feed_mode = ModalFeedMode::G94; break;
+                    case 950: feed_mode = ModalFeedMode::G95; break;
+                    case 540: case 550: case 560: case 570: case 580: case 590:
+                        wcs = (uint8_t)(code / 10 - 54);
+                        break;
+                    default: break;    // G40, G49, G91.1, ... - not shown
+                }
+                break;
+            case 'M':
+                switch (code) {
+                    case 30: spindle = ModalSpindle::M3; break;
+                    case 40: spindle = ModalSpindle::M4; break;
+                    case 50: spindle = ModalSpindle::M5; break;
+                    case 70: new_coolant |= COOLANT_MIST; break;
+                    case 80: new_coolant |= COOLANT_FLOOD; break;
+                    default: break;    // M9 (no bits), M0-M2, M56, ...
+                }
+                break;
+            case 'T': tool = (uint16_t)(v < 0.0f ? 0 : v); break;
+            case 'F': feed = v; break;
+            case 'S': speed = v; break;
+            default: break;
+        }
+    }
+    if (any) coolant = new_coolant;
+    return any;
+}
+
+const char *GCodeModal::motionName() const { return MOTION_NAMES[(int)motion]; }
+const char *GCodeModal::wcsName() const { return WCS_NAMES[wcs]; }
+const char *GCodeModal::planeName() const { return PLANE_NAMES[(int)plane]; }
+const char *GCodeModal::unitsName() const { return UNITS_NAMES[(int)units]; }
+const char *GCodeModal::distanceName() const { return DISTANCE_NAMES[(int)distance]; }
+const char *GCodeModal::feedModeName() const { return FEED_MODE_NAMES[(int)feed_mode]; }
+const char *GCodeModal::spindleName() const { return SPINDLE_NAMES[(int)spindle]; }
+const char *GCodeModal::coolantName() const { return COOLANT_NAMES[coolant & 0x03]; }
+
+bool GCodeModal::operator==(const GCodeModal &o) const {
+    return motion == o.motion && wcs == o.wcs && plane == o.plane && units == o.units &&
+           distance == o.distance && feed_mode == o.feed_mode && spindle == o.spindle &&
+           coolant == o.coolant && tool == o.tool && feed == o.feed && speed == o.speed;
+}
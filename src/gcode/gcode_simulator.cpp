@@ -0,0 +1,477 @@
+#include "gcode/gcode_simulator.h"
+#include "gcode/gcode_number.h"
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstdarg>
+
+static const float MM_PER_INCH = 25.4f;
+static const float ENVELOPE_EPS = 0.001f;    // Rounding slack at the envelope edge (mm)
+static const char AXIS_NAMES[3] = {'X', 'Y', 'Z'};
+
+// Arc plane axes per G17/G18/G19: first, second and linear axis (same order as Grbl)
+static const int PLANE_AXES[3][3] = {{0, 1, 2}, {2, 0, 1}, {1, 2, 0}};
+
+// Non-modal commands (one per line)
+enum NonModal { NM_NONE, NM_DWELL, NM_G10, NM_G28, NM_G28_1, NM_G30, NM_G30_1, NM_G92, NM_G92_1, NM_G43_1, NM_G49 };
+
+void GCodeSimSetup::reset() {
+    memset(wcs, 0, sizeof(wcs));
+    for (int a = 0; a < 3; a++) {
+        g28[a] = g30[a] = g92[a] = 0.0f;
+        start[a] = 0.0f;
+        has_envelope[a] = false;
+        min[a] = max[a] = 0.0f;
+    }
+    tlo = 0.0f;
+    active_wcs = 0;
+}
+
+void GCodeSimReport::reset() {
+    memset(counts, 0, sizeof(counts));
+    memset(issues, 0, sizeof(issues));
+    has_motion = false;
+    for (int a = 0; a < 3; a++) min[a] = max[a] = 0.0f;
+    line_count = move_count = bytes = 0;
+}
+
+uint32_t GCodeSimReport::total() const {
+    uint32_t n = 0;
+    for (int k = 0; k < SIM_KIND_COUNT; k++) n += counts[k];
+    return n;
+}
+
+GCodeSimulator::GCodeSimulator() {
+    begin(GCodeSimSetup());
+}
+
+void GCodeSimulator::begin(const GCodeSimSetup &machine) {
+    setup = machine;
+    if (setup.active_wcs < 0 || setup.active_wcs > 5) setup.active_wcs = 0;
+    result.reset();
+    line_len = 0;
+    line_overflow = false;
+    line_started = false;
+    line_number = 1;
+    for (int a = 0; a < 3; a++) pos[a] = setup.start[a];
+    motion = 0;
+    plane = 0;
+    absolute = true;
+    inches = false;
+    inverse_time = false;
+    feed_set = false;
+    spindle_on = false;
+    spindle_speed = 0.0f;
+}
+
+void GCodeSimulator::feed(const char *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = data[i];
+        result.bytes++;
+        if (c == '\n' || c == '\r') {
+            if (line_len > 0) {
+                line[line_len] = '\0';
+                processLine(line);
+                line_len = 0;
+            }
+            line_overflow = false;
+            if (c == '\n') {
+                line_number++;
+                line_started = false;
+            }
+        } else {
+            line_started = true;
+            if (line_len < MAX_LINE - 1) {
+                line[line_len++] = c;
+            } else {
+                line_overflow = true;
+            }
+        }
+    }
+}
+
+void GCodeSimulator::finish() {
+    if (line_len > 0) {
+        line[line_len] = '\0';
+        processLine(line);
+        line_len = 0;
+    }
+    result.line_count = line_started ? line_number : line_number - 1;
+}
+
+void GCodeSimulator::flag(int kind, const char *fmt, ...) {
+    int n = result.stored(kind);
+    result.counts[kind]++;
+    if (n >= GCodeSimReport::ISSUES_PER_KIND) return;
+
+    GCodeSimIssue &issue = result.issues[kind][n];
+    issue.line = line_number;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(issue.text, sizeof(issue.text), fmt, args);
+    va_end(args);
+}
+
+float GCodeSimulator::offset(int axis) const {
+    float o = setup.wcs[setup.active_wcs][axis] + setup.g92[axis];
+    if (axis == 2) o += setup.tlo;
+    return o;
+}
+
+void GCodeSimulator::processLine(char *s) {
+    if (line_overflow) flag(SIM_UNSUPPORTED, "Line longer than %d characters", MAX_LINE - 1);
+
+    // Strip comments: (...) and ;... - uppercase the rest in place
+    int out = 0;
+    bool in_paren = false;
+    for (int i = 0; s[i]; i++) {
+        char c = s[i];
+        if (in_paren) {
+            if (c == ')') in_paren = false;
+            continue;
+        }
+        if (c == '(') { in_paren = true; continue; }
+        if (c == ';') break;
+        if (c == ' ' || c == '\t') continue;
+        if (c >= 'a' && c <= 'z') c -= 32;
+        s[out++] = c;
+    }
+    s[out] = '\0';
+    if (out == 0 || s[0] == '$' || s[0] == '%') return;
+
+    // Collect words - units and modes are applied after the whole line is read
+    bool has_axis[3] = {false, false, false};
+    float axis[3] = {0, 0, 0};
+    bool has_ijk[3] = {false, false, false};
+    float ijk[3] = {0, 0, 0};
+    bool has_r = false, has_p = false, has_l = false, has_f = false, has_s = false;
+    float val_r = 0, val_p = 0, val_l = 0, val_f = 0, val_s = 0;
+    int new_motion = -2;            // -2 = unchanged
+    int new_plane = -1, new_wcs = -1, new_units = -1, new_distance = -1, new_feed_mode = -1;
+    int non_modal = NM_NONE;
+    bool machine_coords = false;    // G53
+    int spindle = -1;               // 1 = M3/M4, 0 = M5
+    bool program_end = false;
+
+    const char *p = s;
+    while (*p) {
+        char letter = *p++;
+        if (letter == '#' || letter == '[' || letter == 'O') {
+            flag(SIM_UNSUPPORTED, "%s not simulated", letter == 'O' ? "Flow control" : "Expression");
+            return;
+        }
+        if (letter < 'A' || letter > 'Z') {
+            flag(SIM_UNSUPPORTED, "Unexpected '%c'", letter);
+            return;
+        }
+        float v;
+        if (!gcodeReadNumber(p, v)) {
+            flag(SIM_UNSUPPORTED, "%c without a number", letter);
+            return;
+        }
+
+        switch (letter) {
+            case 'G': {
+                int g10 = (int)lroundf(v * 10.0f);
+                switch (g10) {
+                    case 0:   new_motion = 0; break;
+                    case 10:  new_motion = 1; break;
+                    case 20:  new_motion = 2; break;
+                    case 30:  new_motion = 3; break;
+                    case 382: case 383: case 384: case 385: new_motion = 4; break;
+                    case 800: new_motion = -1; break;
+                    case 40:  non_modal = NM_DWELL; break;
+                    case 100: non_modal = NM_G10; break;
+                    case 280: non_modal = NM_G28; break;
+                    case 281: non_modal = NM_G28_1; break;
+                    case 300: non_modal = NM_G30; break;
+                    case 301: non_modal = NM_G30_1; break;
+                    case 920: non_modal = NM_G92; break;
+                    case 921: non_modal = NM_G92_1; break;
+                    case 431: non_modal = NM_G43_1; break;
+                    case 490: non_modal = NM_G49; break;
+                    case 170: new_plane = 0; break;
+                    case 180: new_plane = 1; break;
+                    case 190: new_plane = 2; break;
+                    case 200: new_units = 1; break;
+                    case 210: new_units = 0; break;
+                    case 530: machine_coords = true; break;
+                    case 540: case 550: case 560: case 570: case 580: case 590: new_wcs = (g10 - 540) / 10; break;
+                    case 900: new_distance = 1; break;
+                    case 910: new_distance = 0; break;
+                    case 930: new_feed_mode = 1; break;
+                    case 940: new_feed_mode = 0; break;
+                    case 400: case 610: case 911: break;   // Accepted, nothing to simulate
+                    default:
+                        flag(SIM_UNSUPPORTED, "G%g not supported", v);
+                        break;
+                }
+                break;
+            }
+            case 'M': {
+                int m = (int)lroundf(v);
+                switch (m) {
+                    case 2: case 30: program_end = true; break;
+                    case 3: case 4:  spindle = 1; break;
+                    case 5:          spindle = 0; break;
+                    case 0: case 1: case 6: case 7: case 8: case 9: case 56: case 61:
+                    case 62: case 63: case 64: case 65: case 67: case 68:
+                        break;
+                    default:
+                        flag(SIM_UNSUPPORTED, "M%d not supported", m);
+                        break;
+                }
+                break;
+            }
+            case 'X': has_axis[0] = true; axis[0] = v; break;
+            case 'Y': has_axis[1] = true; axis[1] = v; break;
+            case 'Z': has_axis[2] = true; axis[2] = v; break;
+            case 'I': has_ijk[0] = true; ijk[0] = v; break;
+            case 'J': has_ijk[1] = true; ijk[1] = v; break;
+            case 'K': has_ijk[2] = true; ijk[2] = v; break;
+            case 'R': has_r = true; val_r = v; break;
+            case 'P': has_p = true; val_p = v; break;
+            case 'L': has_l = true; val_l = v; break;
+            case 'F': has_f = true; val_f = v; break;
+            case 'S': has_s = true; val_s = v; break;
+            case 'A': case 'B': case 'C':   // Rotary axes are not tracked
+            case 'N': case 'T': case 'E': case 'Q':
+                break;
+            default:
+                flag(SIM_UNSUPPORTED, "Word %c not supported", letter);
+                break;
+        }
+    }
+
+    // Modal state in RS274 execution order: feed mode, feed, spindle, units, plane,
+    // distance, coordinate system
+    if (new_feed_mode >= 0) inverse_time = new_feed_mode == 1;
+    if (has_f && !inverse_time) feed_set = val_f > 0.0f;
+    if (has_s) spindle_speed = val_s;
+    if (spindle >= 0) spindle_on = spindle == 1;
+    if (new_units >= 0) inches = new_units == 1;
+    if (new_plane >= 0) plane = new_plane;
+    if (new_distance >= 0) absolute = new_distance == 1;
+    if (new_wcs >= 0) setup.active_wcs = new_wcs;
+    if (new_motion != -2) motion = new_motion;
+
+    float scale = inches ? MM_PER_INCH : 1.0f;
+    for (int a = 0; a < 3; a++) {
+        axis[a] *= scale;
+        ijk[a] *= scale;
+    }
+    val_r *= scale;
+
+    switch (non_modal) {
+        case NM_G10: {
+            int l = (int)lroundf(val_l);
+            int index = has_p ? (int)lroundf(val_p) : 0;
+            if (!has_l || (l != 2 && l != 20)) {
+                flag(SIM_UNSUPPORTED, "G10 L%d not supported", l);
+            } else if (index < 0 || index > 6) {
+                flag(SIM_UNSUPPORTED, "G10 P%d out of range", index);
+            } else {
+                int wcs = index == 0 ? setup.active_wcs : index - 1;
+                for (int a = 0; a < 3; a++) {
+                    if (!has_axis[a]) continue;
+                    if (l == 2) {
+                        setup.wcs[wcs][a] = axis[a];
+                    } else {
+                        // L20: current position becomes the given work position
+                        setup.wcs[wcs][a] = pos[a] - setup.g92[a] - (a == 2 ? setup.tlo : 0.0f) - axis[a];
+                    }
+                }
+            }
+            break;
+        }
+        case NM_G28: case NM_G30: {
+            const float *stored = non_modal == NM_G28 ? setup.g28 : setup.g30;
+            float target[3];
+            bool any = has_axis[0] || has_axis[1] || has_axis[2];
+            if (any) {
+                // Intermediate point in work coordinates, then only those axes go to the stored position
+                for (int a = 0; a < 3; a++) {
+                    if (!has_axis[a]) target[a] = pos[a];
+                    else target[a] = absolute ? axis[a] + offset(a) : pos[a] + axis[a];
+                }
+                linearMove(target);
+            }
+            for (int a = 0; a < 3; a++) target[a] = (!any || has_axis[a]) ? stored[a] : pos[a];
+            linearMove(target);
+            break;
+        }
+        case NM_G28_1:
+            for (int a = 0; a < 3; a++) setup.g28[a] = pos[a];
+            break;
+        case NM_G30_1:
+            for (int a = 0; a < 3; a++) setup.g30[a] = pos[a];
+            break;
+        case NM_G92:
+            for (int a = 0; a < 3; a++) {
+                if (has_axis[a]) {
+                    setup.g92[a] = pos[a] - setup.wcs[setup.active_wcs][a] - (a == 2 ? setup.tlo : 0.0f) - axis[a];
+                }
+            }
+            break;
+        case NM_G92_1:
+            for (int a = 0; a < 3; a++) setup.g92[a] = 0.0f;
+            break;
+        case NM_G43_1:
+            if (has_axis[2]) setup.tlo = axis[2];
+            break;
+        case NM_G49:
+            setup.tlo = 0.0f;
+            break;
+        default:
+            break;
+    }
+
+    // Axis words belong to the non-modal command on those lines
+    bool axis_command = non_modal == NM_NONE || non_modal == NM_DWELL;
+    if (axis_command && (has_axis[0] || has_axis[1] || has_axis[2]) && motion >= 0) {
+        float target[3];
+        for (int a = 0; a < 3; a++) {
+            if (!has_axis[a]) target[a] = pos[a];
+            else if (machine_coords) target[a] = axis[a];
+            else if (absolute) target[a] = axis[a] + offset(a);
+            else target[a] = pos[a] + axis[a];
+        }
+
+        if (motion != 0) {
+            bool feed_ok = inverse_time ? has_f && val_f > 0.0f : feed_set;
+            if (!feed_ok) {
+                flag(SIM_NO_FEED, motion == 4 ? "Probe without feed rate" : "G%d without feed rate", motion);
+            }
+        }
+        if (motion >= 1 && motion <= 3 && (!spindle_on || spindle_speed <= 0.0f)) {
+            flag(SIM_NO_SPINDLE, spindle_on ? "G%d at S0" : "G%d with spindle off", motion);
+        }
+
+        if (motion == 2 || motion == 3) {
+            arcMove(target, motion == 2, has_r, val_r, has_ijk, ijk);
+        } else {
+            linearMove(target);
+        }
+    }
+
+    if (program_end) programEnd();
+}
+
+bool GCodeSimulator::checkPoint(const float p[3]) {
+    if (!result.has_motion) {
+        for (int a = 0; a < 3; a++) result.min[a] = result.max[a] = p[a];
+        result.has_motion = true;
+    }
+    for (int a = 0; a < 3; a++) {
+        if (p[a] < result.min[a]) result.min[a] = p[a];
+        if (p[a] > result.max[a]) result.max[a] = p[a];
+    }
+
+    for (int a = 0; a < 3; a++) {
+        if (!setup.has_envelope[a]) continue;
+        if (p[a] < setup.min[a] - ENVELOPE_EPS) {
+            flag(SIM_ENVELOPE, "%c %.3f below min %.3f", AXIS_NAMES[a], p[a], setup.min[a]);
+            return false;
+        }
+        if (p[a] > setup.max[a] + ENVELOPE_EPS) {
+            flag(SIM_ENVELOPE, "%c %.3f above max %.3f", AXIS_NAMES[a], p[a], setup.max[a]);
+            return false;
+        }
+    }
+    return true;
+}
+
+void GCodeSimulator::linearMove(const float target[3]) {
+    result.move_count++;
+    checkPoint(target);
+    for (int a = 0; a < 3; a++) pos[a] = target[a];
+}
+
+void GCodeSimulator::arcMove(const float target[3], bool clockwise, bool has_r, float r,
+                             const bool has_ijk[3], const float ijk[3]) {
+    const int a0 = PLANE_AXES[plane][0];
+    const int a1 = PLANE_AXES[plane][1];
+    const int al = PLANE_AXES[plane][2];
+    float x = target[a0] - pos[a0];
+    float y = target[a1] - pos[a1];
+    float i = ijk[a0];
+    float j = ijk[a1];
+    float radius;
+
+    if (has_r) {
+        // Radius format - same center construction and errors as Grbl
+        float h = 4.0f * r * r - x * x - y * y;
+        float chord = sqrtf(x * x + y * y);
+        if (chord < 1e-6f) {
+            flag(SIM_BAD_ARC, "R arc ends where it starts");
+            linearMove(target);
+            return;
+        }
+        if (h < 0.0f) {
+            flag(SIM_BAD_ARC, "Radius %.3f shorter than half chord", fabsf(r));
+            linearMove(target);
+            return;
+        }
+        h = -sqrtf(h) / chord;
+        if (!clockwise) h = -h;
+        if (r < 0.0f) h = -h;
+        i = 0.5f * (x - y * h);
+        j = 0.5f * (y + x * h);
+        radius = fabsf(r);
+    } else {
+        if (!has_ijk[a0] && !has_ijk[a1]) {
+            flag(SIM_BAD_ARC, "Arc without offsets in plane");
+            linearMove(target);
+            return;
+        }
+        radius = sqrtf(i * i + j * j);
+        float target_r = sqrtf((x - i) * (x - i) + (y - j) * (y - j));
+        float delta_r = fabsf(target_r - radius);
+        if (delta_r > 0.005f && (delta_r > 0.5f || delta_r > 0.001f * radius)) {
+            flag(SIM_BAD_ARC, "Arc radius mismatch %.3f", delta_r);
+            linearMove(target);
+            return;
+        }
+    }
+    if (radius < 1e-6f) {
+        linearMove(target);
+        return;
+    }
+
+    float c0 = pos[a0] + i;
+    float c1 = pos[a1] + j;
+    float start_angle = atan2f(pos[a1] - c1, pos[a0] - c0);
+    float end_angle = atan2f(target[a1] - c1, target[a0] - c0);
+    float sweep = clockwise ? (start_angle - end_angle) : (end_angle - start_angle);
+    while (sweep < 0.0f) sweep += 2.0f * (float)M_PI;
+    if (sweep <= 1e-6f) sweep += 2.0f * (float)M_PI;  // Full circle when start == end
+
+    // The arc's extremes are its end point and the quadrant points it passes
+    result.move_count++;
+    float dl = target[al] - pos[al];
+    bool inside = checkPoint(target);
+    for (int q = 0; q < 4 && inside; q++) {
+        float angle = q * 0.5f * (float)M_PI;
+        float d = clockwise ? start_angle - angle : angle - start_angle;
+        d = fmodf(d, 2.0f * (float)M_PI);
+        if (d < 0.0f) d += 2.0f * (float)M_PI;
+        if (d >= sweep) continue;
+
+        float pt[3];
+        pt[a0] = c0 + radius * cosf(angle);
+        pt[a1] = c1 + radius * sinf(angle);
+        pt[al] = pos[al] + dl * (d / sweep);
+        inside = checkPoint(pt);
+    }
+    for (int a = 0; a < 3; a++) pos[a] = target[a];
+}
+
+void GCodeSimulator::programEnd() {
+    // M2/M30 reset the same modal state as Grbl
+    motion = 1;
+    plane = 0;
+    absolute = true;
+    inverse_time = false;
+    spindle_on = false;
+    setup.active_wcs = 0;
+}
@@ -0,0 +1,157 @@
+#include "gcode/height_map.h"
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+static const char MAGIC[4] = {'F', 'T', 'H', 'M'};
+static const uint16_t VERSION = 1;
+
+// Little-endian helpers for the file image
+static void put16(uint8_t *p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+static uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static void putFloat(uint8_t *p, float f) {
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+static float getFloat(const uint8_t *p) {
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+HeightMap::HeightMap() : x0(0), y0(0), dx(0), dy(0), nx(0), ny(0), probed(0), z(nullptr), set_mask(nullptr) {}
+
+HeightMap::~HeightMap() {
+    clear();
+}
+
+void HeightMap::clear() {
+    free(z);
+    free(set_mask);
+    z = nullptr;
+    set_mask = nullptr;
+    nx = ny = probed = 0;
+}
+
+bool HeightMap::setup(float origin_x, float origin_y, float width, float height, int points_x, int points_y) {
+    clear();
+    if (points_x < MIN_SIDE || points_x > MAX_SIDE || points_y < MIN_SIDE || points_y > MAX_SIDE) return false;
+    if (!(width > 0.0f) || !(height > 0.0f)) return false;
+
+    int count = points_x * points_y;
+    z = (float*)calloc(count, sizeof(float));
+    set_mask = (uint8_t*)calloc((count + 7) / 8, 1);
+    if (!z || !set_mask) {
+        clear();
+        return false;
+    }
+    x0 = origin_x;
+    y0 = origin_y;
+    nx = points_x;
+    ny = points_y;
+    dx = width / (nx - 1);
+    dy = height / (ny - 1);
+    return true;
+}
+
+void HeightMap::set(int i, int j, float height) {
+    if (!z || i < 0 || i >= nx || j < 0 || j >= ny) return;
+    int index = j * nx + i;
+    z[index] = height;
+    if (!(set_mask[index / 8] & (1 << (index % 8)))) {
+        set_mask[index / 8] |= 1 << (index % 8);
+        probed++;
+    }
+}
+
+void HeightMap::normalize() {
+    if (!z) return;
+    float base = z[0];
+    for (int i = 0; i < nx * ny; i++) z[i] -= base;
+}
+
+void HeightMap::range(float &min, float &max) const {
+    min = max = 0.0f;
+    if (!z) return;
+    min = max = z[0];
+    for (int i = 1; i < nx * ny; i++) {
+        if (z[i] < min) min = z[i];
+        if (z[i] > max) max = z[i];
+    }
+}
+
+float HeightMap::zAt(float x, float y) const {
+    if (!z) return 0.0f;
+
+    // Cell and position inside it, clamped to the grid
+    float fx = (x - x0) / dx;
+    float fy = (y - y0) / dy;
+    if (fx < 0.0f) fx = 0.0f;
+    if (fy < 0.0f) fy = 0.0f;
+    if (fx > nx - 1) fx = (float)(nx - 1);
+    if (fy > ny - 1) fy = (float)(ny - 1);
+    int i = (int)fx;
+    int j = (int)fy;
+    if (i > nx - 2) i = nx - 2;
+    if (j > ny - 2) j = ny - 2;
+    float tx = fx - i;
+    float ty = fy - j;
+
+    const float *row0 = z + j * nx + i;
+    const float *row1 = row0 + nx;
+    float bottom = row0[0] + (row0[1] - row0[0]) * tx;
+    float top = row1[0] + (row1[1] - row1[0]) * tx;
+    return bottom + (top - bottom) * ty;
+}
+
+size_t HeightMap::encodedSize() const {
+    return z ? HEADER_SIZE + (size_t)nx * ny * 2 : 0;
+}
+
+size_t HeightMap::encode(uint8_t *buf, size_t cap) const {
+    size_t size = encodedSize();
+    if (size == 0 || cap < size) return 0;
+
+    memcpy(buf, MAGIC, 4);
+    put16(buf + 4, VERSION);
+    put16(buf + 6, (uint16_t)nx);
+    put16(buf + 8, (uint16_t)ny);
+    put16(buf + 10, 0);
+    putFloat(buf + 12, x0);
+    putFloat(buf + 16, y0);
+    putFloat(buf + 20, dx);
+    putFloat(buf + 24, dy);
+
+    // Micrometers, limited to +-32.767 mm
+    uint8_t *p = buf + HEADER_SIZE;
+    for (int i = 0; i < nx * ny; i++, p += 2) {
+        long um = lroundf(z[i] * 1000.0f);
+        if (um > 32767) um = 32767;
+        if (um < -32767) um = -32767;
+        put16(p, (uint16_t)(int16_t)um);
+    }
+    return size;
+}
+
+bool HeightMap::decode(const uint8_t *buf, size_t len) {
+    if (len < HEADER_SIZE || memcmp(buf, MAGIC, 4) != 0 || get16(buf + 4) != VERSION) return false;
+    int points_x = get16(buf + 6);
+    int points_y = get16(buf + 8);
+    float step_x = getFloat(buf + 20);
+    float step_y = getFloat(buf + 24);
+    if (len < HEADER_SIZE + (size_t)points_x * points_y * 2) return false;
+    if (!setup(getFloat(buf + 12), getFloat(buf + 16), step_x * (points_x - 1), step_y * (points_y - 1),
+               points_x, points_y)) {
+        return false;
+    }
+
+    const uint8_t *p = buf + HEADER_SIZE;
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++, p += 2) {
+            set(i, j, (int16_t)get16(p) / 1000.0f);
+        }
+    }
+    return true;
+}
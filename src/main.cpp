@@ -1,12 +1,19 @@
 #include <Arduino.h>
 #include <lvgl.h>
 #include <WiFi.h>
-#include <Preferences.h>
 #include "core/display_driver.h"     // Display driver module
 #include "core/touch_driver.h"       // Touch driver module
 #include "core/power_manager.h"      // Power management module
+#include "core/motion_estimator.h"   // DRO interpolation between status reports
+#include "core/job_eta.h"            // SD job time estimate
+#include "core/sd_card.h"            // Display SD mount, clock probe and read cache
 #include "network/screenshot_server.h"  // Screenshot web server
 #include "network/fluidnc_client.h"     // FluidNC WebSocket client
+#include "network/connection_manager.h" // Non-blocking WiFi/mDNS/WebSocket bring-up
+#include "network/report_policy.h"  // Adaptive auto-report interval
+#include "network/gcode_sender.h"   // Display SD drip-feed streaming
+#include "network/probe_sequencer.h" // Acknowledged probe routines
+#include "network/machine_sessions.h" // Background status sessions to other machines
 #include "ui/ui_theme.h"        // UI theme colors
 #include "ui/ui_splash.h"       // Splash screen module
 #include "ui/ui_machine_select.h" // Machine selection screen
@@ -17,11 +24,31 @@
 #include "ui/tabs/ui_tab_files.h" // Files tab for refresh check
 #include "ui/tabs/ui_tab_macros.h" // Macros tab for progress updates
 #include "ui/tabs/ui_tab_terminal.h" // Terminal tab for updates
+#include "ui/terminal_log.h"    // Terminal SD log
+#include "ui/ui_gcode_preview.h" // G-code preview dialog
+#include "ui/gcode_cache.h"     // G-code analysis cache and jobs
+#include "ui/gcode_dry_run.h"   // G-code dry run against the machine setup
+#include "ui/height_map_store.h" // Surface height map storage
+#include "ui/ui_height_map.h"    // Height map dialog
 #include "ui/tabs/settings/ui_tab_settings_about.h" // About tab for screenshot URL updates
 #include "ui/tabs/control/ui_tab_control_actions.h" // Actions tab for pause button updates
 #include "ui/tabs/control/ui_tab_control_override.h" // Override tab for updates
 #include "ui/tabs/control/ui_tab_control_probe.h"   // Probe tab for probe indicator
 #include "ui/machine_config.h"  // Machine configuration manager
+#include "ui/settings_store.h"   // Write-behind settings commits
+#include "ui/system_prefs.h"     // Cached system preferences
+#include "ui/ui_dashboard.h"      // Multi-machine dashboard
+
+// Push positions to all DROs, extrapolated to now while the machine is moving
+static void updatePositionDisplays(const FluidNCStatus &status, uint32_t now)
+{
+    float d[4];
+    MotionEstimator::getOffset(now, d);
+    UICommon::updateMachinePosition(status.mpos_x + d[0], status.mpos_y + d[1], status.mpos_z + d[2]);
+    UICommon::updateWorkPosition(status.wpos_x + d[0], status.wpos_y + d[1], status.wpos_z + d[2], status.wpos_a + d[3]);
+    UITabStatus::updateWorkPosition(status.wpos_x + d[0], status.wpos_y + d[1], status.wpos_z + d[2], status.wpos_a + d[3]);
+    UITabStatus::updateMachinePosition(status.mpos_x + d[0], status.mpos_y + d[1], status.mpos_z + d[2], status.mpos_a + d[3]);
+}
 
 void setup()
 {
@@ -32,6 +59,9 @@ void setup()
     Serial.printf("PSRAM size: %d bytes\n", ESP.getPsramSize());
     Serial.printf("Free PSRAM: %d bytes\n", ESP.getFreePsram());
 
+    // System preferences are read from NVS once here
+    SystemPrefs::load();
+
     // Initialize Display Driver
     Serial.println("Initializing display driver...");
     static DisplayDriver displayDriver;
@@ -43,10 +73,7 @@ void setup()
     
     // Load and apply display rotation preference
     {
-        Preferences prefs;
-        prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
-        uint8_t display_rotation = prefs.getUChar("display_rot", 0);  // Default to 0 (normal)
-        prefs.end();
+        uint8_t display_rotation = SystemPrefs::getUInt(SysPref::DISPLAY_ROTATION);
         
         Serial.printf("Main: Loading display rotation: %d degrees\n", display_rotation * 90);
         displayDriver.setRotation(display_rotation);
@@ -81,6 +108,7 @@ void setup()
     if (SettingsManager::autoImportOnBoot()) {
         Serial.println("Settings imported successfully! Restarting...");
         delay(2000);  // Give user time to see serial message
+        SettingsStore::flush();  // Pending settings writes
         ESP.restart();
     }
 
@@ -89,10 +117,7 @@ void setup()
     UISplash::show(displayDriver.getDisplay());
 
     // Check if machine selection should be shown
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
-    bool show_machine_select = prefs.getBool("show_mach_sel", true);  // Default to true
-    prefs.end();
+    bool show_machine_select = SystemPrefs::getBool(SysPref::SHOW_MACHINE_SELECT);
     
     Serial.printf("Main: show_mach_sel preference = %d\n", show_machine_select);
     
@@ -103,13 +128,10 @@ void setup()
     } else {
         // Auto-load first configured machine
         Serial.println("Auto-loading first machine...");
-        MachineConfig machines[MAX_MACHINES];
-        MachineConfigManager::loadMachines(machines);
-        
         // Find first configured machine
         int first_machine_index = -1;
         for (int i = 0; i < MAX_MACHINES; i++) {
-            if (machines[i].is_configured) {
+            if (MachineConfigManager::getSummary(i).is_configured) {
                 first_machine_index = i;
                 break;
             }
@@ -118,7 +140,7 @@ void setup()
         if (first_machine_index >= 0) {
             // Set as selected machine and initialize UI
             MachineConfigManager::setSelectedMachineIndex(first_machine_index);
-            Serial.printf("Auto-selected machine: %s\n", machines[first_machine_index].name);
+            Serial.printf("Auto-selected machine: %s\n", MachineConfigManager::getSummary(first_machine_index).name);
             
             // Initialize main UI directly
             UICommon::createMainUI();
@@ -156,16 +178,59 @@ void loop()
     // Handle FluidNC client WebSocket events
     FluidNCClient::loop();
     
-    // Check for connection timeout (non-blocking)
-    UICommon::checkConnectionTimeout();
+    // WCS popup follows $# refreshes while it is open
+    UITabStatus::updateWCSPopup();
+    
+    // Keep FluidNC's receive buffer full while streaming from the Display SD
+    GCodeSender::loop();
+    
+    // Send the next probe routine step once FluidNC acknowledged the previous one
+    ProbeSequencer::loop();
+    HeightMapStore::loop();
+    UITabControlProbe::update();
+    UIHeightMap::update();
+    
+    // Prefetch the next Display SD block for open readers
+    SDCard::loop();
+    
+    // Status sessions to the other machines (once the dashboard has been opened)
+    MachineSessions::loop();
+    UIDashboard::update();
+    
+    // Advance connection bring-up state machine (non-blocking, per-stage timeouts)
+    ConnectionManager::loop();
+    
+    // Renegotiate auto-report interval from machine state, tab, joystick and display power
+    ReportPolicy::update();
     
     // Check for pending file list refresh (from Files tab delete callback)
     UITabFiles::checkPendingRefresh();
     
-    // Update UI from FluidNC status (every 250ms)
+    // Read the next batch of a Display SD directory scan
+    UITabFiles::scanLoop();
+    
+    // Write settings edits to NVS once they have settled
+    SettingsStore::loop();
+    
+    // Sample new status reports for DRO interpolation
+    MotionEstimator::update(FluidNCClient::getStatus());
+    
+    // Sample SD job progress for the time estimate
+    JobEta::update(FluidNCClient::getStatus());
+    
+    // Update UI from FluidNC status (every 250ms, or at the report rate while jogging)
     static uint32_t lastUIUpdate = 0;
+    static uint32_t lastDROFrame = 0;
     uint32_t currentMillis = millis();
-    if (currentMillis - lastUIUpdate >= 250) {
+    
+    // Between reports, refresh only the DROs at frame rate while moving
+    if (MotionEstimator::isMoving() && currentMillis - lastDROFrame >= MOTION_DISPLAY_INTERVAL_MS &&
+        currentMillis - lastUIUpdate < ReportPolicy::getDisplayIntervalMs()) {
+        lastDROFrame = currentMillis;
+        updatePositionDisplays(FluidNCClient::getStatus(), currentMillis);
+    }
+    
+    if (currentMillis - lastUIUpdate >= ReportPolicy::getDisplayIntervalMs()) {
         lastUIUpdate = currentMillis;
         
         bool machine_connected = FluidNCClient::isConnected();
@@ -197,8 +262,8 @@ void loop()
             }
             
             UICommon::updateMachineState(state_str);
-            UICommon::updateMachinePosition(status.mpos_x, status.mpos_y, status.mpos_z);
-            UICommon::updateWorkPosition(status.wpos_x, status.wpos_y, status.wpos_z, status.wpos_a);
+            updatePositionDisplays(status, currentMillis);
+            lastDROFrame = currentMillis;
 
             // Check for HOLD/ALARM state and show popups if needed
             UICommon::checkStatePopups(status.state, status.last_message);
@@ -208,14 +273,10 @@ void loop()
 
             // Update Status tab
             UITabStatus::updateState(state_str);
-            UITabStatus::updateWorkPosition(status.wpos_x, status.wpos_y, status.wpos_z, status.wpos_a);
-            UITabStatus::updateMachinePosition(status.mpos_x, status.mpos_y, status.mpos_z, status.mpos_a);
             UITabStatus::updateFeedRate(status.feed_rate, status.feed_override);
             UITabStatus::updateRapidOverride(status.rapid_override);
             UITabStatus::updateSpindle(status.spindle_speed, status.spindle_override);
-            UITabStatus::updateModalStates(status.modal_wcs, status.modal_plane, status.modal_distance,
-                                        status.modal_units, status.modal_motion, status.modal_feedrate,
-                                        status.modal_spindle, status.modal_coolant, status.modal_tool);
+            UITabStatus::updateModalStates(status.modal);
             UITabStatus::updateMessage(status.last_message);
             UITabStatus::updateLimitSwitches(status.pin_limit_x, status.pin_limit_y, status.pin_limit_z, status.pin_limit_a);
             UITabControlActions::updateLimitSwitches(status.pin_limit_x, status.pin_limit_y, status.pin_limit_z, status.pin_limit_a);
@@ -223,8 +284,15 @@ void loop()
             UITabControlProbe::updateProbe(status.pin_probe);
             
             // Update file progress in status bar (UICommon) instead of status tab
+            // (a Display SD stream also shows its line rate)
+            const char *progress_name = status.sd_filename;
+            char stream_name[80];
+            if (GCodeSender::isActive()) {
+                snprintf(stream_name, sizeof(stream_name), "%s  %.0f l/s", status.sd_filename, GCodeSender::getLinesPerSecond());
+                progress_name = stream_name;
+            }
             UICommon::updateFileProgress(status.is_sd_printing, status.sd_percent,
-                                        status.sd_filename, status.sd_elapsed_ms);
+                                        progress_name, status.sd_elapsed_ms);
             
             // Update control buttons visibility based on machine state
             UITabStatus::updateControlButtons(status.state);
@@ -306,6 +374,12 @@ void loop()
             
             // Update power manager with current machine state
             PowerManager::update(status.state);
+        } else if (ConnectionManager::isReconnecting()) {
+            // Link dropped and is being recovered - keep last known positions and modal
+            // states on screen so the UI is usable again as soon as the link returns
+            UICommon::updateMachineState("OFFLINE");
+            UITabStatus::updateState("OFFLINE");
+            PowerManager::update(STATE_IDLE);
         } else {
             // Machine disconnected - show OFFLINE state and reset all values to dashes
             UICommon::updateMachineState("OFFLINE");
@@ -319,19 +393,27 @@ void loop()
             UITabStatus::updateFeedRate(-9999.0f, -9999.0f);  // Reset feed rate and override
             UITabStatus::updateRapidOverride(-9999.0f);        // Reset rapid override
             UITabStatus::updateSpindle(-9999.0f, -9999.0f);    // Reset spindle and override
-            UITabStatus::updateModalStates("---", "---", "---", "---", "---", "---", "---", "---", "---");
+            UITabStatus::clearModalStates();
             
             // Update power manager with OFFLINE state (treat as IDLE for power management)
             PowerManager::update(STATE_IDLE);
         }
     }
     
-    // Check machine connection timeout
-    UICommon::checkConnectionTimeout();
-    
     // Update Terminal tab (batched UI updates every 100ms)
     UITabTerminal::update();
     
+    // Write a batched terminal log block to the Display SD (only when one is ready)
+    TerminalLog::loop();
+    
+    // Analyze the next chunk of a G-code file (preview or idle-time precompute)
+    GCodeCache::loop();
+    if (GCodeCache::takeChanged()) {
+        UITabFiles::updateEstimates();
+    }
+    GCodeDryRun::loop();
+    UIGCodePreview::update();
+    
     // Update LVGL tick (CRITICAL for timers and input device polling!)
     static uint32_t lastTick = 0;
     lv_tick_inc(currentMillis - lastTick);
@@ -0,0 +1,660 @@
+#include "network/connection_manager.h"
+#include "network/fluidnc_client.h"
+#include "network/screenshot_server.h"
+#include "ui/ui_common.h"
+#include "ui/tabs/ui_tab_files.h"
+#include "config.h"
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <Preferences.h>
+#include <mdns.h>
+#include <esp_netif.h>
+#include <lwip/dns.h>
+
+// Static member initialization
+ConnectionStage ConnectionManager::stage = CONN_STAGE_IDLE;
+MachineConfig ConnectionManager::config;
+uint32_t ConnectionManager::stage_start_ms = 0;
+uint32_t ConnectionManager::begin_ms = 0;
+uint8_t ConnectionManager::resolve_attempt = 0;
+char ConnectionManager::resolved_host[64] = "";
+bool ConnectionManager::mdns_started = false;
+int ConnectionManager::machine_index = -1;
+bool ConnectionManager::using_cached_ip = false;
+bool ConnectionManager::refresh_pending = false;
+bool ConnectionManager::reconnecting = false;
+uint8_t ConnectionManager::reconnect_attempt = 0;
+uint32_t ConnectionManager::lost_ms = 0;
+uint32_t ConnectionManager::backoff_until_ms = 0;
+
+// In-flight asynchronous mDNS query (ESP-IDF mdns component)
+static mdns_search_once_t *mdns_search = nullptr;
+static bool mdns_retry = false;   // Last query could not be started - try again on the next pass
+static IPAddress mdns_result_ip;
+
+// In-flight asynchronous unicast DNS lookup (lwIP). The found callback runs on the
+// tcpip task; the lookup id tells a cancelled lookup's late answer from the current one.
+enum DNSLookupState : uint8_t { DNS_LOOKUP_IDLE, DNS_LOOKUP_PENDING, DNS_LOOKUP_DONE };
+static volatile uint8_t dns_state = DNS_LOOKUP_IDLE;
+static volatile uint32_t dns_result_addr = 0;   // IPv4 address, 0 = not found
+static volatile uint32_t dns_lookup_id = 0;
+static char dns_hostname[64];
+static IPAddress dns_result_ip;
+
+static void dnsFound(const char *name, const ip_addr_t *addr, void *arg) {
+    if ((uint32_t)(uintptr_t)arg != dns_lookup_id || dns_state != DNS_LOOKUP_PENDING) return;
+    dns_result_addr = (addr && IP_IS_V4(addr)) ? ip_2_ip4(addr)->addr : 0;
+    dns_state = DNS_LOOKUP_DONE;
+}
+
+static esp_err_t dnsStart(void *arg) {
+    // Runs on the tcpip task; answers from the lwIP cache come back right away
+    ip_addr_t addr;
+    err_t err = dns_gethostbyname(dns_hostname, &addr, dnsFound, arg);
+    if (err == ERR_OK) {
+        dns_result_addr = IP_IS_V4(&addr) ? ip_2_ip4(&addr)->addr : 0;
+        dns_state = DNS_LOOKUP_DONE;
+    } else if (err != ERR_INPROGRESS) {
+        dns_result_addr = 0;
+        dns_state = DNS_LOOKUP_DONE;
+    }
+    return ESP_OK;
+}
+
+// Maximum mDNS query attempts within the resolve stage
+static const uint8_t MAX_RESOLVE_ATTEMPTS = 5;
+
+void ConnectionManager::begin(const MachineConfig &machine) {
+    cancel();
+
+    config = machine;
+    begin_ms = millis();
+    resolved_host[0] = '\0';
+    reconnecting = false;
+    reconnect_attempt = 0;
+    machine_index = MachineConfigManager::getSelectedMachineIndex();
+    using_cached_ip = false;
+    refresh_pending = false;
+
+    Serial.printf("[Connection] Starting bring-up for %s (%s:%d)\n",
+                  config.name, config.fluidnc_url, config.websocket_port);
+
+    if (config.connection_type == CONN_WIRELESS) {
+        if (strlen(config.ssid) == 0) {
+            Serial.println("[Connection] Warning - Wireless connection selected but no SSID configured");
+            stage = CONN_STAGE_IDLE;
+            return;
+        }
+
+        WiFi.mode(WIFI_STA);
+        WiFi.setAutoReconnect(true);  // Driver rejoins the AP; loop() re-opens the WebSocket
+        WiFi.begin(config.ssid, config.password);
+        enterStage(CONN_STAGE_WIFI);
+    } else {
+        Serial.println("[Connection] Wired connection selected, skipping WiFi initialization");
+        enterStage(CONN_STAGE_RESOLVE);
+    }
+}
+
+void ConnectionManager::cancel() {
+    stopMDNSQuery();
+    stopDNSQuery();
+    refresh_pending = false;
+    if (isConnecting()) {
+        Serial.printf("[Connection] Cancelled during stage %d\n", stage);
+    }
+    stage = CONN_STAGE_IDLE;
+    reconnecting = false;
+    reconnect_attempt = 0;
+}
+
+void ConnectionManager::adopt(const MachineConfig &machine, int index, const char *host) {
+    cancel();
+
+    config = machine;
+    machine_index = index;
+    strncpy(resolved_host, host, sizeof(resolved_host) - 1);
+    resolved_host[sizeof(resolved_host) - 1] = '\0';
+    begin_ms = millis();
+    stage = CONN_STAGE_CONNECTED;
+    Serial.printf("[Connection] Adopted open connection to %s at %s\n", config.name, resolved_host);
+}
+
+bool ConnectionManager::isConnecting() {
+    return stage >= CONN_STAGE_WIFI && stage <= CONN_STAGE_WEBSOCKET;
+}
+
+void ConnectionManager::loop() {
+    switch (stage) {
+        case CONN_STAGE_WIFI:      processWiFi(); break;
+        case CONN_STAGE_MDNS:      processMDNS(); break;
+        case CONN_STAGE_RESOLVE:   processResolve(); break;
+        case CONN_STAGE_WEBSOCKET: processWebSocket(); break;
+        case CONN_STAGE_BACKOFF:   processBackoff(); break;
+        case CONN_STAGE_CONNECTED: processLinkWatch(); break;
+        default: break;
+    }
+}
+
+void ConnectionManager::enterStage(ConnectionStage next) {
+    stage = next;
+    stage_start_ms = millis();
+
+    // Progress text for the connecting popup
+    char text[128];
+    char detail[96];
+    text[0] = '\0';
+    detail[0] = '\0';
+
+    switch (next) {
+        case CONN_STAGE_WIFI:
+            snprintf(text, sizeof(text), "Connecting to %s...", config.ssid);
+            snprintf(detail, sizeof(detail), "Step 1 of 4: WiFi");
+            break;
+        case CONN_STAGE_MDNS:
+            snprintf(text, sizeof(text), "Starting mDNS...");
+            snprintf(detail, sizeof(detail), "Step 2 of 4: mDNS");
+            break;
+        case CONN_STAGE_RESOLVE:
+            snprintf(text, sizeof(text), "Resolving %s...", config.fluidnc_url);
+            snprintf(detail, sizeof(detail), "Step 3 of 4: Resolve");
+            break;
+        case CONN_STAGE_WEBSOCKET:
+            snprintf(text, sizeof(text), "Connecting to %s...", config.name);
+            snprintf(detail, sizeof(detail), "Step 4 of 4: %s:%d", resolved_host, config.websocket_port);
+            break;
+        default:
+            return;
+    }
+
+    // While recovering a dropped link, keep the headline on the reconnect itself
+    if (reconnecting) {
+        char stage_detail[96];
+        strncpy(stage_detail, detail, sizeof(stage_detail) - 1);
+        stage_detail[sizeof(stage_detail) - 1] = '\0';
+        snprintf(text, sizeof(text), "Reconnecting to %s...", config.name);
+        snprintf(detail, sizeof(detail), "Attempt %d of %d - %s",
+                 reconnect_attempt, CONN_RECONNECT_MAX_ATTEMPTS, stage_detail);
+    }
+
+    Serial.printf("[Connection] Stage %d: %s (%lums since start)\n", next, text, millis() - begin_ms);
+    UICommon::updateConnectingPopup(text, detail, (int)next - CONN_STAGE_WIFI, 4);
+}
+
+void ConnectionManager::fail(const char *title, const char *message) {
+    stopMDNSQuery();
+    stopDNSQuery();
+
+    // A cached IP that did not answer is stale - drop it and resolve normally
+    if (using_cached_ip && stage == CONN_STAGE_WEBSOCKET && !reconnecting) {
+        Serial.printf("[Connection] Cached IP %s did not answer, falling back to name resolution\n", resolved_host);
+        FluidNCClient::disconnect();
+        clearCachedAddress();
+        using_cached_ip = false;
+        resolved_host[0] = '\0';
+        enterStage(CONN_STAGE_RESOLVE);
+        return;
+    }
+
+    if (reconnecting) {
+        // A cached IP that no longer answers may have changed (DHCP) - re-resolve next time
+        if (stage == CONN_STAGE_WEBSOCKET && needsResolution(config.fluidnc_url)) {
+            resolved_host[0] = '\0';
+        }
+        Serial.printf("[Connection] Reconnect attempt %d failed: %s\n", reconnect_attempt, title);
+        scheduleReconnect();
+        return;
+    }
+
+    stage = CONN_STAGE_FAILED;
+    Serial.printf("[Connection] Failed after %lums: %s\n", millis() - begin_ms, title);
+    UICommon::showConnectionErrorDialog(title, message);
+}
+
+void ConnectionManager::processWiFi() {
+    if (WiFi.status() == WL_CONNECTED) {
+        Serial.println("[Connection] WiFi connected!");
+        Serial.printf("[Connection] IP Address: %s\n", WiFi.localIP().toString().c_str());
+
+        // Update WiFi status in status bar
+        UICommon::updateWiFiName(WiFi.SSID().c_str());
+
+        // Initialize screenshot server now that WiFi is connected (first connection only)
+        DisplayDriver *display_driver = UICommon::getDisplayDriver();
+        if (display_driver && !reconnecting) {
+            Serial.println("[Connection] Initializing screenshot server with WiFi connection...");
+            ScreenshotServer::init(display_driver);
+            if (ScreenshotServer::isConnected()) {
+                Serial.println("Screenshot server available at: http://" + ScreenshotServer::getIPAddress());
+            }
+        }
+
+        // Reconnects with a cached IP go straight to the WebSocket
+        enterStage((reconnecting && resolved_host[0] != '\0') ? CONN_STAGE_RESOLVE : CONN_STAGE_MDNS);
+        return;
+    }
+
+    if (millis() - stage_start_ms >= CONN_WIFI_TIMEOUT_MS) {
+        Serial.println("[Connection] WiFi connection failed!");
+
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                "Could not connect to network:\n%s\n\nCheck WiFi settings and try again.",
+                config.ssid);
+        fail("WiFi Connection Failed", error_msg);
+    }
+}
+
+void ConnectionManager::processMDNS() {
+    // Initialize mDNS client stack to enable resolving .local hostnames (like fluidnc.local)
+    // Note: MDNS.begin() is required on ESP32 to enable mDNS client queries, not just advertising
+    // No settle delay needed - queries are asynchronous and retried within the resolve stage
+    if (mdns_started) {
+        // Already running from an earlier connection
+    } else if (MDNS.begin("fluidtouch")) {
+        mdns_started = true;
+        Serial.println("[Connection] mDNS client initialized - can now resolve .local hostnames");
+    } else {
+        Serial.println("[Connection] Warning: mDNS client failed to start (.local hostname resolution will not work)");
+    }
+    enterStage(CONN_STAGE_RESOLVE);
+}
+
+void ConnectionManager::processResolve() {
+    // mDNS query failed to start (out of memory, stack busy) - counts as an attempt
+    if (mdns_retry) {
+        if (resolve_attempt < MAX_RESOLVE_ATTEMPTS) {
+            startMDNSQuery();
+        } else {
+            mdns_retry = false;  // Exhausted - fails below
+        }
+    }
+
+    // First pass through this stage: decide how to resolve
+    if (resolved_host[0] == '\0' && mdns_search == nullptr && dns_state == DNS_LOOKUP_IDLE && resolve_attempt == 0) {
+        if (!needsResolution(config.fluidnc_url)) {
+            // IP address - nothing to resolve
+            strncpy(resolved_host, config.fluidnc_url, sizeof(resolved_host) - 1);
+            resolved_host[sizeof(resolved_host) - 1] = '\0';
+        } else if (loadCachedAddress(resolved_host, sizeof(resolved_host))) {
+            // Last good IP from NVS - try it optimistically, re-resolve in the background later
+            using_cached_ip = true;
+            Serial.printf("[Connection] Using cached IP %s for %s\n", resolved_host, config.fluidnc_url);
+        } else if (!String(config.fluidnc_url).endsWith(".local")) {
+            // Unicast DNS for bare hostnames and FQDNs
+            startDNSQuery();
+        } else {
+            startMDNSQuery();
+        }
+    }
+
+    // DNS lookup in flight - poll without blocking (lwIP retries on its own)
+    if (dns_state != DNS_LOOKUP_IDLE) {
+        bool found = false;
+        if (pollDNSQuery(found)) {
+            if (found) {
+                strncpy(resolved_host, dns_result_ip.toString().c_str(), sizeof(resolved_host) - 1);
+                resolved_host[sizeof(resolved_host) - 1] = '\0';
+                Serial.printf("[Connection] Resolved via DNS to IP: %s\n", resolved_host);
+            } else {
+                resolve_attempt = MAX_RESOLVE_ATTEMPTS;  // lwIP already retried
+            }
+        }
+    }
+
+    // mDNS query in flight - poll without blocking
+    if (mdns_search) {
+        bool found = false;
+        if (pollMDNSQuery(found)) {
+            if (found) {
+                strncpy(resolved_host, mdns_result_ip.toString().c_str(), sizeof(resolved_host) - 1);
+                resolved_host[sizeof(resolved_host) - 1] = '\0';
+                Serial.printf("[Connection] Resolved on attempt %d to IP: %s\n", resolve_attempt, resolved_host);
+            } else if (resolve_attempt < MAX_RESOLVE_ATTEMPTS) {
+                Serial.printf("[Connection] Retry attempt %d/%d...\n", resolve_attempt + 1, MAX_RESOLVE_ATTEMPTS);
+                startMDNSQuery();
+            }
+        }
+    }
+
+    if (resolved_host[0] != '\0') {
+        resolve_attempt = 0;
+        enterStage(CONN_STAGE_WEBSOCKET);
+
+        Serial.printf("[Connection] Connecting to FluidNC at %s:%d\n", resolved_host, config.websocket_port);
+        if (!FluidNCClient::connect(config, resolved_host)) {
+            char error_msg[300];
+            snprintf(error_msg, sizeof(error_msg),
+                    "Could not connect to machine:\n%s\n\nURL: %s:%d\n\nCheck that the machine is powered on\nand network connection is available.",
+                    config.name, config.fluidnc_url, config.websocket_port);
+            fail("Machine Connection Failed", error_msg);
+        }
+        return;
+    }
+
+    bool exhausted = (mdns_search == nullptr && dns_state == DNS_LOOKUP_IDLE && resolve_attempt >= MAX_RESOLVE_ATTEMPTS);
+    if (exhausted || millis() - stage_start_ms >= CONN_RESOLVE_TIMEOUT_MS) {
+        Serial.printf("[Connection] Failed to resolve hostname: %s\n", config.fluidnc_url);
+        Serial.println("[Connection] Tip: Try using the IP address instead, or check that mDNS is working on your network");
+        resolve_attempt = 0;
+
+        char error_msg[300];
+        snprintf(error_msg, sizeof(error_msg),
+                "Could not resolve hostname:\n%s\n\nTry using the IP address instead,\nor check that mDNS is working on your network.",
+                config.fluidnc_url);
+        fail("Machine Connection Failed", error_msg);
+    }
+}
+
+void ConnectionManager::processWebSocket() {
+    if (FluidNCClient::isConnected()) {
+        stage = CONN_STAGE_CONNECTED;
+
+        // Remember the address for the next boot; a cached one is re-checked in the background
+        if (needsResolution(config.fluidnc_url)) {
+            if (using_cached_ip) {
+                refresh_pending = true;
+            } else {
+                storeCachedAddress(resolved_host);
+            }
+        }
+
+        if (reconnecting) {
+            Serial.printf("[Connection] ✓ Link recovered in %lums (attempt %d)\n", millis() - lost_ms, reconnect_attempt);
+            reconnecting = false;
+            reconnect_attempt = 0;
+            UITabFiles::onReconnected();
+        } else {
+            Serial.printf("[Connection] ✓ Connected in %lums (first status report received)\n", millis() - begin_ms);
+        }
+        UICommon::hideConnectingPopup();
+        UICommon::hideConnectionErrorDialog();
+        return;
+    }
+
+    uint32_t timeout_ms = using_cached_ip ? CONN_CACHED_IP_TIMEOUT_MS : CONN_WEBSOCKET_TIMEOUT_MS;
+    if (millis() - stage_start_ms >= timeout_ms) {
+        char error_msg[300];
+        snprintf(error_msg, sizeof(error_msg),
+                "Could not connect to machine:\n%s\n\nURL: %s:%d\n\nCheck that the machine is powered on\nand network connection is available.",
+                config.name, config.fluidnc_url, config.websocket_port);
+        fail("Machine Connection Failed", error_msg);
+        Serial.println("[Connection] Machine connection timeout - showing error dialog");
+    }
+}
+
+void ConnectionManager::processLinkWatch() {
+    // WiFi can drop without the WebSocket noticing until its ping times out - act on it now
+    bool wifi_lost = (config.connection_type == CONN_WIRELESS && WiFi.status() != WL_CONNECTED);
+    if (wifi_lost || !FluidNCClient::isConnected()) {
+        Serial.printf("[Connection] %s link lost\n", wifi_lost ? "WiFi" : "WebSocket");
+        FluidNCClient::disconnect();  // May re-enter onConnectionLost() via the close event
+        onConnectionLost();
+        return;
+    }
+
+    if (refresh_pending) {
+        processAddressRefresh();
+    }
+}
+
+void ConnectionManager::processAddressRefresh() {
+    // Connected via a cached IP - confirm it with one asynchronous lookup
+    bool dns = !String(config.fluidnc_url).endsWith(".local");
+    if (!mdns_search && dns_state == DNS_LOOKUP_IDLE) {
+        if (dns) {
+            startDNSQuery();
+        } else {
+            startMDNSQuery();
+            if (!mdns_search) {
+                // Not retried - the cached IP is working
+                refresh_pending = false;
+                mdns_retry = false;
+            }
+        }
+        resolve_attempt = 0;
+        return;
+    }
+
+    bool found = false;
+    if (dns) {
+        if (pollDNSQuery(found)) {
+            refresh_pending = false;
+            if (found) {
+                storeCachedAddress(dns_result_ip.toString().c_str());
+            } else {
+                Serial.println("[Connection] Background DNS refresh got no answer, keeping cached IP");
+            }
+        }
+        return;
+    }
+    if (pollMDNSQuery(found)) {
+        refresh_pending = false;
+        if (found) {
+            // Takes effect on the next reconnect or boot; the open socket is left alone
+            storeCachedAddress(mdns_result_ip.toString().c_str());
+        } else {
+            Serial.println("[Connection] Background mDNS refresh got no answer, keeping cached IP");
+        }
+    }
+}
+
+void ConnectionManager::onConnectionLost() {
+    // Only recover connections that were established; bring-up failures use stage timeouts
+    if (stage != CONN_STAGE_CONNECTED) return;
+
+    Serial.println("[Connection] Connection lost - starting automatic reconnect");
+    reconnecting = true;
+    reconnect_attempt = 0;
+    lost_ms = millis();
+
+    UICommon::showConnectingPopup(config.name, nullptr);
+    scheduleReconnect();
+}
+
+void ConnectionManager::scheduleReconnect() {
+    if (reconnect_attempt >= CONN_RECONNECT_MAX_ATTEMPTS) {
+        Serial.printf("[Connection] Giving up after %d reconnect attempts\n", reconnect_attempt);
+        reconnecting = false;
+        reconnect_attempt = 0;
+        stage = CONN_STAGE_FAILED;
+        UICommon::showConnectionErrorDialog("Machine Disconnected",
+            "Lost connection to machine.\n\nCheck network connection and\nmachine power, then restart.");
+        return;
+    }
+
+    // Exponential backoff with equal jitter: half fixed, half random
+    uint8_t shift = reconnect_attempt < 16 ? reconnect_attempt : 16;
+    uint32_t delay_ms = (uint32_t)CONN_RECONNECT_BASE_MS << shift;
+    if (delay_ms > CONN_RECONNECT_MAX_MS) delay_ms = CONN_RECONNECT_MAX_MS;
+    delay_ms = delay_ms / 2 + (uint32_t)random(delay_ms / 2 + 1);
+
+    stage = CONN_STAGE_BACKOFF;
+    stage_start_ms = millis();
+    backoff_until_ms = stage_start_ms + delay_ms;
+
+    char text[128];
+    char detail[96];
+    snprintf(text, sizeof(text), "Reconnecting to %s...", config.name);
+    snprintf(detail, sizeof(detail), "Attempt %d of %d in %.1fs",
+             reconnect_attempt + 1, CONN_RECONNECT_MAX_ATTEMPTS, delay_ms / 1000.0f);
+    Serial.printf("[Connection] %s\n", detail);
+    UICommon::updateConnectingPopup(text, detail, 0, 4);
+}
+
+void ConnectionManager::processBackoff() {
+    if ((int32_t)(millis() - backoff_until_ms) >= 0) {
+        startReconnectAttempt();
+    }
+}
+
+void ConnectionManager::startReconnectAttempt() {
+    reconnect_attempt++;
+    FluidNCClient::disconnect();  // Make sure the previous socket is fully closed
+
+    stopMDNSQuery();
+    stopDNSQuery();
+    refresh_pending = false;
+    using_cached_ip = false;
+
+    if (config.connection_type == CONN_WIRELESS && WiFi.status() != WL_CONNECTED) {
+        WiFi.reconnect();
+        enterStage(CONN_STAGE_WIFI);
+    } else if (resolved_host[0] != '\0') {
+        // Cached IP from the last good connection - skip mDNS entirely
+        enterStage(CONN_STAGE_RESOLVE);
+    } else {
+        enterStage(CONN_STAGE_MDNS);
+    }
+}
+
+bool ConnectionManager::needsResolution(const char *url) {
+    // Everything but an IP address is resolved here (mDNS for .local, else unicast DNS),
+    // so the WebSocket connect never blocks on a lookup
+    IPAddress ip;
+    return !ip.fromString(url);
+}
+
+void ConnectionManager::startMDNSQuery() {
+    stopMDNSQuery();
+
+    // Query for the hostname without the .local suffix
+    char hostname[64];
+    strncpy(hostname, config.fluidnc_url, sizeof(hostname) - 1);
+    hostname[sizeof(hostname) - 1] = '\0';
+    char *suffix = strstr(hostname, ".local");
+    if (suffix) *suffix = '\0';
+
+    resolve_attempt++;
+    Serial.printf("[Connection] Using mDNS query for: %s (attempt %d)\n", hostname, resolve_attempt);
+    mdns_search = mdns_query_async_new(hostname, nullptr, nullptr, MDNS_TYPE_A, CONN_MDNS_QUERY_MS, 1, nullptr);
+    if (!mdns_search) {
+        Serial.println("[Connection] Failed to start mDNS query");
+        mdns_retry = true;
+    }
+}
+
+bool ConnectionManager::pollMDNSQuery(bool &found) {
+    found = false;
+    if (!mdns_search) return true;
+
+    mdns_result_t *results = nullptr;
+    uint8_t num_results = 0;
+    if (!mdns_query_async_get_results(mdns_search, 0, &results, &num_results)) {
+        return false;  // Still waiting
+    }
+
+    // Take the first IPv4 address of the first result
+    for (mdns_result_t *r = results; r && !found; r = r->next) {
+        for (mdns_ip_addr_t *a = r->addr; a; a = a->next) {
+            if (a->addr.type == ESP_IPADDR_TYPE_V4 && a->addr.u_addr.ip4.addr != 0) {
+                mdns_result_ip = IPAddress(a->addr.u_addr.ip4.addr);
+                found = true;
+                break;
+            }
+        }
+    }
+
+    mdns_query_results_free(results);
+    stopMDNSQuery();
+    return true;
+}
+
+void ConnectionManager::stopMDNSQuery() {
+    mdns_retry = false;
+    if (mdns_search) {
+        mdns_query_async_delete(mdns_search);
+        mdns_search = nullptr;
+    }
+}
+
+void ConnectionManager::startDNSQuery() {
+    stopDNSQuery();
+
+    strncpy(dns_hostname, config.fluidnc_url, sizeof(dns_hostname) - 1);
+    dns_hostname[sizeof(dns_hostname) - 1] = '\0';
+    resolve_attempt++;
+    Serial.printf("[Connection] Using DNS lookup for: %s\n", dns_hostname);
+
+    dns_result_addr = 0;
+    dns_state = DNS_LOOKUP_PENDING;
+    if (esp_netif_tcpip_exec(dnsStart, (void*)(uintptr_t)dns_lookup_id) != ESP_OK) {
+        Serial.println("[Connection] Failed to start DNS lookup");
+        dns_state = DNS_LOOKUP_DONE;
+    }
+}
+
+bool ConnectionManager::pollDNSQuery(bool &found) {
+    found = false;
+    if (dns_state == DNS_LOOKUP_PENDING) return false;  // Still waiting
+    if (dns_state == DNS_LOOKUP_DONE && dns_result_addr != 0) {
+        dns_result_ip = IPAddress(dns_result_addr);
+        found = true;
+    }
+    stopDNSQuery();
+    return true;
+}
+
+void ConnectionManager::stopDNSQuery() {
+    // lwIP can't cancel a lookup - a late answer carries an old id and is ignored
+    dns_lookup_id++;
+    dns_state = DNS_LOOKUP_IDLE;
+}
+
+bool ConnectionManager::loadCachedAddress(char *ip, size_t len) {
+    return readCachedAddress(machine_index, config.fluidnc_url, ip, len);
+}
+
+bool ConnectionManager::readCachedAddress(int index, const char *url, char *ip, size_t len) {
+    if (index < 0 || index >= MAX_MACHINES) return false;
+
+    // Entry is only valid for the hostname it was resolved from (machine may have been edited)
+    String prefix = "m" + String(index) + "_";
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, true);
+    String host = prefs.getString((prefix + "iph").c_str(), "");
+    String cached = prefs.getString((prefix + "ip").c_str(), "");
+    prefs.end();
+
+    if (cached.isEmpty() || host != url) return false;
+
+    strncpy(ip, cached.c_str(), len - 1);
+    ip[len - 1] = '\0';
+    return true;
+}
+
+bool ConnectionManager::getKnownAddress(int index, const MachineSummary &machine, char *host, size_t len) {
+    if (!needsResolution(machine.fluidnc_url)) {
+        strncpy(host, machine.fluidnc_url, len - 1);
+        host[len - 1] = '\0';
+        return true;
+    }
+    return readCachedAddress(index, machine.fluidnc_url, host, len);
+}
+
+void ConnectionManager::storeCachedAddress(const char *ip) {
+    if (machine_index < 0 || machine_index >= MAX_MACHINES || !ip || ip[0] == '\0') return;
+
+    char current[64];
+    if (loadCachedAddress(current, sizeof(current)) && strcmp(current, ip) == 0) {
+        return;  // Unchanged - avoid an NVS write on every connect
+    }
+
+    String prefix = "m" + String(machine_index) + "_";
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, false);
+    prefs.putString((prefix + "iph").c_str(), config.fluidnc_url);
+    prefs.putString((prefix + "ip").c_str(), ip);
+    prefs.end();
+    Serial.printf("[Connection] Cached %s -> %s for machine %d\n", config.fluidnc_url, ip, machine_index);
+}
+
+void ConnectionManager::clearCachedAddress() {
+    if (machine_index < 0 || machine_index >= MAX_MACHINES) return;
+
+    String prefix = "m" + String(machine_index) + "_";
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, false);
+    prefs.remove((prefix + "ip").c_str());
+    prefs.end();
+}
@@ -1,13 +1,18 @@
 #include "network/fluidnc_client.h"
+#include "network/connection_manager.h"
+#include "network/gcode_sender.h"
+#include "network/probe_sequencer.h"
+#include "network/timed_tcp_client.h"
+#include "config.h"
 #include "ui/ui_common.h"
-#include "ui/tabs/control/ui_tab_control_probe.h"
+#include "gcode/gcode_number.h"
 #include <WiFi.h>
-#include <ESPmDNS.h>
 
 using namespace websockets;
 
 // Static member initialization
-WebsocketsClient FluidNCClient::webSocket;
+WebsocketsClient FluidNCClient::primarySocket(std::make_shared<TimedTcpClient>());
+WebsocketsClient *FluidNCClient::webSocket = &FluidNCClient::primarySocket;
 FluidNCStatus FluidNCClient::currentStatus;
 MachineConfig FluidNCClient::currentConfig;
 uint32_t FluidNCClient::lastStatusRequestMs = 0;
@@ -19,8 +24,37 @@ bool FluidNCClient::autoReportingAttempted = false;
 uint32_t FluidNCClient::lastPollingMs = 0;
 uint32_t FluidNCClient::lastGCodePollMs = 0;
 uint32_t FluidNCClient::lastAutoReportAttemptMs = 0;
+uint16_t FluidNCClient::reportIntervalMs = REPORT_INTERVAL_DEFAULT_MS;
 bool FluidNCClient::everConnectedSuccessfully = false;
 bool FluidNCClient::isHandlingDisconnect = false;
+WCSTable FluidNCClient::wcsTable;
+bool FluidNCClient::wcsRefreshWanted = false;
+uint32_t FluidNCClient::wcsRefreshSentMs = 0;
+
+// $# line tags in WCSSlot order
+static const char* WCS_SLOT_TAGS[WCS_SLOT_COUNT] = {"G54", "G55", "G56", "G57", "G58", "G59", "G28", "G30", "G92", "TLO"};
+
+// True if a command changes the work offsets: G10, G92.x, G43.1 or G49 words
+static bool changesWorkOffsets(const char* command) {
+    if (command[0] == '$') return false;
+    for (const char* p = command; *p; p++) {
+        if (*p == '(') {
+            // Skip comments
+            const char* end = strchr(p, ')');
+            if (!end) return false;
+            p = end;
+            continue;
+        }
+        if (*p == ';') return false;
+        if (*p != 'G' && *p != 'g') continue;
+        const char* n = p + 1;
+        float code;
+        if (!gcodeReadNumber(n, code)) continue;
+        int g10 = (int)lroundf(code * 10.0f);
+        if (g10 == 100 || g10 == 431 || g10 == 490 || (g10 >= 920 && g10 <= 923)) return true;
+    }
+    return false;
+}
 
 void FluidNCClient::init() {
     if (initialized) return;
@@ -29,7 +63,7 @@ void FluidNCClient::init() {
     initialized = true;
 }
 
-bool FluidNCClient::connect(const MachineConfig &config) {
+bool FluidNCClient::connect(const MachineConfig &config, const char *host) {
     if (!initialized) {
         Serial.println("[FluidNC] Error: Client not initialized");
         return false;
@@ -38,66 +72,31 @@ bool FluidNCClient::connect(const MachineConfig &config) {
     // Store config
     currentConfig = config;
     
+    // Offsets belong to the machine - fetched again once connected
+    resetWCSTable();
+    
     // Check WiFi connection first
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("[FluidNC] Error: WiFi not connected");
         return false;
     }
     
-    Serial.printf("[FluidNC] Connecting to %s:%d via WebSocket\n", 
-                  config.fluidnc_url, config.websocket_port);
-    
-    // Resolve hostname if needed (mDNS support)
-    String resolvedHost = String(config.fluidnc_url);
-    IPAddress serverIP;
-    if (resolvedHost.indexOf('.') == -1 || resolvedHost.endsWith(".local")) {
-        // It's a hostname or mDNS name, try to resolve it
-        Serial.printf("[FluidNC] Resolving hostname: %s\n", resolvedHost.c_str());
-        
-        // Try resolving with retries (mDNS can be slow to respond)
-        bool resolved = false;
-        for (int attempt = 0; attempt < 5 && !resolved; attempt++) {
-            if (attempt > 0) {
-                Serial.printf("[FluidNC] Retry attempt %d/5...\n", attempt + 1);
-                delay(1000);  // Longer delay between retries for mDNS
-            }
-            
-            if (resolvedHost.endsWith(".local")) {
-                // Use MDNS.queryHost() for .local hostnames (strip the .local suffix)
-                String hostname = resolvedHost.substring(0, resolvedHost.length() - 6);
-                Serial.printf("[FluidNC] Using mDNS query for: %s\n", hostname.c_str());
-                serverIP = MDNS.queryHost(hostname);
-            } else {
-                // Use standard DNS for non-.local hostnames
-                WiFi.hostByName(resolvedHost.c_str(), serverIP);
-            }
-            
-            // Validate that we got a real IP address (not 0.0.0.0)
-            if (serverIP != IPAddress(0, 0, 0, 0)) {
-                Serial.printf("[FluidNC] Resolved on attempt %d to IP: %s\n", attempt + 1, serverIP.toString().c_str());
-                resolved = true;
-            } else {
-                Serial.printf("[FluidNC] Attempt %d returned invalid IP (0.0.0.0)\n", attempt + 1);
-            }
-        }
-        
-        if (!resolved) {
-            Serial.printf("[FluidNC] Failed to resolve hostname: %s after 5 attempts\n", resolvedHost.c_str());
-            Serial.println("[FluidNC] Tip: Try using the IP address instead, or check that mDNS is working on your network");
-            return false;
-        }
-        resolvedHost = serverIP.toString();
-        Serial.printf("[FluidNC] Using resolved IP: %s\n", resolvedHost.c_str());
+    // Hostname resolution (mDNS/DNS) is done asynchronously by ConnectionManager beforehand
+    if (!host || host[0] == '\0') {
+        host = config.fluidnc_url;
     }
     
+    Serial.printf("[FluidNC] Connecting to %s:%d via WebSocket (host %s)\n", 
+                  config.fluidnc_url, config.websocket_port, host);
+    
     // Set up event callbacks
-    webSocket.onMessage(onMessageCallback);
-    webSocket.onEvent(onEventsCallback);
+    webSocket->onMessage(onMessageCallback);
+    webSocket->onEvent(onEventsCallback);
     
-    // Connect to WebSocket (ws://hostname:port/)
+    // Connect to WebSocket (ws://ip:port/) - the TCP connect times out after CONN_TCP_CONNECT_TIMEOUT_MS
     char wsUrl[128];
-    snprintf(wsUrl, sizeof(wsUrl), "ws://%s:%d/", resolvedHost.c_str(), config.websocket_port);
-    bool connected = webSocket.connect(wsUrl);
+    snprintf(wsUrl, sizeof(wsUrl), "ws://%s:%d/", host, config.websocket_port);
+    bool connected = webSocket->connect(wsUrl);
     
     if (!connected) {
         Serial.println("[FluidNC] Initial connection failed");
@@ -113,8 +112,8 @@ bool FluidNCClient::connect(const MachineConfig &config) {
 
 void FluidNCClient::disconnect() {
     Serial.println("[FluidNC] Disconnecting");
-    if (webSocket.available()) {
-        webSocket.close();
+    if (webSocket->available()) {
+        webSocket->close();
     }
     currentStatus.is_connected = false;
     currentStatus.state = STATE_DISCONNECTED;
@@ -124,32 +123,77 @@ void FluidNCClient::stopReconnectionAttempts() {
     Serial.println("[FluidNC] Stopping reconnection attempts");
     // Don't call close() if we're already handling a disconnect event
     // This prevents re-entrant calls that cause stack overflow
-    if (!isHandlingDisconnect && webSocket.available()) {
-        webSocket.close();
+    if (!isHandlingDisconnect && webSocket->available()) {
+        webSocket->close();
     }
     currentStatus.is_connected = false;
     currentStatus.state = STATE_DISCONNECTED;
 }
 
+void FluidNCClient::exchangeConnection(WebsocketsClient *&socket, FluidNCStatus &status, MachineConfig &config) {
+    // The caller's open socket becomes the focused connection and gets our old one back
+    WebsocketsClient *previous_socket = webSocket;
+    webSocket = socket;
+    socket = previous_socket;
+    
+    FluidNCStatus previous_status = currentStatus;
+    currentStatus = status;
+    status = previous_status;
+    
+    MachineConfig previous_config = currentConfig;
+    currentConfig = config;
+    config = previous_config;
+    
+    Serial.printf("[FluidNC] Focused connection is now %s (no reconnect)\n", currentConfig.name);
+    resetWCSTable();
+    wcsRefreshWanted = true;
+    webSocket->onMessage(onMessageCallback);
+    webSocket->onEvent(onEventsCallback);
+    everConnectedSuccessfully = true;
+    
+    // Same handshake as a fresh connection, at the focused report rate
+    lastPollingMs = millis() - 1000;
+    lastGCodePollMs = millis() - 10000;
+    attemptEnableAutoReporting();
+    webSocket->send("?");
+    sendInternal("$G\n");
+    sendInternal("$Build/Info\n");
+}
+
 bool FluidNCClient::isConnected() {
-    return currentStatus.is_connected && webSocket.available();
+    return currentStatus.is_connected && webSocket->available();
 }
 
 bool FluidNCClient::isAutoReporting() {
     return autoReportingEnabled;
 }
 
+void FluidNCClient::setReportInterval(uint16_t interval_ms) {
+    if (interval_ms == reportIntervalMs) return;
+    reportIntervalMs = interval_ms;
+    
+    // Not yet negotiated - the new value goes out with the next auto-report attempt
+    if (!autoReportingEnabled || !webSocket->available()) return;
+    
+    char cmd[32];
+    snprintf(cmd, sizeof(cmd), "$Report/Interval=%u\n", reportIntervalMs);
+    Serial.printf("[FluidNC] Auto-report interval -> %ums\n", reportIntervalMs);
+    sendInternal(cmd);
+}
+
 void FluidNCClient::loop() {
     if (!initialized) return;
     
     // Handle WebSocket events - ArduinoWebsockets handles polling internally
-    webSocket.poll();
+    webSocket->poll();
     
     // Only check auto-reporting and polling if WebSocket is connected
-    if (!webSocket.available()) {
+    if (!webSocket->available()) {
         return;
     }
     
+    checkWCSRefresh();
+    
     // Check if auto-reporting timed out (no status received within 2 seconds of attempt)
     if (autoReportingAttempted && !autoReportingEnabled) {
         uint32_t now = millis();
@@ -183,14 +227,26 @@ void FluidNCClient::sendCommand(const char* command) {
     }
     
     Serial.printf("[FluidNC] Sending command: %s\n", command);
-    webSocket.send(command);
+    GCodeSender::onCommandSent(command);
+    ProbeSequencer::onCommandSent(command);
+    webSocket->send(command);
+    
+    if (changesWorkOffsets(command)) {
+        requestWCSRefresh();
+    }
+}
+
+void FluidNCClient::sendStreamData(const char* data) {
+    // Lines from GCodeSender - already accounted for, and too many to log
+    if (!currentStatus.is_connected) return;
+    webSocket->send(data);
 }
 
 void FluidNCClient::requestStatusReport() {
     if (!currentStatus.is_connected) return;
     
     // Send status query command (realtime command)
-    webSocket.send("?");
+    webSocket->send("?");
 }
 
 String FluidNCClient::getMachineIP() {
@@ -254,6 +310,12 @@ void FluidNCClient::onMessageCallback(WebsocketsMessage message) {
         messageCallback(payload);
     }
     
+    // Responses (ok/error) pace the G-code stream and probe routines
+    if (payload[0] != '<') {
+        GCodeSender::onResponse(payload);
+        ProbeSequencer::onResponse(payload);
+    }
+    
     // Call terminal callback if registered (for terminal display)
     // Terminal tab will filter out status messages (starting with '<')
     if (terminalCallback) {
@@ -289,11 +351,19 @@ void FluidNCClient::onEventsCallback(WebsocketsEvent event, String data) {
             lastPollingMs = millis() - 1000;
             lastGCodePollMs = millis() - 10000;
             
-            // Attempt to enable automatic status reporting
+            // Attempt to enable automatic status reporting (replayed on every reconnect)
             attemptEnableAutoReporting();
             
+            // Ask for a status report and parser state right away so the UI repopulates
+            // without waiting for the first auto-report interval
+            webSocket->send("?");
+            sendInternal("$G\n");
+            
             // Request firmware version info
-            webSocket.send("$Build/Info\n");
+            sendInternal("$Build/Info\n");
+            
+            // Work offsets as soon as the machine is idle
+            wcsRefreshWanted = true;
             break;
             
         case WebsocketsEvent::ConnectionClosed:
@@ -302,20 +372,15 @@ void FluidNCClient::onEventsCallback(WebsocketsEvent event, String data) {
             // Set flag to prevent re-entrant close() calls
             isHandlingDisconnect = true;
             
-            // Only show popup if we've ever successfully received a status report
-            if (everConnectedSuccessfully) {
-                // Build error message
-                char error_msg[256];
-                snprintf(error_msg, sizeof(error_msg), 
-                        "Lost connection to machine.\n\nCheck network connection and\nmachine power, then restart.");
-                
-                // Show error dialog
-                UICommon::showConnectionErrorDialog("Machine Disconnected", error_msg);
-            }
-            
             currentStatus.is_connected = false;
             currentStatus.state = STATE_DISCONNECTED;
             
+            // Only recover if we've ever successfully received a status report
+            // (ConnectionManager shows the error dialog if reconnecting gives up)
+            if (everConnectedSuccessfully) {
+                ConnectionManager::onConnectionLost();
+            }
+            
             // Clear flag after handling disconnect
             isHandlingDisconnect = false;
             break;
@@ -374,8 +439,53 @@ void FluidNCClient::parseStatusReport(const char* message) {
     
     // Track previous state for state change detection
     static MachineState previousState = STATE_DISCONNECTED;
+    bool has_sd = parseStatusFields(message, currentStatus);
     MachineState newState = currentStatus.state;
     
+    // Detect state change to IDLE from HOLD or RUN - retry auto-reporting (not between
+    // the lines of a stream or the steps of a probe routine)
+    if (newState == STATE_IDLE && (previousState == STATE_HOLD || previousState == STATE_RUN)) {
+        if (!autoReportingEnabled && !GCodeSender::isActive() && !ProbeSequencer::isRunning()) {
+            Serial.println("[FluidNC] Machine returned to IDLE - retrying auto-reporting");
+            attemptEnableAutoReporting();
+        }
+    }
+    previousState = newState;
+    
+    if (has_sd) {
+        Serial.printf("[FluidNC] SD Progress: %.1f%% - %s (Elapsed: %lums)\n",
+                      currentStatus.sd_percent, currentStatus.sd_filename, currentStatus.sd_elapsed_ms);
+    } else if (GCodeSender::isActive()) {
+        // Streaming from the Display SD - report it like an SD job so the status bar and ETA follow it
+        currentStatus.is_sd_printing = true;
+        currentStatus.sd_percent = GCodeSender::getPercent();
+        strncpy(currentStatus.sd_filename, GCodeSender::getPath(), sizeof(currentStatus.sd_filename) - 1);
+        currentStatus.sd_filename[sizeof(currentStatus.sd_filename) - 1] = '\0';
+        if (currentStatus.sd_start_time_ms == 0) {
+            currentStatus.sd_start_time_ms = millis();
+        }
+        currentStatus.sd_elapsed_ms = millis() - currentStatus.sd_start_time_ms;
+    } else {
+        // No SD: field means not printing from SD
+        if (currentStatus.is_sd_printing) {
+            Serial.println("[FluidNC] SD file completed or stopped");
+            requestWCSRefresh();  // The file may have changed offsets
+        }
+        clearSDProgress(currentStatus);
+    }
+    
+    // Parse modal states (Pn:, WCO:, etc.)
+    // Note: Full parser state might come in separate $G response
+    
+    Serial.printf("[FluidNC] Status: State=%d, MPos=(%.3f,%.3f,%.3f,%.3f), WPos=(%.3f,%.3f,%.3f,%.3f)\n",
+                  currentStatus.state,
+                  currentStatus.mpos_x, currentStatus.mpos_y, currentStatus.mpos_z, currentStatus.mpos_a,
+                  currentStatus.wpos_x, currentStatus.wpos_y, currentStatus.wpos_z, currentStatus.wpos_a);
+}
+
+bool FluidNCClient::parseStatusFields(const char* message, FluidNCStatus &status) {
+    MachineState newState = status.state;
+    
     // Parse machine state
     if (strstr(message, "<Idle")) {
         newState = STATE_IDLE;
@@ -397,28 +507,18 @@ void FluidNCClient::parseStatusReport(const char* message) {
         newState = STATE_SLEEP;
     }
     
-    // Detect state change to IDLE from HOLD or RUN - retry auto-reporting
-    if (newState == STATE_IDLE && (previousState == STATE_HOLD || previousState == STATE_RUN)) {
-        if (!autoReportingEnabled) {
-            Serial.println("[FluidNC] Machine returned to IDLE - retrying auto-reporting");
-            attemptEnableAutoReporting();
-        }
-    }
-    
-    // Update state and track for next comparison
-    currentStatus.state = newState;
-    previousState = newState;
+    status.state = newState;
     
     // Parse machine position (MPos:x,y,z,a)
     const char* mpos = strstr(message, "MPos:");
     if (mpos) {
         // Try parsing 4 values (X,Y,Z,A), but allow 3 values (X,Y,Z) for machines without A-axis
         int parsed = sscanf(mpos + 5, "%f,%f,%f,%f",
-                           &currentStatus.mpos_x, &currentStatus.mpos_y,
-                           &currentStatus.mpos_z, &currentStatus.mpos_a);
+                           &status.mpos_x, &status.mpos_y,
+                           &status.mpos_z, &status.mpos_a);
         if (parsed == 3) {
             // Only 3 axes parsed - machine doesn't have A-axis, set to 0
-            currentStatus.mpos_a = 0.0f;
+            status.mpos_a = 0.0f;
         }
     }
     
@@ -427,68 +527,62 @@ void FluidNCClient::parseStatusReport(const char* message) {
     if (wco) {
         // Try parsing 4 values (X,Y,Z,A), but allow 3 values (X,Y,Z) for machines without A-axis
         int parsed = sscanf(wco + 4, "%f,%f,%f,%f",
-                           &currentStatus.wco_x, &currentStatus.wco_y,
-                           &currentStatus.wco_z, &currentStatus.wco_a);
+                           &status.wco_x, &status.wco_y,
+                           &status.wco_z, &status.wco_a);
         if (parsed == 3) {
             // Only 3 axes parsed - machine doesn't have A-axis, set to 0
-            currentStatus.wco_a = 0.0f;
+            status.wco_a = 0.0f;
         }
-        Serial.printf("[FluidNC] WCO updated: (%.3f,%.3f,%.3f,%.3f)\n",
-                      currentStatus.wco_x, currentStatus.wco_y, currentStatus.wco_z, currentStatus.wco_a);
     }
     
     // Calculate work position: WPos = MPos - WCO
     // FluidNC typically only sends MPos in every status report, but includes WCO periodically
-    currentStatus.wpos_x = currentStatus.mpos_x - currentStatus.wco_x;
-    currentStatus.wpos_y = currentStatus.mpos_y - currentStatus.wco_y;
-    currentStatus.wpos_z = currentStatus.mpos_z - currentStatus.wco_z;
-    currentStatus.wpos_a = currentStatus.mpos_a - currentStatus.wco_a;
+    status.wpos_x = status.mpos_x - status.wco_x;
+    status.wpos_y = status.mpos_y - status.wco_y;
+    status.wpos_z = status.mpos_z - status.wco_z;
+    status.wpos_a = status.mpos_a - status.wco_a;
     
     // Parse work position directly (WPos:x,y,z,a) - rarely sent, but handle it
     const char* wpos = strstr(message, "WPos:");
     if (wpos) {
         // Try parsing 4 values (X,Y,Z,A), but allow 3 values (X,Y,Z) for machines without A-axis
         int parsed = sscanf(wpos + 5, "%f,%f,%f,%f",
-                           &currentStatus.wpos_x, &currentStatus.wpos_y,
-                           &currentStatus.wpos_z, &currentStatus.wpos_a);
+                           &status.wpos_x, &status.wpos_y,
+                           &status.wpos_z, &status.wpos_a);
         if (parsed == 3) {
             // Only 3 axes parsed - machine doesn't have A-axis, set to 0
-            currentStatus.wpos_a = 0.0f;
+            status.wpos_a = 0.0f;
         }
     }
     
     // Parse feed and spindle (FS:feed,spindle)
     const char* fs = strstr(message, "FS:");
     if (fs) {
-        sscanf(fs + 3, "%f,%f", &currentStatus.feed_rate, &currentStatus.spindle_speed);
-        Serial.printf("[FluidNC] Parsed FS: feed=%.0f, spindle=%.0f\n", 
-                      currentStatus.feed_rate, currentStatus.spindle_speed);
+        sscanf(fs + 3, "%f,%f", &status.feed_rate, &status.spindle_speed);
     }
     
     // Parse overrides (Ov:feed,rapid,spindle)
     const char* ov = strstr(message, "Ov:");
     if (ov) {
-        sscanf(ov + 3, "%f,%f,%f", &currentStatus.feed_override, &currentStatus.rapid_override, &currentStatus.spindle_override);
-        Serial.printf("[FluidNC] Parsed Ov: feed=%.0f%%, rapid=%.0f%%, spindle=%.0f%%\n", 
-                      currentStatus.feed_override, currentStatus.rapid_override, currentStatus.spindle_override);
+        sscanf(ov + 3, "%f,%f,%f", &status.feed_override, &status.rapid_override, &status.spindle_override);
     }
 
     // Parse pin states (Pn:XYZA P) - field only present when pins are active
-    currentStatus.pin_limit_x = false;
-    currentStatus.pin_limit_y = false;
-    currentStatus.pin_limit_z = false;
-    currentStatus.pin_limit_a = false;
-    currentStatus.pin_probe   = false;
+    status.pin_limit_x = false;
+    status.pin_limit_y = false;
+    status.pin_limit_z = false;
+    status.pin_limit_a = false;
+    status.pin_probe   = false;
     const char* pn = strstr(message, "Pn:");
     if (pn) {
         const char* p = pn + 3;
         while (*p && *p != '|' && *p != '>') {
             switch (*p) {
-                case 'X': currentStatus.pin_limit_x = true; break;
-                case 'Y': currentStatus.pin_limit_y = true; break;
-                case 'Z': currentStatus.pin_limit_z = true; break;
-                case 'A': currentStatus.pin_limit_a = true; break;
-                case 'P': currentStatus.pin_probe   = true; break;
+                case 'X': status.pin_limit_x = true; break;
+                case 'Y': status.pin_limit_y = true; break;
+                case 'Z': status.pin_limit_z = true; break;
+                case 'A': status.pin_limit_a = true; break;
+                case 'P': status.pin_probe   = true; break;
             }
             p++;
         }
@@ -496,72 +590,57 @@ void FluidNCClient::parseStatusReport(const char* message) {
     
     // Parse SD card file progress (SD:percent,filename)
     const char* sd = strstr(message, "SD:");
-    if (sd) {
-        // Extract percent and filename
-        float percent = 0;
-        char filename_buf[128] = {0};
-        
-        // Parse: SD:12.5,filename.gcode or SD:100.0,file.nc
-        const char* comma = strchr(sd + 3, ',');
-        if (comma) {
-            sscanf(sd + 3, "%f", &percent);
-            strncpy(filename_buf, comma + 1, sizeof(filename_buf) - 1);
-            
-            // Remove any trailing > or whitespace
-            char* end = strchr(filename_buf, '>');
-            if (end) *end = '\0';
-            end = strchr(filename_buf, '|');
-            if (end) *end = '\0';
-            
-            // Update status
-            currentStatus.is_sd_printing = true;
-            currentStatus.sd_percent = percent;
-            strncpy(currentStatus.sd_filename, filename_buf, sizeof(currentStatus.sd_filename) - 1);
-            currentStatus.sd_filename[sizeof(currentStatus.sd_filename) - 1] = '\0';
-            
-            // Track start time and calculate elapsed time
-            if (currentStatus.sd_start_time_ms == 0) {
-                currentStatus.sd_start_time_ms = millis();
-            }
-            currentStatus.sd_elapsed_ms = millis() - currentStatus.sd_start_time_ms;
-            
-            Serial.printf("[FluidNC] SD Progress: %.1f%% - %s (Elapsed: %lums)\n",
-                          percent, currentStatus.sd_filename, currentStatus.sd_elapsed_ms);
-        }
-    } else {
-        // No SD: field means not printing from SD
-        if (currentStatus.is_sd_printing) {
-            Serial.println("[FluidNC] SD file completed or stopped");
-        }
-        currentStatus.is_sd_printing = false;
-        currentStatus.sd_percent = 0;
-        currentStatus.sd_start_time_ms = 0;
-        currentStatus.sd_elapsed_ms = 0;
-        currentStatus.sd_filename[0] = '\0';
-    }
+    if (!sd) return false;
     
-    // Parse modal states (Pn:, WCO:, etc.)
-    // Note: Full parser state might come in separate $G response
+    // Parse: SD:12.5,filename.gcode or SD:100.0,file.nc
+    const char* comma = strchr(sd + 3, ',');
+    if (!comma) return false;
     
-    Serial.printf("[FluidNC] Status: State=%d, MPos=(%.3f,%.3f,%.3f,%.3f), WPos=(%.3f,%.3f,%.3f,%.3f)\n",
-                  currentStatus.state,
-                  currentStatus.mpos_x, currentStatus.mpos_y, currentStatus.mpos_z, currentStatus.mpos_a,
-                  currentStatus.wpos_x, currentStatus.wpos_y, currentStatus.wpos_z, currentStatus.wpos_a);
+    float percent = 0;
+    char filename_buf[128] = {0};
+    sscanf(sd + 3, "%f", &percent);
+    strncpy(filename_buf, comma + 1, sizeof(filename_buf) - 1);
+    
+    // Remove any trailing > or whitespace
+    char* end = strchr(filename_buf, '>');
+    if (end) *end = '\0';
+    end = strchr(filename_buf, '|');
+    if (end) *end = '\0';
+    
+    status.is_sd_printing = true;
+    status.sd_percent = percent;
+    strncpy(status.sd_filename, filename_buf, sizeof(status.sd_filename) - 1);
+    status.sd_filename[sizeof(status.sd_filename) - 1] = '\0';
+    
+    // Track start time and calculate elapsed time
+    if (status.sd_start_time_ms == 0) {
+        status.sd_start_time_ms = millis();
+    }
+    status.sd_elapsed_ms = millis() - status.sd_start_time_ms;
+    return true;
+}
+
+void FluidNCClient::clearSDProgress(FluidNCStatus &status) {
+    status.is_sd_printing = false;
+    status.sd_percent = 0;
+    status.sd_start_time_ms = 0;
+    status.sd_elapsed_ms = 0;
+    status.sd_filename[0] = '\0';
 }
 
 void FluidNCClient::parseRealtimeFeedback(const char* message) {
     // Handle realtime feedback messages like [MSG:...], [G92:...], [PRB:...], etc.
     Serial.printf("[FluidNC] Feedback: %s\n", message);
     
+    if (parseWCSOffsets(message)) return;
+    
     // Check for probe result message: [PRB:x,y,z:success]
     // Example: [PRB:151.000,149.000,-137.505:1] (success=1) or [PRB:0.000,0.000,0.000:0] (failure=0)
     if (strncmp(message, "[PRB:", 5) == 0) {
         float x, y, z;
         int success;
         if (sscanf(message + 5, "%f,%f,%f:%d", &x, &y, &z, &success) == 4) {
-            // Update probe tab result display with coordinates
-            UITabControlProbe::updateResult(x, y, z, success != 0);
-            
+            // Recorded (and shown on the probe tab) by ProbeSequencer::onResponse()
             Serial.printf("[FluidNC] Probe %s at (%.3f, %.3f, %.3f)\n", 
                          success ? "SUCCESS" : "FAILED", x, y, z);
         }
@@ -640,94 +719,102 @@ void FluidNCClient::parseRealtimeFeedback(const char* message) {
     }
 }
 
-void FluidNCClient::parseGCodeState(const char* message) {
-    // Example: [GC:G0 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]
-    // Parse modal states from GCode parser state report
+void FluidNCClient::requestWCSRefresh() {
+    wcsRefreshWanted = true;
+}
+
+void FluidNCClient::resetWCSTable() {
+    wcsTable.valid = 0;
+    wcsTable.revision++;
+    wcsRefreshWanted = false;
+    wcsRefreshSentMs = 0;
+}
+
+void FluidNCClient::checkWCSRefresh() {
+    uint32_t now = millis();
+    if (wcsRefreshSentMs != 0) {
+        if (now - wcsRefreshSentMs < WCS_REFRESH_TIMEOUT_MS) return;
+        Serial.println("[FluidNC] $# response incomplete - retrying");
+        wcsRefreshSentMs = 0;
+        wcsRefreshWanted = true;
+    }
+    if (!wcsRefreshWanted || !currentStatus.is_connected) return;
     
-    Serial.printf("[FluidNC] GCode State: %s\n", message);
+    // $# is answered between motions only - wait for streams and probe routines to finish
+    if (currentStatus.state != STATE_IDLE && currentStatus.state != STATE_ALARM) return;
+    if (GCodeSender::isActive() || ProbeSequencer::isRunning()) return;
     
-    // Extract modal values by searching for specific patterns
-    const char* ptr = message + 4;  // Skip "[GC:"
-    
-    // Parse motion mode (G0, G1, G2, G3, G38.2, G38.3, G38.4, G38.5, G80)
-    if (const char* g0 = strstr(ptr, "G0 ")) strcpy(currentStatus.modal_motion, "G0");
-    else if (const char* g1 = strstr(ptr, "G1 ")) strcpy(currentStatus.modal_motion, "G1");
-    else if (const char* g2 = strstr(ptr, "G2 ")) strcpy(currentStatus.modal_motion, "G2");
-    else if (const char* g3 = strstr(ptr, "G3 ")) strcpy(currentStatus.modal_motion, "G3");
-    else if (const char* g80 = strstr(ptr, "G80")) strcpy(currentStatus.modal_motion, "G80");
-    
-    // Parse work coordinate system (G54-G59)
-    if (strstr(ptr, "G54")) strcpy(currentStatus.modal_wcs, "G54");
-    else if (strstr(ptr, "G55")) strcpy(currentStatus.modal_wcs, "G55");
-    else if (strstr(ptr, "G56")) strcpy(currentStatus.modal_wcs, "G56");
-    else if (strstr(ptr, "G57")) strcpy(currentStatus.modal_wcs, "G57");
-    else if (strstr(ptr, "G58")) strcpy(currentStatus.modal_wcs, "G58");
-    else if (strstr(ptr, "G59")) strcpy(currentStatus.modal_wcs, "G59");
-    
-    // Parse plane (G17, G18, G19)
-    if (strstr(ptr, "G17")) strcpy(currentStatus.modal_plane, "G17");
-    else if (strstr(ptr, "G18")) strcpy(currentStatus.modal_plane, "G18");
-    else if (strstr(ptr, "G19")) strcpy(currentStatus.modal_plane, "G19");
-    
-    // Parse units (G20=inches, G21=mm)
-    if (strstr(ptr, "G20")) strcpy(currentStatus.modal_units, "G20");
-    else if (strstr(ptr, "G21")) strcpy(currentStatus.modal_units, "G21");
-    
-    // Parse distance mode (G90=absolute, G91=incremental)
-    if (strstr(ptr, "G90")) strcpy(currentStatus.modal_distance, "G90");
-    else if (strstr(ptr, "G91")) strcpy(currentStatus.modal_distance, "G91");
-    
-    // Parse spindle state (M3=CW, M4=CCW, M5=off)
-    if (strstr(ptr, "M3 ")) strcpy(currentStatus.modal_spindle, "M3");
-    else if (strstr(ptr, "M4 ")) strcpy(currentStatus.modal_spindle, "M4");
-    else if (strstr(ptr, "M5")) strcpy(currentStatus.modal_spindle, "M5");
-    
-    // Parse coolant state (M7=mist, M8=flood, M9=off; both M7 and M8 can be active simultaneously)
-    bool hasMist = strstr(ptr, "M7 ") != nullptr;
-    bool hasFlood = strstr(ptr, "M8 ") != nullptr;
-    if (hasMist && hasFlood) strcpy(currentStatus.modal_coolant, "M7 M8");
-    else if (hasMist) strcpy(currentStatus.modal_coolant, "M7");
-    else if (hasFlood) strcpy(currentStatus.modal_coolant, "M8");
-    else if (strstr(ptr, "M9")) strcpy(currentStatus.modal_coolant, "M9");
-    
-    // Parse tool number (T0, T1, etc.)
-    const char* tool = strstr(ptr, " T");
-    if (tool) {
-        int toolNum;
-        if (sscanf(tool, " T%d", &toolNum) == 1) {
-            snprintf(currentStatus.modal_tool, sizeof(currentStatus.modal_tool), "T%d", toolNum);
-        }
+    wcsRefreshWanted = false;
+    wcsRefreshSentMs = now ? now : 1;
+    sendInternal("$#\n");
+}
+
+bool FluidNCClient::parseWCSOffsets(const char* message) {
+    // Example: [G54:90.000,0.000,0.000] or [G54:90.000,0.000,0.000,0.000] with an A axis, [TLO:0.000]
+    if (message[0] != '[' || message[4] != ':') return false;
+    
+    // [PRB:...] is the last line of the $# report - it repeats the previous probe result
+    if (strncmp(message + 1, "PRB", 3) == 0) {
+        if (wcsRefreshSentMs == 0) return false;
+        wcsRefreshSentMs = 0;
+        return true;
     }
     
-    // Parse feed rate (F) - programmed feed rate in mm/min
-    const char* feed = strstr(ptr, " F");
-    if (feed) {
-        float feedValue;
-        if (sscanf(feed, " F%f", &feedValue) == 1) {
-            // Only update if not already set by status report
-            if (currentStatus.feed_rate == 0.0f) {
-                currentStatus.feed_rate = feedValue;
-            }
+    int slot = -1;
+    for (int i = 0; i < WCS_SLOT_COUNT; i++) {
+        if (strncmp(message + 1, WCS_SLOT_TAGS[i], 3) == 0) {
+            slot = i;
+            break;
         }
     }
+    if (slot < 0) return false;
     
-    // Parse spindle speed (S) - programmed spindle speed in RPM
-    const char* spindle = strstr(ptr, " S");
-    if (spindle) {
-        float spindleValue;
-        if (sscanf(spindle, " S%f", &spindleValue) == 1) {
-            // Only update if not already set by status report
-            if (currentStatus.spindle_speed == 0.0f) {
-                currentStatus.spindle_speed = spindleValue;
-            }
-        }
+    float values[4] = {0, 0, 0, 0};
+    const char* p = message + 5;
+    int count = 0;
+    while (count < 4) {
+        char* end;
+        float v = strtof(p, &end);
+        if (end == p) break;
+        values[count++] = v;
+        if (*end != ',') break;
+        p = end + 1;
+    }
+    if (count == 0) return true;
+    if (slot == WCS_SLOT_TLO) {
+        values[2] = values[0];
+        values[0] = 0.0f;
     }
     
-    Serial.printf("[FluidNC] Parsed modals: Motion=%s, WCS=%s, Plane=%s, Units=%s, Distance=%s, Spindle=%s, Coolant=%s, Tool=%s, Feed=%.0f, SpindleSpeed=%.0f\n",
-                  currentStatus.modal_motion, currentStatus.modal_wcs, currentStatus.modal_plane,
-                  currentStatus.modal_units, currentStatus.modal_distance, currentStatus.modal_spindle,
-                  currentStatus.modal_coolant, currentStatus.modal_tool,
-                  currentStatus.feed_rate, currentStatus.spindle_speed);
+    float *dest = wcsTable.offsets[slot];
+    if (!wcsTable.has(slot) || memcmp(dest, values, sizeof(values)) != 0) {
+        memcpy(dest, values, sizeof(values));
+        wcsTable.valid |= 1 << slot;
+        wcsTable.revision++;
+    }
+    wcsTable.updated_ms = millis();
+    return true;
+}
+
+void FluidNCClient::parseGCodeState(const char* message) {
+    // Example: [GC:G0 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]
+    Serial.printf("[FluidNC] GCode State: %s\n", message);
+    
+    GCodeModal &modal = currentStatus.modal;
+    if (!modal.parse(message)) return;
+    
+    // Programmed feed rate and spindle speed - only used until the status report has them
+    if (currentStatus.feed_rate == 0.0f) {
+        currentStatus.feed_rate = modal.feed;
+    }
+    if (currentStatus.spindle_speed == 0.0f) {
+        currentStatus.spindle_speed = modal.speed;
+    }
+    
+    Serial.printf("[FluidNC] Parsed modals: Motion=%s, WCS=%s, Plane=%s, Units=%s, Distance=%s, Spindle=%s, Coolant=%s, Tool=T%u, Feed=%.0f, SpindleSpeed=%.0f\n",
+                  modal.motionName(), modal.wcsName(), modal.planeName(), modal.unitsName(),
+                  modal.distanceName(), modal.spindleName(), modal.coolantName(), modal.tool,
+                  modal.feed, modal.speed);
 }
 
 float FluidNCClient::extractFloat(const char* str, const char* key) {
@@ -757,14 +844,27 @@ void FluidNCClient::extractString(const char* str, const char* key, char* dest,
 }
 
 void FluidNCClient::attemptEnableAutoReporting() {
-    Serial.println("[FluidNC] Attempting to enable automatic reporting (250ms)");
-    webSocket.send("$Report/Interval=250\n");
+    // A paused interval would look like a failed attempt - start from the default rate
+    if (reportIntervalMs == 0) {
+        reportIntervalMs = REPORT_INTERVAL_DEFAULT_MS;
+    }
+    
+    char cmd[32];
+    snprintf(cmd, sizeof(cmd), "$Report/Interval=%u\n", reportIntervalMs);
+    Serial.printf("[FluidNC] Attempting to enable automatic reporting (%ums)\n", reportIntervalMs);
+    sendInternal(cmd);
     
     autoReportingAttempted = true;
     autoReportingEnabled = false;  // Will be set true when we receive status
     lastAutoReportAttemptMs = millis();
 }
 
+void FluidNCClient::sendInternal(const char* line) {
+    GCodeSender::onCommandSent(line);
+    ProbeSequencer::onCommandSent(line);
+    webSocket->send(line);
+}
+
 void FluidNCClient::performFallbackPolling() {
     // If auto-reporting is enabled, no need to poll
     if (autoReportingEnabled) {
@@ -776,14 +876,14 @@ void FluidNCClient::performFallbackPolling() {
     // Send status poll ("?") every 1 second
     if (now - lastPollingMs >= 1000) {
         Serial.println("[FluidNC] Fallback polling: sending '?'");
-        webSocket.send("?");
+        webSocket->send("?");
         lastPollingMs = now;
     }
     
     // Send GCode parser state poll ("$G") every 10 seconds
     if (now - lastGCodePollMs >= 10000) {
         Serial.println("[FluidNC] Fallback polling: sending '$G'");
-        webSocket.send("$G\n");
+        sendInternal("$G\n");
         lastGCodePollMs = now;
     }
 }
@@ -0,0 +1,322 @@
+#include "network/gcode_sender.h"
+#include "network/fluidnc_client.h"
+#include "network/probe_sequencer.h"
+#include "ui/upload_manager.h"
+#include "ui/height_map_store.h"
+#include "gcode/gcode_leveler.h"
+#include "core/sd_card.h"
+#include "config.h"
+
+// Static member initialization
+GCodeSender::State GCodeSender::state = GCodeSender::State::IDLE;
+char GCodeSender::path[128] = "";
+char GCodeSender::error[64] = "";
+uint32_t GCodeSender::file_size = 0;
+uint32_t GCodeSender::acked_offset = 0;
+bool GCodeSender::eof = false;
+GCodeSender::InFlight GCodeSender::in_flight[MAX_IN_FLIGHT];
+int GCodeSender::in_flight_head = 0;
+int GCodeSender::in_flight_count = 0;
+uint32_t GCodeSender::in_flight_chars = 0;
+char GCodeSender::next_line[256] = "";
+uint16_t GCodeSender::next_len = 0;
+uint32_t GCodeSender::next_end_offset = 0;
+uint32_t GCodeSender::rate_window_ms = 0;
+uint32_t GCodeSender::rate_window_lines = 0;
+float GCodeSender::lines_per_sec = 0.0f;
+bool GCodeSender::leveling = false;
+uint32_t GCodeSender::lines_acked = 0;
+uint32_t GCodeSender::fill_samples = 0;
+uint64_t GCodeSender::fill_sum = 0;
+uint16_t GCodeSender::pending_responses = 0;
+uint32_t GCodeSender::pending_since_ms = 0;
+
+static SDReader reader;
+static GCodeLeveler leveler;
+static char read_buf[2048];
+static uint16_t read_pos = 0;
+static uint16_t read_len = 0;
+static uint32_t read_offset = 0;   // File offset of read_buf[read_pos]
+
+bool GCodeSender::start(const char *file_path) {
+    if (state == State::STREAMING) return false;
+    if (!FluidNCClient::isConnected() || FluidNCClient::getStatus().state != STATE_IDLE) {
+        Serial.println("[Sender] Machine must be connected and idle");
+        return false;
+    }
+    if (UploadManager::isUploading() || ProbeSequencer::isRunning()) return false;
+    if (pending_responses > 0) {
+        if (millis() - pending_since_ms < SENDER_PENDING_TIMEOUT_MS) {
+            Serial.printf("[Sender] %u earlier commands not answered yet\n", pending_responses);
+            return false;
+        }
+        // An idle machine answers within milliseconds - the responses were lost
+        Serial.printf("[Sender] Dropping %u unanswered commands\n", pending_responses);
+        pending_responses = 0;
+    }
+
+    if (!reader.open(file_path)) {
+        Serial.printf("[Sender] Cannot open %s\n", file_path);
+        return false;
+    }
+
+    strncpy(path, file_path, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    error[0] = '\0';
+    file_size = reader.size();
+    acked_offset = 0;
+    eof = false;
+    read_pos = read_len = 0;
+    read_offset = 0;
+    in_flight_head = in_flight_count = 0;
+    in_flight_chars = 0;
+    next_len = 0;
+    rate_window_ms = millis();
+    rate_window_lines = 0;
+    lines_per_sec = 0.0f;
+    lines_acked = 0;
+    fill_samples = 0;
+    fill_sum = 0;
+    leveling = HeightMapStore::isEnabled();
+    if (leveling) {
+        leveler.begin(&HeightMapStore::getMap(), HEIGHTMAP_SEGMENT_MM);
+    }
+    state = State::STREAMING;
+
+    Serial.printf("[Sender] Streaming %s (%u bytes, %u char buffer%s)\n", path, file_size, SENDER_RX_BUFFER_SIZE,
+                  leveling ? ", height map applied" : "");
+    return true;
+}
+
+float GCodeSender::getPercent() {
+    if (file_size == 0) return 0.0f;
+    return acked_offset * 100.0f / file_size;
+}
+
+void GCodeSender::finish(State final_state, const char *message) {
+    reader.close();
+    state = final_state;
+    // Lines still in the controller are answered later - keep counting them
+    pending_responses = in_flight_count;
+    pending_since_ms = millis();
+    in_flight_count = 0;
+    in_flight_chars = 0;
+    next_len = 0;
+    FluidNCClient::requestWCSRefresh();  // The file may have changed offsets
+    if (message) {
+        strncpy(error, message, sizeof(error) - 1);
+        error[sizeof(error) - 1] = '\0';
+    }
+    Serial.printf("[Sender] %s: %u lines acknowledged%s%s\n",
+                  final_state == State::DONE ? "Done" : "Stopped", lines_acked,
+                  message ? " - " : "", message ? message : "");
+}
+
+bool GCodeSender::readNextLine() {
+    // Assemble the next non-empty line, without ';' comments and surrounding whitespace
+    uint16_t len = 0;
+    bool comment = false;
+    while (true) {
+        if (read_pos >= read_len) {
+            int n = reader.read((uint8_t*)read_buf, sizeof(read_buf));
+            if (n < 0) return false;
+            if (n == 0) {
+                eof = true;
+                break;  // Last line without a newline
+            }
+            read_pos = 0;
+            read_len = n;
+        }
+        char c = read_buf[read_pos++];
+        read_offset++;
+
+        if (c == '\n') {
+            while (len > 0 && (next_line[len - 1] == ' ' || next_line[len - 1] == '\t')) len--;
+            if (len > 0 && next_line[0] != '%') break;
+            len = 0;
+            comment = false;
+            continue;
+        }
+        if (c == '\r' || comment) continue;
+        if (c == ';') { comment = true; continue; }
+        if (len == 0 && (c == ' ' || c == '\t')) continue;
+        if (len >= sizeof(next_line) - 2) {
+            finish(State::FAILED, "Line too long");
+            return false;
+        }
+        next_line[len++] = c;
+    }
+
+    while (len > 0 && (next_line[len - 1] == ' ' || next_line[len - 1] == '\t')) len--;
+    if (len == 0 || next_line[0] == '%') {
+        next_len = 0;
+        return true;
+    }
+    next_line[len++] = '\n';
+    next_len = len;
+    next_end_offset = read_offset;
+    return true;
+}
+
+void GCodeSender::push(uint16_t length, bool ours, uint32_t end_offset) {
+    if (in_flight_count >= MAX_IN_FLIGHT) return;
+    InFlight &entry = in_flight[(in_flight_head + in_flight_count) % MAX_IN_FLIGHT];
+    entry.length = length;
+    entry.ours = ours;
+    entry.end_offset = end_offset;
+    in_flight_count++;
+    in_flight_chars += length;
+}
+
+void GCodeSender::onCommandSent(const char *command) {
+    // Realtime characters get no response and don't use the line buffer
+    size_t len = strlen(command);
+    uint8_t first = (uint8_t)command[0];
+    if (len == 1 && (first == '?' || first == '!' || first == '~' || first == 0x18 || first >= 0x80)) {
+        if (first == 0x18) {
+            if (state == State::STREAMING) finish(State::FAILED, "Soft reset");
+            pending_responses = 0;  // A reset drops queued lines unanswered
+        }
+        return;
+    }
+
+    // Each line (macros may send several at once) is answered with its own ok
+    const char *p = command;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t line_len = eol ? (size_t)(eol - p) : strlen(p);
+        if (line_len > 0) {
+            if (state == State::STREAMING) {
+                push(line_len + 1, false, 0);
+            } else {
+                pending_responses++;
+                pending_since_ms = millis();
+            }
+        }
+        if (!eol) break;
+        p = eol + 1;
+    }
+}
+
+void GCodeSender::onResponse(const char *payload) {
+    // A message may carry several lines
+    const char *p = payload;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+        bool ok = (len >= 2 && strncmp(p, "ok", 2) == 0 && (len == 2 || p[2] == '\r'));
+        bool err = (len >= 6 && strncmp(p, "error:", 6) == 0);
+
+        if ((ok || err) && state != State::STREAMING) {
+            if (pending_responses > 0) {
+                pending_responses--;
+                pending_since_ms = millis();
+            }
+        } else if ((ok || err) && in_flight_count > 0) {
+            InFlight entry = in_flight[in_flight_head];
+            in_flight_head = (in_flight_head + 1) % MAX_IN_FLIGHT;
+            in_flight_count--;
+            in_flight_chars -= entry.length;
+
+            if (entry.ours) {
+                if (err) {
+                    // Don't keep cutting after a rejected line
+                    char msg[64];
+                    snprintf(msg, sizeof(msg), "%.*s at byte %u", (int)(len < 20 ? len : 20), p, acked_offset);
+                    FluidNCClient::sendCommand("!");
+                    finish(State::FAILED, msg);
+                    return;
+                }
+                acked_offset = entry.end_offset;
+                lines_acked++;
+                rate_window_lines++;
+            }
+        }
+        if (!eol) break;
+        p = eol + 1;
+    }
+}
+
+void GCodeSender::loop() {
+    if (state != State::STREAMING) {
+        if (pending_responses > 0 && !FluidNCClient::isConnected()) pending_responses = 0;
+        return;
+    }
+
+    if (!FluidNCClient::isConnected()) {
+        finish(State::FAILED, "Connection lost");
+        return;
+    }
+    if (FluidNCClient::getStatus().state == STATE_ALARM) {
+        finish(State::FAILED, "Alarm");
+        return;
+    }
+
+    // Pack every line that fits in the receive buffer into one WebSocket message
+    static char frame[SENDER_RX_BUFFER_SIZE + 1];
+    size_t frame_len = 0;
+    bool too_long = false;
+    while (in_flight_count < MAX_IN_FLIGHT) {
+        if (next_len == 0 && leveling && leveler.next(next_line, sizeof(next_line) - 1)) {
+            // Next compensated segment of the current file line
+            next_len = strlen(next_line);
+            next_line[next_len++] = '\n';
+        }
+        if (next_len == 0) {
+            if (eof) break;
+            if (!readNextLine()) {
+                if (state == State::STREAMING) finish(State::FAILED, "SD read error");
+                return;
+            }
+            if (next_len == 0) continue;
+            if (leveling) {
+                next_line[next_len - 1] = '\0';
+                next_len = 0;
+                if (!leveler.setLine(next_line)) {
+                    finish(State::FAILED, "Line too long to level");
+                    return;
+                }
+                continue;
+            }
+        }
+        if (next_len > SENDER_RX_BUFFER_SIZE) {
+            // Would never fit, however empty the buffer gets
+            too_long = true;
+            break;
+        }
+        if (in_flight_chars + next_len > SENDER_RX_BUFFER_SIZE) break;
+
+        memcpy(frame + frame_len, next_line, next_len);
+        frame_len += next_len;
+        push(next_len, true, next_end_offset);
+        next_len = 0;
+    }
+    if (frame_len > 0) {
+        frame[frame_len] = '\0';
+        FluidNCClient::sendStreamData(frame);
+    }
+    if (too_long) {
+        FluidNCClient::sendCommand("!");
+        finish(State::FAILED, "Line longer than controller buffer");
+        return;
+    }
+
+    if (eof && next_len == 0 && in_flight_count == 0) {
+        finish(State::DONE, nullptr);
+        return;
+    }
+
+    // Throughput and buffer fill - a full buffer means the planner never starves
+    fill_sum += in_flight_chars;
+    fill_samples++;
+    uint32_t now = millis();
+    if (now - rate_window_ms >= SENDER_RATE_WINDOW_MS) {
+        lines_per_sec = rate_window_lines * 1000.0f / (now - rate_window_ms);
+        Serial.printf("[Sender] %.0f lines/s, buffer %.0f%% full, %.1f%%\n", lines_per_sec,
+                      fill_samples ? fill_sum * 100.0f / fill_samples / SENDER_RX_BUFFER_SIZE : 0.0f, getPercent());
+        rate_window_ms = now;
+        rate_window_lines = 0;
+        fill_sum = 0;
+        fill_samples = 0;
+    }
+}
@@ -0,0 +1,249 @@
+#include "network/machine_sessions.h"
+#include "network/connection_manager.h"
+#include "network/gcode_sender.h"
+#include "network/probe_sequencer.h"
+#include "ui/ui_common.h"
+#include "ui/ui_dashboard.h"
+#include "ui/tabs/control/ui_tab_control_joystick.h"
+#include "config.h"
+#include <WiFi.h>
+
+using namespace websockets;
+
+// Static member initialization
+MachineSession MachineSessions::sessions[MAX_MACHINES];
+bool MachineSessions::started = false;
+uint32_t MachineSessions::last_connect_ms = 0;
+uint32_t MachineSessions::last_stats_ms = 0;
+
+bool MachineSession::open(int index, const MachineSummary &machine, const char *address) {
+    close();
+    machine_index = index;
+    strncpy(host, address, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    has_address = true;
+    status = FluidNCStatus();
+    attach();
+
+    char url[96];
+    snprintf(url, sizeof(url), "ws://%s:%d/", host, machine.websocket_port);
+    uint32_t heap_before = ESP.getFreeHeap();
+    uint32_t start_ms = millis();
+    if (!ws->connect(url)) {
+        closed_ms = millis() | 1;
+        if (failures < 255) failures++;
+        Serial.printf("[Sessions] %s: connect to %s failed (%lu ms), retry in %lus\n", machine.name, host,
+                      millis() - start_ms, retryDelayMs() / 1000);
+        return false;
+    }
+    failures = 0;
+
+    uint32_t heap_after = ESP.getFreeHeap();
+    heap_bytes = heap_before > heap_after ? heap_before - heap_after : 0;
+    Serial.printf("[Sessions] %s: open at %s in %lu ms, %u bytes heap%s\n", machine.name, host,
+                  millis() - start_ms, heap_bytes, heap_bytes > SESSION_HEAP_BUDGET ? " (over budget)" : "");
+    requestReports();
+    return true;
+}
+
+uint32_t MachineSession::retryDelayMs() const {
+    // SESSION_RETRY_MS, doubled for every failed connect in a row
+    uint8_t shift = failures > 1 ? failures - 1 : 0;
+    if (shift > 8) shift = 8;
+    uint32_t delay_ms = (uint32_t)SESSION_RETRY_MS << shift;
+    return delay_ms < SESSION_RETRY_MAX_MS ? delay_ms : SESSION_RETRY_MAX_MS;
+}
+
+void MachineSession::close() {
+    if (ws->available()) {
+        ws->close();
+    }
+    status.is_connected = false;
+    status.state = STATE_DISCONNECTED;
+}
+
+void MachineSession::poll() {
+    if (!ws->available()) return;
+    uint32_t start = micros();
+    ws->poll();
+    poll_us += micros() - start;
+    poll_count++;
+}
+
+void MachineSession::attach() {
+    ws->onMessage([this](WebsocketsMessage message) { onMessage(message); });
+    ws->onEvent([this](WebsocketsEvent event, String) { onEvent(event); });
+}
+
+void MachineSession::requestReports() {
+    char cmd[32];
+    snprintf(cmd, sizeof(cmd), "$Report/Interval=%u\n", SESSION_REPORT_INTERVAL_MS);
+    ws->send(cmd);
+    ws->send("?");
+}
+
+void MachineSession::onMessage(WebsocketsMessage message) {
+    // Everything but status reports is ignored
+    const char *payload = message.c_str();
+    if (payload[0] != '<') return;
+
+    if (!FluidNCClient::parseStatusFields(payload, status)) {
+        FluidNCClient::clearSDProgress(status);
+    }
+    status.is_connected = true;
+    status.last_update_ms = millis();
+    reports++;
+}
+
+void MachineSession::onEvent(WebsocketsEvent event) {
+    if (event == WebsocketsEvent::ConnectionClosed) {
+        Serial.printf("[Sessions] Machine %d: session closed\n", machine_index);
+        status.is_connected = false;
+        status.state = STATE_DISCONNECTED;
+        closed_ms = millis() | 1;
+    }
+}
+
+void MachineSessions::start() {
+    if (started) return;
+    started = true;
+    last_stats_ms = millis();
+    Serial.printf("[Sessions] Watching other machines (free heap %u bytes)\n", ESP.getFreeHeap());
+}
+
+const MachineSession* MachineSessions::getSession(int machine_index) {
+    if (!started || machine_index < 0 || machine_index >= MAX_MACHINES) return nullptr;
+    if (machine_index == MachineConfigManager::getSelectedMachineIndex()) return nullptr;
+    return &sessions[machine_index];
+}
+
+bool MachineSessions::isReachable(const MachineSummary &machine) {
+    if (WiFi.status() != WL_CONNECTED) return false;
+    return machine.connection_type == CONN_WIRED || WiFi.SSID() == machine.ssid;
+}
+
+void MachineSessions::loop() {
+    if (!started) return;
+
+    for (MachineSession &s : sessions) {
+        s.poll();
+    }
+
+    uint32_t now = millis();
+    if (now - last_connect_ms >= SESSION_CONNECT_SPACING_MS) {
+        openNext();
+    }
+    if (now - last_stats_ms >= SESSION_STATS_MS) {
+        last_stats_ms = now;
+        logStats();
+    }
+}
+
+void MachineSessions::openNext() {
+    // Connecting blocks the main loop - only for the dashboard, and never while streaming,
+    // jogging, probing or bringing up the focused link
+    if (!UIDashboard::isVisible()) return;
+    if (GCodeSender::isActive() || ProbeSequencer::isRunning() || !FluidNCClient::isConnected()) return;
+    if (UITabControlJoystick::isActive() || FluidNCClient::getStatus().state == STATE_JOG) return;
+
+    int focused = MachineConfigManager::getSelectedMachineIndex();
+    uint32_t now = millis();
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        MachineSession &s = sessions[i];
+        if (i == focused || s.isOpen()) continue;
+        if (s.closed_ms != 0 && now - s.closed_ms < s.retryDelayMs()) continue;
+
+        const MachineSummary &machine = MachineConfigManager::getSummary(i);
+        if (!machine.is_configured || !isReachable(machine)) continue;
+
+        char host[64];
+        if (!ConnectionManager::getKnownAddress(i, machine, host, sizeof(host))) {
+            // mDNS name never resolved by a focused connection - nothing to connect to
+            s.has_address = false;
+            s.closed_ms = now | 1;
+            continue;
+        }
+        if (ESP.getFreeHeap() < SESSION_MIN_FREE_HEAP) {
+            Serial.printf("[Sessions] Free heap %u below %u - not opening more sessions\n",
+                          ESP.getFreeHeap(), SESSION_MIN_FREE_HEAP);
+            s.closed_ms = now | 1;
+            return;
+        }
+
+        last_connect_ms = now;
+        s.open(i, machine, host);
+        return;  // One connect per call
+    }
+}
+
+void MachineSessions::logStats() {
+    int open = 0;
+    uint32_t heap = 0, poll_us = 0, polls = 0, reports = 0;
+    for (MachineSession &s : sessions) {
+        if (!s.isOpen()) continue;
+        open++;
+        heap += s.heap_bytes;
+        poll_us += s.poll_us;
+        polls += s.poll_count;
+        reports += s.reports;
+        s.poll_us = s.poll_count = s.reports = 0;
+    }
+    if (open == 0) return;
+    Serial.printf("[Sessions] %d open: %u bytes heap/session (budget %u), %u us/poll, %.1f%% CPU, %u reports/min\n",
+                  open, heap / open, SESSION_HEAP_BUDGET, polls ? poll_us / polls : 0,
+                  poll_us * 100.0f / (SESSION_STATS_MS * 1000.0f), reports);
+}
+
+bool MachineSessions::focus(int machine_index) {
+    int old_index = MachineConfigManager::getSelectedMachineIndex();
+    if (machine_index == old_index) return true;
+    if (!started || machine_index < 0 || machine_index >= MAX_MACHINES || old_index < 0) return false;
+
+    MachineSession &target = sessions[machine_index];
+    MachineConfig config;
+    if (!target.isConnected() || !MachineConfigManager::getMachine(machine_index, config)) return false;
+    if (GCodeSender::isActive()) {
+        Serial.println("[Sessions] Display SD stream running - not switching");
+        return false;
+    }
+    if (ProbeSequencer::isRunning()) {
+        // Its steps and PRB results belong to the focused machine
+        Serial.println("[Sessions] Probe routine running - not switching");
+        return false;
+    }
+
+    uint32_t start_ms = millis();
+    MachineConfig focused_config = config;
+    char focused_host[64];
+    strncpy(focused_host, target.host, sizeof(focused_host));
+    char previous_host[64];
+    strncpy(previous_host, ConnectionManager::getResolvedHost(), sizeof(previous_host) - 1);
+    previous_host[sizeof(previous_host) - 1] = '\0';
+
+    // Hand the open socket over; the previously focused connection comes back in exchange
+    MachineSession &previous = sessions[old_index];
+    previous.close();
+    WebsocketsClient *socket = target.ws;
+    FluidNCStatus status = target.status;
+    FluidNCClient::exchangeConnection(socket, status, config);
+
+    target.ws = previous.ws;
+    target.status = FluidNCStatus();
+    target.closed_ms = 0;
+
+    previous.ws = socket;
+    previous.machine_index = old_index;
+    strncpy(previous.host, previous_host, sizeof(previous.host));
+    previous.has_address = true;
+    previous.status = status;
+    previous.closed_ms = 0;
+    previous.attach();
+    previous.requestReports();
+
+    ConnectionManager::adopt(focused_config, machine_index, focused_host);
+    MachineConfigManager::setSelectedMachineIndex(machine_index);
+    UICommon::rebuildMainUI();
+
+    Serial.printf("[Sessions] Focused %s in %lu ms\n", focused_config.name, millis() - start_ms);
+    return true;
+}
@@ -0,0 +1,477 @@
+#include "network/probe_sequencer.h"
+#include "network/fluidnc_client.h"
+#include "network/gcode_sender.h"
+#include "gcode/height_map.h"
+#include "config.h"
+#include <stdarg.h>
+
+// Static member initialization
+ProbeSequencer::State ProbeSequencer::state = ProbeSequencer::State::IDLE;
+ProbeSequencer::Routine ProbeSequencer::routine = ProbeSequencer::Routine::AXIS;
+ProbeSequencer::Step ProbeSequencer::steps[MAX_STEPS];
+int ProbeSequencer::step_count = 0;
+int ProbeSequencer::step_index = 0;
+float ProbeSequencer::start_pos[3] = {0, 0, 0};
+float ProbeSequencer::slots[MAX_SLOTS][3];
+ProbeParams ProbeSequencer::params = {};
+char ProbeSequencer::restore_line[8] = "";
+HeightMap *ProbeSequencer::grid_map = nullptr;
+int ProbeSequencer::grid_point = 0;
+ReplyTracker ProbeSequencer::replies;
+bool ProbeSequencer::got_contact = false;
+uint32_t ProbeSequencer::sent_ms = 0;
+uint32_t ProbeSequencer::step_timeout_ms = 0;
+char ProbeSequencer::message[96] = "No probe data";
+uint32_t ProbeSequencer::changes = 0;
+ProbeResult ProbeSequencer::history[PROBE_HISTORY_SIZE];
+int ProbeSequencer::history_head = 0;
+int ProbeSequencer::history_count = 0;
+
+// Routine details used for the result summary
+static int corner_sx = 1, corner_sy = 1;   // Direction from the outside towards the stock
+static bool corner_touch_z = false;
+static char probe_axis = 'X';
+
+bool ProbeSequencer::begin(Routine kind, const ProbeParams &p) {
+    if (state == State::RUNNING) return false;
+    const FluidNCStatus &status = FluidNCClient::getStatus();
+    if (!FluidNCClient::isConnected()) {
+        setMessage("FAILED\nNot connected to FluidNC");
+        return false;
+    }
+    if (status.state != STATE_IDLE || status.is_sd_printing || GCodeSender::isActive()) {
+        setMessage("FAILED\nMachine must be idle");
+        return false;
+    }
+    if (p.feed_rate <= 0 || p.max_distance <= 0) {
+        setMessage("FAILED\nInvalid feed rate or distance");
+        return false;
+    }
+
+    // Replies to lines sent before the routine are skipped first (unless long overdue)
+    replies.dropStale(millis(), SENDER_PENDING_TIMEOUT_MS);
+
+    routine = kind;
+    params = p;
+    step_count = 0;
+    step_index = 0;
+    start_pos[0] = status.mpos_x;
+    start_pos[1] = status.mpos_y;
+    start_pos[2] = status.mpos_z;
+    memset(slots, 0, sizeof(slots));
+    snprintf(restore_line, sizeof(restore_line), "%s", status.modal.distanceName());
+    return true;
+}
+
+void ProbeSequencer::addSend(const char *fmt, ...) {
+    if (step_count >= MAX_STEPS) return;
+    Step &s = steps[step_count++];
+    s.kind = StepKind::SEND;
+    s.axis = 0;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(s.line, sizeof(s.line), fmt, args);
+    va_end(args);
+}
+
+void ProbeSequencer::addProbe(char axis, float distance, int slot, float thickness) {
+    if (step_count >= MAX_STEPS) return;
+    Step &s = steps[step_count++];
+    s.kind = StepKind::PROBE;
+    s.axis = axis;
+    s.slot_a = slot;
+    if (thickness > 0.001f) {
+        snprintf(s.line, sizeof(s.line), "G38.2 %c%.3f F%.0f P%.2f", axis, distance, params.feed_rate, thickness);
+    } else {
+        snprintf(s.line, sizeof(s.line), "G38.2 %c%.3f F%.0f", axis, distance, params.feed_rate);
+    }
+}
+
+void ProbeSequencer::addMove(char axis, Base base, int slot_a, int slot_b, float offset) {
+    if (step_count >= MAX_STEPS) return;
+    Step &s = steps[step_count++];
+    s.kind = StepKind::MOVE;
+    s.axis = axis;
+    s.base = base;
+    s.slot_a = slot_a;
+    s.slot_b = slot_b;
+    s.offset = offset;
+    s.line[0] = '\0';
+}
+
+bool ProbeSequencer::probeAxis(char axis, char direction, const ProbeParams &p) {
+    if (!begin(Routine::AXIS, p)) return false;
+    probe_axis = axis;
+
+    // Incremental mode is set on its own line (modal group violation if combined)
+    float sign = (direction == '-') ? -1.0f : 1.0f;
+    addSend("G91");
+    addProbe(axis, sign * p.max_distance, 0, p.thickness);
+    if (p.retract > 0.001f) {
+        addSend("G0 %c%.3f", axis, -sign * p.retract);
+    }
+    addSend("%s", restore_line);
+
+    Serial.printf("[Probe] %c%c: %d steps\n", axis, direction, step_count);
+    setMessage("Probing %c%c...", axis, direction);
+    state = State::RUNNING;
+    return true;
+}
+
+void ProbeSequencer::addCornerLegs(int sx, int sy, float cx, float cy) {
+    // From the outside corner (offset cx/cy from the start position, at probing depth):
+    // beside the X edge, probe towards it, back out the same way, then the Y edge
+    float r = params.tip_diameter / 2.0f;
+    float reach = 2.0f * (PROBE_CORNER_CLEARANCE_MM + r);
+
+    addMove('Y', Base::START, -1, -1, cy + sy * reach);
+    addProbe('X', sx * params.max_distance, 1);
+    addSend("G10 L20 P0 X%.3f", -sx * r);
+    addSend("G0 X%.3f", -sx * params.retract);
+    addMove('X', Base::START, -1, -1, cx);
+    addMove('Y', Base::START, -1, -1, cy);
+
+    addMove('X', Base::START, -1, -1, cx + sx * reach);
+    addProbe('Y', sy * params.max_distance, 2);
+    addSend("G10 L20 P0 Y%.3f", -sy * r);
+    addSend("G0 Y%.3f", -sy * params.retract);
+    addMove('Y', Base::START, -1, -1, cy);
+    addMove('X', Base::START, -1, -1, cx);
+}
+
+bool ProbeSequencer::probeCorner(ProbeCorner corner, bool touch_z, const ProbeParams &p) {
+    if (!begin(Routine::CORNER, p)) return false;
+    corner_sx = (corner == ProbeCorner::FRONT_LEFT || corner == ProbeCorner::BACK_LEFT) ? 1 : -1;
+    corner_sy = (corner == ProbeCorner::FRONT_LEFT || corner == ProbeCorner::FRONT_RIGHT) ? 1 : -1;
+    corner_touch_z = touch_z;
+
+    addSend("G91");
+    if (touch_z) {
+        // Start above the stock, less than the clearance in from both edges: touch the
+        // plate, lift, move out past the corner and down to probing depth
+        float reach = 2.0f * (PROBE_CORNER_CLEARANCE_MM + p.tip_diameter / 2.0f);
+        addProbe('Z', -p.max_distance, 0);
+        addSend("G10 L20 P0 Z%.3f", p.thickness);
+        addMove('Z', Base::SLOT, 0, -1, p.retract > 1.0f ? p.retract : 1.0f);
+        addMove('X', Base::START, -1, -1, -corner_sx * reach);
+        addMove('Y', Base::START, -1, -1, -corner_sy * reach);
+        addMove('Z', Base::SLOT, 0, -1, -(p.thickness + PROBE_CORNER_DEPTH_MM));
+        addCornerLegs(corner_sx, corner_sy, -corner_sx * reach, -corner_sy * reach);
+        addMove('Z', Base::SLOT, 0, -1, p.retract > 1.0f ? p.retract : 1.0f);
+    } else {
+        // Start outside the corner at probing depth, less than the clearance from both edges
+        addCornerLegs(corner_sx, corner_sy, 0.0f, 0.0f);
+    }
+    addSend("%s", restore_line);
+
+    Serial.printf("[Probe] Corner %c%c%s: %d steps\n", corner_sy > 0 ? 'F' : 'B', corner_sx > 0 ? 'L' : 'R',
+                  touch_z ? " with Z" : "", step_count);
+    setMessage("Probing corner...");
+    state = State::RUNNING;
+    return true;
+}
+
+bool ProbeSequencer::probeBore(const ProbeParams &p) {
+    if (!begin(Routine::BORE, p)) return false;
+
+    // Start inside the bore at probing depth. X is centered first so the Y chord runs
+    // through the center, then X is probed again on the Y center line.
+    addSend("G91");
+    addProbe('X', -p.max_distance, 0);
+    addMove('X', Base::START, -1, -1, 0.0f);
+    addProbe('X', p.max_distance, 1);
+    addMove('X', Base::MID, 0, 1, 0.0f);
+    addProbe('Y', -p.max_distance, 2);
+    addMove('Y', Base::START, -1, -1, 0.0f);
+    addProbe('Y', p.max_distance, 3);
+    addMove('Y', Base::MID, 2, 3, 0.0f);
+    addProbe('X', -p.max_distance, 4);
+    addMove('X', Base::MID, 0, 1, 0.0f);
+    addProbe('X', p.max_distance, 5);
+    addMove('X', Base::MID, 4, 5, 0.0f);
+    addSend("G10 L20 P0 X0 Y0");
+    addSend("%s", restore_line);
+
+    Serial.printf("[Probe] Bore center: %d steps\n", step_count);
+    setMessage("Probing bore...");
+    state = State::RUNNING;
+    return true;
+}
+
+bool ProbeSequencer::probeGrid(HeightMap &map, const ProbeParams &p) {
+    if (!map.isValid() || !begin(Routine::GRID, p)) return false;
+    grid_map = &map;
+    grid_point = 0;
+
+    // Rapid between points at the clearance height (work Z), probe down from there
+    addSend("G90");
+    addSend("G0 Z%.3f", HEIGHTMAP_CLEARANCE_MM);
+    addGridPoint();
+
+    Serial.printf("[Probe] Grid %dx%d over X%.3f Y%.3f +%.3f x %.3f\n", map.getNX(), map.getNY(),
+                  map.getX0(), map.getY0(), map.getWidth(), map.getHeight());
+    setMessage("Probing grid...");
+    state = State::RUNNING;
+    return true;
+}
+
+void ProbeSequencer::gridIndex(int point, int &i, int &j) {
+    // Serpentine: every other row runs backwards, so each move is one grid step
+    int nx = grid_map->getNX();
+    j = point / nx;
+    i = (j % 2 == 0) ? point % nx : nx - 1 - point % nx;
+}
+
+void ProbeSequencer::addGridPoint() {
+    int i, j;
+    gridIndex(grid_point, i, j);
+    addSend("G0 X%.3f Y%.3f", grid_map->pointX(i), grid_map->pointY(j));
+    addSend("G91");
+    addProbe('Z', -params.max_distance, 0);
+    addSend("G90");
+    addSend("G0 Z%.3f", HEIGHTMAP_CLEARANCE_MM);
+}
+
+float ProbeSequencer::axisValue(const float pos[3], char axis) {
+    return pos[axis == 'X' ? 0 : axis == 'Y' ? 1 : 2];
+}
+
+void ProbeSequencer::sendStep() {
+    Step &s = steps[step_index];
+    char line[48];
+    if (s.kind == StepKind::MOVE) {
+        float base = axisValue(start_pos, s.axis);
+        if (s.base == Base::SLOT) {
+            base = axisValue(slots[s.slot_a], s.axis);
+        } else if (s.base == Base::MID) {
+            base = (axisValue(slots[s.slot_a], s.axis) + axisValue(slots[s.slot_b], s.axis)) / 2.0f;
+        }
+        snprintf(line, sizeof(line), "G53 G0 %c%.3f\n", s.axis, base + s.offset);
+    } else {
+        snprintf(line, sizeof(line), "%s\n", s.line);
+    }
+
+    // Probing moves may take max_distance at the probe feed rate before they are answered
+    step_timeout_ms = PROBE_STEP_TIMEOUT_MS;
+    if (s.kind == StepKind::PROBE) {
+        step_timeout_ms += (uint32_t)(params.max_distance / params.feed_rate * 60000.0f);
+        if (routine == Routine::GRID) {
+            setMessage("Probing point %d/%d...", grid_point + 1, grid_map->getNX() * grid_map->getNY());
+        } else {
+            setMessage("Probing %c (step %d/%d)...", s.axis, step_index + 1, step_count);
+        }
+    }
+
+    Serial.printf("[Probe] Step %d/%d: %s", step_index + 1, step_count, line);
+    replies.sentOwn();
+    got_contact = false;
+    sent_ms = millis();
+    // Sent as stream data so onCommandSent() only counts lines that aren't ours
+    FluidNCClient::sendStreamData(line);
+}
+
+void ProbeSequencer::loop() {
+    if (!FluidNCClient::isConnected()) {
+        if (state == State::RUNNING) finish(State::FAILED, "Disconnected", false);
+        replies.reset();   // Nothing sent on the old connection is answered any more
+        return;
+    }
+    if (state != State::RUNNING) return;
+    if (FluidNCClient::getStatus().state == STATE_ALARM) {
+        finish(State::FAILED, "Alarm", false);
+        return;
+    }
+    if (replies.isAwaiting()) {
+        if (millis() - sent_ms >= step_timeout_ms) {
+            finish(State::FAILED, "No response from FluidNC", false);
+        }
+        return;
+    }
+
+    if (step_index >= step_count) {
+        int points = routine == Routine::GRID ? grid_map->getNX() * grid_map->getNY() : 0;
+        if (grid_point + 1 >= points) {
+            finish(State::DONE, nullptr, false);
+            return;
+        }
+        // Next grid point - the step list only ever holds one
+        grid_point++;
+        step_count = step_index = 0;
+        addGridPoint();
+        if (grid_point + 1 == points) addSend("%s", restore_line);
+    }
+    sendStep();
+}
+
+void ProbeSequencer::onCommandSent(const char *command) {
+    // Realtime characters get no response; hold and reset end the routine
+    size_t len = strlen(command);
+    uint8_t first = (uint8_t)command[0];
+    if (len == 1 && (first == '?' || first == '!' || first == '~' || first == 0x18 || first >= 0x80)) {
+        if (state == State::RUNNING && first == '!') finish(State::FAILED, "Feed hold", false);
+        if (first == 0x18) {
+            if (state == State::RUNNING) finish(State::FAILED, "Soft reset", false);
+            replies.reset();  // A reset drops queued lines unanswered
+        }
+        return;
+    }
+    replies.sentForeign(ReplyTracker::countLines(command), millis());
+}
+
+void ProbeSequencer::onResponse(const char *payload) {
+    // A message may carry several lines, e.g. "[PRB:...]\nok"
+    const char *p = payload;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+        if (len > 0 && p[len - 1] == '\r') len--;
+        handleLine(p, len);
+        if (!eol) break;
+        p = eol + 1;
+    }
+}
+
+void ProbeSequencer::handleLine(const char *line, size_t len) {
+    if (len > 5 && strncmp(line, "[PRB:", 5) == 0) {
+        // The $# report repeats the last probe result - not a contact
+        if (FluidNCClient::isWCSReplyPending()) return;
+        ProbeResult result;
+        int success;
+        if (sscanf(line + 5, "%f,%f,%f:%d", &result.x, &result.y, &result.z, &success) == 4) {
+            result.success = success != 0;
+            result.time_ms = millis();
+            onContact(result);
+        }
+        return;
+    }
+
+    bool ok = (len == 2 && strncmp(line, "ok", 2) == 0);
+    bool err = (len >= 6 && strncmp(line, "error:", 6) == 0);
+    if (state != State::RUNNING) {
+        if (ok || err) replies.onReply();   // Keeps the count of outstanding lines
+        return;
+    }
+
+    if (len >= 6 && strncmp(line, "ALARM:", 6) == 0) {
+        char text[24];
+        snprintf(text, sizeof(text), "%.*s", (int)len, line);
+        finish(State::FAILED, text, false);
+        return;
+    }
+
+    if (!ok && !err) return;
+
+    // Answers arrive in send order
+    if (!replies.onReply()) return;
+
+    if (err) {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*s on step %d", (int)(len < 12 ? len : 12), line, step_index + 1);
+        finish(State::FAILED, text, true);
+        return;
+    }
+    if (steps[step_index].kind == StepKind::PROBE && !got_contact) {
+        finish(State::FAILED, "No probe report", true);
+        return;
+    }
+    step_index++;   // The next step goes out from loop(), not from inside the WebSocket callback
+}
+
+void ProbeSequencer::onContact(const ProbeResult &result) {
+    history[history_head] = result;
+    history_head = (history_head + 1) % PROBE_HISTORY_SIZE;
+    if (history_count < PROBE_HISTORY_SIZE) history_count++;
+    changes++;
+
+    if (state != State::RUNNING) {
+        // Probing from a macro or the terminal
+        if (result.success) setMessage("SUCCESS\nX:%.3f Y:%.3f Z:%.3f", result.x, result.y, result.z);
+        else setMessage("FAILED\nNo contact detected");
+        return;
+    }
+    if (!replies.isAwaiting() || steps[step_index].kind != StepKind::PROBE) return;
+    if (!result.success) {
+        // FluidNC raises an alarm after a failed G38.2 - nothing more is sent
+        finish(State::FAILED, "No contact detected", false);
+        return;
+    }
+    if (routine == Routine::GRID) {
+        int i, j;
+        gridIndex(grid_point, i, j);
+        grid_map->set(i, j, result.z);
+    }
+    float *slot = slots[steps[step_index].slot_a];
+    slot[0] = result.x;
+    slot[1] = result.y;
+    slot[2] = result.z;
+    got_contact = true;
+}
+
+void ProbeSequencer::finish(State final_state, const char *text, bool restore) {
+    state = final_state;
+    replies.cancelOwn(millis());
+
+    // Corner and bore routines set offsets with G10 (also when stopped part way)
+    if (routine == Routine::CORNER || routine == Routine::BORE) {
+        FluidNCClient::requestWCSRefresh();
+    }
+
+    if (final_state == State::FAILED) {
+        setMessage("FAILED\n%s", text);
+        Serial.printf("[Probe] Stopped at step %d/%d: %s\n", step_index + 1, step_count, text);
+        // Leave the machine in the distance mode it was in (not after alarms or holds)
+        if (restore && FluidNCClient::isConnected()) {
+            char cmd[12];
+            snprintf(cmd, sizeof(cmd), "%s\n", restore_line);
+            FluidNCClient::sendCommand(cmd);
+        }
+        return;
+    }
+
+    float r = params.tip_diameter / 2.0f;
+    switch (routine) {
+        case Routine::AXIS:
+            setMessage("SUCCESS\n%c: %.3f mm", probe_axis, axisValue(slots[0], probe_axis));
+            break;
+        case Routine::CORNER:
+            if (corner_touch_z) {
+                setMessage("SUCCESS - corner is X0 Y0 Z0\nEdges X%.3f Y%.3f Z%.3f (machine)",
+                           slots[1][0] + corner_sx * r, slots[2][1] + corner_sy * r, slots[0][2] - params.thickness);
+            } else {
+                setMessage("SUCCESS - corner is X0 Y0\nEdges X%.3f Y%.3f (machine)",
+                           slots[1][0] + corner_sx * r, slots[2][1] + corner_sy * r);
+            }
+            break;
+        case Routine::GRID: {
+            float min, max;
+            grid_map->normalize();
+            grid_map->range(min, max);
+            setMessage("SUCCESS - %dx%d height map\nRange %.3f to %.3f mm", grid_map->getNX(), grid_map->getNY(), min, max);
+            break;
+        }
+        case Routine::BORE:
+            setMessage("SUCCESS - center is X0 Y0\nDiameter X %.3f  Y %.3f mm",
+                       slots[5][0] - slots[4][0] + params.tip_diameter, slots[3][1] - slots[2][1] + params.tip_diameter);
+            break;
+    }
+    Serial.printf("[Probe] Done: %s\n", message);
+}
+
+void ProbeSequencer::setMessage(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(message, sizeof(message), fmt, args);
+    va_end(args);
+    changes++;
+}
+
+const ProbeResult& ProbeSequencer::getHistory(int index) {
+    int i = (history_head - 1 - index + PROBE_HISTORY_SIZE * 2) % PROBE_HISTORY_SIZE;
+    return history[i];
+}
+
+void ProbeSequencer::clearHistory() {
+    history_head = 0;
+    history_count = 0;
+    changes++;
+}
@@ -0,0 +1,60 @@
+#include "network/reply_tracker.h"
+#include <cstring>
+
+void ReplyTracker::reset() {
+    awaiting = false;
+    ahead = behind = 0;
+}
+
+void ReplyTracker::sentOwn() {
+    ahead += behind;
+    behind = 0;
+    awaiting = true;
+}
+
+void ReplyTracker::sentForeign(int lines, uint32_t now_ms) {
+    if (lines <= 0) return;
+    if (awaiting) behind += lines;
+    else ahead += lines;
+    foreign_ms = now_ms;
+}
+
+bool ReplyTracker::onReply() {
+    if (ahead > 0) {
+        ahead--;
+        return false;
+    }
+    if (!awaiting) {
+        if (behind > 0) behind--;
+        return false;
+    }
+    awaiting = false;
+    return true;
+}
+
+void ReplyTracker::cancelOwn(uint32_t now_ms) {
+    if (!awaiting) return;
+    ahead += 1 + behind;
+    behind = 0;
+    awaiting = false;
+    foreign_ms = now_ms;
+}
+
+void ReplyTracker::dropStale(uint32_t now_ms, uint32_t max_age_ms) {
+    if (!awaiting && ahead + behind > 0 && now_ms - foreign_ms >= max_age_ms) {
+        ahead = behind = 0;
+    }
+}
+
+int ReplyTracker::countLines(const char *command) {
+    int lines = 0;
+    const char *p = command;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t line_len = eol ? (size_t)(eol - p) : strlen(p);
+        if (line_len > 0) lines++;
+        if (!eol) break;
+        p = eol + 1;
+    }
+    return lines;
+}
@@ -0,0 +1,71 @@
+#include "network/report_policy.h"
+#include "network/fluidnc_client.h"
+#include "core/power_manager.h"
+#include "ui/ui_tabs.h"
+#include "ui/tabs/control/ui_tab_control_joystick.h"
+#include "config.h"
+
+// Static member initialization
+uint16_t ReportPolicy::pending_interval = REPORT_INTERVAL_DEFAULT_MS;
+uint32_t ReportPolicy::pending_since_ms = 0;
+uint32_t ReportPolicy::last_heartbeat_ms = 0;
+
+void ReportPolicy::update() {
+    // Only renegotiate once FluidNC has accepted auto-reporting (fallback polling is fixed-rate)
+    if (!FluidNCClient::isConnected() || !FluidNCClient::isAutoReporting()) {
+        pending_interval = FluidNCClient::getReportInterval();
+        return;
+    }
+
+    uint32_t now = millis();
+    uint16_t current = FluidNCClient::getReportInterval();
+    uint16_t target = chooseInterval();
+
+    if (target != pending_interval) {
+        pending_interval = target;
+        pending_since_ms = now;
+    }
+
+    // Speed up immediately; slow down (or pause) only once the target has held steady,
+    // so brief Idle reports between jog commands don't make the rate flap
+    if (target != current) {
+        bool faster = (current == 0) || (target != 0 && target < current);
+        if (faster || now - pending_since_ms >= REPORT_POLICY_SETTLE_MS) {
+            FluidNCClient::setReportInterval(target);
+            last_heartbeat_ms = now;
+        }
+    }
+
+    // Paused: poll occasionally so state changes (e.g. a job started elsewhere) still wake the display
+    if (FluidNCClient::getReportInterval() == 0 && now - last_heartbeat_ms >= REPORT_PAUSED_POLL_MS) {
+        FluidNCClient::requestStatusReport();
+        last_heartbeat_ms = now;
+    }
+}
+
+uint32_t ReportPolicy::getDisplayIntervalMs() {
+    uint16_t interval = FluidNCClient::getReportInterval();
+    return (interval > 0 && interval < REPORT_INTERVAL_DEFAULT_MS) ? interval : REPORT_INTERVAL_DEFAULT_MS;
+}
+
+uint16_t ReportPolicy::chooseInterval() {
+    PowerManager::PowerState power = PowerManager::getCurrentState();
+    if (power == PowerManager::SCREEN_OFF) {
+        return 0;
+    }
+
+    int state = FluidNCClient::getStatus().state;
+    if (UITabControlJoystick::isActive() || state == STATE_JOG) {
+        return REPORT_INTERVAL_MOTION_MS;
+    }
+
+    if (state == STATE_IDLE) {
+        // DROs are only on the Status and Control tabs (status bar is fine at the slow rate)
+        uint32_t tab = UITabs::getActiveTab();
+        if (power == PowerManager::DIMMED || (tab != 0 && tab != 1)) {
+            return REPORT_INTERVAL_IDLE_MS;
+        }
+    }
+
+    return REPORT_INTERVAL_DEFAULT_MS;
+}
@@ -0,0 +1,482 @@
+#include "ui/gcode_cache.h"
+#include "ui/upload_manager.h"
+#include "core/sd_card.h"
+#include "network/fluidnc_client.h"
+#include "network/connection_manager.h"
+#include "config.h"
+#include <LittleFS.h>
+#include <HTTPClient.h>
+#include <esp_heap_caps.h>
+
+// Static member initialization
+bool GCodeCache::loaded = false;
+bool GCodeCache::fs_ok = false;
+GCodeCacheEntry *GCodeCache::entries = nullptr;
+uint32_t GCodeCache::entry_count = 0;
+uint32_t GCodeCache::use_counter = 0;
+bool GCodeCache::changed = false;
+std::vector<GCodeCache::PendingFile> GCodeCache::background;
+bool GCodeCache::job_active = false;
+bool GCodeCache::job_foreground = false;
+bool GCodeCache::job_display_sd = false;
+char GCodeCache::job_path[256] = "";
+uint32_t GCodeCache::job_size = 0;
+uint32_t GCodeCache::job_head_hash = 0;
+uint32_t GCodeCache::job_key = 0;
+uint32_t GCodeCache::last_key = 0;
+HTTPClient *GCodeCache::http = nullptr;
+WiFiClient *GCodeCache::stream = nullptr;
+
+static GCodeAnalyzer analyzer;
+static GCodeThumbnail thumb_buf;
+static SDReader job_reader;
+static uint32_t job_read = 0;
+static char tail_buf[GCODE_CACHE_HASH_BLOCK];   // Last bytes of the file for the content hash
+static float job_profile[GCodeCacheEntry::PROFILE_POINTS + 1];
+static int job_profile_next = 0;                // Next profile point to fill
+
+// Cache file layout: header, then fixed-size records (entry header + thumbnail)
+struct CacheFileHeader {
+    uint32_t magic;
+    uint32_t record_size;
+};
+static const uint32_t CACHE_MAGIC = 0x34434347;  // "GCC4" - bump when analysis results change
+static const uint32_t RECORD_SIZE = sizeof(GCodeCacheEntry) + sizeof(GCodeThumbnail);
+
+static const uint32_t FNV_OFFSET = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+static uint32_t fnv(uint32_t hash, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Minimal URL encoding for FluidNC file paths
+static String encodePath(const char *path) {
+    String out;
+    for (const char *p = path; *p; p++) {
+        char c = *p;
+        if (isalnum((unsigned char)c) || c == '/' || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += c;
+        } else {
+            char hex[4];
+            snprintf(hex, sizeof(hex), "%%%02X", (uint8_t)c);
+            out += hex;
+        }
+    }
+    return out;
+}
+
+String GCodeCache::fileURL(const char *path) {
+    // FluidNC serves its storage over HTTP at /sd/... and /localfs/...
+    const char *host = ConnectionManager::getResolvedHost();
+    if (!host || !host[0]) return String();
+    return String("http://") + host + encodePath(path);
+}
+
+uint32_t GCodeCache::hashPath(const char *path, bool display_sd) {
+    uint32_t h = FNV_OFFSET;
+    if (!display_sd) {
+        // The same /sd/ path on another machine is another file - the machine URL
+        // (with its terminator as separator) goes in front of the path
+        const char *machine = FluidNCClient::getMachineURL();
+        h = fnv(h, (const uint8_t*)machine, strlen(machine) + 1);
+    }
+    h = fnv(h, (const uint8_t*)path, strlen(path));
+    return h ? h : 1;  // 0 marks an empty slot
+}
+
+void GCodeCache::ensureLoaded() {
+    if (loaded) return;
+    loaded = true;
+
+    entries = (GCodeCacheEntry*)heap_caps_calloc(GCODE_CACHE_SLOTS, sizeof(GCodeCacheEntry), MALLOC_CAP_SPIRAM);
+    if (!entries) {
+        Serial.println("[GCodeCache] Failed to allocate index");
+        return;
+    }
+
+    fs_ok = LittleFS.begin(true);
+    if (!fs_ok) {
+        Serial.println("[GCodeCache] LittleFS mount failed - results kept in RAM only");
+        return;
+    }
+
+    File f = LittleFS.open(GCODE_CACHE_PATH, FILE_READ);
+    if (f) {
+        CacheFileHeader header;
+        if (f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == CACHE_MAGIC && header.record_size == RECORD_SIZE) {
+            // Only the headers are kept in RAM - thumbnails are read on demand
+            while (entry_count < GCODE_CACHE_SLOTS &&
+                   f.seek(sizeof(header) + entry_count * RECORD_SIZE) &&
+                   f.read((uint8_t*)&entries[entry_count], sizeof(GCodeCacheEntry)) == sizeof(GCodeCacheEntry)) {
+                if (entries[entry_count].last_used > use_counter) use_counter = entries[entry_count].last_used;
+                entry_count++;
+            }
+        } else {
+            Serial.println("[GCodeCache] Cache format changed - starting over");
+            f.close();
+            LittleFS.remove(GCODE_CACHE_PATH);
+        }
+        if (f) f.close();
+    }
+    Serial.printf("[GCodeCache] %u cached analyses\n", entry_count);
+}
+
+int GCodeCache::findSlot(uint32_t path_hash, uint32_t size) {
+    for (uint32_t i = 0; i < entry_count; i++) {
+        if (entries[i].path_hash == path_hash && entries[i].size == size) return i;
+    }
+    return -1;
+}
+
+const GCodeCacheEntry* GCodeCache::lookup(const char *path, bool display_sd, uint32_t size) {
+    ensureLoaded();
+    if (!entries) return nullptr;
+    int slot = findSlot(hashPath(path, display_sd), size);
+    if (slot < 0) return nullptr;
+    entries[slot].last_used = ++use_counter;
+    return &entries[slot];
+}
+
+const GCodeCacheEntry* GCodeCache::lookupPath(const char *path, bool display_sd) {
+    ensureLoaded();
+    if (!entries) return nullptr;
+    uint32_t path_hash = hashPath(path, display_sd);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        if (entries[i].path_hash == path_hash) return &entries[i];
+    }
+    return nullptr;
+}
+
+void GCodeCache::profileHook(uint32_t byte_offset, float time_sec, void *ctx) {
+    // Record the time estimate as each 1/PROFILE_POINTS of the file is passed
+    const int N = GCodeCacheEntry::PROFILE_POINTS;
+    if (job_size == 0) return;
+    while (job_profile_next <= N && (uint64_t)byte_offset * N >= (uint64_t)job_profile_next * job_size) {
+        job_profile[job_profile_next++] = time_sec;
+    }
+}
+
+bool GCodeCache::get(const char *path, bool display_sd, uint32_t size, GCodeAnalysis &analysis, GCodeThumbnail &thumbnail) {
+    // Most recent job result is still in the analyzer
+    uint32_t key = hashPath(path, display_sd);
+    if (!job_active && last_key == key) {
+        analysis = analyzer.result();
+        analyzer.getThumbnail(thumbnail);
+        return true;
+    }
+
+    const GCodeCacheEntry *entry = lookup(path, display_sd, size);
+    if (!entry || !fs_ok) return false;
+
+    File f = LittleFS.open(GCODE_CACHE_PATH, FILE_READ);
+    if (!f) return false;
+    uint32_t slot = entry - entries;
+    bool ok = f.seek(sizeof(CacheFileHeader) + slot * RECORD_SIZE + sizeof(GCodeCacheEntry)) &&
+              f.read((uint8_t*)&thumbnail, sizeof(GCodeThumbnail)) == sizeof(GCodeThumbnail);
+    f.close();
+    if (ok) analysis = entry->analysis;
+    return ok;
+}
+
+void GCodeCache::store(uint32_t path_hash) {
+    if (!entries) return;
+
+    // Same path is replaced in place, otherwise append or reuse the least recently used slot
+    int slot = -1;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        if (entries[i].path_hash == path_hash) { slot = i; break; }
+    }
+    if (slot < 0 && entry_count < GCODE_CACHE_SLOTS) {
+        slot = entry_count;
+    }
+    if (slot < 0) {
+        slot = 0;
+        for (uint32_t i = 1; i < entry_count; i++) {
+            if (entries[i].last_used < entries[slot].last_used) slot = i;
+        }
+    }
+
+    GCodeCacheEntry &e = entries[slot];
+    e.path_hash = path_hash;
+    e.size = job_size;
+    e.content_hash = finishHash();
+    e.last_used = ++use_counter;
+    e.analysis = analyzer.result();
+    for (int k = job_profile_next; k <= GCodeCacheEntry::PROFILE_POINTS; k++) {
+        job_profile[k] = e.analysis.est_time_sec;
+    }
+    memcpy(e.profile, job_profile, sizeof(e.profile));
+    if ((uint32_t)slot == entry_count) entry_count++;
+    changed = true;
+
+    if (!fs_ok) return;
+
+    // Create the file with its header on first use
+    if (!LittleFS.exists(GCODE_CACHE_PATH)) {
+        File f = LittleFS.open(GCODE_CACHE_PATH, FILE_WRITE);
+        if (!f) return;
+        CacheFileHeader header = {CACHE_MAGIC, RECORD_SIZE};
+        f.write((const uint8_t*)&header, sizeof(header));
+        f.close();
+    }
+
+    analyzer.getThumbnail(thumb_buf);
+    File f = LittleFS.open(GCODE_CACHE_PATH, "r+");
+    if (!f) return;
+    if (f.seek(sizeof(CacheFileHeader) + slot * RECORD_SIZE)) {
+        f.write((const uint8_t*)&e, sizeof(GCodeCacheEntry));
+        f.write((const uint8_t*)&thumb_buf, sizeof(GCodeThumbnail));
+    }
+    f.close();
+}
+
+bool GCodeCache::hashDisplaySDFile(const char *path, uint32_t &hash) {
+    SDReader f;
+    if (!f.open(path)) return false;
+
+    // Head block, then tail block (tail_buf may belong to a running job)
+    uint8_t buf[512];
+    uint32_t size = f.size();
+    uint32_t n = size < GCODE_CACHE_HASH_BLOCK ? size : GCODE_CACHE_HASH_BLOCK;
+    bool ok = true;
+    hash = FNV_OFFSET;
+    for (int pass = 0; pass < 2 && ok; pass++) {
+        ok = f.seek(pass == 0 ? 0 : size - n);
+        for (uint32_t done = 0; ok && done < n; ) {
+            uint32_t want = n - done < sizeof(buf) ? n - done : sizeof(buf);
+            ok = f.read(buf, want) == (int)want;
+            hash = fnv(hash, buf, want);
+            done += want;
+        }
+    }
+    hash = (hash ^ size) * FNV_PRIME;
+    f.close();
+    return ok;
+}
+
+uint32_t GCodeCache::finishHash() {
+    // Same result as hashDisplaySDFile(): head block, then the tail block in file order
+    uint32_t n = job_read < GCODE_CACHE_HASH_BLOCK ? job_read : GCODE_CACHE_HASH_BLOCK;
+    uint32_t start = (job_read - n) % GCODE_CACHE_HASH_BLOCK;
+    uint32_t hash = job_head_hash;
+    for (uint32_t i = 0; i < n; i++) {
+        hash = (hash ^ (uint8_t)tail_buf[(start + i) % GCODE_CACHE_HASH_BLOCK]) * FNV_PRIME;
+    }
+    return (hash ^ job_read) * FNV_PRIME;
+}
+
+bool GCodeCache::analyze(const char *path, bool display_sd, uint32_t size) {
+    ensureLoaded();
+
+    if (job_active && job_key == hashPath(path, display_sd)) {
+        job_foreground = true;
+        return true;
+    }
+
+    const GCodeCacheEntry *entry = lookup(path, display_sd, size);
+    if (entry) {
+        // FluidNC files can't be checked without downloading them - path and size have to do
+        if (!display_sd) return false;
+        uint32_t hash;
+        if (hashDisplaySDFile(path, hash) && hash == entry->content_hash) return false;
+        Serial.printf("[GCodeCache] %s changed - re-analyzing\n", path);
+    }
+
+    if (job_active) {
+        // Background job is dropped - it is queued again the next time its folder is listed
+        endJob(false);
+    }
+    return startJob(path, display_sd, size, true);
+}
+
+bool GCodeCache::startJob(const char *path, bool display_sd, uint32_t size, bool foreground) {
+    strncpy(job_path, path, sizeof(job_path) - 1);
+    job_path[sizeof(job_path) - 1] = '\0';
+    job_display_sd = display_sd;
+    job_key = hashPath(path, display_sd);   // Taken now - the focused machine may change before it ends
+    job_size = size;
+    job_foreground = foreground;
+    job_read = 0;
+    job_head_hash = FNV_OFFSET;
+    last_key = 0;
+
+    if (display_sd) {
+        if (!job_reader.open(path)) return false;
+        job_size = job_reader.size();
+    } else {
+        String url = fileURL(path);
+        if (url.isEmpty()) return false;
+
+        http = new HTTPClient();
+        http->begin(url);
+        http->setTimeout(PREVIEW_HTTP_TIMEOUT_MS);
+        int code = http->GET();
+        if (code != HTTP_CODE_OK) {
+            Serial.printf("[GCodeCache] HTTP GET %s failed: %d\n", path, code);
+            http->end();
+            delete http;
+            http = nullptr;
+            return false;
+        }
+        int len = http->getSize();
+        if (len > 0) job_size = len;
+        stream = http->getStreamPtr();
+    }
+
+    GCodeMachineLimits limits;
+    limits.rapid_rate_mm_min = PREVIEW_RAPID_RATE_MM_MIN;
+    limits.accel_mm_s2 = PREVIEW_ACCEL_MM_S2;
+    limits.junction_factor = PREVIEW_JUNCTION_FACTOR;
+    analyzer.begin(limits);
+    analyzer.setProgressHook(profileHook, nullptr);
+    job_profile[0] = 0.0f;
+    job_profile_next = 1;
+    job_active = true;
+    Serial.printf("[GCodeCache] Analyzing %s (%s%s)\n", path, display_sd ? "Display SD" : "FluidNC",
+                  foreground ? "" : ", background");
+    return true;
+}
+
+void GCodeCache::endJob(bool complete) {
+    job_reader.close();
+    if (http) {
+        http->end();
+        delete http;
+        http = nullptr;
+    }
+    stream = nullptr;
+    job_active = false;
+
+    if (!complete) return;
+
+    analyzer.finish();
+    last_key = job_key;
+    store(job_key);
+
+    const GCodeAnalysis &r = analyzer.result();
+    Serial.printf("[GCodeCache] Done: %u lines, %u moves, cut %.0f mm, rapid %.0f mm, est %.0f s\n",
+                  r.line_count, r.move_count, r.cut_length_mm, r.rapid_length_mm, r.est_time_sec);
+}
+
+void GCodeCache::clearBackground() {
+    background.clear();
+}
+
+void GCodeCache::queueBackground(const char *path, uint32_t size) {
+    // Cached files are queued too, to have their content hash checked
+    bool cached = lookup(path, true, size) != nullptr;
+    uint32_t queued = 0;
+    for (const PendingFile &f : background) {
+        if (f.cached == cached) queued++;
+    }
+    if (queued >= GCODE_CACHE_SLOTS) return;
+    background.push_back({path, size, cached});
+}
+
+bool GCodeCache::isAnalyzing(const char *path) {
+    return job_active && strcmp(job_path, path) == 0;
+}
+
+int GCodeCache::getProgress() {
+    if (!job_active || job_size == 0) return 0;
+    return (int)((uint64_t)job_read * 100 / job_size);
+}
+
+const GCodeAnalyzer& GCodeCache::getAnalyzer() {
+    return analyzer;
+}
+
+bool GCodeCache::takeChanged() {
+    bool was = changed;
+    changed = false;
+    return was;
+}
+
+// Background work only while nothing else needs the machine or the SD card
+static bool backgroundAllowed() {
+    if (UploadManager::isUploading()) return false;
+    const FluidNCStatus &status = FluidNCClient::getStatus();
+    if (status.is_sd_printing) return false;
+    return status.state == STATE_IDLE || !FluidNCClient::isConnected();
+}
+
+void GCodeCache::loop() {
+    if (!job_active) {
+        // Start the next background job
+        while (!background.empty() && backgroundAllowed()) {
+            PendingFile next = background.front();
+            background.erase(background.begin());
+            const GCodeCacheEntry *entry = lookup(next.path.c_str(), true, next.size);
+            if (entry) {
+                // Path and size match - check the content, one file per loop (reads head and tail)
+                uint32_t hash;
+                if (!hashDisplaySDFile(next.path.c_str(), hash) || hash == entry->content_hash) return;
+                Serial.printf("[GCodeCache] %s changed - re-analyzing\n", next.path.c_str());
+            }
+            if (startJob(next.path.c_str(), true, next.size, false)) break;
+        }
+        return;
+    }
+
+    if (!job_foreground && !backgroundAllowed()) {
+        // Machine got busy - try again later
+        background.insert(background.begin(), {job_path, job_size, false});
+        endJob(false);
+        return;
+    }
+    if (job_display_sd && UploadManager::isUploading()) return;
+
+    static char buf[1024];
+    uint32_t budget = job_foreground ? PREVIEW_CHUNK_BYTES : GCODE_CACHE_BACKGROUND_CHUNK;
+    bool done = false;
+    bool failed = false;
+
+    while (budget > 0) {
+        size_t want = budget < sizeof(buf) ? budget : sizeof(buf);
+        int n = 0;
+        if (job_display_sd) {
+            n = job_reader.read((uint8_t*)buf, want);
+            if (n <= 0) { done = true; break; }
+        } else {
+            int avail = stream->available();
+            if (avail <= 0) {
+                if (!stream->connected()) {
+                    done = true;
+                    failed = job_size > 0 && job_read < job_size;
+                }
+                break;  // Wait for more data next loop
+            }
+            n = stream->read((uint8_t*)buf, (size_t)avail < want ? (size_t)avail : want);
+            if (n <= 0) break;
+        }
+
+        // Content hash: first block directly, last block through a ring buffer
+        if (job_read < GCODE_CACHE_HASH_BLOCK) {
+            uint32_t head = GCODE_CACHE_HASH_BLOCK - job_read;
+            job_head_hash = fnv(job_head_hash, (const uint8_t*)buf, (uint32_t)n < head ? (uint32_t)n : head);
+        }
+        for (int i = 0; i < n; i++) {
+            tail_buf[(job_read + i) % GCODE_CACHE_HASH_BLOCK] = buf[i];
+        }
+
+        analyzer.feed(buf, n);
+        job_read += n;
+        budget -= n;
+
+        if (job_size > 0 && job_read >= job_size) {
+            done = true;
+            break;
+        }
+    }
+
+    if (done) {
+        if (failed) Serial.printf("[GCodeCache] %s: connection closed after %u of %u bytes\n", job_path, job_read, job_size);
+        job_size = job_read;
+        endJob(!failed);
+    }
+}
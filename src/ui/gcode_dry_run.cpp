@@ -0,0 +1,287 @@
+#include "ui/gcode_dry_run.h"
+#include "ui/gcode_cache.h"
+#include "ui/upload_manager.h"
+#include "core/sd_card.h"
+#include "network/fluidnc_client.h"
+#include "network/gcode_sender.h"
+#include "config.h"
+#include <HTTPClient.h>
+
+// Static member initialization
+GCodeDryRun::State GCodeDryRun::state = GCodeDryRun::State::IDLE;
+char GCodeDryRun::path[256] = "";
+bool GCodeDryRun::display_sd = false;
+uint32_t GCodeDryRun::file_size = 0;
+uint32_t GCodeDryRun::file_read = 0;
+GCodeSimSetup GCodeDryRun::setup;
+bool GCodeDryRun::machine_setup = false;
+int GCodeDryRun::pending_responses = 0;
+uint32_t GCodeDryRun::query_start_ms = 0;
+float GCodeDryRun::travel[3] = {0, 0, 0};
+float GCodeDryRun::home_mpos[3] = {0, 0, 0};
+bool GCodeDryRun::home_positive[3] = {true, true, true};
+HTTPClient *GCodeDryRun::http = nullptr;
+WiFiClient *GCodeDryRun::stream = nullptr;
+
+static GCodeSimulator simulator;
+static SDReader reader;
+
+static const char AXIS_LETTERS[] = "xyz";
+static const char *WCS_NAMES[6] = {"G54", "G55", "G56", "G57", "G58", "G59"};
+static const int QUERY_RESPONSES = 1 + 3 * 3;   // $# and three settings per axis
+
+bool GCodeDryRun::start(const char *file_path, bool from_display_sd) {
+    if (isRunning()) cancel();
+
+    strncpy(path, file_path, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    display_sd = from_display_sd;
+    file_read = 0;
+    file_size = 0;
+
+    // Without answers from the machine the job is placed with the current work offset (WCO)
+    const FluidNCStatus &status = FluidNCClient::getStatus();
+    setup.reset();
+    machine_setup = false;
+    setup.active_wcs = status.modal.wcs;
+    if (status.is_connected) {
+        setup.start[0] = status.mpos_x;
+        setup.start[1] = status.mpos_y;
+        setup.start[2] = status.mpos_z;
+        setup.wcs[setup.active_wcs][0] = status.wco_x;
+        setup.wcs[setup.active_wcs][1] = status.wco_y;
+        setup.wcs[setup.active_wcs][2] = status.wco_z;
+    }
+
+    // Queries share the response stream with a running job - only ask an idle machine
+    if (!FluidNCClient::isConnected() || status.state != STATE_IDLE || status.is_sd_printing || GCodeSender::isActive()) {
+        Serial.printf("[DryRun] %s: machine not idle - using the current work offset only\n", path);
+        startSimulation();
+        return state == State::RUNNING;
+    }
+
+    for (int a = 0; a < 3; a++) {
+        travel[a] = 0.0f;
+        home_mpos[a] = 0.0f;
+        home_positive[a] = true;   // FluidNC defaults
+    }
+    char cmd[320];
+    int len = snprintf(cmd, sizeof(cmd), "$#\n");
+    for (int a = 0; a < 3; a++) {
+        char c = AXIS_LETTERS[a];
+        len += snprintf(cmd + len, sizeof(cmd) - len,
+                        "$/axes/%c/max_travel_mm\n$/axes/%c/homing/mpos_mm\n$/axes/%c/homing/positive_direction\n", c, c, c);
+    }
+    pending_responses = QUERY_RESPONSES;
+    query_start_ms = millis();
+    state = State::QUERYING;
+    FluidNCClient::setMessageCallback(onMessage);
+    FluidNCClient::sendCommand(cmd);
+    return true;
+}
+
+void GCodeDryRun::onMessage(const char *message) {
+    if (state != State::QUERYING) return;
+
+    // A message may carry several lines
+    char line[128];
+    const char *p = message;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+        if (len > 0 && p[len - 1] == '\r') len--;
+        if (len < sizeof(line)) {
+            memcpy(line, p, len);
+            line[len] = '\0';
+            parseResponse(line);
+        }
+        if (!eol) break;
+        p = eol + 1;
+    }
+}
+
+void GCodeDryRun::parseResponse(const char *line) {
+    if (strcmp(line, "ok") == 0 || strncmp(line, "error:", 6) == 0) {
+        // Settings that don't exist (no homing section) answer with an error - defaults stay.
+        // The simulation is started from loop(), not from inside the WebSocket callback.
+        pending_responses--;
+        return;
+    }
+
+    float v[3];
+    if (line[0] == '[') {
+        // $# lines: [G54:x,y,z,...] [G28:...] [G30:...] [G92:...] [TLO:z]
+        float *dest = nullptr;
+        for (int i = 0; i < 6; i++) {
+            if (strncmp(line + 1, WCS_NAMES[i], 3) == 0 && line[4] == ':') dest = setup.wcs[i];
+        }
+        if (strncmp(line, "[G28:", 5) == 0) dest = setup.g28;
+        if (strncmp(line, "[G30:", 5) == 0) dest = setup.g30;
+        if (strncmp(line, "[G92:", 5) == 0) dest = setup.g92;
+        if (strncmp(line, "[TLO:", 5) == 0) {
+            setup.tlo = strtof(line + 5, nullptr);
+        } else if (dest && sscanf(line + 5, "%f,%f,%f", &v[0], &v[1], &v[2]) == 3) {
+            memcpy(dest, v, sizeof(v));
+        }
+        return;
+    }
+
+    // Axis settings: $/axes/x/max_travel_mm=300.000
+    if (strncmp(line, "$/axes/", 7) != 0 || line[8] != '/') return;
+    const char *axis_letter = strchr(AXIS_LETTERS, line[7]);
+    const char *eq = strchr(line, '=');
+    if (!axis_letter || !eq) return;
+    int a = axis_letter - AXIS_LETTERS;
+    const char *name = line + 9;
+    if (strncmp(name, "max_travel_mm=", 14) == 0) {
+        travel[a] = strtof(eq + 1, nullptr);
+    } else if (strncmp(name, "homing/mpos_mm=", 15) == 0) {
+        home_mpos[a] = strtof(eq + 1, nullptr);
+    } else if (strncmp(name, "homing/positive_direction=", 26) == 0) {
+        home_positive[a] = strcmp(eq + 1, "true") == 0;
+    }
+}
+
+void GCodeDryRun::startSimulation() {
+    if (state == State::QUERYING) {
+        FluidNCClient::clearMessageCallback();
+    }
+
+    // Soft limit envelope as FluidNC derives it: travel ends at the homing position
+    for (int a = 0; a < 3 && machine_setup; a++) {
+        if (travel[a] <= 0.0f) continue;
+        setup.has_envelope[a] = true;
+        setup.min[a] = home_positive[a] ? home_mpos[a] - travel[a] : home_mpos[a];
+        setup.max[a] = home_positive[a] ? home_mpos[a] : home_mpos[a] + travel[a];
+    }
+
+    if (!openFile()) {
+        Serial.printf("[DryRun] Cannot open %s\n", path);
+        end(State::FAILED);
+        return;
+    }
+    simulator.begin(setup);
+    state = State::RUNNING;
+    Serial.printf("[DryRun] Simulating %s (%s, %s)\n", path, display_sd ? "Display SD" : "FluidNC",
+                  machine_setup ? "machine offsets and envelope" : "work offset only");
+}
+
+bool GCodeDryRun::openFile() {
+    if (display_sd) {
+        if (!reader.open(path)) return false;
+        file_size = reader.size();
+        return true;
+    }
+
+    String url = GCodeCache::fileURL(path);
+    if (url.isEmpty()) return false;
+    http = new HTTPClient();
+    http->begin(url);
+    http->setTimeout(PREVIEW_HTTP_TIMEOUT_MS);
+    int code = http->GET();
+    if (code != HTTP_CODE_OK) {
+        Serial.printf("[DryRun] HTTP GET %s failed: %d\n", path, code);
+        http->end();
+        delete http;
+        http = nullptr;
+        return false;
+    }
+    int len = http->getSize();
+    file_size = len > 0 ? len : 0;
+    stream = http->getStreamPtr();
+    return true;
+}
+
+void GCodeDryRun::end(State final_state) {
+    if (state == State::QUERYING) {
+        FluidNCClient::clearMessageCallback();
+    }
+    reader.close();
+    if (http) {
+        http->end();
+        delete http;
+        http = nullptr;
+    }
+    stream = nullptr;
+    state = final_state;
+}
+
+void GCodeDryRun::cancel() {
+    if (!isRunning()) return;
+    Serial.printf("[DryRun] %s cancelled\n", path);
+    end(State::IDLE);
+}
+
+int GCodeDryRun::getProgress() {
+    if (state != State::RUNNING || file_size == 0) return 0;
+    return (int)((uint64_t)file_read * 100 / file_size);
+}
+
+const GCodeSimReport& GCodeDryRun::getReport() {
+    return simulator.report();
+}
+
+void GCodeDryRun::loop() {
+    if (state == State::QUERYING) {
+        if (pending_responses <= 0) {
+            machine_setup = true;
+            startSimulation();
+        } else if (millis() - query_start_ms >= DRY_RUN_QUERY_TIMEOUT_MS) {
+            Serial.printf("[DryRun] %d responses missing - simulating with what was received\n", pending_responses);
+            machine_setup = pending_responses < QUERY_RESPONSES;
+            startSimulation();
+        }
+        return;
+    }
+    if (state != State::RUNNING) return;
+    if (display_sd && UploadManager::isUploading()) return;
+
+    static char buf[1024];
+    uint32_t budget = DRY_RUN_CHUNK_BYTES;
+    bool done = false;
+    bool failed = false;
+
+    while (budget > 0) {
+        size_t want = budget < sizeof(buf) ? budget : sizeof(buf);
+        int n = 0;
+        if (display_sd) {
+            n = reader.read((uint8_t*)buf, want);
+            if (n < 0) failed = true;
+            if (n <= 0) { done = true; break; }
+        } else {
+            int avail = stream->available();
+            if (avail <= 0) {
+                if (!stream->connected()) {
+                    done = true;
+                    failed = file_size > 0 && file_read < file_size;
+                }
+                break;  // Wait for more data next loop
+            }
+            n = stream->read((uint8_t*)buf, (size_t)avail < want ? (size_t)avail : want);
+            if (n <= 0) break;
+        }
+
+        simulator.feed(buf, n);
+        file_read += n;
+        budget -= n;
+
+        if (file_size > 0 && file_read >= file_size) {
+            done = true;
+            break;
+        }
+    }
+
+    if (!done) return;
+    if (failed) {
+        Serial.printf("[DryRun] %s: read failed after %u of %u bytes\n", path, file_read, file_size);
+        end(State::FAILED);
+        return;
+    }
+
+    simulator.finish();
+    end(State::DONE);
+    const GCodeSimReport &r = simulator.report();
+    Serial.printf("[DryRun] Done: %u lines, %u moves, %u issues (envelope %u, unsupported %u, spindle %u, feed %u, arc %u)\n",
+                  r.line_count, r.move_count, r.total(), r.counts[SIM_ENVELOPE], r.counts[SIM_UNSUPPORTED],
+                  r.counts[SIM_NO_SPINDLE], r.counts[SIM_NO_FEED], r.counts[SIM_BAD_ARC]);
+}
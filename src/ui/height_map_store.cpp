@@ -0,0 +1,82 @@
+#include "ui/height_map_store.h"
+#include "ui/upload_manager.h"
+#include "config.h"
+#include "core/sd_card.h"
+
+// Static member initialization
+HeightMap HeightMapStore::map;
+bool HeightMapStore::loaded = false;
+bool HeightMapStore::probing = false;
+bool HeightMapStore::enabled = false;
+
+// Largest file image (HeightMap::MAX_SIDE points per axis)
+static const size_t MAX_IMAGE = HeightMap::HEADER_SIZE + HeightMap::MAX_SIDE * HeightMap::MAX_SIDE * 2;
+
+bool HeightMapStore::load(bool force) {
+    if (loaded && !force) return map.isComplete();
+    loaded = true;
+    map.clear();
+
+    if (!UploadManager::init() || !SDCard::exists(HEIGHTMAP_PATH)) return false;
+    SDReader file;
+    if (!file.open(HEIGHTMAP_PATH)) return false;
+
+    size_t size = file.size();
+    uint8_t *buf = size <= MAX_IMAGE ? (uint8_t*)malloc(size) : nullptr;
+    bool ok = buf && file.read(buf, size) == (int)size && map.decode(buf, size);
+    free(buf);
+    file.close();
+
+    if (!ok) {
+        Serial.printf("[HeightMap] %s is not a valid height map (%u bytes)\n", HEIGHTMAP_PATH, size);
+        map.clear();
+        return false;
+    }
+    Serial.printf("[HeightMap] Loaded %dx%d grid from %s\n", map.getNX(), map.getNY(), HEIGHTMAP_PATH);
+    return true;
+}
+
+bool HeightMapStore::save() {
+    size_t size = map.encodedSize();
+    uint8_t *buf = (uint8_t*)malloc(size);
+    if (!buf || map.encode(buf, size) != size || !UploadManager::init()) {
+        free(buf);
+        return false;
+    }
+
+    File file = SDCard::openForWrite(HEIGHTMAP_PATH);
+    bool ok = file && file.write(buf, size) == size;
+    if (file) file.close();
+    free(buf);
+    Serial.printf("[HeightMap] %s %s (%u bytes)\n", ok ? "Saved" : "Failed to save", HEIGHTMAP_PATH, size);
+    return ok;
+}
+
+bool HeightMapStore::startProbe(float x0, float y0, float width, float height, int nx, int ny, const ProbeParams &params) {
+    if (probing || ProbeSequencer::isRunning()) return false;
+    if (!map.setup(x0, y0, width, height, nx, ny)) {
+        Serial.printf("[HeightMap] Invalid grid %dx%d over %.3f x %.3f\n", nx, ny, width, height);
+        load(true);
+        return false;
+    }
+    if (!ProbeSequencer::probeGrid(map, params)) {
+        load(true);
+        return false;
+    }
+    probing = true;
+    loaded = true;
+    return true;
+}
+
+void HeightMapStore::loop() {
+    if (!probing || ProbeSequencer::isRunning()) return;
+    probing = false;
+
+    if (ProbeSequencer::getState() == ProbeSequencer::State::DONE && map.isComplete()) {
+        save();
+    } else {
+        // Partial grids are never used - go back to the saved map
+        Serial.println("[HeightMap] Grid probing stopped - keeping the saved map");
+        load(true);
+    }
+}
@@ -1,171 +1,519 @@
 #include "ui/machine_config.h"
 #include "config.h"
+#include "ui/settings_store.h"
 #include <Preferences.h>
+#include <LittleFS.h>
 #include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <esp_heap_caps.h>
 
-// Static cache members
-MachineConfig MachineConfigManager::cached_machines[MAX_MACHINES];
-bool MachineConfigManager::cache_valid = false;
+static_assert(MAX_MACHINES <= 32, "dirty_summaries is a 32-bit mask");
 
-void MachineConfigManager::loadMachines(MachineConfig machines[MAX_MACHINES]) {
-    // If cache is valid, copy from cache instead of reading NVS
-    if (cache_valid) {
-        Serial.println("MachineConfigManager: Using cached machines");
-        memcpy(machines, cached_machines, sizeof(MachineConfig) * MAX_MACHINES);
+// Static members
+MachineSummary *MachineConfigManager::summaries = nullptr;
+MachineConfig *MachineConfigManager::ram_records = nullptr;
+bool MachineConfigManager::loaded = false;
+bool MachineConfigManager::fs_ok = false;
+MachineConfig MachineConfigManager::cached_config;
+int MachineConfigManager::cached_index = -1;
+bool MachineConfigManager::cached_dirty = false;
+uint32_t MachineConfigManager::dirty_summaries = 0;
+uint8_t MachineConfigManager::recent[MACHINE_RECENT_COUNT];
+int MachineConfigManager::recent_count = 0;
+
+static MachineSummary empty_summary = {};
+
+// Catalog file layout:
+//   CatalogHeader
+//   MachineSummary[slots]   - read into RAM on first use
+//   CatalogRecord[slots]    - read one at a time with a seek
+// LittleFS only replaces a file's blocks when it is closed, so an interrupted write
+// leaves the previous version. Bump CATALOG_VERSION (and convert in ensureLoaded)
+// when MachineConfig or MachineSummary change.
+struct CatalogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slots;          // MAX_MACHINES when written
+    uint32_t summary_size;
+    uint32_t record_size;
+};
+
+struct CatalogRecord {
+    uint32_t crc;            // CRC32 of config
+    MachineConfig config;
+};
+
+static const uint32_t CATALOG_MAGIC = 0x4D434654;  // "TFCM"
+static const uint16_t CATALOG_VERSION = 1;
+
+static size_t summaryOffset(int index) {
+    return sizeof(CatalogHeader) + index * sizeof(MachineSummary);
+}
+
+static size_t recordOffset(int index, int slots = MAX_MACHINES) {
+    return sizeof(CatalogHeader) + slots * sizeof(MachineSummary) + index * sizeof(CatalogRecord);
+}
+
+// Machines were kept in NVS (4 slots) before the catalog: first as one key per
+// field, then as one "m<i>_rec" blob per slot. Both are migrated on first load.
+static const int NVS_SLOTS = 4;
+static const uint16_t NVS_RECORD_VERSION = 1;
+
+struct NVSRecord {
+    uint16_t version;
+    uint16_t size;         // sizeof(MachineConfig) when written
+    uint32_t crc;          // CRC32 of config
+    MachineConfig config;
+};
+
+// Per-field keys used before the packed record
+static const char *LEGACY_KEYS[] = {
+    "cfg", "name", "type", "ssid", "pwd", "url", "port",
+    "jxy_st", "jz_st", "ja_st", "jxy_fd", "jz_fd", "ja_fd", "jxy_mx", "jz_mx", "ja_mx",
+    "jxy_sts", "jz_sts", "ja_sts", "p_feed", "p_dist", "p_ret", "p_thick", "a_en"
+};
+
+static uint32_t configCrc(const MachineConfig &config) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&config, sizeof(MachineConfig));
+}
+
+static bool readNVSRecord(Preferences &prefs, int index, MachineConfig &config) {
+    char key[16];
+    snprintf(key, sizeof(key), "m%d_rec", index);
+    if (prefs.getBytesLength(key) != sizeof(NVSRecord)) return false;
+
+    NVSRecord record;
+    if (prefs.getBytes(key, &record, sizeof(record)) != sizeof(record)) return false;
+    if (record.version != NVS_RECORD_VERSION || record.size != sizeof(MachineConfig) ||
+        record.crc != configCrc(record.config)) {
+        Serial.printf("MachineConfigManager: Slot %d NVS record invalid (version %u, size %u)\n",
+                      index, record.version, record.size);
+        return false;
+    }
+    config = record.config;
+    return true;
+}
+
+// Read a slot from the old one-key-per-field layout
+static bool readLegacy(Preferences &prefs, int i, MachineConfig &config) {
+    String prefix = "m" + String(i) + "_";
+    if (!prefs.isKey((prefix + "cfg").c_str())) return false;
+
+    config = MachineConfig();
+    config.is_configured = prefs.getBool((prefix + "cfg").c_str(), false);
+    if (!config.is_configured) return true;
+
+    prefs.getString((prefix + "name").c_str(), config.name, sizeof(config.name));
+    config.connection_type = (ConnectionType)prefs.getUChar((prefix + "type").c_str(), CONN_WIRELESS);
+    prefs.getString((prefix + "ssid").c_str(), config.ssid, sizeof(config.ssid));
+    prefs.getString((prefix + "pwd").c_str(), config.password, sizeof(config.password));
+    prefs.getString((prefix + "url").c_str(), config.fluidnc_url, sizeof(config.fluidnc_url));
+    config.websocket_port = prefs.getUShort((prefix + "port").c_str(), 81);
+
+    // Jog settings (with defaults if not present)
+    config.jog_xy_step = prefs.getFloat((prefix + "jxy_st").c_str(), 10.0f);
+    config.jog_z_step = prefs.getFloat((prefix + "jz_st").c_str(), 1.0f);
+    config.jog_a_step = prefs.getFloat((prefix + "ja_st").c_str(), 1.0f);
+    config.jog_xy_feed = prefs.getInt((prefix + "jxy_fd").c_str(), 3000);
+    config.jog_z_feed = prefs.getInt((prefix + "jz_fd").c_str(), 1000);
+    config.jog_a_feed = prefs.getInt((prefix + "ja_fd").c_str(), 1000);
+    config.jog_max_xy_feed = prefs.getInt((prefix + "jxy_mx").c_str(), 3000);
+    config.jog_max_z_feed = prefs.getInt((prefix + "jz_mx").c_str(), 1000);
+    config.jog_max_a_feed = prefs.getInt((prefix + "ja_mx").c_str(), 1000);
+    prefs.getString((prefix + "jxy_sts").c_str(), config.jog_xy_steps, sizeof(config.jog_xy_steps));
+    prefs.getString((prefix + "jz_sts").c_str(), config.jog_z_steps, sizeof(config.jog_z_steps));
+    prefs.getString((prefix + "ja_sts").c_str(), config.jog_a_steps, sizeof(config.jog_a_steps));
+    // If step values are empty, set defaults
+    if (strlen(config.jog_xy_steps) == 0) strcpy(config.jog_xy_steps, "100,50,10,1,0.1");
+    if (strlen(config.jog_z_steps) == 0) strcpy(config.jog_z_steps, "50,25,10,1,0.1");
+    if (strlen(config.jog_a_steps) == 0) strcpy(config.jog_a_steps, "50,25,10,1,0.1");
+
+    // Probe settings (with defaults if not present)
+    config.probe_feed_rate = prefs.getInt((prefix + "p_feed").c_str(), 100);
+    config.probe_max_distance = prefs.getInt((prefix + "p_dist").c_str(), 10);
+    config.probe_retract = prefs.getInt((prefix + "p_ret").c_str(), 2);
+    config.probe_thickness = prefs.getFloat((prefix + "p_thick").c_str(), 0.0f);
+
+    // Axis configuration
+    config.enable_a_axis = prefs.getBool((prefix + "a_en").c_str(), false);
+    return true;
+}
+
+static void removeNVS(Preferences &prefs, int i) {
+    char key[16];
+    snprintf(key, sizeof(key), "m%d_rec", i);
+    prefs.remove(key);
+    for (const char *suffix : LEGACY_KEYS) {
+        snprintf(key, sizeof(key), "m%d_%s", i, suffix);
+        prefs.remove(key);
+    }
+}
+
+static void fillSummary(MachineSummary &summary, const MachineConfig &config) {
+    memset(&summary, 0, sizeof(summary));
+    if (!config.is_configured) return;
+    strncpy(summary.name, config.name, sizeof(summary.name) - 1);
+    strncpy(summary.ssid, config.ssid, sizeof(summary.ssid) - 1);
+    strncpy(summary.fluidnc_url, config.fluidnc_url, sizeof(summary.fluidnc_url) - 1);
+    summary.websocket_port = config.websocket_port;
+    summary.connection_type = config.connection_type;
+    summary.is_configured = true;
+    summary.has_password = config.password[0] != '\0';
+}
+
+void MachineConfigManager::ensureLoaded() {
+    if (loaded) return;
+    loaded = true;
+    uint32_t start_ms = millis();
+
+    summaries = (MachineSummary*)heap_caps_calloc(MAX_MACHINES, sizeof(MachineSummary), MALLOC_CAP_SPIRAM);
+    if (!summaries) summaries = (MachineSummary*)calloc(MAX_MACHINES, sizeof(MachineSummary));
+
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, true);
+    uint8_t stored[MACHINE_RECENT_COUNT];
+    size_t stored_count = prefs.isKey("m_recent") ? prefs.getBytes("m_recent", stored, sizeof(stored)) : 0;
+    prefs.end();
+    for (size_t k = 0; k < stored_count; k++) {
+        if (stored[k] < MAX_MACHINES) recent[recent_count++] = stored[k];
+    }
+
+    fs_ok = LittleFS.begin(true);
+    if (!fs_ok) {
+        Serial.println("MachineConfigManager: LittleFS mount failed - machines kept in RAM only");
+        ram_records = new MachineConfig[MAX_MACHINES];
+        migrateFromNVS();
         return;
     }
-    
+
+    File f = LittleFS.open(MACHINE_CATALOG_PATH, FILE_READ);
+    if (!f) {
+        migrateFromNVS();
+        return;
+    }
+
+    CatalogHeader header;
+    bool valid = f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == CATALOG_MAGIC && header.version == CATALOG_VERSION &&
+                 header.summary_size == sizeof(MachineSummary) && header.record_size == sizeof(CatalogRecord);
+    if (valid && header.slots == MAX_MACHINES) {
+        // The summary table is the only part kept in RAM
+        valid = f.read((uint8_t*)summaries, MAX_MACHINES * sizeof(MachineSummary)) == MAX_MACHINES * sizeof(MachineSummary);
+        f.close();
+        if (valid) {
+            Serial.printf("MachineConfigManager: %d machines in catalog (%lu ms)\n", getMachineCount(), millis() - start_ms);
+            return;
+        }
+        memset(summaries, 0, MAX_MACHINES * sizeof(MachineSummary));
+    } else {
+        f.close();
+        if (valid && convertCatalog(header.slots)) return;
+    }
+
+    // Keep the unreadable file for inspection rather than silently overwriting it
+    Serial.println("MachineConfigManager: Catalog unreadable - moved to " MACHINE_CATALOG_PATH ".bad");
+    LittleFS.remove(MACHINE_CATALOG_PATH ".bad");
+    LittleFS.rename(MACHINE_CATALOG_PATH, MACHINE_CATALOG_PATH ".bad");
+    migrateFromNVS();
+}
+
+bool MachineConfigManager::convertCatalog(uint16_t old_slots) {
+    // MAX_MACHINES changed - carry the records over into the new layout
+    int count = old_slots < MAX_MACHINES ? old_slots : MAX_MACHINES;
+    MachineConfig *configs = new MachineConfig[count];
+    File f = LittleFS.open(MACHINE_CATALOG_PATH, FILE_READ);
+    if (!f) {
+        delete[] configs;
+        return false;
+    }
+
+    CatalogRecord record;
+    for (int i = 0; i < count; i++) {
+        if (f.seek(recordOffset(i, old_slots)) && f.read((uint8_t*)&record, sizeof(record)) == sizeof(record) &&
+            record.crc == configCrc(record.config)) {
+            configs[i] = record.config;
+        }
+    }
+    f.close();
+
+    bool ok = writeCatalog(configs, count);
+    delete[] configs;
+    Serial.printf("MachineConfigManager: Catalog resized from %u to %d slots\n", old_slots, MAX_MACHINES);
+    return ok;
+}
+
+void MachineConfigManager::migrateFromNVS() {
+    MachineConfig *configs = new MachineConfig[NVS_SLOTS];
+    int found = 0;
+
     Preferences prefs;
     prefs.begin(PREFS_NAMESPACE, true); // Read-only
-    
-    Serial.println("MachineConfigManager: Loading machines from NVS...");
-    
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        String prefix = "m" + String(i) + "_";
-        
-        machines[i].is_configured = prefs.getBool((prefix + "cfg").c_str(), false);
-        
-        Serial.printf("  Slot %d: is_configured = %d\n", i, machines[i].is_configured);
-        
-        if (machines[i].is_configured) {
-            prefs.getString((prefix + "name").c_str(), machines[i].name, sizeof(machines[i].name));
-            machines[i].connection_type = (ConnectionType)prefs.getUChar((prefix + "type").c_str(), CONN_WIRELESS);
-            prefs.getString((prefix + "ssid").c_str(), machines[i].ssid, sizeof(machines[i].ssid));
-            prefs.getString((prefix + "pwd").c_str(), machines[i].password, sizeof(machines[i].password));
-            prefs.getString((prefix + "url").c_str(), machines[i].fluidnc_url, sizeof(machines[i].fluidnc_url));
-            machines[i].websocket_port = prefs.getUShort((prefix + "port").c_str(), 81);
-            
-            Serial.printf("    Name: %s, URL: %s:%d\n", machines[i].name, machines[i].fluidnc_url, machines[i].websocket_port);
-            
-            // Load jog settings (with defaults if not present)
-            machines[i].jog_xy_step = prefs.getFloat((prefix + "jxy_st").c_str(), 10.0f);
-            machines[i].jog_z_step = prefs.getFloat((prefix + "jz_st").c_str(), 1.0f);
-            machines[i].jog_a_step = prefs.getFloat((prefix + "ja_st").c_str(), 1.0f);
-            machines[i].jog_xy_feed = prefs.getInt((prefix + "jxy_fd").c_str(), 3000);
-            machines[i].jog_z_feed = prefs.getInt((prefix + "jz_fd").c_str(), 1000);
-            machines[i].jog_a_feed = prefs.getInt((prefix + "ja_fd").c_str(), 1000);
-            machines[i].jog_max_xy_feed = prefs.getInt((prefix + "jxy_mx").c_str(), 3000);
-            machines[i].jog_max_z_feed = prefs.getInt((prefix + "jz_mx").c_str(), 1000);
-            machines[i].jog_max_a_feed = prefs.getInt((prefix + "ja_mx").c_str(), 1000);
-            prefs.getString((prefix + "jxy_sts").c_str(), machines[i].jog_xy_steps, sizeof(machines[i].jog_xy_steps));
-            prefs.getString((prefix + "jz_sts").c_str(), machines[i].jog_z_steps, sizeof(machines[i].jog_z_steps));
-            prefs.getString((prefix + "ja_sts").c_str(), machines[i].jog_a_steps, sizeof(machines[i].jog_a_steps));
-            // If step values are empty, set defaults
-            if (strlen(machines[i].jog_xy_steps) == 0) strcpy(machines[i].jog_xy_steps, "100,50,10,1,0.1");
-            if (strlen(machines[i].jog_z_steps) == 0) strcpy(machines[i].jog_z_steps, "50,25,10,1,0.1");
-            if (strlen(machines[i].jog_a_steps) == 0) strcpy(machines[i].jog_a_steps, "50,25,10,1,0.1");
-            
-            // Load probe settings (with defaults if not present)
-            machines[i].probe_feed_rate = prefs.getInt((prefix + "p_feed").c_str(), 100);
-            machines[i].probe_max_distance = prefs.getInt((prefix + "p_dist").c_str(), 10);
-            machines[i].probe_retract = prefs.getInt((prefix + "p_ret").c_str(), 2);
-            machines[i].probe_thickness = prefs.getFloat((prefix + "p_thick").c_str(), 0.0f);
-
-            // Load axis configuration
-            machines[i].enable_a_axis = prefs.getBool((prefix + "a_en").c_str(), false);
+    for (int i = 0; i < NVS_SLOTS; i++) {
+        if (!readNVSRecord(prefs, i, configs[i])) {
+            readLegacy(prefs, i, configs[i]);
         }
+        if (configs[i].is_configured) found++;
     }
-    
     prefs.end();
-    Serial.println("MachineConfigManager: Load complete");
-    
-    // Cache the loaded data
-    memcpy(cached_machines, machines, sizeof(MachineConfig) * MAX_MACHINES);
-    cache_valid = true;
+
+    if (!fs_ok) {
+        for (int i = 0; i < NVS_SLOTS; i++) {
+            ram_records[i] = configs[i];
+            fillSummary(summaries[i], configs[i]);
+        }
+    } else if (writeCatalog(configs, NVS_SLOTS) && found > 0) {
+        prefs.begin(PREFS_NAMESPACE, false);
+        for (int i = 0; i < NVS_SLOTS; i++) {
+            removeNVS(prefs, i);
+        }
+        prefs.end();
+        Serial.printf("MachineConfigManager: Migrated %d machines from NVS to the catalog\n", found);
+    }
+    delete[] configs;
+}
+
+bool MachineConfigManager::writeCatalog(const MachineConfig *configs, int count) {
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        if (i < count) {
+            fillSummary(summaries[i], configs[i]);
+        } else {
+            memset(&summaries[i], 0, sizeof(MachineSummary));
+        }
+    }
+    dirty_summaries = 0;
+
+    File f = LittleFS.open(MACHINE_CATALOG_PATH, FILE_WRITE);
+    if (!f) {
+        Serial.println("MachineConfigManager: Can't create catalog");
+        return false;
+    }
+
+    CatalogHeader header = {CATALOG_MAGIC, CATALOG_VERSION, MAX_MACHINES,
+                            sizeof(MachineSummary), sizeof(CatalogRecord)};
+    bool ok = f.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    ok = ok && f.write((const uint8_t*)summaries, MAX_MACHINES * sizeof(MachineSummary)) == MAX_MACHINES * sizeof(MachineSummary);
+
+    // Empty slots are zero-filled (their CRC never matches)
+    CatalogRecord record;
+    for (int i = 0; ok && i < MAX_MACHINES; i++) {
+        memset(&record, 0, sizeof(record));
+        if (i < count && configs[i].is_configured) {
+            record.config = configs[i];
+            record.crc = configCrc(record.config);
+        }
+        ok = f.write((const uint8_t*)&record, sizeof(record)) == sizeof(record);
+    }
+    f.close();
+    if (!ok) Serial.println("MachineConfigManager: Catalog write failed");
+    return ok;
 }
 
-void MachineConfigManager::reloadMachines() {
-    Serial.println("MachineConfigManager: Clearing cache, forcing reload");
-    cache_valid = false;
+bool MachineConfigManager::readRecord(int index, MachineConfig &config) {
+    if (!fs_ok) {
+        config = ram_records[index];
+        return config.is_configured;
+    }
+
+    File f = LittleFS.open(MACHINE_CATALOG_PATH, FILE_READ);
+    if (!f) return false;
+    CatalogRecord record;
+    bool ok = f.seek(recordOffset(index)) && f.read((uint8_t*)&record, sizeof(record)) == sizeof(record);
+    f.close();
+
+    if (!ok || record.crc != configCrc(record.config)) {
+        Serial.printf("MachineConfigManager: Slot %d record invalid\n", index);
+        return false;
+    }
+    config = record.config;
+    return true;
 }
 
-void MachineConfigManager::saveMachines(const MachineConfig machines[MAX_MACHINES]) {
-    Preferences prefs;
-    prefs.begin(PREFS_NAMESPACE, false); // Read-write
-    
+void MachineConfigManager::writeSlots(const int *indexes, const MachineConfig *configs, int count) {
+    if (!fs_ok) {
+        for (int k = 0; k < count; k++) {
+            ram_records[indexes[k]] = configs[k];
+        }
+        dirty_summaries = 0;
+        return;
+    }
+
+    File f = LittleFS.open(MACHINE_CATALOG_PATH, "r+");
+    if (!f) {
+        Serial.println("MachineConfigManager: Can't open catalog for writing");
+        return;
+    }
+
+    // Changed summaries, then the records - deleted slots only need their summary
     for (int i = 0; i < MAX_MACHINES; i++) {
-        String prefix = "m" + String(i) + "_";
-        
-        prefs.putBool((prefix + "cfg").c_str(), machines[i].is_configured);
-        
-        if (machines[i].is_configured) {
-            prefs.putString((prefix + "name").c_str(), machines[i].name);
-            prefs.putUChar((prefix + "type").c_str(), (uint8_t)machines[i].connection_type);
-            prefs.putString((prefix + "ssid").c_str(), machines[i].ssid);
-            prefs.putString((prefix + "pwd").c_str(), machines[i].password);
-            prefs.putString((prefix + "url").c_str(), machines[i].fluidnc_url);
-            prefs.putUShort((prefix + "port").c_str(), machines[i].websocket_port);
-            
-            // Save jog settings
-            prefs.putFloat((prefix + "jxy_st").c_str(), machines[i].jog_xy_step);
-            prefs.putFloat((prefix + "jz_st").c_str(), machines[i].jog_z_step);
-            prefs.putFloat((prefix + "ja_st").c_str(), machines[i].jog_a_step);
-            prefs.putInt((prefix + "jxy_fd").c_str(), machines[i].jog_xy_feed);
-            prefs.putInt((prefix + "jz_fd").c_str(), machines[i].jog_z_feed);
-            prefs.putInt((prefix + "ja_fd").c_str(), machines[i].jog_a_feed);
-            prefs.putInt((prefix + "jxy_mx").c_str(), machines[i].jog_max_xy_feed);
-            prefs.putInt((prefix + "jz_mx").c_str(), machines[i].jog_max_z_feed);
-            prefs.putInt((prefix + "ja_mx").c_str(), machines[i].jog_max_a_feed);
-            prefs.putString((prefix + "jxy_sts").c_str(), machines[i].jog_xy_steps);
-            prefs.putString((prefix + "jz_sts").c_str(), machines[i].jog_z_steps);
-            prefs.putString((prefix + "ja_sts").c_str(), machines[i].jog_a_steps);
-            
-            // Save probe settings
-            prefs.putInt((prefix + "p_feed").c_str(), machines[i].probe_feed_rate);
-            prefs.putInt((prefix + "p_dist").c_str(), machines[i].probe_max_distance);
-            prefs.putInt((prefix + "p_ret").c_str(), machines[i].probe_retract);
-            prefs.putFloat((prefix + "p_thick").c_str(), machines[i].probe_thickness);
-
-            // Save axis configuration
-            prefs.putBool((prefix + "a_en").c_str(), machines[i].enable_a_axis);
+        if ((dirty_summaries & (1UL << i)) && f.seek(summaryOffset(i))) {
+            f.write((const uint8_t*)&summaries[i], sizeof(MachineSummary));
         }
     }
-    
-    prefs.end();
-    
-    // Invalidate cache since machines were modified
-    cache_valid = false;
+    CatalogRecord record;
+    for (int k = 0; k < count; k++) {
+        memset(&record, 0, sizeof(record));
+        record.config = configs[k];
+        record.crc = configCrc(record.config);
+        if (f.seek(recordOffset(indexes[k]))) {
+            f.write((const uint8_t*)&record, sizeof(record));
+        }
+    }
+    f.close();
+    dirty_summaries = 0;
+}
+
+void MachineConfigManager::setSummary(int index, const MachineConfig &config) {
+    fillSummary(summaries[index], config);
+    dirty_summaries |= (1UL << index);
+}
+
+void MachineConfigManager::commitMachines() {
+    if (cached_dirty) {
+        cached_dirty = false;
+        writeSlots(&cached_index, &cached_config, 1);
+    } else if (dirty_summaries) {
+        writeSlots(nullptr, nullptr, 0);
+    }
+}
+
+const MachineSummary& MachineConfigManager::getSummary(int index) {
+    ensureLoaded();
+    if (index < 0 || index >= MAX_MACHINES || !summaries) return empty_summary;
+    return summaries[index];
+}
+
+int MachineConfigManager::getMachineCount() {
+    ensureLoaded();
+    int count = 0;
+    for (int i = 0; summaries && i < MAX_MACHINES; i++) {
+        if (summaries[i].is_configured) count++;
+    }
+    return count;
 }
 
 bool MachineConfigManager::getMachine(int index, MachineConfig &config) {
-    if (index < 0 || index >= MAX_MACHINES) return false;
-    
-    MachineConfig machines[MAX_MACHINES];
-    loadMachines(machines);
+    if (!getSummary(index).is_configured) return false;
     
-    if (machines[index].is_configured) {
-        config = machines[index];
+    if (index == cached_index) {
+        config = cached_config;
         return true;
     }
-    return false;
+    if (!readRecord(index, config)) return false;
+    
+    // Don't evict a record still waiting for the write-behind
+    if (!cached_dirty) {
+        cached_config = config;
+        cached_index = index;
+    }
+    return true;
 }
 
 bool MachineConfigManager::saveMachine(int index, const MachineConfig &config) {
     if (index < 0 || index >= MAX_MACHINES) return false;
+    ensureLoaded();
     
-    MachineConfig machines[MAX_MACHINES];
-    loadMachines(machines);
+    if (index == cached_index && summaries[index].is_configured &&
+        memcmp(&cached_config, &config, sizeof(MachineConfig)) == 0) {
+        return true;  // Unchanged
+    }
     
-    machines[index] = config;
-    machines[index].is_configured = true;
+    // Only one unsaved record is held - write the other one first
+    if (cached_dirty && cached_index != index) commitMachines();
     
-    saveMachines(machines);
+    // Update the cache now; the record is written by commitMachines() once edits settle
+    cached_config = config;
+    cached_config.is_configured = true;
+    cached_index = index;
+    cached_dirty = true;
+    setSummary(index, cached_config);
+    SettingsStore::schedule(commitMachines);
     return true;
 }
 
 bool MachineConfigManager::deleteMachine(int index) {
     if (index < 0 || index >= MAX_MACHINES) return false;
+    ensureLoaded();
+    
+    if (index == cached_index) {
+        cached_index = -1;
+        cached_dirty = false;
+    }
+    forgetRecent(index);
+    setSummary(index, MachineConfig()); // Unconfigured
+    SettingsStore::schedule(commitMachines);
+    return true;
+}
+
+bool MachineConfigManager::swapMachines(int index1, int index2) {
+    MachineConfig configs[2];
+    if (!getMachine(index2, configs[0]) || !getMachine(index1, configs[1])) return false;
     
-    MachineConfig machines[MAX_MACHINES];
-    loadMachines(machines);
+    if (cached_dirty && cached_index != index1 && cached_index != index2) commitMachines();
+    cached_index = -1;
+    cached_dirty = false;
     
-    machines[index] = MachineConfig(); // Reset to defaults
-    machines[index].is_configured = false;
+    // Recent list follows the machines to their new slots
+    for (int k = 0; k < recent_count; k++) {
+        if (recent[k] == index1) recent[k] = index2;
+        else if (recent[k] == index2) recent[k] = index1;
+    }
+    if (recent_count > 0) SettingsStore::schedule(commitRecent);
     
-    saveMachines(machines);
+    int indexes[2] = {index1, index2};
+    setSummary(index1, configs[0]);
+    setSummary(index2, configs[1]);
+    writeSlots(indexes, configs, 2);
     return true;
 }
 
+void MachineConfigManager::clearMachines() {
+    ensureLoaded();
+    cached_index = -1;
+    cached_dirty = false;
+    recent_count = 0;
+    SettingsStore::schedule(commitRecent);
+    
+    if (!fs_ok) {
+        for (int i = 0; i < MAX_MACHINES; i++) {
+            ram_records[i] = MachineConfig();
+            memset(&summaries[i], 0, sizeof(MachineSummary));
+        }
+        dirty_summaries = 0;
+        return;
+    }
+    writeCatalog(nullptr, 0);
+}
+
+int MachineConfigManager::getRecentMachines(int *indexes, int max) {
+    ensureLoaded();
+    int count = 0;
+    for (int k = 0; k < recent_count && count < max; k++) {
+        if (summaries[recent[k]].is_configured) indexes[count++] = recent[k];
+    }
+    return count;
+}
+
+void MachineConfigManager::forgetRecent(int index) {
+    int out = 0;
+    for (int k = 0; k < recent_count; k++) {
+        if (recent[k] != index) recent[out++] = recent[k];
+    }
+    if (out == recent_count) return;
+    recent_count = out;
+    SettingsStore::schedule(commitRecent);
+}
+
+void MachineConfigManager::commitRecent() {
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, false);
+    if (recent_count > 0) {
+        prefs.putBytes("m_recent", recent, recent_count);
+    } else {
+        prefs.remove("m_recent");  // putBytes() writes nothing for an empty list
+    }
+    prefs.end();
+}
+
 int MachineConfigManager::getSelectedMachineIndex() {
     Preferences prefs;
     prefs.begin(PREFS_NAMESPACE, true);
@@ -179,6 +527,19 @@ void MachineConfigManager::setSelectedMachineIndex(int index) {
     prefs.begin(PREFS_NAMESPACE, false);
     prefs.putInt("sel_machine", index);
     prefs.end();
+    
+    if (index < 0 || index >= MAX_MACHINES) return;
+    ensureLoaded();
+    if (recent_count > 0 && recent[0] == index) return;
+    
+    // Move to the front, dropping the oldest entry when full
+    int k = 0;
+    while (k < recent_count && recent[k] != index) k++;
+    if (k == recent_count && recent_count < MACHINE_RECENT_COUNT) recent_count++;
+    if (k == recent_count) k = recent_count - 1;
+    memmove(&recent[1], &recent[0], k);
+    recent[0] = index;
+    SettingsStore::schedule(commitRecent);
 }
 
 bool MachineConfigManager::getSelectedMachine(MachineConfig &config) {
@@ -190,13 +551,5 @@ bool MachineConfigManager::getSelectedMachine(MachineConfig &config) {
 }
 
 bool MachineConfigManager::hasConfiguredMachines() {
-    MachineConfig machines[MAX_MACHINES];
-    loadMachines(machines);
-    
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        if (machines[i].is_configured) {
-            return true;
-        }
-    }
-    return false;
+    return getMachineCount() > 0;
 }
@@ -3,116 +3,194 @@
 #include "ui/upload_manager.h"
 #include "ui/tabs/ui_tab_macros.h"
 #include "ui/wcs_config.h"
+#include "ui/settings_store.h"
+#include "ui/system_prefs.h"
+#include "ui/settings_stream.h"
 #include "config.h"
+#include "core/sd_card.h"
 #include "core/power_manager.h"
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <SD.h>
 
-// Export all settings to JSON file on Display SD card
-bool SettingsManager::exportSettings(const char* filepath) {
-    Serial.printf("[SettingsManager] Exporting settings to: %s\n", filepath);
+// Backup file streams over the Display SD (see ui/settings_stream.h)
+class SDFileSink : public SettingsSink {
+public:
+    explicit SDFileSink(File &f) : file(f) {}
+    size_t write(const uint8_t *data, size_t len) override { return file.write(data, len); }
+
+private:
+    File &file;
+};
+
+class SDReaderSource : public SettingsSource {
+public:
+    explicit SDReaderSource(SDReader &r) : reader(r) {}
+    int read(uint8_t *buf, size_t len) override { return reader.read(buf, len); }
+
+private:
+    SDReader &reader;
+};
+
+// One JSON value from the backup file, bounded by SETTINGS_MAX_RECORD_BYTES
+static DeserializationError readValue(SettingsFileReader &in, JsonDocument &doc) {
+    in.beginRecord();
+    DeserializationError error = deserializeJson(doc, in);
+    return in.endRecord() ? error : DeserializationError(DeserializationError::NoMemory);
+}
+
+// One machine, with its macros and WCS names, in the backup file format
+static void machineToJson(int index, const MachineConfig &mc, JsonObject machine) {
+    machine["name"] = mc.name;
+    machine["connection_type"] = (uint8_t)mc.connection_type;
+    machine["ssid"] = mc.ssid;
+    machine["password"] = "";  // Password not exported for security
+    machine["fluidnc_url"] = mc.fluidnc_url;
+    machine["websocket_port"] = mc.websocket_port;
+    
+    // Jog settings
+    JsonObject jog = machine["jog"].to<JsonObject>();
+    jog["xy_feed_rate"] = mc.jog_xy_feed;
+    jog["z_feed_rate"] = mc.jog_z_feed;
+    jog["xy_step"] = mc.jog_xy_step;
+    jog["z_step"] = mc.jog_z_step;
+    jog["xy_steps"] = mc.jog_xy_steps;
+    jog["z_steps"] = mc.jog_z_steps;
+    jog["a_steps"] = mc.jog_a_steps;
+    
+    // Probe settings
+    JsonObject probe = machine["probe"].to<JsonObject>();
+    probe["feed_rate"] = mc.probe_feed_rate;
+    probe["max_distance"] = mc.probe_max_distance;
+    probe["retract"] = mc.probe_retract;
+    probe["thickness"] = mc.probe_thickness;
+    
+    // Macros (read from preferences for this machine)
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, true);  // Read-only
     
-    // Initialize SD card if needed
-    if (!UploadManager::init()) {
-        Serial.println("[SettingsManager] ERROR - Failed to initialize SD card");
-        return false;
-    }
+    char key[32];
+    snprintf(key, sizeof(key), "m%d_macros", index);
     
-    // Check if SD card is available
-    if (SD.cardType() == CARD_NONE) {
-        Serial.println("[SettingsManager] ERROR - No SD card detected");
-        return false;
+    MacroConfig macros[MAX_MACROS];
+    size_t size = prefs.getBytesLength(key);
+    if (size == sizeof(macros)) {
+        prefs.getBytes(key, macros, size);
+        
+        JsonArray macrosArray = machine["macros"].to<JsonArray>();
+        for (int m = 0; m < MAX_MACROS; m++) {
+            if (!macros[m].is_configured) continue;
+            
+            JsonObject macro = macrosArray.add<JsonObject>();
+            macro["name"] = macros[m].name;
+            macro["file_path"] = macros[m].file_path;
+            macro["color_index"] = macros[m].color_index;
+        }
     }
     
-    // Create JSON document (allocate enough space)
-    JsonDocument doc;
-    
-    // Add metadata
-    doc["version"] = "1.0";
-    doc["fluidtouch_version"] = FLUIDTOUCH_VERSION;
-    
-    // Get current timestamp (use millis since we don't have RTC)
-    char timestamp[32];
-    unsigned long ms = millis();
-    snprintf(timestamp, sizeof(timestamp), "uptime_%lu_ms", ms);
-    doc["exported"] = timestamp;
-    
-    // === Export Machines ===
-    JsonArray machines = doc["machines"].to<JsonArray>();
-    MachineConfig machine_configs[MAX_MACHINES];
-    MachineConfigManager::loadMachines(machine_configs);
+    prefs.end();
     
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        if (!machine_configs[i].is_configured) continue;
-        
-        JsonObject machine = machines.add<JsonObject>();
-        machine["name"] = machine_configs[i].name;
-        machine["connection_type"] = (uint8_t)machine_configs[i].connection_type;
-        machine["ssid"] = machine_configs[i].ssid;
-        machine["password"] = "";  // Password not exported for security
-        machine["fluidnc_url"] = machine_configs[i].fluidnc_url;
-        machine["websocket_port"] = machine_configs[i].websocket_port;
+    // WCS configuration (names and locks) for this machine
+    char wcs_names[6][32];
+    bool wcs_locks[6];
+    WCSConfig::loadWCSConfig(index, wcs_names, wcs_locks);
+    
+    JsonArray wcsArray = machine["wcs"].to<JsonArray>();
+    for (int w = 0; w < 6; w++) {
+        JsonObject wcs = wcsArray.add<JsonObject>();
+        wcs["code"] = WCSConfig::getWCSCode(w);
+        wcs["name"] = wcs_names[w];
+        wcs["locked"] = wcs_locks[w];
+    }
+}
+
+// Fill mc from a machine record and store its macros and WCS names under index
+static void machineFromJson(int index, JsonObject machine, MachineConfig &mc) {
+    mc.is_configured = true;
+    strncpy(mc.name, machine["name"] | "", sizeof(mc.name) - 1);
+    mc.connection_type = (ConnectionType)(machine["connection_type"] | 0);
+    strncpy(mc.ssid, machine["ssid"] | "", sizeof(mc.ssid) - 1);
+    strncpy(mc.password, machine["password"] | "", sizeof(mc.password) - 1);
+    strncpy(mc.fluidnc_url, machine["fluidnc_url"] | "", sizeof(mc.fluidnc_url) - 1);
+    mc.websocket_port = machine["websocket_port"] | 81;
+    
+    // Jog settings
+    JsonObject jog = machine["jog"];
+    mc.jog_xy_feed = jog["xy_feed_rate"] | 1000;
+    mc.jog_z_feed = jog["z_feed_rate"] | 500;
+    mc.jog_xy_step = jog["xy_step"] | 10.0f;
+    mc.jog_z_step = jog["z_step"] | 1.0f;
+    
+    // Step values (comma-separated lists)
+    strncpy(mc.jog_xy_steps, jog["xy_steps"] | "100,50,10,1,0.1", sizeof(mc.jog_xy_steps) - 1);
+    strncpy(mc.jog_z_steps, jog["z_steps"] | "50,25,10,1,0.1", sizeof(mc.jog_z_steps) - 1);
+    strncpy(mc.jog_a_steps, jog["a_steps"] | "50,25,10,1,0.1", sizeof(mc.jog_a_steps) - 1);
+    
+    // Probe settings
+    JsonObject probe = machine["probe"];
+    mc.probe_feed_rate = probe["feed_rate"] | 50;
+    mc.probe_max_distance = probe["max_distance"] | 50.0f;
+    mc.probe_retract = probe["retract"] | 2.0f;
+    mc.probe_thickness = probe["thickness"] | 0.0f;
+    
+    // Macros
+    JsonArray macrosArray = machine["macros"];
+    if (macrosArray.size() > 0) {
+        MacroConfig macros[MAX_MACROS];
         
-        // Jog settings
-        JsonObject jog = machine["jog"].to<JsonObject>();
-        jog["xy_feed_rate"] = machine_configs[i].jog_xy_feed;
-        jog["z_feed_rate"] = machine_configs[i].jog_z_feed;
-        jog["xy_step"] = machine_configs[i].jog_xy_step;
-        jog["z_step"] = machine_configs[i].jog_z_step;
-        jog["xy_steps"] = machine_configs[i].jog_xy_steps;
-        jog["z_steps"] = machine_configs[i].jog_z_steps;
-        jog["a_steps"] = machine_configs[i].jog_a_steps;
+        // Initialize all macros as unconfigured
+        for (int m = 0; m < MAX_MACROS; m++) {
+            macros[m].is_configured = false;
+        }
         
-        // Probe settings
-        JsonObject probe = machine["probe"].to<JsonObject>();
-        probe["feed_rate"] = machine_configs[i].probe_feed_rate;
-        probe["max_distance"] = machine_configs[i].probe_max_distance;
-        probe["retract"] = machine_configs[i].probe_retract;
-        probe["thickness"] = machine_configs[i].probe_thickness;
+        // Import each macro
+        int macro_index = 0;
+        for (JsonObject macro : macrosArray) {
+            if (macro_index >= MAX_MACROS) break;
+            
+            macros[macro_index].is_configured = true;
+            strncpy(macros[macro_index].name, macro["name"] | "", sizeof(macros[macro_index].name) - 1);
+            strncpy(macros[macro_index].file_path, macro["file_path"] | "", sizeof(macros[macro_index].file_path) - 1);
+            macros[macro_index].color_index = macro["color_index"] | 0;
+            
+            macro_index++;
+        }
         
-        // Macros (read from preferences for this machine)
+        // Save macros to preferences
         Preferences prefs;
-        prefs.begin(PREFS_NAMESPACE, true);  // Read-only
+        prefs.begin(PREFS_NAMESPACE, false);  // Read-write
         
         char key[32];
-        snprintf(key, sizeof(key), "m%d_macros", i);
-        
-        MacroConfig macros[MAX_MACROS];
-        size_t size = prefs.getBytesLength(key);
-        if (size == sizeof(macros)) {
-            prefs.getBytes(key, macros, size);
-            
-            JsonArray macrosArray = machine["macros"].to<JsonArray>();
-            for (int m = 0; m < MAX_MACROS; m++) {
-                if (!macros[m].is_configured) continue;
-                
-                JsonObject macro = macrosArray.add<JsonObject>();
-                macro["name"] = macros[m].name;
-                macro["file_path"] = macros[m].file_path;
-                macro["color_index"] = macros[m].color_index;
-            }
-        }
+        snprintf(key, sizeof(key), "m%d_macros", index);
+        prefs.putBytes(key, macros, sizeof(macros));
         
         prefs.end();
+    }
+    
+    // WCS configuration
+    JsonArray wcsArray = machine["wcs"];
+    if (wcsArray.size() == 6) {
+        char wcs_names[6][32] = {{0}};
+        bool wcs_locks[6] = {false};
         
-        // WCS configuration (names and locks) for this machine
-        char wcs_names[6][32];
-        bool wcs_locks[6];
-        WCSConfig::loadWCSConfig(i, wcs_names, wcs_locks);
-        
-        JsonArray wcsArray = machine["wcs"].to<JsonArray>();
-        for (int w = 0; w < 6; w++) {
-            JsonObject wcs = wcsArray.add<JsonObject>();
-            wcs["code"] = WCSConfig::getWCSCode(w);
-            wcs["name"] = wcs_names[w];
-            wcs["locked"] = wcs_locks[w];
+        int wcs_index = 0;
+        for (JsonObject wcs : wcsArray) {
+            if (wcs_index >= 6) break;
+            
+            const char* wcs_name = wcs["name"] | "";
+            strncpy(wcs_names[wcs_index], wcs_name, sizeof(wcs_names[wcs_index]) - 1);
+            wcs_locks[wcs_index] = wcs["locked"] | false;
+            
+            wcs_index++;
         }
+        
+        // Save WCS configuration for this machine
+        WCSConfig::saveWCSConfig(index, wcs_names, wcs_locks);
+        Serial.printf("[SettingsManager] Imported WCS config for machine %d\n", index);
     }
-    
-    // === Export System Settings ===
-    JsonObject system = doc["system"].to<JsonObject>();
-    
+}
+
+static void systemToJson(JsonObject system) {
     // Power management settings
     JsonObject power = system["power"].to<JsonObject>();
     power["enabled"] = PowerManager::isEnabled();
@@ -123,41 +201,51 @@ bool SettingsManager::exportSettings(const char* filepath) {
     power["dim_brightness"] = PowerManager::getDimBrightness();
     
     // UI preferences
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
     JsonObject ui = system["ui"].to<JsonObject>();
-    ui["show_machine_select"] = prefs.getBool("show_mach_sel", true);
-    ui["folders_on_top"] = prefs.getBool("folders_on_top", false);
-    prefs.end();
+    ui["show_machine_select"] = SystemPrefs::getBool(SysPref::SHOW_MACHINE_SELECT);
+    ui["folders_on_top"] = SystemPrefs::getBool(SysPref::FOLDERS_ON_TOP);
     
     // Selected machine index
+    Preferences prefs;
     prefs.begin(PREFS_NAMESPACE, true);  // Read-only
     system["selected_machine"] = prefs.getInt("sel_machine", 0);
     prefs.end();
-    
-    // Write to SD card
-    File file = SD.open(filepath, FILE_WRITE);
-    if (!file) {
-        Serial.printf("[SettingsManager] ERROR - Failed to open file for writing: %s\n", filepath);
-        return false;
+}
+
+static void systemFromJson(JsonObject system) {
+    // Power management
+    JsonObject power = system["power"];
+    if (!power.isNull()) {
+        PowerManager::setEnabled(power["enabled"] | true);
+        PowerManager::setDimTimeout(power["dim_timeout"] | 30);
+        PowerManager::setSleepTimeout(power["sleep_timeout"] | 300);
+        PowerManager::setDeepSleepTimeout(power["deep_sleep_timeout"] | 900);
+        PowerManager::setNormalBrightness(power["normal_brightness"] | 100);
+        PowerManager::setDimBrightness(power["dim_brightness"] | 25);
+        PowerManager::saveSettings();
     }
     
-    if (serializeJsonPretty(doc, file) == 0) {
-        Serial.println("[SettingsManager] ERROR - Failed to write JSON to file");
-        file.close();
-        return false;
+    // UI preferences
+    JsonObject ui = system["ui"];
+    if (!ui.isNull()) {
+        SystemPrefs::setBool(SysPref::SHOW_MACHINE_SELECT, ui["show_machine_select"] | true);
+        SystemPrefs::setBool(SysPref::FOLDERS_ON_TOP, ui["folders_on_top"] | false);
     }
     
-    file.close();
-    Serial.printf("[SettingsManager] Successfully exported settings to: %s\n", filepath);
-    Serial.printf("[SettingsManager] File size: %d bytes\n", SD.open(filepath).size());
+    // Selected machine
+    int sel_machine = system["selected_machine"] | 0;
+    Preferences prefs;
+    prefs.begin(PREFS_NAMESPACE, false);  // Read-write
+    prefs.putInt("sel_machine", sel_machine);
+    prefs.end();
     
-    return true;
+    Serial.println("[SettingsManager] Imported system settings");
 }
 
-// Import settings from JSON file on Display SD card
-bool SettingsManager::importSettings(const char* filepath) {
-    Serial.printf("[SettingsManager] Importing settings from: %s\n", filepath);
+// Export all settings to JSON file on Display SD card
+bool SettingsManager::exportSettings(const char* filepath) {
+    Serial.printf("[SettingsManager] Exporting settings to: %s\n", filepath);
+    uint32_t start_ms = millis();
     
     // Initialize SD card if needed
     if (!UploadManager::init()) {
@@ -171,186 +259,168 @@ bool SettingsManager::importSettings(const char* filepath) {
         return false;
     }
     
-    // Check if file exists
-    if (!SD.exists(filepath)) {
-        Serial.printf("[SettingsManager] ERROR - File not found: %s\n", filepath);
-        return false;
-    }
-    
-    // Open file
-    File file = SD.open(filepath, FILE_READ);
+    File file = SDCard::openForWrite(filepath);
     if (!file) {
-        Serial.printf("[SettingsManager] ERROR - Failed to open file: %s\n", filepath);
+        Serial.printf("[SettingsManager] ERROR - Failed to open file for writing: %s\n", filepath);
         return false;
     }
+    SDFileSink sink(file);
+    SettingsFileWriter out(sink);
+    
+    // Metadata (timestamp is uptime since we don't have RTC)
+    out.printf("{\n  \"version\": \"1.0\",\n  \"fluidtouch_version\": \"%s\",\n  \"exported\": \"uptime_%lu_ms\",\n",
+               FLUIDTOUCH_VERSION, millis());
     
-    // Parse JSON
+    // === Export Machines === (one record in memory at a time)
+    out.print("  \"machines\": [");
+    MachineConfig config;
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    int count = 0;
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        if (!MachineConfigManager::getMachine(i, config)) continue;
+        
+        doc.clear();
+        machineToJson(i, config, doc.to<JsonObject>());
+        out.print(count++ > 0 ? ",\n    " : "\n    ");
+        serializeJson(doc, out);
+    }
+    out.print(count > 0 ? "\n  ],\n" : "],\n");
     
-    if (error) {
-        Serial.printf("[SettingsManager] ERROR - Failed to parse JSON: %s\n", error.c_str());
+    // === Export System Settings ===
+    doc.clear();
+    systemToJson(doc.to<JsonObject>());
+    out.print("  \"system\": ");
+    serializeJson(doc, out);
+    out.print("\n}\n");
+    
+    bool ok = out.flushBuffer();
+    file.close();
+    if (!ok) {
+        Serial.println("[SettingsManager] ERROR - Failed to write JSON to file");
         return false;
     }
     
-    // Validate version
-    const char* version = doc["version"] | "unknown";
-    Serial.printf("[SettingsManager] Import file version: %s\n", version);
+    Serial.printf("[SettingsManager] Successfully exported %d machines to: %s\n", count, filepath);
+    Serial.printf("[SettingsManager] File size: %u bytes, %u ms\n", (unsigned)out.total, millis() - start_ms);
     
-    if (strcmp(version, "1.0") != 0) {
-        Serial.println("[SettingsManager] WARNING - Unknown version, attempting import anyway");
+    return true;
+}
+
+// Walk the backup file member by member. With apply == false the file is only
+// validated, so a damaged file is rejected before anything has been changed.
+static bool readSettingsFile(const char* filepath, bool apply) {
+    SDReader file;
+    if (!file.open(filepath)) {
+        Serial.printf("[SettingsManager] ERROR - Failed to open file: %s\n", filepath);
+        return false;
     }
+    SDReaderSource source(file);
+    SettingsFileReader in(source);
+    JsonDocument doc;
     
-    // === Import Machines ===
-    JsonArray machines = doc["machines"];
-    if (machines.size() > 0) {
-        MachineConfig machine_configs[MAX_MACHINES];
+    int machine_count = 0;
+    
+    bool ok = in.consume('{');
+    bool first = true;
+    while (ok && !in.consume('}')) {
+        if (!first && !(ok = in.consume(','))) break;
+        first = false;
         
-        // Initialize all machines as unconfigured
-        for (int i = 0; i < MAX_MACHINES; i++) {
-            machine_configs[i].is_configured = false;
-        }
+        char key[32];
+        if (!(ok = in.readKey(key, sizeof(key)))) break;
         
-        // Import each machine
-        int machine_index = 0;
-        for (JsonObject machine : machines) {
-            if (machine_index >= MAX_MACHINES) break;
-            
-            machine_configs[machine_index].is_configured = true;
-            strncpy(machine_configs[machine_index].name, machine["name"] | "", sizeof(machine_configs[machine_index].name) - 1);
-            machine_configs[machine_index].connection_type = (ConnectionType)(machine["connection_type"] | 0);
-            strncpy(machine_configs[machine_index].ssid, machine["ssid"] | "", sizeof(machine_configs[machine_index].ssid) - 1);
-            strncpy(machine_configs[machine_index].password, machine["password"] | "", sizeof(machine_configs[machine_index].password) - 1);
-            strncpy(machine_configs[machine_index].fluidnc_url, machine["fluidnc_url"] | "", sizeof(machine_configs[machine_index].fluidnc_url) - 1);
-            machine_configs[machine_index].websocket_port = machine["websocket_port"] | 81;
-            
-            // Jog settings
-            JsonObject jog = machine["jog"];
-            machine_configs[machine_index].jog_xy_feed = jog["xy_feed_rate"] | 1000;
-            machine_configs[machine_index].jog_z_feed = jog["z_feed_rate"] | 500;
-            machine_configs[machine_index].jog_xy_step = jog["xy_step"] | 10.0f;
-            machine_configs[machine_index].jog_z_step = jog["z_step"] | 1.0f;
-            
-            // Step values (comma-separated lists)
-            strncpy(machine_configs[machine_index].jog_xy_steps, 
-                    jog["xy_steps"] | "100,50,10,1,0.1", 
-                    sizeof(machine_configs[machine_index].jog_xy_steps) - 1);
-            strncpy(machine_configs[machine_index].jog_z_steps, 
-                    jog["z_steps"] | "50,25,10,1,0.1", 
-                    sizeof(machine_configs[machine_index].jog_z_steps) - 1);
-            strncpy(machine_configs[machine_index].jog_a_steps, 
-                    jog["a_steps"] | "50,25,10,1,0.1", 
-                    sizeof(machine_configs[machine_index].jog_a_steps) - 1);
-            
-            // Probe settings
-            JsonObject probe = machine["probe"];
-            machine_configs[machine_index].probe_feed_rate = probe["feed_rate"] | 50;
-            machine_configs[machine_index].probe_max_distance = probe["max_distance"] | 50.0f;
-            machine_configs[machine_index].probe_retract = probe["retract"] | 2.0f;
-            machine_configs[machine_index].probe_thickness = probe["thickness"] | 0.0f;
-            
-            // Macros
-            JsonArray macrosArray = machine["macros"];
-            if (macrosArray.size() > 0) {
-                MacroConfig macros[MAX_MACROS];
+        if (strcmp(key, "machines") == 0 && in.next() == '[') {
+            // === Import Machines ===
+            in.consume('[');
+            bool first_machine = true;
+            while (ok && !in.consume(']')) {
+                if (!first_machine && !(ok = in.consume(','))) break;
+                first_machine = false;
                 
-                // Initialize all macros as unconfigured
-                for (int m = 0; m < MAX_MACROS; m++) {
-                    macros[m].is_configured = false;
+                DeserializationError error = readValue(in, doc);
+                if (error) {
+                    Serial.printf("[SettingsManager] ERROR - Machine %d: %s\n", machine_count, error.c_str());
+                    ok = false;
+                    break;
                 }
-                
-                // Import each macro
-                int macro_index = 0;
-                for (JsonObject macro : macrosArray) {
-                    if (macro_index >= MAX_MACROS) break;
-                    
-                    macros[macro_index].is_configured = true;
-                    strncpy(macros[macro_index].name, macro["name"] | "", sizeof(macros[macro_index].name) - 1);
-                    strncpy(macros[macro_index].file_path, macro["file_path"] | "", sizeof(macros[macro_index].file_path) - 1);
-                    macros[macro_index].color_index = macro["color_index"] | 0;
-                    
-                    macro_index++;
+                if (machine_count >= MAX_MACHINES) continue;
+                if (apply) {
+                    // Catalog keeps one unsaved record - each save writes the previous one
+                    MachineConfig config;
+                    machineFromJson(machine_count, doc.as<JsonObject>(), config);
+                    MachineConfigManager::saveMachine(machine_count, config);
                 }
-                
-                // Save macros to preferences
-                Preferences prefs;
-                prefs.begin(PREFS_NAMESPACE, false);  // Read-write
-                
-                char key[32];
-                snprintf(key, sizeof(key), "m%d_macros", machine_index);
-                prefs.putBytes(key, macros, sizeof(macros));
-                
-                prefs.end();
+                machine_count++;
             }
-            
-            // WCS configuration
-            JsonArray wcsArray = machine["wcs"];
-            if (wcsArray.size() == 6) {
-                char wcs_names[6][32] = {{0}};
-                bool wcs_locks[6] = {false};
-                
-                int wcs_index = 0;
-                for (JsonObject wcs : wcsArray) {
-                    if (wcs_index >= 6) break;
-                    
-                    const char* wcs_name = wcs["name"] | "";
-                    strncpy(wcs_names[wcs_index], wcs_name, sizeof(wcs_names[wcs_index]) - 1);
-                    wcs_locks[wcs_index] = wcs["locked"] | false;
-                    
-                    wcs_index++;
-                }
-                
-                // Save WCS configuration for this machine
-                WCSConfig::saveWCSConfig(machine_index, wcs_names, wcs_locks);
-                Serial.printf("[SettingsManager] Imported WCS config for machine %d\n", machine_index);
-            }
-            
-            machine_index++;
+            continue;
+        }
+        
+        DeserializationError error = readValue(in, doc);
+        if (error) {
+            Serial.printf("[SettingsManager] ERROR - Failed to parse \"%s\": %s\n", key, error.c_str());
+            ok = false;
+            break;
         }
         
-        // Save all machines
-        MachineConfigManager::saveMachines(machine_configs);
-        Serial.printf("[SettingsManager] Imported %d machines\n", machine_index);
+        if (strcmp(key, "version") == 0) {
+            // Validate version
+            const char* version = doc.as<const char*>();
+            if (!version) version = "unknown";
+            if (!apply) Serial.printf("[SettingsManager] Import file version: %s\n", version);
+            if (!apply && strcmp(version, "1.0") != 0) {
+                Serial.println("[SettingsManager] WARNING - Unknown version, attempting import anyway");
+            }
+        } else if (strcmp(key, "system") == 0 && apply) {
+            // === Import System Settings ===
+            if (doc.is<JsonObject>()) systemFromJson(doc.as<JsonObject>());
+        }
     }
+    file.close();
     
-    // === Import System Settings ===
-    JsonObject system = doc["system"];
+    if (!ok) {
+        Serial.println("[SettingsManager] ERROR - Failed to parse JSON");
+        return false;
+    }
     
-    if (!system.isNull()) {
-        Preferences prefs;
-        
-        // Power management
-        JsonObject power = system["power"];
-        if (!power.isNull()) {
-            PowerManager::setEnabled(power["enabled"] | true);
-            PowerManager::setDimTimeout(power["dim_timeout"] | 30);
-            PowerManager::setSleepTimeout(power["sleep_timeout"] | 300);
-            PowerManager::setDeepSleepTimeout(power["deep_sleep_timeout"] | 900);
-            PowerManager::setNormalBrightness(power["normal_brightness"] | 100);
-            PowerManager::setDimBrightness(power["dim_brightness"] | 25);
-            PowerManager::saveSettings();
-        }
-        
-        // UI preferences
-        JsonObject ui = system["ui"];
-        if (!ui.isNull()) {
-            prefs.begin(PREFS_SYSTEM_NAMESPACE, false);  // Read-write
-            prefs.putBool("show_mach_sel", ui["show_machine_select"] | true);
-            prefs.putBool("folders_on_top", ui["folders_on_top"] | false);
-            prefs.end();
+    if (apply && machine_count > 0) {
+        // Imported machines replace the whole list
+        for (int i = machine_count; i < MAX_MACHINES; i++) {
+            MachineConfigManager::deleteMachine(i);
         }
-        
-        // Selected machine
-        int sel_machine = system["selected_machine"] | 0;
-        prefs.begin(PREFS_NAMESPACE, false);  // Read-write
-        prefs.putInt("sel_machine", sel_machine);
-        prefs.end();
-        
-        Serial.println("[SettingsManager] Imported system settings");
+        Serial.printf("[SettingsManager] Imported %d machines\n", machine_count);
+    }
+    return true;
+}
+
+// Import settings from JSON file on Display SD card
+bool SettingsManager::importSettings(const char* filepath) {
+    Serial.printf("[SettingsManager] Importing settings from: %s\n", filepath);
+    uint32_t start_ms = millis();
+    
+    // Initialize SD card if needed
+    if (!UploadManager::init()) {
+        Serial.println("[SettingsManager] ERROR - Failed to initialize SD card");
+        return false;
     }
     
-    Serial.println("[SettingsManager] Import completed successfully");
+    // Check if SD card is available
+    if (SD.cardType() == CARD_NONE) {
+        Serial.println("[SettingsManager] ERROR - No SD card detected");
+        return false;
+    }
+    
+    // Check if file exists
+    if (!SDCard::exists(filepath)) {
+        Serial.printf("[SettingsManager] ERROR - File not found: %s\n", filepath);
+        return false;
+    }
+    
+    // Validate the whole file first, then apply it
+    if (!readSettingsFile(filepath, false) || !readSettingsFile(filepath, true)) {
+        return false;
+    }
+    
+    Serial.printf("[SettingsManager] Import completed successfully (%u ms)\n", millis() - start_ms);
     Serial.println("[SettingsManager] WARNING: WiFi passwords were NOT imported for security.");
     Serial.println("[SettingsManager] You will need to set WiFi passwords manually for each machine.");
     return true;
@@ -360,6 +430,9 @@ bool SettingsManager::importSettings(const char* filepath) {
 void SettingsManager::clearAllSettings() {
     Serial.println("[SettingsManager] Clearing all settings from NVS...");
     
+    // Write pending edits first so they can't land after the clear
+    SettingsStore::flush();
+    
     Preferences prefs;
     
     // Clear main namespace (machines, macros, etc.)
@@ -367,12 +440,14 @@ void SettingsManager::clearAllSettings() {
     prefs.clear();
     prefs.end();
     Serial.println("[SettingsManager] Cleared PREFS_NAMESPACE");
+    MachineConfigManager::clearMachines();  // Machine catalog lives on LittleFS
     
     // Clear system namespace (power, UI settings, etc.)
     prefs.begin(PREFS_SYSTEM_NAMESPACE, false);
     prefs.clear();
     prefs.end();
     Serial.println("[SettingsManager] Cleared PREFS_SYSTEM_NAMESPACE");
+    SystemPrefs::load();  // Back to defaults
     
     Serial.println("[SettingsManager] All settings cleared - restart required");
 }
@@ -389,7 +464,7 @@ bool SettingsManager::importFileExists(const char* filepath) {
         return false;
     }
     
-    return SD.exists(filepath);
+    return SDCard::exists(filepath);
 }
 
 // Auto-import on boot (only if no machines configured)
@@ -397,18 +472,7 @@ bool SettingsManager::autoImportOnBoot() {
     Serial.println("\n[SettingsManager] Checking for auto-import...");
     
     // Check if any machines are configured
-    MachineConfig machines[MAX_MACHINES];
-    MachineConfigManager::loadMachines(machines);
-    
-    bool has_machines = false;
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        if (machines[i].is_configured) {
-            has_machines = true;
-            break;
-        }
-    }
-    
-    if (has_machines) {
+    if (MachineConfigManager::hasConfiguredMachines()) {
         Serial.println("[SettingsManager] Machines already configured, skipping auto-import");
         return false;
     }
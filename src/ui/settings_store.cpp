@@ -0,0 +1,61 @@
+#include "ui/settings_store.h"
+#include "config.h"
+
+// Static member initialization
+SettingsStore::CommitFn SettingsStore::pending[MAX_PENDING] = {nullptr};
+int SettingsStore::pending_count = 0;
+uint32_t SettingsStore::first_change_ms = 0;
+uint32_t SettingsStore::last_change_ms = 0;
+uint32_t SettingsStore::commit_count = 0;
+uint32_t SettingsStore::coalesced_count = 0;
+uint32_t SettingsStore::last_commit_us = 0;
+uint32_t SettingsStore::max_commit_us = 0;
+
+void SettingsStore::schedule(CommitFn commit) {
+    uint32_t now = millis();
+    last_change_ms = now;
+
+    for (int i = 0; i < pending_count; i++) {
+        if (pending[i] == commit) {
+            coalesced_count++;
+            return;
+        }
+    }
+    if (pending_count == MAX_PENDING) {
+        // Should not happen (one entry per owner) - write it through
+        commit();
+        commit_count++;
+        return;
+    }
+    if (pending_count == 0) first_change_ms = now;
+    pending[pending_count++] = commit;
+}
+
+void SettingsStore::loop() {
+    if (pending_count == 0) return;
+
+    // Wait for a quiet period, but don't let continuous edits postpone the write forever
+    uint32_t now = millis();
+    if (now - last_change_ms < SETTINGS_COMMIT_DELAY_MS &&
+        now - first_change_ms < SETTINGS_COMMIT_MAX_DELAY_MS) {
+        return;
+    }
+    flush();
+}
+
+void SettingsStore::flush() {
+    if (pending_count == 0) return;
+
+    uint32_t start = micros();
+    int count = pending_count;
+    for (int i = 0; i < count; i++) {
+        pending[i]();
+    }
+    pending_count = 0;
+
+    last_commit_us = micros() - start;
+    if (last_commit_us > max_commit_us) max_commit_us = last_commit_us;
+    commit_count += count;
+    Serial.printf("[SettingsStore] Committed %d owner(s) in %lu us (total %lu commits, %lu edits coalesced, max %lu us)\n",
+                  count, last_commit_us, commit_count, coalesced_count, max_commit_us);
+}
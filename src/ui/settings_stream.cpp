@@ -0,0 +1,99 @@
+#include "ui/settings_stream.h"
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+size_t SettingsFileWriter::write(uint8_t c) {
+    if (len == sizeof(buf) && !flushBuffer()) return 0;
+    buf[len++] = c;
+    return 1;
+}
+
+size_t SettingsFileWriter::write(const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (!write(data[i])) return i;
+    }
+    return size;
+}
+
+void SettingsFileWriter::print(const char *s) {
+    write((const uint8_t*)s, strlen(s));
+}
+
+void SettingsFileWriter::printf(const char *fmt, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (n < 0) return;
+    write((const uint8_t*)line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+}
+
+bool SettingsFileWriter::flushBuffer() {
+    if (len > 0 && sink.write(buf, len) != len) failed = true;
+    total += len;
+    len = 0;
+    return !failed;
+}
+
+bool SettingsFileReader::fill() {
+    if (pos < len) return true;
+    int n = source.read(buf, sizeof(buf));
+    pos = 0;
+    len = n > 0 ? n : 0;
+    return len > 0;
+}
+
+int SettingsFileReader::read() {
+    if (!fill()) return -1;
+    if (limited && ++record_bytes > SETTINGS_MAX_RECORD_BYTES) {
+        too_large = true;
+        return -1;
+    }
+    return buf[pos++];
+}
+
+size_t SettingsFileReader::readBytes(char *out, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) out[n++] = (char)c;
+    return n;
+}
+
+int SettingsFileReader::next() {
+    while (fill() && isspace(buf[pos])) pos++;
+    return peek();
+}
+
+bool SettingsFileReader::consume(char c) {
+    if (next() != c) return false;
+    pos++;
+    return true;
+}
+
+bool SettingsFileReader::readKey(char *key, size_t key_size) {
+    if (!consume('"')) return false;
+    size_t n = 0;
+    while (true) {
+        int c = read();
+        if (c < 0) return false;
+        if (c == '"') break;
+        if (c == '\\' && (c = read()) < 0) return false;
+        if (n < key_size - 1) key[n++] = (char)c;
+    }
+    key[n] = '\0';
+    return consume(':');
+}
+
+void SettingsFileReader::beginRecord() {
+    limited = true;
+    record_bytes = 0;
+    too_large = false;
+}
+
+bool SettingsFileReader::endRecord() {
+    limited = false;
+    return !too_large;
+}
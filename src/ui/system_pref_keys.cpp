@@ -0,0 +1,29 @@
+#include "ui/system_pref_keys.h"
+
+// Indexed by SysPref
+static const PrefDef DEFS[(int)SysPref::COUNT] = {
+    {"show_mach_sel",  PrefType::BOOL, 1},
+    {"folders_on_top", PrefType::BOOL, 0},
+    {"display_rot",    PrefType::U8,   0},
+    {"term_log",       PrefType::BOOL, 0},
+    {"clean_shutdown", PrefType::BOOL, 0},
+    {"pm_enabled",     PrefType::BOOL, 1},
+    {"pm_dim_to",      PrefType::U32,  30},
+    {"pm_sleep_to",    PrefType::U32,  300},
+    {"pm_deepsleep",   PrefType::U32,  900},
+    {"pm_norm_bri",    PrefType::U8,   100},
+    {"pm_dim_bri",     PrefType::U8,   25},
+    {"probe_tip_um",   PrefType::U32,  0},
+};
+
+const PrefDef &sysPrefDef(SysPref pref) {
+    return DEFS[(int)pref];
+}
+
+uint32_t sysPrefValue(SysPref pref, uint32_t value) {
+    switch (DEFS[(int)pref].type) {
+        case PrefType::BOOL: return value ? 1 : 0;
+        case PrefType::U8:   return value > 255 ? 255 : value;
+        default:             return value;
+    }
+}
@@ -0,0 +1,65 @@
+#include "ui/system_prefs.h"
+#include "ui/settings_store.h"
+#include "config.h"
+#include <Preferences.h>
+
+// Static member initialization
+uint32_t SystemPrefs::values[(int)SysPref::COUNT] = {0};
+uint32_t SystemPrefs::dirty_mask = 0;
+SystemPrefs::Listener SystemPrefs::listeners[MAX_LISTENERS] = {nullptr};
+
+void SystemPrefs::load() {
+    Preferences prefs;
+    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
+    for (int i = 0; i < (int)SysPref::COUNT; i++) {
+        const PrefDef &d = sysPrefDef((SysPref)i);
+        switch (d.type) {
+            case PrefType::BOOL: values[i] = prefs.getBool(d.key, d.def != 0) ? 1 : 0; break;
+            case PrefType::U8:   values[i] = prefs.getUChar(d.key, (uint8_t)d.def); break;
+            case PrefType::U32:  values[i] = prefs.getUInt(d.key, d.def); break;
+        }
+    }
+    prefs.end();
+    dirty_mask = 0;
+    Serial.printf("[SystemPrefs] Loaded %d keys\n", (int)SysPref::COUNT);
+}
+
+void SystemPrefs::setUInt(SysPref pref, uint32_t value) {
+    int i = (int)pref;
+    value = sysPrefValue(pref, value);
+    if (values[i] == value) return;
+
+    values[i] = value;
+    dirty_mask |= (1u << i);
+    SettingsStore::schedule(commit);
+
+    for (Listener l : listeners) {
+        if (l) l(pref);
+    }
+}
+
+void SystemPrefs::subscribe(Listener listener) {
+    for (Listener &l : listeners) {
+        if (l == listener) return;  // Already subscribed (UI rebuilt)
+        if (!l) { l = listener; return; }
+    }
+    Serial.println("[SystemPrefs] Too many listeners");
+}
+
+void SystemPrefs::commit() {
+    if (!dirty_mask) return;
+
+    Preferences prefs;
+    prefs.begin(PREFS_SYSTEM_NAMESPACE, false);  // Read-write
+    for (int i = 0; i < (int)SysPref::COUNT; i++) {
+        if (!(dirty_mask & (1u << i))) continue;
+        const PrefDef &d = sysPrefDef((SysPref)i);
+        switch (d.type) {
+            case PrefType::BOOL: prefs.putBool(d.key, values[i] != 0); break;
+            case PrefType::U8:   prefs.putUChar(d.key, (uint8_t)values[i]); break;
+            case PrefType::U32:  prefs.putUInt(d.key, values[i]); break;
+        }
+    }
+    prefs.end();
+    dirty_mask = 0;
+}
@@ -360,10 +360,10 @@ void UITabControlActions::onZeroXClicked(lv_event_t *e) {
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
         
-        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
         
         // Show lock confirmation dialog
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Actions] Confirmed Zero X on locked WCS");
             FluidNCClient::sendCommand("G10 L20 P0 X0\n");
         });
@@ -386,10 +386,10 @@ void UITabControlActions::onZeroYClicked(lv_event_t *e) {
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
         
-        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
         
         // Show lock confirmation dialog
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Actions] Confirmed Zero Y on locked WCS");
             FluidNCClient::sendCommand("G10 L20 P0 Y0\n");
         });
@@ -412,10 +412,10 @@ void UITabControlActions::onZeroZClicked(lv_event_t *e) {
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
         
-        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
         
         // Show lock confirmation dialog
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Actions] Confirmed Zero Z on locked WCS");
             FluidNCClient::sendCommand("G10 L20 P0 Z0\n");
         });
@@ -438,10 +438,10 @@ void UITabControlActions::onZeroAClicked(lv_event_t *e) {
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
 
-        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
 
         // Show lock confirmation dialog
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Actions] Confirmed Zero A on locked WCS");
             FluidNCClient::sendCommand("G10 L20 P0 A0\n");
         });
@@ -464,10 +464,10 @@ void UITabControlActions::onZeroAllClicked(lv_event_t *e) {
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
 
-        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Actions] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
 
         // Show lock confirmation dialog
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Actions] Confirmed Zero All on locked WCS");
             if (UICommon::isAAxisEnabled()) {
                 FluidNCClient::sendCommand("G10 L20 P0 X0 Y0 Z0 A0\n");
@@ -932,6 +932,10 @@ static void za_joystick_toggle_event_cb(lv_event_t *e) {
     Serial.printf("[Joystick] Switched to %s mode\n", is_z_mode ? "Z" : "A");
 }
 
+bool UITabControlJoystick::isActive() {
+    return xy_jogging || z_jogging || a_jogging;
+}
+
 void UITabControlJoystick::create(lv_obj_t *parent) {
     // Set parent to use horizontal flex layout (XY joystick on left, info in center, Z slider on right)
     lv_obj_set_flex_flow(parent, LV_FLEX_FLOW_ROW);
@@ -3,6 +3,8 @@
 #include "ui/ui_theme.h"
 #include "ui/ui_common.h"
 #include "ui/wcs_config.h"
+#include "ui/system_prefs.h"
+#include "ui/ui_height_map.h"
 #include "network/fluidnc_client.h"
 #include "config.h"
 #include <lvgl.h>
@@ -15,12 +17,21 @@ lv_obj_t* UITabControlProbe::probe_indicator = nullptr;
 lv_obj_t* UITabControlProbe::keyboard = nullptr;
 lv_obj_t* UITabControlProbe::parent_tab = nullptr;
 
-// Track which axis was last probed
-char UITabControlProbe::last_probed_axis = '\0';
+// Probe routines dialog
+lv_obj_t* UITabControlProbe::routines_dialog = nullptr;
+lv_obj_t* UITabControlProbe::routines_keyboard = nullptr;
+lv_obj_t* UITabControlProbe::touch_z_switch = nullptr;
+lv_obj_t* UITabControlProbe::tip_input = nullptr;
+lv_obj_t* UITabControlProbe::history_label = nullptr;
+uint32_t UITabControlProbe::shown_changes = 0;
 
 // Temporary storage for pending probe operation (when WCS is locked)
 static char pending_axis = '\0';
 static char pending_direction = '\0';
+static int pending_routine = 0;
+static bool pending_touch_z = false;
+
+static const int ROUTINE_BORE = 4;   // After the four ProbeCorner values
 
 // Static pointers to input fields for reading values
 static lv_obj_t* feed_input_ptr = nullptr;
@@ -35,6 +46,9 @@ void UITabControlProbe::create(lv_obj_t *parent) {
     // Store parent tab reference
     parent_tab = parent;
     
+    // A routines dialog lives on the previous screen and goes with it
+    routines_dialog = routines_keyboard = touch_z_switch = tip_input = history_label = nullptr;
+    
     // Load probe defaults from settings
     UITabSettingsProbe::loadPreferences();
     
@@ -117,6 +131,17 @@ void UITabControlProbe::create(lv_obj_t *parent) {
     lv_obj_set_style_text_font(z_minus_lbl, &lv_font_montserrat_20, 0);
     lv_obj_center(z_minus_lbl);
     
+    // Routines button (corner, bore center, probe history)
+    lv_obj_t* routines_btn = lv_button_create(parent);
+    lv_obj_set_size(routines_btn, 100, 50);
+    lv_obj_set_pos(routines_btn, 120, 255);
+    lv_obj_set_style_bg_color(routines_btn, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(routines_btn, routines_handler, LV_EVENT_CLICKED, NULL);
+    lv_obj_t* routines_lbl = lv_label_create(routines_btn);
+    lv_label_set_text(routines_lbl, "More...");
+    lv_obj_set_style_text_font(routines_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(routines_lbl);
+    
     // === PARAMETERS SECTION (Right Side) ===
     lv_obj_t* params_header = lv_label_create(parent);
     lv_label_set_text(params_header, "PARAMETERS");
@@ -238,7 +263,8 @@ void UITabControlProbe::create(lv_obj_t *parent) {
     lv_obj_clear_flag(probe_indicator, LV_OBJ_FLAG_SCROLLABLE);
     
     results_text = lv_textarea_create(parent);
-    lv_textarea_set_text(results_text, "No probe data");
+    lv_textarea_set_text(results_text, ProbeSequencer::getMessage());
+    shown_changes = ProbeSequencer::getChangeCount();
     lv_obj_set_size(results_text, 370, 50);  // 10px wider for better readability
     lv_obj_set_pos(results_text, 260, 295);  // Aligned with parameters section, moved down 20px
     lv_obj_set_style_text_font(results_text, &lv_font_montserrat_16, 0);  // Larger font for better readability
@@ -287,86 +313,92 @@ void UITabControlProbe::executeProbe(char axis, char direction, bool checkWcsLoc
         char wcs_name[32];
         WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
         
-        Serial.printf("[Probe] WCS %s is locked, showing confirmation\n", status.modal_wcs);
+        Serial.printf("[Probe] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
         
         // Store probe parameters for callback
         pending_axis = axis;
         pending_direction = direction;
         
         // Show lock confirmation dialog - execute probe on confirmation (bypass lock check)
-        UICommon::showWCSLockDialog(status.modal_wcs, wcs_name, [](lv_event_t *e) {
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
             Serial.println("[Probe] Confirmed probe on locked WCS - executing probe");
             UITabControlProbe::executeProbe(pending_axis, pending_direction, false);
         });
         return;
     }
     
-    // Store which axis is being probed for result filtering
-    last_probed_axis = axis;
-    
-    // Read parameters from input fields
-    const char* feed_text = lv_textarea_get_text(feed_input_ptr);
-    const char* dist_text = lv_textarea_get_text(dist_input_ptr);
-    const char* retract_text = lv_textarea_get_text(retract_input_ptr);
-    const char* thickness_text = lv_textarea_get_text(thickness_input_ptr);
+    ProbeParams params;
+    if (!readParams(params)) return;
     
-    float feed_rate = atof(feed_text);
-    float max_dist = atof(dist_text);
-    float retract = atof(retract_text);
-    float thickness = atof(thickness_text);
-    
-    // Validate inputs
-    if (feed_rate <= 0 || max_dist <= 0) {
+    // Each line waits for the previous "ok" - the result shows up through update()
+    ProbeSequencer::probeAxis(axis, direction, params);
+}
+
+void UITabControlProbe::routines_handler(lv_event_t* e) {
+    showRoutinesDialog();
+}
+
+void UITabControlProbe::executeRoutine(int routine, bool touch_z, bool checkWcsLock) {
+    if (!FluidNCClient::isConnected()) {
         if (results_text) {
-            lv_textarea_set_text(results_text, "Error: Invalid feed rate or distance");
+            lv_textarea_set_text(results_text, "Error: Not connected to FluidNC");
         }
         return;
     }
     
-    // Update result text to show probing in progress
-    if (results_text) {
-        char status[64];
-        snprintf(status, sizeof(status), "Probing %c%c...", axis, direction);
-        lv_textarea_set_text(results_text, status);
+    // Routines set the work offset of the current WCS
+    if (checkWcsLock && WCSConfig::isCurrentWCSLocked()) {
+        const FluidNCStatus& status = FluidNCClient::getStatus();
+        char wcs_name[32];
+        WCSConfig::getCurrentWCSName(wcs_name, sizeof(wcs_name));
+        
+        Serial.printf("[Probe] WCS %s is locked, showing confirmation\n", status.modal.wcsName());
+        
+        pending_routine = routine;
+        pending_touch_z = touch_z;
+        UICommon::showWCSLockDialog(status.modal.wcsName(), wcs_name, [](lv_event_t *e) {
+            Serial.println("[Probe] Confirmed routine on locked WCS - executing");
+            UITabControlProbe::executeRoutine(pending_routine, pending_touch_z, false);
+        });
+        return;
     }
     
-    // Save current distance mode (G90/G91) to restore after probing
-    const char* saved_distance_mode = FluidNCClient::getStatus().modal_distance;
-    
-    // Set incremental mode BEFORE probe command (modal group violation if combined)
-    FluidNCClient::sendCommand("G91\n");
+    ProbeParams params;
+    if (!readParams(params)) return;
     
-    // Build G38.2 command WITHOUT G91 (already set above): G38.2 <AXIS><DIRECTION><DISTANCE> F<FEED> P<THICKNESS>
-    char command[128];
-    
-    if (thickness > 0.001) {  // Use P parameter if thickness is specified
-        snprintf(command, sizeof(command), "G38.2 %c%.1f F%.0f P%.2f\n", 
-                 axis, (direction == '-' ? -max_dist : max_dist), feed_rate, thickness);
+    if (routine == ROUTINE_BORE) {
+        ProbeSequencer::probeBore(params);
     } else {
-        snprintf(command, sizeof(command), "G38.2 %c%.1f F%.0f\n", 
-                 axis, (direction == '-' ? -max_dist : max_dist), feed_rate);
+        ProbeSequencer::probeCorner((ProbeCorner)routine, touch_z, params);
     }
+}
+
+bool UITabControlProbe::readParams(ProbeParams &params) {
+    params.feed_rate = atof(lv_textarea_get_text(feed_input_ptr));
+    params.max_distance = atof(lv_textarea_get_text(dist_input_ptr));
+    params.retract = atof(lv_textarea_get_text(retract_input_ptr));
+    params.thickness = atof(lv_textarea_get_text(thickness_input_ptr));
+    params.tip_diameter = SystemPrefs::getUInt(SysPref::PROBE_TIP_DIAMETER) / 1000.0f;
     
-    Serial.printf("Probe: Sending command: %s\n", command);
-    FluidNCClient::sendCommand(command);
-    
-    // Send retract move if retract distance is specified
-    if (retract > 0.001) {
-        // Retract in opposite direction from probe (no + sign in GCode)
-        char retract_sign = (direction == '-') ? ' ' : '-';
-        
-        // Still in G91 mode from probe setup, send retract move
-        char retract_command[64];
-        snprintf(retract_command, sizeof(retract_command), "G0 %c%c%.2f\n", 
-                 axis, retract_sign, retract);
-        Serial.printf("Probe: Sending retract: %s", retract_command);
-        FluidNCClient::sendCommand(retract_command);
+    // Validate inputs
+    if (params.feed_rate <= 0 || params.max_distance <= 0) {
+        if (results_text) {
+            lv_textarea_set_text(results_text, "Error: Invalid feed rate or distance");
+        }
+        return false;
     }
+    return true;
+}
+
+void UITabControlProbe::update() {
+    uint32_t changes = ProbeSequencer::getChangeCount();
+    if (changes == shown_changes) return;
+    shown_changes = changes;
     
-    // Restore original distance mode (G90 or G91)
-    char restore_cmd[8];
-    snprintf(restore_cmd, sizeof(restore_cmd), "%s\n", saved_distance_mode);
-    FluidNCClient::sendCommand(restore_cmd);
+    if (results_text) {
+        lv_textarea_set_text(results_text, ProbeSequencer::getMessage());
+    }
+    updateHistory();
 }
 
 void UITabControlProbe::updateResult(const char* message) {
@@ -375,48 +407,225 @@ void UITabControlProbe::updateResult(const char* message) {
     }
 }
 
-void UITabControlProbe::updateResult(float x, float y, float z, bool success) {
-    if (!results_text) return;
-    
-    char result[256];
-    if (success) {
-        // Only show the value for the axis that was probed
-        const char* axis_name = "";
-        float axis_value = 0.0f;
-        
-        switch (last_probed_axis) {
-            case 'X':
-                axis_name = "X";
-                axis_value = x;
-                break;
-            case 'Y':
-                axis_name = "Y";
-                axis_value = y;
-                break;
-            case 'Z':
-                axis_name = "Z";
-                axis_value = z;
-                break;
-            default:
-                // Fallback: show all axes if unknown (compact 2-line format)
-                snprintf(result, sizeof(result), 
-                        "SUCCESS\nX:%.3f Y:%.3f Z:%.3f", 
-                        x, y, z);
-                lv_textarea_set_text(results_text, result);
-                return;
-        }
-        
-        // Compact 2-line format
-        snprintf(result, sizeof(result), 
-                "SUCCESS\n%s: %.3f mm", 
-                axis_name, axis_value);
-    } else {
-        // Compact 2-line format
-        snprintf(result, sizeof(result), 
-                "FAILED\nNo contact detected");
+// Corner button labels, laid out as seen from the front of the machine
+static const char* CORNER_LABELS[4] = {"Front-Left", "Front-Right", "Back-Left", "Back-Right"};
+
+void UITabControlProbe::showRoutinesDialog() {
+    if (routines_dialog) return;
+    hideKeyboard();
+    
+    // Create modal background
+    routines_dialog = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(routines_dialog, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(routines_dialog, lv_color_make(0, 0, 0), 0);
+    lv_obj_set_style_bg_opa(routines_dialog, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(routines_dialog, 0, 0);
+    lv_obj_clear_flag(routines_dialog, LV_OBJ_FLAG_SCROLLABLE);
+    
+    // Dialog content box
+    lv_obj_t *content = lv_obj_create(routines_dialog);
+    lv_obj_set_size(content, 700, 400);
+    lv_obj_center(content);
+    lv_obj_set_style_bg_color(content, UITheme::BG_MEDIUM, 0);
+    lv_obj_set_style_border_color(content, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_set_style_border_width(content, 3, 0);
+    lv_obj_set_style_pad_all(content, 15, 0);
+    lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
+    
+    lv_obj_t *title = lv_label_create(content);
+    lv_label_set_text(title, "Probe Routines");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(title, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 0, 0);
+    
+    // === CORNER SECTION (back row on top) ===
+    lv_obj_t *corner_header = lv_label_create(content);
+    lv_label_set_text(corner_header, "CORNER");
+    lv_obj_set_style_text_font(corner_header, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(corner_header, UITheme::TEXT_DISABLED, 0);
+    lv_obj_set_pos(corner_header, 0, 45);
+    
+    static const int CORNER_ORDER[4] = {(int)ProbeCorner::BACK_LEFT, (int)ProbeCorner::BACK_RIGHT,
+                                        (int)ProbeCorner::FRONT_LEFT, (int)ProbeCorner::FRONT_RIGHT};
+    for (int i = 0; i < 4; i++) {
+        int corner = CORNER_ORDER[i];
+        lv_obj_t *btn = lv_button_create(content);
+        lv_obj_set_size(btn, 140, 50);
+        lv_obj_set_pos(btn, (i % 2) * 150, 75 + (i / 2) * 60);
+        lv_obj_set_style_bg_color(btn, UITheme::ACCENT_PRIMARY, 0);
+        lv_obj_add_event_cb(btn, [](lv_event_t *e) {
+            int corner = (int)(intptr_t)lv_event_get_user_data(e);
+            bool touch_z = lv_obj_has_state(touch_z_switch, LV_STATE_CHECKED);
+            closeRoutinesDialog();
+            executeRoutine(corner, touch_z);
+        }, LV_EVENT_CLICKED, (void*)(intptr_t)corner);
+        lv_obj_t *lbl = lv_label_create(btn);
+        lv_label_set_text(lbl, CORNER_LABELS[corner]);
+        lv_obj_set_style_text_font(lbl, &lv_font_montserrat_18, 0);
+        lv_obj_center(lbl);
+    }
+    
+    // Touch Z first: start above the stock instead of outside the corner at depth
+    touch_z_switch = lv_switch_create(content);
+    lv_obj_set_pos(touch_z_switch, 0, 200);
+    lv_obj_t *touch_z_label = lv_label_create(content);
+    lv_label_set_text(touch_z_label, "Touch Z first");
+    lv_obj_set_style_text_font(touch_z_label, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(touch_z_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(touch_z_label, 70, 202);
+    
+    // Bore center
+    lv_obj_t *bore_btn = lv_button_create(content);
+    lv_obj_set_size(bore_btn, 140, 50);
+    lv_obj_set_pos(bore_btn, 0, 245);
+    lv_obj_set_style_bg_color(bore_btn, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_add_event_cb(bore_btn, [](lv_event_t *e) {
+        closeRoutinesDialog();
+        executeRoutine(ROUTINE_BORE, false);
+    }, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *bore_lbl = lv_label_create(bore_btn);
+    lv_label_set_text(bore_lbl, "Bore Center");
+    lv_obj_set_style_text_font(bore_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(bore_lbl);
+    
+    // Height map (grid probing and surface compensation)
+    lv_obj_t *map_btn = lv_button_create(content);
+    lv_obj_set_size(map_btn, 140, 50);
+    lv_obj_set_pos(map_btn, 150, 245);
+    lv_obj_set_style_bg_color(map_btn, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_add_event_cb(map_btn, [](lv_event_t *e) {
+        closeRoutinesDialog();
+        UIHeightMap::show();
+    }, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *map_lbl = lv_label_create(map_btn);
+    lv_label_set_text(map_lbl, "Height Map...");
+    lv_obj_set_style_text_font(map_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(map_lbl);
+    
+    // Tip diameter (saved as a system preference in microns)
+    lv_obj_t *tip_label = lv_label_create(content);
+    lv_label_set_text(tip_label, "Tip Diameter:");
+    lv_obj_set_style_text_font(tip_label, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(tip_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(tip_label, 0, 326);
+    
+    tip_input = lv_textarea_create(content);
+    lv_textarea_set_one_line(tip_input, true);
+    lv_obj_set_style_text_font(tip_input, &lv_font_montserrat_18, 0);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.3f", SystemPrefs::getUInt(SysPref::PROBE_TIP_DIAMETER) / 1000.0f);
+    lv_textarea_set_text(tip_input, buf);
+    lv_textarea_set_accepted_chars(tip_input, "0123456789.");
+    lv_obj_set_size(tip_input, 100, 45);
+    lv_obj_set_pos(tip_input, 140, 315);
+    lv_obj_clear_flag(tip_input, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(tip_input, [](lv_event_t *e) {
+        lv_obj_clear_flag(routines_keyboard, LV_OBJ_FLAG_HIDDEN);
+    }, LV_EVENT_FOCUSED, nullptr);
+    lv_obj_add_event_cb(tip_input, [](lv_event_t *e) {
+        float tip = atof(lv_textarea_get_text(tip_input));
+        SystemPrefs::setUInt(SysPref::PROBE_TIP_DIAMETER, tip > 0 ? (uint32_t)(tip * 1000.0f + 0.5f) : 0);
+    }, LV_EVENT_VALUE_CHANGED, nullptr);
+    
+    lv_obj_t *tip_unit = lv_label_create(content);
+    lv_label_set_text(tip_unit, "mm");
+    lv_obj_set_style_text_font(tip_unit, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(tip_unit, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(tip_unit, 250, 326);
+    
+    // === HISTORY SECTION (Right Side) ===
+    lv_obj_t *history_header = lv_label_create(content);
+    lv_label_set_text(history_header, "PROBE HISTORY (MACHINE)");
+    lv_obj_set_style_text_font(history_header, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(history_header, UITheme::TEXT_DISABLED, 0);
+    lv_obj_set_pos(history_header, 320, 45);
+    
+    lv_obj_t *history_box = lv_obj_create(content);
+    lv_obj_set_size(history_box, 345, 220);
+    lv_obj_set_pos(history_box, 320, 75);
+    lv_obj_set_style_bg_color(history_box, UITheme::BG_DARKER, 0);
+    lv_obj_set_style_border_width(history_box, 0, 0);
+    lv_obj_set_style_pad_all(history_box, 6, 0);
+    
+    history_label = lv_label_create(history_box);
+    lv_obj_set_width(history_label, LV_PCT(100));
+    lv_obj_set_style_text_font(history_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(history_label, UITheme::TEXT_LIGHT, 0);
+    updateHistory();
+    
+    // Clear history button
+    lv_obj_t *clear_btn = lv_button_create(content);
+    lv_obj_set_size(clear_btn, 150, 50);
+    lv_obj_align(clear_btn, LV_ALIGN_BOTTOM_RIGHT, -160, 0);
+    lv_obj_set_style_bg_color(clear_btn, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(clear_btn, [](lv_event_t *e) {
+        ProbeSequencer::clearHistory();
+    }, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *clear_lbl = lv_label_create(clear_btn);
+    lv_label_set_text(clear_lbl, "Clear");
+    lv_obj_set_style_text_font(clear_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(clear_lbl);
+    
+    // Close button
+    lv_obj_t *close_btn = lv_button_create(content);
+    lv_obj_set_size(close_btn, 150, 50);
+    lv_obj_align(close_btn, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_set_style_bg_color(close_btn, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(close_btn, [](lv_event_t *e) {
+        closeRoutinesDialog();
+    }, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *close_lbl = lv_label_create(close_btn);
+    lv_label_set_text(close_lbl, "Close");
+    lv_obj_set_style_text_font(close_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(close_lbl);
+    
+    // Numeric keyboard for the tip diameter (hidden until the field is focused)
+    routines_keyboard = lv_keyboard_create(routines_dialog);
+    lv_obj_set_size(routines_keyboard, SCREEN_WIDTH, 220);
+    lv_obj_align(routines_keyboard, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_text_font(routines_keyboard, &lv_font_montserrat_20, 0);
+    lv_keyboard_set_mode(routines_keyboard, LV_KEYBOARD_MODE_NUMBER);
+    lv_keyboard_set_textarea(routines_keyboard, tip_input);
+    lv_obj_add_flag(routines_keyboard, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_event_cb(routines_keyboard, [](lv_event_t *e) {
+        lv_obj_add_flag(routines_keyboard, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_state(tip_input, LV_STATE_FOCUSED);
+    }, LV_EVENT_READY, nullptr);
+    lv_obj_add_event_cb(routines_keyboard, [](lv_event_t *e) {
+        lv_obj_add_flag(routines_keyboard, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_state(tip_input, LV_STATE_FOCUSED);
+    }, LV_EVENT_CANCEL, nullptr);
+}
+
+void UITabControlProbe::closeRoutinesDialog() {
+    if (!routines_dialog) return;
+    lv_obj_del(routines_dialog);
+    routines_dialog = nullptr;
+    routines_keyboard = nullptr;
+    touch_z_switch = nullptr;
+    tip_input = nullptr;
+    history_label = nullptr;
+}
+
+void UITabControlProbe::updateHistory() {
+    if (!history_label) return;
+    
+    int count = ProbeSequencer::getHistoryCount();
+    if (count == 0) {
+        lv_label_set_text(history_label, "No probe data");
+        return;
     }
     
-    lv_textarea_set_text(results_text, result);
+    // Newest first
+    static char text[PROBE_HISTORY_SIZE * 48];
+    int len = 0;
+    for (int i = 0; i < count && len < (int)sizeof(text); i++) {
+        const ProbeResult &r = ProbeSequencer::getHistory(i);
+        len += snprintf(text + len, sizeof(text) - len, "%2d  X%.3f Y%.3f Z%.3f%s\n",
+                        i + 1, r.x, r.y, r.z, r.success ? "" : "  FAILED");
+    }
+    if (len > 0 && len < (int)sizeof(text)) text[len - 1] = '\0';
+    lv_label_set_text(history_label, text);
 }
 
 // Textarea focused event handler - show keyboard
@@ -2,6 +2,7 @@
 #include "ui/ui_theme.h"
 #include "ui/settings_manager.h"
 #include "config.h"
+#include "ui/settings_store.h"
 #include <Preferences.h>
 
 // Global references for UI elements
@@ -281,6 +282,7 @@ static void btn_clear_event_handler(lv_event_t *e) {
                 lv_task_handler();
                 delay(1000);
                 
+                SettingsStore::flush();  // Pending settings writes
                 // Restart ESP32
                 ESP.restart();
             }
@@ -5,7 +5,8 @@
 #include "ui/settings_manager.h"
 #include "core/display_driver.h"
 #include "config.h"
-#include <Preferences.h>
+#include "ui/settings_store.h"
+#include "ui/system_prefs.h"
 
 // Global references for UI elements
 static lv_obj_t *status_label = NULL;
@@ -27,12 +28,9 @@ void UITabSettingsGeneral::create(lv_obj_t *tab) {
     // Disable scrolling for fixed layout
     lv_obj_clear_flag(tab, LV_OBJ_FLAG_SCROLLABLE);
     
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
-    bool show_machine_select = prefs.getBool("show_mach_sel", true);  // Default to true
-    bool folders_on_top = prefs.getBool("folders_on_top", false);  // Default to false (folders at bottom)
-    uint8_t display_rotation = prefs.getUChar("display_rot", 0);  // Default to 0 (normal)
-    prefs.end();
+    bool show_machine_select = SystemPrefs::getBool(SysPref::SHOW_MACHINE_SELECT);
+    bool folders_on_top = SystemPrefs::getBool(SysPref::FOLDERS_ON_TOP);
+    uint8_t display_rotation = SystemPrefs::getUInt(SysPref::DISPLAY_ROTATION);
 
     // Load enable_a_axis from the selected machine config (it's machine-specific)
     bool enable_a_axis = false;
@@ -188,25 +186,12 @@ static void btn_save_general_event_handler(lv_event_t *e) {
 
         Serial.printf("UITabSettingsGeneral: Saving show_mach_sel=%d, folders_on_top=%d, display_rot=%d, enable_a_axis=%d\n", show_machine_select, folders_on_top, rotation, enable_a_axis);
         
-        Preferences prefs;
-        if (!prefs.begin(PREFS_SYSTEM_NAMESPACE, false)) {  // Read-write
-            Serial.println("UITabSettingsGeneral: ERROR - Failed to open Preferences for writing!");
-            if (status_label != NULL) {
-                lv_label_set_text(status_label, "Error: Failed to save!");
-                lv_obj_set_style_text_color(status_label, UITheme::STATE_ALARM, 0);
-            }
-            return;
-        }
-        
-        prefs.putBool("show_mach_sel", show_machine_select);
-        prefs.putBool("folders_on_top", folders_on_top);
-
         // Check if rotation changed - requires restart
-        uint8_t old_rotation = prefs.getUChar("display_rot", 0);
-        bool rotation_changed = (rotation != old_rotation);
-        
-        prefs.putUChar("display_rot", rotation);
-        prefs.end();
+        bool rotation_changed = (rotation != SystemPrefs::getUInt(SysPref::DISPLAY_ROTATION));
+
+        SystemPrefs::setBool(SysPref::SHOW_MACHINE_SELECT, show_machine_select);
+        SystemPrefs::setBool(SysPref::FOLDERS_ON_TOP, folders_on_top);
+        SystemPrefs::setUInt(SysPref::DISPLAY_ROTATION, rotation);
 
         // Save enable_a_axis to the selected machine config
         bool a_axis_changed = false;
@@ -223,15 +208,6 @@ static void btn_save_general_event_handler(lv_event_t *e) {
         // Update cached A-axis setting immediately (no restart needed)
         UICommon::setAAxisEnabled(enable_a_axis);
 
-        // Verify system prefs were saved
-        prefs.begin(PREFS_SYSTEM_NAMESPACE, true);
-        bool verified_machine = prefs.getBool("show_mach_sel", true);
-        bool verified_folders = prefs.getBool("folders_on_top", false);
-        uint8_t verified_rotation = prefs.getUChar("display_rot", 0);
-        prefs.end();
-
-        Serial.printf("UITabSettingsGeneral: Verified show_mach_sel=%d, folders_on_top=%d, display_rot=%d, enable_a_axis=%d\n", verified_machine, verified_folders, verified_rotation, enable_a_axis);
-
         if (status_label != NULL) {
             lv_label_set_text(status_label, "Settings saved!");
             lv_obj_set_style_text_color(status_label, UITheme::UI_SUCCESS, 0);
@@ -343,6 +319,7 @@ static void showRotationRestartDialog() {
             lv_task_handler();
             delay(2000);
             
+            SettingsStore::flush();  // Pending settings writes
             // Restart ESP32
             ESP.restart();
         }
@@ -441,6 +418,7 @@ static void showAAxisRestartDialog() {
             lv_task_handler();
             delay(2000);
 
+            SettingsStore::flush();  // Pending settings writes
             // Restart ESP32
             ESP.restart();
         }
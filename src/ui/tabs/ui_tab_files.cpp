@@ -2,12 +2,16 @@
 #include "ui/ui_theme.h"
 #include "ui/ui_tabs.h"
 #include "ui/upload_manager.h"
+#include "ui/ui_gcode_preview.h"
+#include "ui/gcode_cache.h"
+#include "core/sd_card.h"
+#include "ui/system_prefs.h"
 #include "network/fluidnc_client.h"
+#include "network/gcode_sender.h"
 #include "config.h"
 #include <Arduino.h>
 #include <algorithm>
 #include <ArduinoJson.h>
-#include <Preferences.h>
 #include <SD.h>
 #include <SPI.h>
 
@@ -31,6 +35,16 @@ UITabFiles::StorageCache UITabFiles::fluidnc_sd_cache = {"", false, {}};
 UITabFiles::StorageCache UITabFiles::fluidnc_flash_cache = {"", false, {}};
 UITabFiles::StorageCache UITabFiles::display_sd_cache = {"", false, {}};
 
+// File list rows (persistent across callbacks): full path, size and estimate label
+static char filenames_storage[100][256];
+static int32_t row_sizes[100];
+static lv_obj_t *row_estimate_labels[100];
+
+// Display SD directory scan in progress (continued from the main loop by scanLoop())
+static File scan_root;
+static uint32_t scan_start_ms = 0;
+static size_t row_count = 0;
+
 // Helper to get current storage cache
 static UITabFiles::StorageCache* getCurrentCache() {
     if (UITabFiles::current_storage == StorageSource::FLUIDNC_SD) {
@@ -67,6 +81,16 @@ void UITabFiles::requestRefresh() {
     refresh_pending = true;
 }
 
+void UITabFiles::onReconnected() {
+    fluidnc_sd_cache.is_cached = false;
+    fluidnc_flash_cache.is_cached = false;
+
+    // Re-list the FluidNC folder on screen; other sources reload when next selected
+    if (initial_load_done && current_storage != StorageSource::DISPLAY_SD) {
+        requestRefresh();
+    }
+}
+
 // Check and execute pending refresh (called from main loop)
 void UITabFiles::checkPendingRefresh() {
     if (!refresh_pending) return;
@@ -90,7 +114,22 @@ void UITabFiles::checkPendingRefresh() {
     }
 }
 
+// Cached lists are sorted - re-list when the folder order changes
+static void onSystemPrefChanged(SysPref pref) {
+    if (pref != SysPref::FOLDERS_ON_TOP) return;
+    UITabFiles::fluidnc_sd_cache.is_cached = false;
+    UITabFiles::fluidnc_flash_cache.is_cached = false;
+    UITabFiles::display_sd_cache.is_cached = false;
+}
+
 void UITabFiles::create(lv_obj_t *tab) {
+    SystemPrefs::subscribe(onSystemPrefChanged);
+    
+    // A rebuilt UI may belong to another machine - re-read the FluidNC listings
+    cancelScan();
+    fluidnc_sd_cache.is_cached = false;
+    fluidnc_flash_cache.is_cached = false;
+
     lv_obj_set_style_bg_color(tab, UITheme::BG_MEDIUM, LV_PART_MAIN);
     lv_obj_set_style_pad_all(tab, 10, 0);
 
@@ -174,6 +213,8 @@ void UITabFiles::refreshFileList() {
 }
 
 void UITabFiles::refreshFileList(const std::string &path) {
+    cancelScan();
+    
     if (!FluidNCClient::isConnected()) {
         if (status_label) {
             lv_label_set_text(status_label, "Not connected");
@@ -327,6 +368,7 @@ void UITabFiles::storage_dropdown_event_cb(lv_event_t *e) {
     uint16_t selected = lv_dropdown_get_selected(dropdown);
     Serial.printf("[Files] Storage changed to index: %d\n", selected);
     
+    cancelScan();
     current_storage = static_cast<StorageSource>(selected);
     
     // Switch storage root path
@@ -523,6 +565,37 @@ static void directory_button_event_cb(lv_event_t *e) {
     }
 }
 
+// Files worth analyzing for a preview / time estimate
+static bool isGCodeFile(const std::string &name) {
+    static const char *extensions[] = {".nc", ".gcode", ".gc", ".ngc", ".tap", ".cnc", ".g"};
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) return false;
+    for (const char *ext : extensions) {
+        if (strcasecmp(name.c_str() + dot, ext) == 0) return true;
+    }
+    return false;
+}
+
+// "1h 05m" / "12m 30s" estimate text for a file row
+static void formatEstimate(char *buf, size_t len, float seconds) {
+    uint32_t secs = (uint32_t)(seconds + 0.5f);
+    if (secs >= 3600) {
+        snprintf(buf, len, "%uh %02um", secs / 3600, (secs / 60) % 60);
+    } else {
+        snprintf(buf, len, "%um %02us", secs / 60, secs % 60);
+    }
+}
+
+static void preview_row_event_cb(lv_event_t *e) {
+    const char *filename = (const char*)lv_event_get_user_data(e);
+    if (filename) {
+        size_t row = (filename - filenames_storage[0]) / sizeof(filenames_storage[0]);
+        Serial.printf("[Files] Preview file: %s\n", filename);
+        UIGCodePreview::show(filename, UITabFiles::current_storage == StorageSource::DISPLAY_SD,
+                             row < row_count ? row_sizes[row] : 0);
+    }
+}
+
 static void play_button_event_cb(lv_event_t *e) {
     const char *filename = (const char*)lv_event_get_user_data(e);
     if (filename) {
@@ -549,6 +622,20 @@ static void play_button_event_cb(lv_event_t *e) {
     }
 }
 
+static void stream_button_event_cb(lv_event_t *e) {
+    const char *filename = (const char*)lv_event_get_user_data(e);
+    if (filename) {
+        Serial.printf("[Files] Stream file: %s\n", filename);
+        if (!GCodeSender::start(filename)) return;
+        
+        // Switch to Status tab (index 0) to monitor progress
+        lv_obj_t *tabview = UITabs::getTabview();
+        if (tabview) {
+            lv_tabview_set_active(tabview, 0, LV_ANIM_OFF);
+        }
+    }
+}
+
 static void delete_confirm_event_cb(lv_event_t *e) {
     const char *filename = (const char*)lv_event_get_user_data(e);
     
@@ -763,11 +850,7 @@ void UITabFiles::parseFileList(const std::string &response) {
         }
     }
     
-    // Load folders_on_top preference
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);  // Read-only
-    bool folders_on_top = prefs.getBool("folders_on_top", false);  // Default to false (folders at bottom)
-    prefs.end();
+    bool folders_on_top = SystemPrefs::getBool(SysPref::FOLDERS_ON_TOP);
     
     // Sort based on user preference
     if (folders_on_top) {
@@ -811,6 +894,156 @@ void UITabFiles::parseFileList(const std::string &response) {
     updateFileListUI();
 }
 
+// Create the list row for entry i (also used to append rows while a scan runs)
+void UITabFiles::createFileRow(size_t i, const FileInfo &file) {
+    // Build full path for the entry
+    std::string full_path = current_path;
+    if (full_path[full_path.length() - 1] != '/') {
+        full_path += "/";
+    }
+    full_path += file.name;
+    // Note: Don't add trailing slash for directories - FluidNC doesn't like it
+    
+    // Store full path in persistent storage
+    strncpy(filenames_storage[i], full_path.c_str(), 255);
+    filenames_storage[i][255] = '\0';
+    row_sizes[i] = file.size;
+    row_estimate_labels[i] = nullptr;
+    
+    // File/directory row container
+    lv_obj_t *file_row = lv_obj_create(file_list_container);
+    lv_obj_set_size(file_row, 750, 46);
+    lv_obj_set_style_bg_color(file_row, file.is_directory ? UITheme::BG_BUTTON : UITheme::BG_DARKER, 0);
+    lv_obj_set_style_border_width(file_row, 1, 0);
+    lv_obj_set_style_border_color(file_row, UITheme::BORDER_MEDIUM, 0);
+    lv_obj_set_style_pad_all(file_row, 5, 0);
+    lv_obj_set_style_radius(file_row, 3, 0);
+    lv_obj_clear_flag(file_row, LV_OBJ_FLAG_SCROLLABLE);
+    
+    if (file.is_directory) {
+        // Make directory row clickable
+        lv_obj_add_flag(file_row, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(file_row, directory_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+    } else {
+        // File row opens the G-code preview (buttons on the row handle their own clicks)
+        lv_obj_add_flag(file_row, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(file_row, preview_row_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+    }
+    
+    // Icon + Filename label (left side)
+    lv_obj_t *lbl_filename = lv_label_create(file_row);
+    if (file.is_directory) {
+        char label_text[256];
+        snprintf(label_text, sizeof(label_text), LV_SYMBOL_DIRECTORY " %s", file.name.c_str());
+        lv_label_set_text(lbl_filename, label_text);
+        lv_obj_set_style_text_color(lbl_filename, UITheme::ACCENT_SECONDARY, 0);
+    } else {
+        lv_label_set_text(lbl_filename, file.name.c_str());
+        lv_obj_set_style_text_color(lbl_filename, lv_color_white(), 0);
+    }
+    lv_obj_set_style_text_font(lbl_filename, &lv_font_montserrat_20, 0);
+    lv_obj_align(lbl_filename, LV_ALIGN_LEFT_MID, 5, 0);
+    lv_label_set_long_mode(lbl_filename, LV_LABEL_LONG_DOT);
+    // Display SD rows carry an extra Run button - leave it room
+    bool display_sd = (current_storage == StorageSource::DISPLAY_SD);
+    lv_obj_set_width(lbl_filename, file.is_directory ? 720 : (display_sd ? 340 : 400));
+    
+    // Only show size and buttons for files, not directories
+    if (!file.is_directory) {
+        // File size label (center)
+        lv_obj_t *lbl_size = lv_label_create(file_row);
+        char size_str[32];
+        if (file.size >= 1024 * 1024) {
+            snprintf(size_str, sizeof(size_str), "%.2f MB", file.size / (1024.0f * 1024.0f));
+        } else if (file.size >= 1024) {
+            snprintf(size_str, sizeof(size_str), "%.1f KB", file.size / 1024.0f);
+        } else {
+            snprintf(size_str, sizeof(size_str), "%d B", file.size);
+        }
+        lv_label_set_text(lbl_size, size_str);
+        lv_obj_set_style_text_font(lbl_size, &lv_font_montserrat_20, 0);
+        lv_obj_set_style_text_color(lbl_size, UITheme::TEXT_MEDIUM, 0);
+        lv_obj_align(lbl_size, LV_ALIGN_LEFT_MID, display_sd ? 355 : 420, 0);
+        
+        // Estimated run time from the analysis cache (filled in by background analysis)
+        if (isGCodeFile(file.name)) {
+            lv_obj_t *lbl_estimate = lv_label_create(file_row);
+            lv_label_set_text(lbl_estimate, "");
+            lv_obj_set_style_text_font(lbl_estimate, &lv_font_montserrat_16, 0);
+            lv_obj_set_style_text_color(lbl_estimate, UITheme::UI_INFO, 0);
+            lv_obj_align(lbl_estimate, LV_ALIGN_LEFT_MID, display_sd ? 455 : 515, 0);
+            row_estimate_labels[i] = lbl_estimate;
+            
+            const GCodeCacheEntry *entry = GCodeCache::lookup(filenames_storage[i], display_sd, file.size);
+            if (entry) {
+                char est[24];
+                formatEstimate(est, sizeof(est), entry->analysis.est_time_sec);
+                lv_label_set_text(lbl_estimate, est);
+            }
+            if (display_sd) {
+                // Analyzed, or content-checked if cached, while idle. FluidNC files are only
+                // analyzed when previewed (HTTP would block the loop)
+                GCodeCache::queueBackground(filenames_storage[i], file.size);
+            }
+        }
+        
+        // Show run/upload buttons for Display SD, or play/delete for FluidNC storage
+        if (display_sd) {
+            // Upload button (for Display SD files)
+            lv_obj_t *btn_upload = lv_button_create(file_row);
+            lv_obj_set_size(btn_upload, 120, 38);
+            lv_obj_align(btn_upload, LV_ALIGN_RIGHT_MID, -5, 0);
+            lv_obj_set_style_bg_color(btn_upload, UITheme::ACCENT_PRIMARY, 0);
+            lv_obj_set_style_radius(btn_upload, 3, 0);
+            lv_obj_add_event_cb(btn_upload, upload_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+            
+            lv_obj_t *lbl_upload = lv_label_create(btn_upload);
+            lv_label_set_text(lbl_upload, LV_SYMBOL_UPLOAD " Upload");
+            lv_obj_set_style_text_font(lbl_upload, &lv_font_montserrat_18, 0);
+            lv_obj_center(lbl_upload);
+            
+            // Run button - streams the file without uploading it
+            lv_obj_t *btn_stream = lv_button_create(file_row);
+            lv_obj_set_size(btn_stream, 70, 38);
+            lv_obj_align(btn_stream, LV_ALIGN_RIGHT_MID, -130, 0);
+            lv_obj_set_style_bg_color(btn_stream, UITheme::BTN_PLAY, 0);
+            lv_obj_set_style_radius(btn_stream, 3, 0);
+            lv_obj_add_event_cb(btn_stream, stream_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+            
+            lv_obj_t *lbl_stream = lv_label_create(btn_stream);
+            lv_label_set_text(lbl_stream, LV_SYMBOL_PLAY);
+            lv_obj_set_style_text_font(lbl_stream, &lv_font_montserrat_18, 0);
+            lv_obj_center(lbl_stream);
+        } else {
+            // Delete button (for FluidNC files)
+            lv_obj_t *btn_delete = lv_button_create(file_row);
+            lv_obj_set_size(btn_delete, 70, 38);
+            lv_obj_align(btn_delete, LV_ALIGN_RIGHT_MID, -80, 0);
+            lv_obj_set_style_bg_color(btn_delete, UITheme::BTN_ESTOP, 0);
+            lv_obj_set_style_radius(btn_delete, 3, 0);
+            lv_obj_add_event_cb(btn_delete, delete_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+            
+            lv_obj_t *lbl_delete = lv_label_create(btn_delete);
+            lv_label_set_text(lbl_delete, LV_SYMBOL_TRASH);
+            lv_obj_set_style_text_font(lbl_delete, &lv_font_montserrat_18, 0);
+            lv_obj_center(lbl_delete);
+            
+            // Play button (for FluidNC files)
+            lv_obj_t *btn_play = lv_button_create(file_row);
+            lv_obj_set_size(btn_play, 70, 38);
+            lv_obj_align(btn_play, LV_ALIGN_RIGHT_MID, -5, 0);
+            lv_obj_set_style_bg_color(btn_play, UITheme::BTN_PLAY, 0);
+            lv_obj_set_style_radius(btn_play, 3, 0);
+            lv_obj_add_event_cb(btn_play, play_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
+            
+            lv_obj_t *lbl_play = lv_label_create(btn_play);
+            lv_label_set_text(lbl_play, LV_SYMBOL_PLAY);
+            lv_obj_set_style_text_font(lbl_play, &lv_font_montserrat_18, 0);
+            lv_obj_center(lbl_play);
+        }
+    }  // End of if (!file.is_directory)
+}
+
 void UITabFiles::updateFileListUI() {
     if (!file_list_container) return;
     
@@ -818,7 +1051,9 @@ void UITabFiles::updateFileListUI() {
     StorageCache* cache = getCurrentCache();
     
     // Clear existing file buttons
+    row_count = 0;
     lv_obj_clean(file_list_container);
+    GCodeCache::clearBackground();
     
     if (cache->file_list.empty()) {
         lv_obj_t *empty_label = lv_label_create(file_list_container);
@@ -833,120 +1068,13 @@ void UITabFiles::updateFileListUI() {
         return;
     }
     
-    // Static storage for filenames/paths (persistent across callbacks)
-    static char filenames_storage[100][256];
     size_t max_files = std::min(cache->file_list.size(), (size_t)100);
     
     // Create file/directory entries
     for (size_t i = 0; i < max_files; i++) {
-        const FileInfo &file = cache->file_list[i];
-        
-        // Build full path for the entry
-        std::string full_path = current_path;
-        if (full_path[full_path.length() - 1] != '/') {
-            full_path += "/";
-        }
-        full_path += file.name;
-        // Note: Don't add trailing slash for directories - FluidNC doesn't like it
-        
-        // Store full path in persistent storage
-        strncpy(filenames_storage[i], full_path.c_str(), 255);
-        filenames_storage[i][255] = '\0';
-        
-        // File/directory row container
-        lv_obj_t *file_row = lv_obj_create(file_list_container);
-        lv_obj_set_size(file_row, 750, 46);
-        lv_obj_set_style_bg_color(file_row, file.is_directory ? UITheme::BG_BUTTON : UITheme::BG_DARKER, 0);
-        lv_obj_set_style_border_width(file_row, 1, 0);
-        lv_obj_set_style_border_color(file_row, UITheme::BORDER_MEDIUM, 0);
-        lv_obj_set_style_pad_all(file_row, 5, 0);
-        lv_obj_set_style_radius(file_row, 3, 0);
-        lv_obj_clear_flag(file_row, LV_OBJ_FLAG_SCROLLABLE);
-        
-        if (file.is_directory) {
-            // Make directory row clickable
-            lv_obj_add_flag(file_row, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_add_event_cb(file_row, directory_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
-        } else {
-            lv_obj_clear_flag(file_row, LV_OBJ_FLAG_CLICKABLE);
-        }
-        
-        // Icon + Filename label (left side)
-        lv_obj_t *lbl_filename = lv_label_create(file_row);
-        if (file.is_directory) {
-            char label_text[256];
-            snprintf(label_text, sizeof(label_text), LV_SYMBOL_DIRECTORY " %s", file.name.c_str());
-            lv_label_set_text(lbl_filename, label_text);
-            lv_obj_set_style_text_color(lbl_filename, UITheme::ACCENT_SECONDARY, 0);
-        } else {
-            lv_label_set_text(lbl_filename, file.name.c_str());
-            lv_obj_set_style_text_color(lbl_filename, lv_color_white(), 0);
-        }
-        lv_obj_set_style_text_font(lbl_filename, &lv_font_montserrat_20, 0);
-        lv_obj_align(lbl_filename, LV_ALIGN_LEFT_MID, 5, 0);
-        lv_label_set_long_mode(lbl_filename, LV_LABEL_LONG_DOT);
-        lv_obj_set_width(lbl_filename, file.is_directory ? 720 : 400);
-        
-        // Only show size and buttons for files, not directories
-        if (!file.is_directory) {
-            // File size label (center)
-            lv_obj_t *lbl_size = lv_label_create(file_row);
-            char size_str[32];
-            if (file.size >= 1024 * 1024) {
-                snprintf(size_str, sizeof(size_str), "%.2f MB", file.size / (1024.0f * 1024.0f));
-            } else if (file.size >= 1024) {
-                snprintf(size_str, sizeof(size_str), "%.1f KB", file.size / 1024.0f);
-            } else {
-                snprintf(size_str, sizeof(size_str), "%d B", file.size);
-            }
-            lv_label_set_text(lbl_size, size_str);
-            lv_obj_set_style_text_font(lbl_size, &lv_font_montserrat_20, 0);
-            lv_obj_set_style_text_color(lbl_size, UITheme::TEXT_MEDIUM, 0);
-            lv_obj_align(lbl_size, LV_ALIGN_LEFT_MID, 420, 0);
-            
-            // Show upload button for Display SD, or play/delete for FluidNC storage
-            if (current_storage == StorageSource::DISPLAY_SD) {
-                // Upload button (for Display SD files)
-                lv_obj_t *btn_upload = lv_button_create(file_row);
-                lv_obj_set_size(btn_upload, 120, 38);
-                lv_obj_align(btn_upload, LV_ALIGN_RIGHT_MID, -5, 0);
-                lv_obj_set_style_bg_color(btn_upload, UITheme::ACCENT_PRIMARY, 0);
-                lv_obj_set_style_radius(btn_upload, 3, 0);
-                lv_obj_add_event_cb(btn_upload, upload_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
-                
-                lv_obj_t *lbl_upload = lv_label_create(btn_upload);
-                lv_label_set_text(lbl_upload, LV_SYMBOL_UPLOAD " Upload");
-                lv_obj_set_style_text_font(lbl_upload, &lv_font_montserrat_18, 0);
-                lv_obj_center(lbl_upload);
-            } else {
-                // Delete button (for FluidNC files)
-                lv_obj_t *btn_delete = lv_button_create(file_row);
-                lv_obj_set_size(btn_delete, 70, 38);
-                lv_obj_align(btn_delete, LV_ALIGN_RIGHT_MID, -80, 0);
-                lv_obj_set_style_bg_color(btn_delete, UITheme::BTN_ESTOP, 0);
-                lv_obj_set_style_radius(btn_delete, 3, 0);
-                lv_obj_add_event_cb(btn_delete, delete_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
-                
-                lv_obj_t *lbl_delete = lv_label_create(btn_delete);
-                lv_label_set_text(lbl_delete, LV_SYMBOL_TRASH);
-                lv_obj_set_style_text_font(lbl_delete, &lv_font_montserrat_18, 0);
-                lv_obj_center(lbl_delete);
-                
-                // Play button (for FluidNC files)
-                lv_obj_t *btn_play = lv_button_create(file_row);
-                lv_obj_set_size(btn_play, 70, 38);
-                lv_obj_align(btn_play, LV_ALIGN_RIGHT_MID, -5, 0);
-                lv_obj_set_style_bg_color(btn_play, UITheme::BTN_PLAY, 0);
-                lv_obj_set_style_radius(btn_play, 3, 0);
-                lv_obj_add_event_cb(btn_play, play_button_event_cb, LV_EVENT_CLICKED, filenames_storage[i]);
-                
-                lv_obj_t *lbl_play = lv_label_create(btn_play);
-                lv_label_set_text(lbl_play, LV_SYMBOL_PLAY);
-                lv_obj_set_style_text_font(lbl_play, &lv_font_montserrat_18, 0);
-                lv_obj_center(lbl_play);
-            }
-        }  // End of if (!file.is_directory)
-    }  // End of for loop
+        createFileRow(i, cache->file_list[i]);
+    }
+    row_count = max_files;
     
     if (status_label) {
         char buf[64];
@@ -968,9 +1096,24 @@ void UITabFiles::updateFileListUI() {
     }
 }
 
+// Fill in estimates for rows analyzed (or re-analyzed after a change) since the list was built
+void UITabFiles::updateEstimates() {
+    bool display_sd = (current_storage == StorageSource::DISPLAY_SD);
+    for (size_t i = 0; i < row_count; i++) {
+        if (!row_estimate_labels[i]) continue;
+        const GCodeCacheEntry *entry = GCodeCache::lookup(filenames_storage[i], display_sd, row_sizes[i]);
+        if (entry) {
+            char est[24];
+            formatEstimate(est, sizeof(est), entry->analysis.est_time_sec);
+            lv_label_set_text(row_estimate_labels[i], est);
+        }
+    }
+}
+
 // List files from Display SD card
 void UITabFiles::listDisplaySDFiles(const std::string &path) {
     Serial.printf("[Files] Listing Display SD: %s\n", path.c_str());
+    cancelScan();
     
     // Check if SD card is available
     if (!isDisplaySDAvailable()) {
@@ -995,10 +1138,11 @@ void UITabFiles::listDisplaySDFiles(const std::string &path) {
     current_path = path;
     
     // Get Display SD cache
+    display_sd_cache.is_cached = false;
     display_sd_cache.file_list.clear();
     
-    File root = SD.open(path.c_str());
-    if (!root || !root.isDirectory()) {
+    File root = SDCard::openDir(path.c_str());
+    if (!root) {
         Serial.println("[Files] Failed to open Display SD directory (card may have been removed)");
         display_sd_cache.is_cached = false;
         display_sd_cache.file_list.clear();
@@ -1016,8 +1160,37 @@ void UITabFiles::listDisplaySDFiles(const std::string &path) {
         return;
     }
     
-    File file = root.openNextFile();
-    while (file) {
+    // Entries are read a few at a time by scanLoop() so large folders don't block touch input;
+    // rows appear as they are found and are sorted once the scan completes
+    scan_root = root;
+    scan_start_ms = millis();
+    row_count = 0;
+    if (file_list_container) {
+        lv_obj_clean(file_list_container);
+    }
+    GCodeCache::clearBackground();
+    
+    if (path_label) {
+        lv_label_set_text(path_label, current_path.c_str());
+    }
+    if (status_label) {
+        lv_label_set_text(status_label, "Scanning...");
+        lv_obj_set_style_text_color(status_label, UITheme::UI_INFO, 0);
+    }
+}
+
+// Continue the Display SD scan for one time slice (called from main loop)
+void UITabFiles::scanLoop() {
+    if (!scan_root) return;
+    
+    uint32_t slice_start = millis();
+    while (millis() - slice_start < DIR_SCAN_SLICE_MS) {
+        File file = scan_root.openNextFile();
+        if (!file) {
+            finishScan();
+            return;
+        }
+        
         FileInfo info;
         info.name = file.name();
         
@@ -1029,24 +1202,39 @@ void UITabFiles::listDisplaySDFiles(const std::string &path) {
         
         // Skip "System Volume Information" folder
         if (info.name == "System Volume Information") {
-            file = root.openNextFile();
             continue;
         }
         
         info.is_directory = file.isDirectory();
         info.size = info.is_directory ? -1 : file.size();
-        
         display_sd_cache.file_list.push_back(info);
-        file = root.openNextFile();
+        
+        // Show the first rows right away (in directory order)
+        if (file_list_container && row_count < 100) {
+            createFileRow(row_count, info);
+            row_count++;
+        }
     }
     
-    root.close();
+    if (status_label) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Scanning... %u items", (unsigned)display_sd_cache.file_list.size());
+        lv_label_set_text(status_label, buf);
+    }
+}
+
+// Stop a running Display SD scan (navigation or storage change)
+void UITabFiles::cancelScan() {
+    if (!scan_root) return;
+    scan_root.close();
+    Serial.printf("[Files] Display SD scan cancelled after %d items\n", display_sd_cache.file_list.size());
+}
+
+void UITabFiles::finishScan() {
+    scan_root.close();
     
     // Sort files (folders on top if preference is set)
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, true);
-    bool folders_on_top = prefs.getBool("folders_on_top", false);
-    prefs.end();
+    bool folders_on_top = SystemPrefs::getBool(SysPref::FOLDERS_ON_TOP);
     
     if (folders_on_top) {
         std::sort(display_sd_cache.file_list.begin(), display_sd_cache.file_list.end(),
@@ -1063,18 +1251,14 @@ void UITabFiles::listDisplaySDFiles(const std::string &path) {
                  });
     }
     
-    Serial.printf("[Files] Found %d items on Display SD\n", display_sd_cache.file_list.size());
+    Serial.printf("[Files] Found %d items on Display SD in %lu ms\n", display_sd_cache.file_list.size(),
+                  millis() - scan_start_ms);
     
     // Mark cache as valid after successful list
     display_sd_cache.cached_path = current_path;
     display_sd_cache.is_cached = true;
     
-    // Update path label
-    if (path_label) {
-        lv_label_set_text(path_label, current_path.c_str());
-    }
-    
-    // Update UI
+    // Update UI (sorted)
     updateFileListUI();
 }
 
@@ -1126,8 +1310,8 @@ void UITabFiles::upload_button_event_cb(lv_event_t *e) {
     const char* filename = (lastSlash != std::string::npos) ? fullPath + lastSlash + 1 : fullPath;
     
     // Get file size
-    File file = SD.open(fullPath);
-    if (!file) {
+    SDReader file;
+    if (!file.open(fullPath)) {
         Serial.printf("[Files] Failed to open file: %s\n", fullPath);
         return;
     }
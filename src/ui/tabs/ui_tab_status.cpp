@@ -72,15 +72,8 @@ float UITabStatus::last_rapid_override = -1.0f;
 float UITabStatus::last_spindle_speed = -1.0f;
 float UITabStatus::last_spindle_override = -1.0f;
 char UITabStatus::last_state[16] = "";
-char UITabStatus::last_modal_wcs[8] = "";
-char UITabStatus::last_modal_plane[8] = "";
-char UITabStatus::last_modal_dist[8] = "";
-char UITabStatus::last_modal_units[8] = "";
-char UITabStatus::last_modal_motion[8] = "";
-char UITabStatus::last_modal_feedrate[8] = "";
-char UITabStatus::last_modal_spindle[8] = "";
-char UITabStatus::last_modal_coolant[8] = "";
-char UITabStatus::last_modal_tool[8] = "";
+GCodeModal UITabStatus::last_modal;
+bool UITabStatus::modal_shown = false;
 
 // WCS popup static members
 lv_obj_t *UITabStatus::wcs_popup = nullptr;
@@ -90,9 +83,12 @@ lv_obj_t *UITabStatus::wcs_btn_cancel = nullptr;
 lv_obj_t *UITabStatus::wcs_buttons[6] = {nullptr};  // Store button references
 int UITabStatus::selected_wcs_index = -1;  // -1 = none selected
 int UITabStatus::current_wcs_index = -1;  // -1 = none is current
-char UITabStatus::wcs_offsets[10][64] = {{0}};  // G54-G59, G28, G30, G92, TLO
+lv_obj_t *UITabStatus::wcs_coord_labels[6] = {nullptr};
+uint32_t UITabStatus::wcs_shown_revision = 0;
 
 void UITabStatus::create(lv_obj_t *tab) {
+    modal_shown = false;  // New labels start at "---"
+    
     // Set 5px margins by using padding
     lv_obj_set_style_pad_all(tab, 10, 0);
     
@@ -884,66 +880,67 @@ void UITabStatus::updateSpindle(float speed, float override_pct) {
     }
 }
 
-void UITabStatus::updateModalStates(const char *wcs, const char *plane, const char *dist, 
-                                    const char *units, const char *motion, const char *feedrate,
-                                    const char *spindle, const char *coolant, const char *tool) {
-    if (lbl_modal_wcs_value && strcmp(wcs, last_modal_wcs) != 0) {
-        lv_label_set_text(lbl_modal_wcs_value, wcs);
-        strncpy(last_modal_wcs, wcs, sizeof(last_modal_wcs) - 1);
-        last_modal_wcs[sizeof(last_modal_wcs) - 1] = '\0';
+void UITabStatus::updateModalStates(const GCodeModal &modal) {
+    // Integer compares per group - labels are only formatted when a group changed
+    bool all = !modal_shown;
+    
+    if (lbl_modal_wcs_value && (all || modal.wcs != last_modal.wcs)) {
+        lv_label_set_text(lbl_modal_wcs_value, modal.wcsName());
     }
     
-    if (lbl_modal_plane && strcmp(plane, last_modal_plane) != 0) {
-        lv_label_set_text(lbl_modal_plane, plane);
-        strncpy(last_modal_plane, plane, sizeof(last_modal_plane) - 1);
-        last_modal_plane[sizeof(last_modal_plane) - 1] = '\0';
+    if (lbl_modal_plane && (all || modal.plane != last_modal.plane)) {
+        lv_label_set_text(lbl_modal_plane, modal.planeName());
     }
     
-    if (lbl_modal_dist && strcmp(dist, last_modal_dist) != 0) {
-        lv_label_set_text(lbl_modal_dist, dist);
-        strncpy(last_modal_dist, dist, sizeof(last_modal_dist) - 1);
-        last_modal_dist[sizeof(last_modal_dist) - 1] = '\0';
+    if (lbl_modal_dist && (all || modal.distance != last_modal.distance)) {
+        lv_label_set_text(lbl_modal_dist, modal.distanceName());
     }
     
-    if (lbl_modal_units && strcmp(units, last_modal_units) != 0) {
-        lv_label_set_text(lbl_modal_units, units);
-        strncpy(last_modal_units, units, sizeof(last_modal_units) - 1);
-        last_modal_units[sizeof(last_modal_units) - 1] = '\0';
+    if (lbl_modal_units && (all || modal.units != last_modal.units)) {
+        lv_label_set_text(lbl_modal_units, modal.unitsName());
     }
     
-    if (lbl_modal_motion && strcmp(motion, last_modal_motion) != 0) {
-        lv_label_set_text(lbl_modal_motion, motion);
-        strncpy(last_modal_motion, motion, sizeof(last_modal_motion) - 1);
-        last_modal_motion[sizeof(last_modal_motion) - 1] = '\0';
+    if (lbl_modal_motion && (all || modal.motion != last_modal.motion)) {
+        lv_label_set_text(lbl_modal_motion, modal.motionName());
     }
     
-    if (lbl_modal_feedrate && strcmp(feedrate, last_modal_feedrate) != 0) {
-        lv_label_set_text(lbl_modal_feedrate, feedrate);
-        strncpy(last_modal_feedrate, feedrate, sizeof(last_modal_feedrate) - 1);
-        last_modal_feedrate[sizeof(last_modal_feedrate) - 1] = '\0';
+    if (lbl_modal_feedrate && (all || modal.feed_mode != last_modal.feed_mode)) {
+        lv_label_set_text(lbl_modal_feedrate, modal.feedModeName());
     }
     
-    if (lbl_modal_spindle && strcmp(spindle, last_modal_spindle) != 0) {
-        lv_label_set_text(lbl_modal_spindle, spindle);
-        strncpy(last_modal_spindle, spindle, sizeof(last_modal_spindle) - 1);
-        last_modal_spindle[sizeof(last_modal_spindle) - 1] = '\0';
+    if (lbl_modal_spindle && (all || modal.spindle != last_modal.spindle)) {
+        lv_label_set_text(lbl_modal_spindle, modal.spindleName());
     }
     
-    if (lbl_modal_coolant && strcmp(coolant, last_modal_coolant) != 0) {
-        bool bothActive = (strcmp(coolant, "M7 M8") == 0);
-        lv_label_set_text(lbl_modal_coolant, coolant);
+    if (lbl_modal_coolant && (all || modal.coolant != last_modal.coolant)) {
+        bool bothActive = (modal.coolant == (COOLANT_MIST | COOLANT_FLOOD));
+        lv_label_set_text(lbl_modal_coolant, modal.coolantName());
         // Use smaller font and slight y offset when both M7 and M8 are active
         lv_obj_set_style_text_font(lbl_modal_coolant,
             bothActive ? &lv_font_montserrat_16 : &lv_font_montserrat_20, 0);
         lv_obj_set_y(lbl_modal_coolant, coolant_base_y + (bothActive ? 2 : 0));
-        strncpy(last_modal_coolant, coolant, sizeof(last_modal_coolant) - 1);
-        last_modal_coolant[sizeof(last_modal_coolant) - 1] = '\0';
     }
     
-    if (lbl_modal_tool && strcmp(tool, last_modal_tool) != 0) {
-        lv_label_set_text(lbl_modal_tool, tool);
-        strncpy(last_modal_tool, tool, sizeof(last_modal_tool) - 1);
-        last_modal_tool[sizeof(last_modal_tool) - 1] = '\0';
+    if (lbl_modal_tool && (all || modal.tool != last_modal.tool)) {
+        lv_label_set_text_fmt(lbl_modal_tool, "T%u", (unsigned)modal.tool);
+    }
+    
+    last_modal = modal;
+    modal_shown = true;
+}
+
+void UITabStatus::clearModalStates() {
+    if (!modal_shown) return;
+    modal_shown = false;
+    
+    lv_obj_t *labels[] = {lbl_modal_wcs_value, lbl_modal_plane, lbl_modal_dist, lbl_modal_units, lbl_modal_motion,
+                          lbl_modal_feedrate, lbl_modal_spindle, lbl_modal_coolant, lbl_modal_tool};
+    for (lv_obj_t *label : labels) {
+        if (label) lv_label_set_text(label, "---");
+    }
+    if (lbl_modal_coolant) {
+        lv_obj_set_style_text_font(lbl_modal_coolant, &lv_font_montserrat_20, 0);
+        lv_obj_set_y(lbl_modal_coolant, coolant_base_y);
     }
 }
 
@@ -1333,55 +1330,46 @@ void UITabStatus::keyboard_event_handler(lv_event_t *e) {
 
 // WCS Button Click Handler
 void UITabStatus::onWCSButtonClicked(lv_event_t *e) {
-    Serial.println("WCS button clicked, requesting coordinate offsets");
-    
-    // Set callback to capture the $# response
-    FluidNCClient::setMessageCallback([](const char* message) {
-        parseWCSOffsetsResponse(message);
-    });
-    
-    // Request coordinate offsets from FluidNC
-    // Popup will be shown automatically when G59 is parsed
-    FluidNCClient::sendCommand("$#\n");
+    // Open from the cached offsets and check them again in the background
+    Serial.println("WCS button clicked, showing cached offsets and refreshing");
+    FluidNCClient::requestWCSRefresh();
+    showWCSPopup();
 }
 
-// Parse WCS offsets response from $# command
-void UITabStatus::parseWCSOffsetsResponse(const char* response) {
-    // FluidNC sends each coordinate system as a separate message
-    // Example: [G54:90.000,0.000,0.000]
-    
-    // Map of WCS names to array indices
-    const char* wcs_names[] = {"G54", "G55", "G56", "G57", "G58", "G59", "G28", "G30", "G92", "TLO"};
+// Offsets line of a WCS button, from FluidNCClient's table
+void UITabStatus::setWCSCoordText(int index) {
+    lv_obj_t *label = wcs_coord_labels[index];
+    if (!label) return;
     
-    // Check if this message contains a WCS offset
-    if (response[0] != '[') return;
-    
-    // Find which WCS this is
-    for (int i = 0; i < 10; i++) {
-        char search[8];
-        snprintf(search, sizeof(search), "[%s:", wcs_names[i]);
-        
-        if (strncmp(response, search, strlen(search)) == 0) {
-            // Found matching WCS - extract coordinates
-            const char* start = response + strlen(search);
-            const char* end = strchr(start, ']');
-            
-            if (end) {
-                int len = end - start;
-                if (len < 64) {
-                    strncpy(wcs_offsets[i], start, len);
-                    wcs_offsets[i][len] = '\0';
-                    Serial.printf("Parsed %s: %s\n", wcs_names[i], wcs_offsets[i]);
-                    
-                    // Show popup after parsing G59 (last coordinate system we display)
-                    if (i == 5) {  // G59 is at index 5
-                        Serial.println("G59 parsed, showing WCS popup");
-                        showWCSPopup();
-                    }
-                }
-            }
-            break;
-        }
+    const WCSTable &table = FluidNCClient::getWCSTable();
+    if (!table.has(index)) {
+        lv_label_set_text(label, "Reading offsets...");
+        return;
+    }
+    const float *offset = table.offsets[index];
+    
+    // Format with axis color codes (LVGL recolor feature)
+    // Extract RGB components from theme colors (convert from RGB565 to RGB888)
+    uint32_t x_color = lv_color_to_u32(UITheme::AXIS_X);
+    uint32_t y_color = lv_color_to_u32(UITheme::AXIS_Y);
+    uint32_t z_color = lv_color_to_u32(UITheme::AXIS_Z);
+    
+    char text[120];
+    snprintf(text, sizeof(text), 
+             "#%06X X: %.3f#  #%06X Y: %.3f#  #%06X Z: %.3f#",
+             x_color & 0xFFFFFF, offset[0],
+             y_color & 0xFFFFFF, offset[1],
+             z_color & 0xFFFFFF, offset[2]);
+    lv_label_set_text(label, text);
+}
+
+void UITabStatus::updateWCSPopup() {
+    if (!wcs_popup) return;
+    uint32_t revision = FluidNCClient::getWCSTable().revision;
+    if (revision == wcs_shown_revision) return;
+    wcs_shown_revision = revision;
+    for (int i = 0; i < 6; i++) {
+        setWCSCoordText(i);
     }
 }
 
@@ -1448,7 +1436,7 @@ void UITabStatus::showWCSPopup() {
         lv_obj_set_style_border_color(btn, UITheme::BG_BUTTON, LV_PART_MAIN);  // Match background
         
         // Check if this is the current WCS
-        bool is_current = (strcmp(wcs_names[i], lv_label_get_text(lbl_modal_wcs_value)) == 0);
+        bool is_current = modal_shown && last_modal.wcs == i;
         if (is_current) {
             current_wcs_index = i;  // Store which button is current
             lv_obj_set_style_border_color(btn, UITheme::ACCENT_SECONDARY, LV_PART_MAIN);
@@ -1483,29 +1471,11 @@ void UITabStatus::showWCSPopup() {
         
         // Coordinates label with axis colors (axis labels AND values colored)
         lv_obj_t *lbl_coords = lv_label_create(btn);
-        char text[120];
-        char* coords = wcs_offsets[i];
-        
-        // Parse the three coordinate values
-        float x_val = 0, y_val = 0, z_val = 0;
-        sscanf(coords, "%f,%f,%f", &x_val, &y_val, &z_val);
-        
-        // Format with axis color codes (LVGL recolor feature)
-        // Extract RGB components from theme colors (convert from RGB565 to RGB888)
-        uint32_t x_color = lv_color_to_u32(UITheme::AXIS_X);
-        uint32_t y_color = lv_color_to_u32(UITheme::AXIS_Y);
-        uint32_t z_color = lv_color_to_u32(UITheme::AXIS_Z);
-        
-        snprintf(text, sizeof(text), 
-                 "#%06X X: %.3f#  #%06X Y: %.3f#  #%06X Z: %.3f#",
-                 x_color & 0xFFFFFF, x_val,
-                 y_color & 0xFFFFFF, y_val,
-                 z_color & 0xFFFFFF, z_val);
-        
-        lv_label_set_text(lbl_coords, text);
         lv_obj_set_style_text_font(lbl_coords, &lv_font_montserrat_16, 0);
         lv_label_set_recolor(lbl_coords, true);
         lv_obj_align(lbl_coords, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+        wcs_coord_labels[i] = lbl_coords;
+        setWCSCoordText(i);
         
         // Store button reference for highlighting
         wcs_buttons[i] = btn;
@@ -1544,6 +1514,7 @@ void UITabStatus::showWCSPopup() {
     
     // Initialize selection state
     selected_wcs_index = -1;
+    wcs_shown_revision = FluidNCClient::getWCSTable().revision;
 }
 
 // Hide WCS Popup
@@ -1556,13 +1527,11 @@ void UITabStatus::hideWCSPopup() {
         wcs_btn_cancel = nullptr;
         for (int i = 0; i < 6; i++) {
             wcs_buttons[i] = nullptr;
+            wcs_coord_labels[i] = nullptr;
         }
         selected_wcs_index = -1;
         current_wcs_index = -1;
     }
-    
-    // Clear message callback
-    FluidNCClient::clearMessageCallback();
 }
 
 // WCS Selected Handler (highlights selection, doesn't execute)
@@ -3,14 +3,30 @@
 #include "network/fluidnc_client.h"
 #include "config.h"
 #include "ui/fonts/jetbrains_mono_16.h"
+#include "ui/terminal_log.h"
+#include <esp_heap_caps.h>
 
 // Static member initialization
-lv_obj_t *UITabTerminal::terminal_text = nullptr;
 lv_obj_t *UITabTerminal::terminal_cont = nullptr;
 lv_obj_t *UITabTerminal::input_field = nullptr;
 lv_obj_t *UITabTerminal::keyboard = nullptr;
 lv_obj_t *UITabTerminal::auto_scroll_switch = nullptr;
-String UITabTerminal::terminal_buffer = "";
+lv_obj_t *UITabTerminal::search_popup = nullptr;
+lv_obj_t *UITabTerminal::search_result_label = nullptr;
+lv_obj_t *UITabTerminal::search_log_switch = nullptr;
+char *UITabTerminal::line_ring = nullptr;
+uint16_t UITabTerminal::ring_capacity = 0;
+uint16_t UITabTerminal::ring_count = 0;
+uint32_t UITabTerminal::total_lines = 0;
+uint32_t UITabTerminal::dropped_pending = 0;
+uint8_t UITabTerminal::line_cols = 80;
+int32_t UITabTerminal::row_height = 18;
+lv_obj_t *UITabTerminal::spacer = nullptr;
+lv_obj_t *UITabTerminal::row_labels[UITabTerminal::VIEW_ROWS] = {nullptr};
+uint32_t UITabTerminal::row_seq[UITabTerminal::VIEW_ROWS] = {0};
+const char *UITabTerminal::search_token = nullptr;
+uint32_t UITabTerminal::search_before_seq = 0;
+bool UITabTerminal::search_using_log = false;
 bool UITabTerminal::auto_scroll_enabled = true;
 bool UITabTerminal::buffer_dirty = false;
 uint32_t UITabTerminal::last_update_ms = 0;
@@ -32,12 +48,12 @@ void UITabTerminal::create(lv_obj_t *tab) {
     // Tab content height = SCREEN_HEIGHT (480) - STATUS_BAR_HEIGHT (60) - TAB_BUTTON_HEIGHT (50) = 370px
     const int content_height = SCREEN_HEIGHT - STATUS_BAR_HEIGHT - TAB_BUTTON_HEIGHT;
     const int input_height = 45;
-    const int btn_small_w = 45;   // Clear / Up / Down buttons
+    const int btn_small_w = 45;   // Clear / Up / Down / Search buttons
     const int btn_send_w = 80;    // Send button
     const int gap = 5;
     // Effective content width: 800 - 2*15 padding = 770px
-    // Right 120px reserved for auto-scroll; buttons: 3*45 + 80 + 4*5 = 235px; input: 415px
-    const int input_width = 770 - 120 - (3 * btn_small_w) - btn_send_w - (4 * gap);
+    // Right 120px reserved for auto-scroll; buttons: 4*45 + 80 + 5*5 = 285px; input: 365px
+    const int input_width = 770 - 120 - (4 * btn_small_w) - btn_send_w - (5 * gap);
     const int terminal_height = content_height - input_height - (gap * 3);
 
     // Input text area
@@ -86,6 +102,17 @@ void UITabTerminal::create(lv_obj_t *tab) {
     lv_obj_center(down_lbl);
     bx += btn_small_w + gap;
 
+    // Search history button (ALARM / error / MSG)
+    lv_obj_t *search_btn = lv_button_create(tab);
+    lv_obj_set_size(search_btn, btn_small_w, input_height);
+    lv_obj_set_pos(search_btn, bx, 0);
+    lv_obj_set_style_bg_color(search_btn, UITheme::BG_BUTTON, LV_PART_MAIN);
+    lv_obj_add_event_cb(search_btn, search_btn_event_cb, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *search_lbl = lv_label_create(search_btn);
+    lv_label_set_text(search_lbl, LV_SYMBOL_LIST);
+    lv_obj_center(search_lbl);
+    bx += btn_small_w + gap;
+
     // Send button
     lv_obj_t *send_btn = lv_button_create(tab);
     lv_obj_set_size(send_btn, btn_send_w, input_height);
@@ -121,15 +148,54 @@ void UITabTerminal::create(lv_obj_t *tab) {
     // Enable scrolling for terminal output
     lv_obj_set_scroll_dir(terminal_cont, LV_DIR_VER);
 
-    terminal_text = lv_label_create(terminal_cont);
-    lv_label_set_text(terminal_text, "");
-    lv_obj_set_style_text_font(terminal_text, &jetbrains_mono_16, 0);
-    lv_obj_set_style_text_color(terminal_text, UITheme::UI_SUCCESS, 0);
-    lv_label_set_long_mode(terminal_text, LV_LABEL_LONG_WRAP);
-    lv_obj_set_width(terminal_text, 760);
+    lv_obj_add_event_cb(terminal_cont, terminal_scroll_event_cb, LV_EVENT_SCROLL, nullptr);
+
+    // Monospace font - one ring slot per display row, hard-wrapped at the row width
+    row_height = lv_font_get_line_height(&jetbrains_mono_16);
+    int32_t char_w = lv_font_get_glyph_width(&jetbrains_mono_16, 'M', 0);
+    int cols = (char_w > 0) ? (756 / char_w) : 80;
+    line_cols = (uint8_t)((cols < (int)LINE_SLOT - 2) ? cols : LINE_SLOT - 2);
+
+    // Invisible spacer gives the container its full scroll height without one object per line
+    spacer = lv_obj_create(terminal_cont);
+    lv_obj_remove_style_all(spacer);
+    lv_obj_clear_flag(spacer, (lv_obj_flag_t)(LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE));
+    lv_obj_set_size(spacer, 1, 0);
+    lv_obj_set_pos(spacer, 0, 0);
+
+    // Fixed pool of row labels, repositioned over whatever part of the ring is visible
+    for (int i = 0; i < VIEW_ROWS; i++) {
+        row_labels[i] = lv_label_create(terminal_cont);
+        lv_label_set_text(row_labels[i], "");
+        lv_obj_set_style_text_font(row_labels[i], &jetbrains_mono_16, 0);
+        lv_obj_set_style_text_color(row_labels[i], UITheme::UI_SUCCESS, 0);
+        lv_label_set_long_mode(row_labels[i], LV_LABEL_LONG_CLIP);
+        lv_obj_set_size(row_labels[i], 756, row_height);
+        lv_obj_add_flag(row_labels[i], LV_OBJ_FLAG_HIDDEN);
+        row_seq[i] = UINT32_MAX;
+    }
 
-    // Initialize buffer (empty)
-    terminal_buffer = "";
+    allocRing();
+
+    // Optional SD log of everything shown here
+    TerminalLog::init();
+}
+
+void UITabTerminal::allocRing() {
+    if (line_ring) return;
+
+    line_ring = (char*)heap_caps_malloc((size_t)MAX_LINES * LINE_SLOT, MALLOC_CAP_SPIRAM);
+    ring_capacity = MAX_LINES;
+    if (!line_ring) {
+        // No PSRAM - keep a small scrollback in internal RAM rather than none
+        Serial.println("[Terminal] PSRAM scrollback allocation failed, using 256-line fallback");
+        ring_capacity = 256;
+        line_ring = (char*)malloc((size_t)ring_capacity * LINE_SLOT);
+        if (!line_ring) ring_capacity = 0;
+    }
+    ring_count = 0;
+    Serial.printf("[Terminal] Scrollback ring: %u lines x %u bytes, %u columns\n",
+                  ring_capacity, (unsigned)LINE_SLOT, line_cols);
 }
 
 // Send button event handler
@@ -205,10 +271,8 @@ void UITabTerminal::send_command() {
         FluidNCClient::sendCommand((cmd_str + "\n").c_str());
 
         // Echo command to terminal
-        terminal_buffer += "> ";
-        terminal_buffer += cmd_str;
-        terminal_buffer += "\n";
-        trimBuffer();
+        String echo = "> " + cmd_str;
+        appendLine(echo.c_str(), echo.length());
 
         // Update display immediately for user commands
         updateDisplay();
@@ -276,46 +340,62 @@ void UITabTerminal::appendMessage(const char *message) {
         return;
     }
 
-    // Strip trailing whitespace/newlines from message
-    String clean_msg = String(message);
-    while (clean_msg.length() > 0 && isspace(clean_msg[clean_msg.length() - 1])) {
-        clean_msg.remove(clean_msg.length() - 1);
-    }
-
-    // Skip blank lines - check if cleaned message is empty
-    if (clean_msg.length() == 0) {
-        return;
+    // Append each non-blank line (trailing whitespace stripped) - no String copies
+    const char *p = message;
+    while (*p) {
+        const char *eol = strchr(p, '\n');
+        size_t len = eol ? (size_t)(eol - p) : strlen(p);
+        size_t trimmed = len;
+        while (trimmed > 0 && isspace((unsigned char)p[trimmed - 1])) trimmed--;
+        if (trimmed > 0) {
+            appendLine(p, trimmed);
+        }
+        if (!eol) break;
+        p = eol + 1;
     }
 
-    // Append cleaned message to buffer with exactly one newline
-    terminal_buffer += clean_msg;
-    terminal_buffer += "\n";
-
-    // Trim buffer if needed
-    trimBuffer();
-
     // Mark buffer as dirty - UI will be updated in update() method
     buffer_dirty = true;
 }
 
-void UITabTerminal::trimBuffer() {
-    // If buffer exceeds max size, remove lines from the beginning
-    if (terminal_buffer.length() > MAX_BUFFER_SIZE) {
-        // Find position to start trimming (keep last 75% of buffer)
-        size_t trim_to = MAX_BUFFER_SIZE * 3 / 4;
-
-        // Find the first newline after the trim point to avoid cutting mid-line
-        int newline_pos = terminal_buffer.indexOf('\n', terminal_buffer.length() - trim_to);
-
-        if (newline_pos > 0) {
-            terminal_buffer = terminal_buffer.substring(newline_pos + 1);
+void UITabTerminal::appendLine(const char *text, size_t len) {
+    // Batched to SD by TerminalLog::loop() when logging is enabled
+    TerminalLog::append(text, len, total_lines);
+
+    if (ring_capacity == 0) return;
+
+    // Hard-wrap into display rows; cost is proportional to the line, not the scrollback
+    size_t cols = line_cols > 0 ? line_cols : LINE_SLOT - 2;
+    bool continuation = false;
+    do {
+        size_t chunk = len < cols ? len : cols;
+        char *slot = line_ring + (size_t)(total_lines % ring_capacity) * LINE_SLOT;
+        memcpy(slot, text, chunk);
+        slot[chunk] = '\0';
+        slot[LINE_SLOT - 1] = continuation ? 1 : 0;  // Wrapped rows don't start a line
+        continuation = true;
+        total_lines++;
+        if (ring_count < ring_capacity) {
+            ring_count++;
         } else {
-            // No newline found, just trim to size
-            terminal_buffer = terminal_buffer.substring(terminal_buffer.length() - trim_to);
+            dropped_pending++;  // Oldest row overwritten
         }
+        text += chunk;
+        len -= chunk;
+    } while (len > 0);
 
-        Serial.printf("[Terminal] Buffer trimmed to %d bytes\n", terminal_buffer.length());
-    }
+    buffer_dirty = true;
+}
+
+uint32_t UITabTerminal::rowsForLength(size_t len) {
+    size_t cols = line_cols > 0 ? line_cols : LINE_SLOT - 2;
+    return len == 0 ? 1 : (uint32_t)((len + cols - 1) / cols);
+}
+
+const char* UITabTerminal::getRow(uint32_t seq) {
+    uint32_t first = total_lines - ring_count;
+    if (seq < first || seq >= total_lines) return nullptr;
+    return line_ring + (size_t)(seq % ring_capacity) * LINE_SLOT;
 }
 
 void UITabTerminal::update() {
@@ -334,17 +414,58 @@ void UITabTerminal::update() {
 }
 
 void UITabTerminal::updateDisplay() {
-    // Update display if terminal exists
-    if (terminal_text) {
-        lv_label_set_text(terminal_text, terminal_buffer.c_str());
+    if (!terminal_cont || !spacer) return;
+
+    // Grow the scroll area to the rows held (constant once the ring is full)
+    lv_obj_set_height(spacer, (int32_t)ring_count * row_height);
+
+    if (auto_scroll_enabled) {
+        lv_obj_scroll_to_y(terminal_cont, LV_COORD_MAX, LV_ANIM_OFF);
+    } else if (dropped_pending > 0) {
+        // Rows shifted up as old ones were evicted - keep the same text under the user's view
+        lv_obj_scroll_by(terminal_cont, 0, (int32_t)dropped_pending * row_height, LV_ANIM_OFF);
+    }
+    dropped_pending = 0;
+
+    refreshRows();
+}
+
+void UITabTerminal::refreshRows() {
+    if (!terminal_cont || ring_count == 0) {
+        for (int i = 0; i < VIEW_ROWS; i++) {
+            if (row_labels[i]) lv_obj_add_flag(row_labels[i], LV_OBJ_FLAG_HIDDEN);
+        }
+        return;
+    }
+
+    // Visible window starts at the row under the top of the scrolled container
+    int32_t scroll_y = lv_obj_get_scroll_y(terminal_cont);
+    int32_t top_row = scroll_y > 0 ? scroll_y / row_height : 0;
+    uint32_t first = total_lines - ring_count;
+
+    for (int i = 0; i < VIEW_ROWS; i++) {
+        int32_t row = top_row + i;
+        if (row >= (int32_t)ring_count) {
+            lv_obj_add_flag(row_labels[i], LV_OBJ_FLAG_HIDDEN);
+            row_seq[i] = UINT32_MAX;
+            continue;
+        }
 
-        // Auto-scroll to bottom only if enabled
-        if (terminal_cont && auto_scroll_enabled) {
-            lv_obj_scroll_to_y(terminal_cont, LV_COORD_MAX, LV_ANIM_OFF);
+        // Reposition every time (eviction shifts rows); only re-render text when the row changes
+        uint32_t seq = first + row;
+        lv_obj_set_pos(row_labels[i], 0, row * row_height);
+        if (row_seq[i] != seq) {
+            lv_label_set_text(row_labels[i], getRow(seq));
+            row_seq[i] = seq;
         }
+        lv_obj_clear_flag(row_labels[i], LV_OBJ_FLAG_HIDDEN);
     }
 }
 
+void UITabTerminal::terminal_scroll_event_cb(lv_event_t *e) {
+    refreshRows();
+}
+
 void UITabTerminal::clear_btn_event_cb(lv_event_t *e) {
     lv_textarea_set_text(input_field, "");
     hist_index = -1;
@@ -371,3 +492,180 @@ void UITabTerminal::hist_down_event_cb(lv_event_t *e) {
         lv_textarea_set_text(input_field, hist_draft.c_str());
     }
 }
+
+bool UITabTerminal::scrollToRow(uint32_t seq) {
+    if (!terminal_cont || !getRow(seq)) return false;
+
+    // Stop following new output so the row stays in view
+    auto_scroll_enabled = false;
+    if (auto_scroll_switch) lv_obj_clear_state(auto_scroll_switch, LV_STATE_CHECKED);
+
+    updateDisplay();
+    int32_t row = (int32_t)(seq - (total_lines - ring_count));
+    int32_t y = (row > 2 ? row - 2 : 0) * row_height;  // A little context above the match
+    lv_obj_scroll_to_y(terminal_cont, y, LV_ANIM_OFF);
+    refreshRows();
+    return true;
+}
+
+bool UITabTerminal::findInScrollback(TerminalLogMatch &match) {
+    size_t token_len = strlen(search_token);
+    uint32_t first = total_lines - ring_count;
+
+    while (search_before_seq > first) {
+        uint32_t seq = --search_before_seq;
+        const char *row = getRow(seq);
+        if (!row || row[LINE_SLOT - 1]) continue;  // Skip wrapped continuation rows
+        if (strncmp(row, search_token, token_len) == 0) {
+            strncpy(match.text, row, sizeof(match.text) - 1);
+            match.text[sizeof(match.text) - 1] = '\0';
+            match.seq = seq;
+            match.first_ms = 0;
+            match.this_boot = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void UITabTerminal::search_btn_event_cb(lv_event_t *e) {
+    if (search_popup) return;
+
+    // Modal backdrop
+    search_popup = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(search_popup, SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_obj_set_style_bg_color(search_popup, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(search_popup, LV_OPA_50, 0);
+    lv_obj_set_style_border_width(search_popup, 0, 0);
+    lv_obj_clear_flag(search_popup, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *dialog = lv_obj_create(search_popup);
+    lv_obj_set_size(dialog, 600, 330);
+    lv_obj_center(dialog);
+    lv_obj_set_style_bg_color(dialog, UITheme::BG_MEDIUM, 0);
+    lv_obj_set_style_border_width(dialog, 3, 0);
+    lv_obj_set_style_border_color(dialog, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_set_style_pad_all(dialog, 20, 0);
+    lv_obj_clear_flag(dialog, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *title = lv_label_create(dialog);
+    lv_label_set_text(title, "Find in Terminal History");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(title, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_set_pos(title, 0, 0);
+
+    // One button per searchable line type (token is the button's user data)
+    static const char *tokens[] = {"ALARM:", "error:", "[MSG:"};
+    static const char *labels[] = {"ALARM", "error", "MSG"};
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *btn = lv_button_create(dialog);
+        lv_obj_set_size(btn, 170, 50);
+        lv_obj_set_pos(btn, i * 190, 45);
+        lv_obj_set_style_bg_color(btn, i == 0 ? UITheme::STATE_ALARM : UITheme::BG_BUTTON, LV_PART_MAIN);
+        lv_obj_add_event_cb(btn, search_kind_event_cb, LV_EVENT_CLICKED, (void*)tokens[i]);
+        lv_obj_t *lbl = lv_label_create(btn);
+        lv_label_set_text(lbl, labels[i]);
+        lv_obj_set_style_text_font(lbl, &lv_font_montserrat_18, 0);
+        lv_obj_center(lbl);
+    }
+
+    search_result_label = lv_label_create(dialog);
+    lv_label_set_text(search_result_label, "Choose a line type to find the most recent one.");
+    lv_obj_set_style_text_font(search_result_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(search_result_label, UITheme::TEXT_LIGHT, 0);
+    lv_label_set_long_mode(search_result_label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_width(search_result_label, 550);
+    lv_obj_set_pos(search_result_label, 0, 110);
+
+    // SD log toggle
+    lv_obj_t *log_label = lv_label_create(dialog);
+    lv_label_set_text(log_label, "Log to Display SD:");
+    lv_obj_set_style_text_font(log_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(log_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(log_label, 0, 245);
+
+    search_log_switch = lv_switch_create(dialog);
+    lv_obj_set_size(search_log_switch, 50, 25);
+    lv_obj_set_pos(search_log_switch, 160, 242);
+    if (TerminalLog::isEnabled()) lv_obj_add_state(search_log_switch, LV_STATE_CHECKED);
+    lv_obj_add_event_cb(search_log_switch, search_log_event_cb, LV_EVENT_VALUE_CHANGED, nullptr);
+
+    lv_obj_t *btn_older = lv_button_create(dialog);
+    lv_obj_set_size(btn_older, 150, 50);
+    lv_obj_set_pos(btn_older, 240, 230);
+    lv_obj_set_style_bg_color(btn_older, UITheme::ACCENT_SECONDARY, LV_PART_MAIN);
+    lv_obj_add_event_cb(btn_older, search_older_event_cb, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *lbl_older = lv_label_create(btn_older);
+    lv_label_set_text(lbl_older, LV_SYMBOL_UP " Older");
+    lv_obj_set_style_text_font(lbl_older, &lv_font_montserrat_18, 0);
+    lv_obj_center(lbl_older);
+
+    lv_obj_t *btn_close = lv_button_create(dialog);
+    lv_obj_set_size(btn_close, 150, 50);
+    lv_obj_set_pos(btn_close, 405, 230);
+    lv_obj_set_style_bg_color(btn_close, UITheme::BG_BUTTON, LV_PART_MAIN);
+    lv_obj_add_event_cb(btn_close, search_close_event_cb, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *lbl_close = lv_label_create(btn_close);
+    lv_label_set_text(lbl_close, "Close");
+    lv_obj_set_style_text_font(lbl_close, &lv_font_montserrat_18, 0);
+    lv_obj_center(lbl_close);
+}
+
+void UITabTerminal::search_kind_event_cb(lv_event_t *e) {
+    search_token = (const char*)lv_event_get_user_data(e);
+
+    // Indexed SD log when enabled (covers earlier sessions), otherwise the in-memory scrollback
+    search_using_log = TerminalLog::isEnabled();
+    if (search_using_log) {
+        TerminalLog::beginSearch(search_token);
+    }
+    search_before_seq = total_lines;
+    search_older_event_cb(e);
+}
+
+void UITabTerminal::search_older_event_cb(lv_event_t *e) {
+    if (!search_token) return;
+
+    TerminalLogMatch match;
+    bool found = search_using_log ? TerminalLog::findPrevious(match) : findInScrollback(match);
+    if (!found || !search_result_label) {
+        showNoMoreMatches();
+        return;
+    }
+
+    char buf[256];
+    bool shown = match.this_boot && scrollToRow(match.seq);
+    if (!match.this_boot) {
+        snprintf(buf, sizeof(buf), "%s\n\nFrom an earlier session (Display SD log).", match.text);
+    } else if (match.first_ms > 0) {
+        uint32_t ago = (millis() - match.first_ms) / 1000;
+        snprintf(buf, sizeof(buf), "%s\n\nReceived about %lum %02lus ago%s.", match.text,
+                 (unsigned long)(ago / 60), (unsigned long)(ago % 60),
+                 shown ? " - shown in terminal" : " (no longer in scrollback)");
+    } else {
+        snprintf(buf, sizeof(buf), "%s\n\nShown in terminal.", match.text);
+    }
+    lv_label_set_text(search_result_label, buf);
+}
+
+void UITabTerminal::showNoMoreMatches() {
+    if (!search_result_label) return;
+    lv_label_set_text(search_result_label, search_using_log ? "No more matches in the Display SD log."
+                                                            : "No more matches in the scrollback.");
+}
+
+void UITabTerminal::search_log_event_cb(lv_event_t *e) {
+    lv_obj_t *sw = (lv_obj_t *)lv_event_get_target(e);
+    TerminalLog::setEnabled(lv_obj_has_state(sw, LV_STATE_CHECKED));
+    search_token = nullptr;  // Restart the search with the new source
+}
+
+void UITabTerminal::search_close_event_cb(lv_event_t *e) {
+    if (search_popup) {
+        lv_obj_del(search_popup);
+        search_popup = nullptr;
+        search_result_label = nullptr;
+        search_log_switch = nullptr;
+    }
+    search_token = nullptr;
+}
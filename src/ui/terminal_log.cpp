@@ -0,0 +1,333 @@
+#include "ui/terminal_log.h"
+#include "ui/upload_manager.h"
+#include "ui/tabs/ui_tab_terminal.h"
+#include "ui/system_prefs.h"
+#include "config.h"
+#include "core/sd_card.h"
+#include <esp_heap_caps.h>
+
+// Static member initialization
+bool TerminalLog::enabled = false;
+bool TerminalLog::file_ok = false;
+uint32_t TerminalLog::boot_id = 0;
+uint32_t TerminalLog::log_size = 0;
+char *TerminalLog::active_buf = nullptr;
+TerminalLogBlock TerminalLog::active = {};
+char *TerminalLog::sealed_buf = nullptr;
+TerminalLogBlock TerminalLog::sealed = {};
+bool TerminalLog::sealed_pending = false;
+uint32_t TerminalLog::dropped_lines = 0;
+TerminalLogBlock *TerminalLog::index = nullptr;
+uint32_t TerminalLog::index_count = 0;
+uint32_t TerminalLog::index_capacity = 0;
+char TerminalLog::search_token[16] = "";
+uint32_t TerminalLog::search_bit = 0;
+int32_t TerminalLog::search_block = -1;
+int32_t TerminalLog::search_line = 0;
+char *TerminalLog::read_buf = nullptr;
+int32_t TerminalLog::read_block = -1;
+
+// Index records kept in memory (log is rotated when either limit is reached)
+static const uint32_t MAX_INDEX_RECORDS = 4096;
+
+void TerminalLog::init() {
+    enabled = SystemPrefs::getBool(SysPref::TERMINAL_LOG);
+
+    if (enabled) {
+        file_ok = openFiles();
+    }
+    Serial.printf("[TerminalLog] %s\n", enabled ? (file_ok ? "Logging to Display SD" : "Enabled but SD not available") : "Disabled");
+}
+
+void TerminalLog::setEnabled(bool enable) {
+    if (enable == enabled) return;
+
+    SystemPrefs::setBool(SysPref::TERMINAL_LOG, enable);
+
+    if (!enable) {
+        // Keep what has been collected so far
+        sealActive();
+        loop();
+    }
+    enabled = enable;
+    if (enabled && !file_ok) {
+        file_ok = openFiles();
+    }
+    Serial.printf("[TerminalLog] Logging %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool TerminalLog::openFiles() {
+    if (!UploadManager::init()) {
+        return false;
+    }
+
+    if (!active_buf) {
+        active_buf = (char*)heap_caps_malloc(TERMINAL_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        sealed_buf = (char*)heap_caps_malloc(TERMINAL_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        read_buf = (char*)heap_caps_malloc(TERMINAL_LOG_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        index = (TerminalLogBlock*)heap_caps_malloc(MAX_INDEX_RECORDS * sizeof(TerminalLogBlock), MALLOC_CAP_SPIRAM);
+        if (!active_buf || !sealed_buf || !read_buf || !index) {
+            Serial.println("[TerminalLog] Failed to allocate buffers");
+            return false;
+        }
+        index_capacity = MAX_INDEX_RECORDS;
+    }
+
+    loadIndex();
+
+    active = {};
+    active.offset = log_size;
+    active.boot_id = boot_id;
+    return true;
+}
+
+void TerminalLog::loadIndex() {
+    index_count = 0;
+    log_size = 0;
+    boot_id = 1;
+
+    SDReader log;
+    if (log.open(TERMINAL_LOG_PATH)) {
+        log_size = log.size();
+        log.close();
+    }
+
+    SDReader idx;
+    if (idx.open(TERMINAL_LOG_INDEX_PATH)) {
+        // Keep only records that point inside the log (a torn final write is dropped)
+        TerminalLogBlock rec;
+        while (index_count < index_capacity && idx.read((uint8_t*)&rec, sizeof(rec)) == (int)sizeof(rec)) {
+            if (rec.offset + rec.length > log_size) break;
+            index[index_count++] = rec;
+        }
+        idx.close();
+    }
+
+    if (index_count > 0) {
+        const TerminalLogBlock &last = index[index_count - 1];
+        boot_id = last.boot_id + 1;
+        log_size = last.offset + last.length;  // Ignore any unindexed tail
+    }
+    Serial.printf("[TerminalLog] %u indexed blocks, %u bytes, boot %u\n", index_count, log_size, boot_id);
+}
+
+void TerminalLog::append(const char *text, size_t len, uint32_t seq) {
+    if (!enabled || !file_ok || !active_buf) return;
+    if (len > TERMINAL_LOG_BLOCK_SIZE - 1) len = TERMINAL_LOG_BLOCK_SIZE - 1;
+
+    // After a drop, lines resume in a fresh block so row sequence numbers stay exact
+    if (dropped_lines > 0 || active.length + len + 1 > TERMINAL_LOG_BLOCK_SIZE) {
+        sealActive();
+        if (active.lines > 0) {
+            dropped_lines++;  // Previous block still unwritten
+            return;
+        }
+    }
+    if (dropped_lines > 0) {
+        appendDropMarker(seq);
+        if (active.length + len + 1 > TERMINAL_LOG_BLOCK_SIZE) len = TERMINAL_LOG_BLOCK_SIZE - active.length - 1;
+    }
+
+    if (active.lines == 0) {
+        active.first_ms = millis();
+        active.first_seq = seq;
+        active.token_mask = 0;
+    }
+    memcpy(active_buf + active.length, text, len);
+    active_buf[active.length + len] = '\n';
+    active.length += len + 1;
+    active.lines++;
+    active.token_mask |= tokenBit(text, len);
+}
+
+void TerminalLog::appendDropMarker(uint32_t seq) {
+    // First line of a fresh block; takes no terminal rows
+    int n = snprintf(active_buf, TERMINAL_LOG_BLOCK_SIZE, "[%u lines dropped]\n", dropped_lines);
+    Serial.printf("[TerminalLog] %u lines dropped (SD writes behind)\n", dropped_lines);
+    active.first_ms = millis();
+    active.first_seq = seq;
+    active.token_mask = tokenBit(active_buf, n - 1);
+    active.length = n;
+    active.lines = 1;
+    dropped_lines = 0;
+}
+
+bool TerminalLog::isDropMarker(const char *text, size_t len) {
+    static const char SUFFIX[] = " lines dropped]";
+    size_t suffix_len = sizeof(SUFFIX) - 1;
+    return len > suffix_len + 1 && text[0] == '[' && text[1] >= '0' && text[1] <= '9' &&
+           memcmp(text + len - suffix_len, SUFFIX, suffix_len) == 0;
+}
+
+void TerminalLog::sealActive() {
+    if (active.lines == 0 || sealed_pending) return;
+
+    // Swap buffers - the UI keeps appending into a fresh block while this one is written
+    char *tmp = sealed_buf;
+    sealed_buf = active_buf;
+    active_buf = tmp;
+    sealed = active;
+    sealed_pending = true;
+
+    active = {};
+    active.offset = sealed.offset + sealed.length;
+    active.boot_id = boot_id;
+}
+
+void TerminalLog::loop() {
+    if (!file_ok) return;
+
+    // Seal a partial block once it has been open long enough
+    if (!sealed_pending && active.lines > 0 && millis() - active.first_ms >= TERMINAL_LOG_FLUSH_MS) {
+        sealActive();
+    }
+
+    // Don't compete with an upload for the SD card
+    if (!sealed_pending || UploadManager::isUploading()) return;
+
+    if (!writeBlock(sealed_buf, sealed)) {
+        Serial.println("[TerminalLog] Write failed (card removed?) - logging paused");
+        file_ok = false;
+    }
+    sealed_pending = false;
+}
+
+bool TerminalLog::writeBlock(const char *buf, TerminalLogBlock &block) {
+    // Start over when the log or index is full
+    if (index_count >= index_capacity || log_size + block.length > TERMINAL_LOG_MAX_BYTES) {
+        rotate();
+    }
+    block.offset = log_size;
+
+    File log = SDCard::openForWrite(TERMINAL_LOG_PATH, FILE_APPEND);
+    if (!log) return false;
+    size_t written = log.write((const uint8_t*)buf, block.length);
+    log.close();
+    if (written != block.length) return false;
+
+    // Index record goes last so a block is never indexed before its data is on the card
+    File idx = SDCard::openForWrite(TERMINAL_LOG_INDEX_PATH, FILE_APPEND);
+    if (!idx) return false;
+    idx.write((const uint8_t*)&block, sizeof(block));
+    idx.close();
+
+    log_size += block.length;
+    index[index_count++] = block;
+    active.offset = log_size;
+    return true;
+}
+
+void TerminalLog::rotate() {
+    // The full log becomes the .old pair (the pair before it is dropped)
+    Serial.println("[TerminalLog] Log full - rotating to " TERMINAL_LOG_OLD_PATH);
+    SDCard::remove(TERMINAL_LOG_OLD_PATH);
+    SDCard::remove(TERMINAL_LOG_OLD_INDEX_PATH);
+    if (!SDCard::rename(TERMINAL_LOG_PATH, TERMINAL_LOG_OLD_PATH) ||
+        !SDCard::rename(TERMINAL_LOG_INDEX_PATH, TERMINAL_LOG_OLD_INDEX_PATH)) {
+        // Never append to a log whose index is gone
+        SDCard::remove(TERMINAL_LOG_PATH);
+        SDCard::remove(TERMINAL_LOG_INDEX_PATH);
+    }
+    index_count = 0;
+    log_size = 0;
+    read_block = -1;
+    search_block = -1;
+}
+
+uint32_t TerminalLog::tokenBit(const char *text, size_t len) {
+    // First token = up to and including the first ':' (or up to the first space)
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < len && i < sizeof(search_token) - 1; i++) {
+        char c = text[i];
+        if (c == ' ') break;
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+        if (c == ':') break;
+    }
+    return 1u << (hash & 31);
+}
+
+void TerminalLog::beginSearch(const char *token) {
+    strncpy(search_token, token, sizeof(search_token) - 1);
+    search_token[sizeof(search_token) - 1] = '\0';
+    search_bit = tokenBit(search_token, strlen(search_token));
+    search_block = -1;
+    search_line = INT32_MAX;
+    if (!file_ok || !index) return;
+
+    // Push everything collected so far to the card (user-initiated, at most two blocks)
+    for (int i = 0; i < 2; i++) {
+        sealActive();
+        if (sealed_pending) {
+            if (!writeBlock(sealed_buf, sealed)) file_ok = false;
+            sealed_pending = false;
+        }
+    }
+
+    // Walk the index newest to oldest
+    search_block = (int32_t)index_count - 1;
+}
+
+bool TerminalLog::findPrevious(TerminalLogMatch &match) {
+    if (!file_ok || !index) return false;
+
+    while (search_block >= 0 && search_block < (int32_t)index_count) {
+        const TerminalLogBlock &block = index[search_block];
+
+        // Only blocks whose mask can match are read back from the card
+        if (block.lines > 0 && (block.token_mask & search_bit)) {
+            if (read_block != search_block) {
+                SDReader log;
+                if (!log.open(TERMINAL_LOG_PATH) || !log.seek(block.offset) ||
+                    log.read((uint8_t*)read_buf, block.length) != (int)block.length) {
+                    return false;
+                }
+                log.close();
+                read_block = search_block;
+            }
+            if (searchBlock(read_buf, block, block.boot_id == boot_id, match)) {
+                return true;
+            }
+        }
+
+        // Nothing (more) in this block - move to the next older one
+        search_block--;
+        search_line = INT32_MAX;
+    }
+    return false;
+}
+
+bool TerminalLog::searchBlock(const char *buf, const TerminalLogBlock &block, bool this_boot, TerminalLogMatch &match) {
+    size_t token_len = strlen(search_token);
+    int32_t found_line = -1;
+    const char *found_text = nullptr;
+    size_t found_len = 0;
+    uint32_t found_seq = 0;
+
+    // Forward pass to keep row sequence numbers; the last hit before search_line wins
+    uint32_t seq = block.first_seq;
+    const char *p = buf;
+    const char *end = buf + block.length;
+    for (int32_t line = 0; p < end && line < search_line; line++) {
+        const char *eol = (const char*)memchr(p, '\n', end - p);
+        size_t len = eol ? (size_t)(eol - p) : (size_t)(end - p);
+        if (len >= token_len && strncmp(p, search_token, token_len) == 0) {
+            found_line = line;
+            found_text = p;
+            found_len = len;
+            found_seq = seq;
+        }
+        if (!isDropMarker(p, len)) seq += UITabTerminal::rowsForLength(len);
+        p = eol ? eol + 1 : end;
+    }
+
+    if (found_line < 0) return false;
+
+    size_t n = found_len < sizeof(match.text) - 1 ? found_len : sizeof(match.text) - 1;
+    memcpy(match.text, found_text, n);
+    match.text[n] = '\0';
+    match.first_ms = block.first_ms;
+    match.seq = found_seq;
+    match.this_boot = this_boot;
+    search_line = found_line;  // Next call continues above this line
+    return true;
+}
@@ -6,11 +6,13 @@
 #include "network/fluidnc_client.h"
 #include "core/display_driver.h"
 #include "core/power_manager.h"
-#include "network/screenshot_server.h"
+#include "core/job_eta.h"
+#include "network/connection_manager.h"
 #include "config.h"
-#include <Preferences.h>
+#include "ui/settings_store.h"
+#include "ui/system_prefs.h"
+#include "ui/ui_dashboard.h"
 #include <WiFi.h>
-#include <ESPmDNS.h>
 #include <esp_sleep.h>
 
 // Static member initialization
@@ -21,6 +23,9 @@ lv_obj_t *UICommon::status_bar_left_area = nullptr;
 lv_obj_t *UICommon::status_bar_right_area = nullptr;
 lv_obj_t *UICommon::machine_select_dialog = nullptr;
 lv_obj_t *UICommon::connecting_popup = nullptr;
+lv_obj_t *UICommon::connecting_popup_label = nullptr;
+lv_obj_t *UICommon::connecting_popup_detail = nullptr;
+lv_obj_t *UICommon::connecting_popup_bar = nullptr;
 lv_obj_t *UICommon::connection_error_dialog = nullptr;
 lv_obj_t *UICommon::hold_popup = nullptr;
 lv_obj_t *UICommon::hold_popup_msg_label = nullptr;
@@ -83,12 +88,7 @@ static char last_filename[128] = "";
 static float last_percent = -1.0f;
 static uint32_t last_elapsed_sec = 0xFFFFFFFF;  // Use seconds for comparison
 static uint32_t last_estimated_sec = 0xFFFFFFFF;
-
-// Connection timeout tracking
-static uint32_t connection_timeout_start = 0;
-static bool connection_timeout_active = false;
-static bool connection_error_shown = false;
-static bool ever_connected_successfully = false;  // Track if we've connected at least once
+static uint32_t last_band_sec = 0xFFFFFFFF;
 
 // Event handler for status bar left area click (go to Status tab)
 static void status_bar_left_click_handler(lv_event_t *e) {
@@ -137,6 +137,12 @@ static void status_bar_right_click_handler(lv_event_t *e) {
     }
 }
 
+// Event handler for opening the multi-machine dashboard
+static void on_machines_click(lv_event_t *e) {
+    UICommon::hideMachineSelectConfirmDialog();
+    UIDashboard::show();
+}
+
 // Event handler for confirming machine selection change
 static void on_machine_select_confirm(lv_event_t *e) {
     Serial.println("UICommon: Restarting to change machine...");
@@ -153,6 +159,7 @@ static void on_machine_select_confirm(lv_event_t *e) {
     lv_timer_handler();
     delay(500);
     
+    SettingsStore::flush();  // Pending settings writes
     // Restart the ESP32
     ESP.restart();
 }
@@ -162,11 +169,9 @@ static void on_power_off_confirm(lv_event_t *e) {
     Serial.println("UICommon: Powering off device...");
     UICommon::hideMachineSelectConfirmDialog();
     
-    // Save clean shutdown flag in separate namespace to avoid corrupting machine configs
-    Preferences prefs;
-    prefs.begin(PREFS_SYSTEM_NAMESPACE, false);
-    prefs.putBool("clean_shutdown", true);
-    prefs.end();
+    // Save clean shutdown flag (with any pending settings writes)
+    SystemPrefs::setBool(SysPref::CLEAN_SHUTDOWN, true);
+    SettingsStore::flush();
     
     // Show power off message
     lv_obj_t *poweroff_label = lv_label_create(lv_screen_active());
@@ -270,102 +275,40 @@ void UICommon::createMainUI() {
     // Create all tabs
     UITabs::createTabs();
     
-    // Initialize WiFi connection using machine-specific credentials
-    if (config.connection_type == CONN_WIRELESS) {
-        if (strlen(config.ssid) > 0) {
-            Serial.println("\n=== WiFi Connection ===");
-            Serial.printf("Connecting to WiFi: %s\n", config.ssid);
-            
-            WiFi.mode(WIFI_STA);
-            WiFi.setAutoReconnect(false);  // Disable auto-reconnect - user must manually reconnect
-            WiFi.begin(config.ssid, config.password);
-            
-            // Wait for connection with timeout (10 seconds)
-            int timeout = 20;
-            while (WiFi.status() != WL_CONNECTED && timeout > 0) {
-                delay(500);
-                Serial.print(".");
-                timeout--;
-                lv_timer_handler();  // Keep UI responsive
-            }
-            
-            if (WiFi.status() == WL_CONNECTED) {
-                Serial.println("\nWiFi connected!");
-                Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-                
-                // Initialize mDNS client stack to enable resolving .local hostnames (like fluidnc.local)
-                // Note: MDNS.begin() is required on ESP32 to enable mDNS client queries, not just advertising
-                if (MDNS.begin("fluidtouch")) {
-                    Serial.println("mDNS client initialized - can now resolve .local hostnames");
-                    delay(1000);  // Give mDNS time to fully initialize before attempting queries
-                } else {
-                    Serial.println("Warning: mDNS client failed to start (.local hostname resolution will not work)");
-                }
-                
-                // Initialize screenshot server now that WiFi is connected
-                if (display_driver) {
-                    Serial.println("Initializing screenshot server with WiFi connection...");
-                    ScreenshotServer::init(display_driver);
-                    if (ScreenshotServer::isConnected()) {
-                        Serial.println("Screenshot server available at: http://" + ScreenshotServer::getIPAddress());
-                    }
-                }
-                
-                // Update WiFi status in status bar
-                if (lbl_wifi_name) {
-                    lv_label_set_text(lbl_wifi_name, config.ssid);
-                }
-                if (lbl_wifi_symbol) {
-                    lv_obj_set_style_text_color(lbl_wifi_symbol, UITheme::STATE_IDLE, 0);
-                }
-                
-                // Update popup to show machine connection (WiFi is now connected)
-                hideConnectingPopup();
-                showConnectingPopup(config.name, nullptr);  // nullptr = no WiFi name (already connected)
-            } else {
-                Serial.println("\nWiFi connection failed!");
-                
-                // Build error message
-                char error_msg[256];
-                snprintf(error_msg, sizeof(error_msg), 
-                        "Could not connect to network:\n%s\n\nCheck WiFi settings and try again.",
-                        config.ssid);
-                
-                // Show error dialog
-                showConnectionErrorDialog("WiFi Connection Failed", error_msg);
-                
-                // Disable connection timeout monitoring since we're not attempting machine connection
-                connection_timeout_active = false;
-                
-                // Do NOT attempt machine connection if WiFi failed
-                return;
-            }
-        } else {
-            Serial.println("UICommon: Warning - Wireless connection selected but no SSID configured");
-            // Popup already shown at start
-            // Disable connection timeout monitoring since we're not attempting machine connection
-            connection_timeout_active = false;
-            return;  // Don't attempt machine connection without WiFi config
-        }
-    } else {
-        Serial.println("UICommon: Wired connection selected, skipping WiFi initialization");
-        // Popup already shown at start
-    }
-    
-    // Connect to FluidNC using selected machine
-    // Only reached if WiFi connected successfully (or wired connection)
-    Serial.printf("UICommon: Connecting to FluidNC at %s:%d\n", 
-                 config.fluidnc_url, config.websocket_port);
-    FluidNCClient::connect(config);
-    
-    // Start connection timeout monitoring (10 seconds)
-    connection_timeout_start = millis();
-    connection_timeout_active = true;
-    connection_error_shown = false;
+    // Start connection bring-up (WiFi -> mDNS -> resolve -> WebSocket)
+    // ConnectionManager::loop() advances it from the main loop so the UI stays responsive
+    ConnectionManager::begin(config);
     
     Serial.println("UICommon: Main UI created");
 }
 
+void UICommon::rebuildMainUI() {
+    Serial.println("UICommon: Rebuilding main UI for the focused machine");
+
+    // Popups live on the old screen and go with it
+    hideMachineSelectConfirmDialog();
+    hideConnectingPopup();
+    hideConnectionErrorDialog();
+    hideHoldPopup();
+    hideAlarmPopup();
+    last_popup_state = -1;
+    hold_popup_dismissed = false;
+    alarm_popup_dismissed = false;
+    last_wpos_x = last_wpos_y = last_wpos_z = last_wpos_a = -9999.0f;
+    last_mpos_x = last_mpos_y = last_mpos_z = -9999.0f;
+
+    loadSystemPreferences();
+
+    lv_obj_t *old_screen = lv_screen_active();
+    lv_obj_t *main_screen = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(main_screen, UITheme::BG_DARKER, LV_PART_MAIN);
+    lv_scr_load(main_screen);
+
+    createStatusBar();
+    UITabs::createTabs();
+    lv_obj_del(old_screen);
+}
+
 void UICommon::createStatusBar() {
     // Debug: Check A-axis state at status bar creation
     bool a_axis_enabled = isAAxisEnabled();
@@ -766,6 +709,15 @@ void UICommon::updateConnectionStatus(bool machine_connected, bool wifi_connecte
     }
 }
 
+void UICommon::updateWiFiName(const char *ssid) {
+    if (lbl_wifi_name) {
+        lv_label_set_text(lbl_wifi_name, ssid);
+    }
+    if (lbl_wifi_symbol) {
+        lv_obj_set_style_text_color(lbl_wifi_symbol, UITheme::STATE_IDLE, 0);
+    }
+}
+
 void UICommon::showMachineSelectConfirmDialog() {
     // Create modal background
     machine_select_dialog = lv_obj_create(lv_scr_act());
@@ -798,9 +750,9 @@ void UICommon::showMachineSelectConfirmDialog() {
     // Message (centered vertically in available space)
     lv_obj_t *msg_label = lv_label_create(content);
     if (power_mgmt_enabled) {
-        lv_label_set_text(msg_label, "Restart to change machines,\nor power off for battery operation.\n\nNote: Press reset button to power on\nafter using power off.");
+        lv_label_set_text(msg_label, "Open Machines to watch or switch machines,\nrestart, or power off for battery operation.\n\nNote: Press reset button to power on\nafter using power off.");
     } else {
-        lv_label_set_text(msg_label, "Restart to change machines.");
+        lv_label_set_text(msg_label, "Open Machines to watch or switch machines,\nor restart.");
     }
     lv_obj_set_style_text_font(msg_label, &lv_font_montserrat_16, 0);
     lv_obj_set_style_text_color(msg_label, UITheme::TEXT_LIGHT, 0);
@@ -821,9 +773,21 @@ void UICommon::showMachineSelectConfirmDialog() {
     lv_obj_align(btn_container, LV_ALIGN_BOTTOM_MID, 0, 0);
     lv_obj_clear_flag(btn_container, LV_OBJ_FLAG_SCROLLABLE);
     
+    // Machines button (dashboard of all machines)
+    int btn_width = power_mgmt_enabled ? 128 : 170;
+    lv_obj_t *machines_btn = lv_btn_create(btn_container);
+    lv_obj_set_size(machines_btn, btn_width, 50);
+    lv_obj_set_style_bg_color(machines_btn, UITheme::ACCENT_SECONDARY, 0);
+    lv_obj_add_event_cb(machines_btn, on_machines_click, LV_EVENT_CLICKED, nullptr);
+    
+    lv_obj_t *machines_label = lv_label_create(machines_btn);
+    lv_label_set_text(machines_label, LV_SYMBOL_LIST " Machines");
+    lv_obj_set_style_text_font(machines_label, &lv_font_montserrat_16, 0);
+    lv_obj_center(machines_label);
+    
     // Restart button (adjust size based on number of buttons)
     lv_obj_t *restart_btn = lv_btn_create(btn_container);
-    lv_obj_set_size(restart_btn, power_mgmt_enabled ? 165 : 250, 50);
+    lv_obj_set_size(restart_btn, btn_width, 50);
     lv_obj_set_style_bg_color(restart_btn, UITheme::ACCENT_PRIMARY, 0);
     lv_obj_add_event_cb(restart_btn, on_machine_select_confirm, LV_EVENT_CLICKED, nullptr);
     
@@ -835,7 +799,7 @@ void UICommon::showMachineSelectConfirmDialog() {
     // Power off button (only show if power management is enabled)
     if (power_mgmt_enabled) {
         lv_obj_t *poweroff_btn = lv_btn_create(btn_container);
-        lv_obj_set_size(poweroff_btn, 165, 50);
+        lv_obj_set_size(poweroff_btn, btn_width, 50);
         lv_obj_set_style_bg_color(poweroff_btn, lv_color_make(180, 60, 0), 0);  // Orange/red for power off
         lv_obj_add_event_cb(poweroff_btn, on_power_off_confirm, LV_EVENT_CLICKED, nullptr);
         
@@ -847,7 +811,7 @@ void UICommon::showMachineSelectConfirmDialog() {
     
     // Cancel button (adjust size based on number of buttons)
     lv_obj_t *cancel_btn = lv_btn_create(btn_container);
-    lv_obj_set_size(cancel_btn, power_mgmt_enabled ? 165 : 250, 50);
+    lv_obj_set_size(cancel_btn, btn_width, 50);
     lv_obj_set_style_bg_color(cancel_btn, UITheme::BG_BUTTON, 0);
     lv_obj_add_event_cb(cancel_btn, on_machine_select_cancel, LV_EVENT_CLICKED, nullptr);
     
@@ -941,6 +905,9 @@ void UICommon::hideMachineSelectConfirmDialog() {
 }
 
 void UICommon::showConnectingPopup(const char *machine_name, const char *ssid) {
+    // Replace any popup already showing (e.g. reconnect from error dialog)
+    hideConnectingPopup();
+    
     // Create modal background
     connecting_popup = lv_obj_create(lv_scr_act());
     lv_obj_set_size(connecting_popup, LV_PCT(100), LV_PCT(100));
@@ -959,7 +926,7 @@ void UICommon::showConnectingPopup(const char *machine_name, const char *ssid) {
     lv_obj_set_flex_flow(content, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(content, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
     lv_obj_set_style_pad_all(content, 25, 0);
-    lv_obj_set_style_pad_gap(content, 20, 0);
+    lv_obj_set_style_pad_gap(content, 15, 0);
     lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
     
     // Connection text - use ssid if provided, otherwise machine name
@@ -971,18 +938,52 @@ void UICommon::showConnectingPopup(const char *machine_name, const char *ssid) {
         snprintf(conn_text, sizeof(conn_text), "Connecting to %s...", machine_name);
     }
     
-    lv_obj_t *conn_label = lv_label_create(content);
-    lv_label_set_text(conn_label, conn_text);
-    lv_obj_set_style_text_font(conn_label, &lv_font_montserrat_22, 0);
-    lv_obj_set_style_text_color(conn_label, UITheme::TEXT_LIGHT, 0);
+    connecting_popup_label = lv_label_create(content);
+    lv_label_set_text(connecting_popup_label, conn_text);
+    lv_obj_set_style_text_font(connecting_popup_label, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(connecting_popup_label, UITheme::TEXT_LIGHT, 0);
+    
+    // Stage detail (updated by ConnectionManager as each stage starts)
+    connecting_popup_detail = lv_label_create(content);
+    lv_label_set_text(connecting_popup_detail, "");
+    lv_obj_set_style_text_font(connecting_popup_detail, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(connecting_popup_detail, UITheme::TEXT_MEDIUM, 0);
+    
+    // Stage progress bar
+    connecting_popup_bar = lv_bar_create(content);
+    lv_obj_set_size(connecting_popup_bar, 400, 10);
+    lv_obj_set_style_bg_color(connecting_popup_bar, UITheme::BG_BUTTON, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(connecting_popup_bar, UITheme::ACCENT_PRIMARY, LV_PART_INDICATOR);
+    lv_bar_set_value(connecting_popup_bar, 0, LV_ANIM_OFF);
     
     Serial.printf("UICommon: %s\n", conn_text);
 }
 
+void UICommon::updateConnectingPopup(const char *text, const char *detail, int step, int total_steps) {
+    if (!connecting_popup) return;
+    
+    // Keep popup above status bar and tabs created after it
+    lv_obj_move_foreground(connecting_popup);
+    
+    if (connecting_popup_label && text) {
+        lv_label_set_text(connecting_popup_label, text);
+    }
+    if (connecting_popup_detail && detail) {
+        lv_label_set_text(connecting_popup_detail, detail);
+    }
+    if (connecting_popup_bar && total_steps > 0) {
+        lv_bar_set_range(connecting_popup_bar, 0, total_steps);
+        lv_bar_set_value(connecting_popup_bar, step, LV_ANIM_OFF);
+    }
+}
+
 void UICommon::hideConnectingPopup() {
     if (connecting_popup) {
         lv_obj_del(connecting_popup);
         connecting_popup = nullptr;
+        connecting_popup_label = nullptr;
+        connecting_popup_detail = nullptr;
+        connecting_popup_bar = nullptr;
         Serial.println("UICommon: Connecting popup hidden");
     }
 }
@@ -1009,55 +1010,14 @@ static void on_connection_error_connect(lv_event_t *e) {
     lv_refr_now(nullptr);  // Force immediate display update
     
     // Disconnect existing connections
+    ConnectionManager::cancel();
     WiFi.disconnect();
     FluidNCClient::disconnect();
     
-    // Small delay to ensure clean disconnect
-    delay(100);
-    lv_timer_handler();
-    
-    // Reconnect WiFi
+    // Reconnect WiFi and machine (non-blocking, progress shown in connecting popup)
     if (config.connection_type == CONN_WIRELESS && strlen(config.ssid) > 0) {
         Serial.printf("UICommon: Reconnecting to WiFi: %s\n", config.ssid);
-        WiFi.mode(WIFI_STA);
-        WiFi.setAutoReconnect(false);
-        WiFi.begin(config.ssid, config.password);
-        
-        // Wait for WiFi connection with timeout (10 seconds)
-        int timeout = 20;
-        while (WiFi.status() != WL_CONNECTED && timeout > 0) {
-            delay(500);
-            Serial.print(".");
-            timeout--;
-            lv_timer_handler();
-        }
-        
-        if (WiFi.status() == WL_CONNECTED) {
-            Serial.println("\nWiFi reconnected!");
-            Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-            
-            // Update status bar WiFi indicator
-            UICommon::updateConnectionStatus(false, true);
-            
-            // Update connecting popup to show machine connection
-            UICommon::hideConnectingPopup();
-            UICommon::showConnectingPopup(config.name, nullptr);
-            
-            // Reconnect to FluidNC
-            Serial.printf("UICommon: Reconnecting to FluidNC at %s:%d\n", 
-                         config.fluidnc_url, config.websocket_port);
-            FluidNCClient::connect(config);
-            
-            // Restart connection timeout monitoring (10 seconds)
-            connection_timeout_start = millis();
-            connection_timeout_active = true;
-            connection_error_shown = false;
-        } else {
-            Serial.println("\nWiFi reconnection failed!");
-            UICommon::hideConnectingPopup();
-            UICommon::showConnectionErrorDialog("WiFi Connection Failed", 
-                "Could not reconnect to WiFi.\n\nCheck network settings and try again.");
-        }
+        ConnectionManager::begin(config);
     }
 }
 
@@ -1076,6 +1036,7 @@ static void on_connection_error_restart(lv_event_t *e) {
     lv_timer_handler();
     delay(500);
     
+    SettingsStore::flush();  // Pending settings writes
     // Restart the ESP32
     ESP.restart();
 }
@@ -1180,45 +1141,6 @@ void UICommon::hideConnectionErrorDialog() {
     }
 }
 
-void UICommon::checkConnectionTimeout() {
-    // If not monitoring timeout, nothing to do
-    if (!connection_timeout_active) {
-        return;
-    }
-    
-    // If already connected, deactivate timeout and hide popups
-    if (FluidNCClient::isConnected()) {
-        connection_timeout_active = false;
-        connection_error_shown = false;
-        ever_connected_successfully = true;  // Mark that we've connected successfully
-        hideConnectingPopup();  // Hide connecting popup when connected
-        hideConnectionErrorDialog();
-        return;
-    }
-    
-    // Check if timeout exceeded (10 seconds)
-    uint32_t elapsed = millis() - connection_timeout_start;
-    if (elapsed >= 10000 && !connection_error_shown && !ever_connected_successfully) {
-        // Only show error if we've never connected successfully (prevents popup on brief disconnects after initial connection)
-        connection_error_shown = true;
-        
-        // Get machine config for error message
-        MachineConfig config;
-        if (MachineConfigManager::getSelectedMachine(config)) {
-            // Build error message
-            char error_msg[300];
-            snprintf(error_msg, sizeof(error_msg), 
-                    "Could not connect to machine:\n%s\n\nURL: %s:%d\n\nCheck that the machine is powered on\nand network connection is available.",
-                    config.name, config.fluidnc_url, config.websocket_port);
-            
-            // Show error dialog
-            showConnectionErrorDialog("Machine Connection Failed", error_msg);
-            
-            Serial.println("UICommon: Machine connection timeout - showing error dialog");
-        }
-    }
-}
-
 // HOLD popup - shown when machine enters HOLD state
 void UICommon::showHoldPopup(const char *message) {
     if (hold_popup) return; // Already showing
@@ -1496,15 +1418,27 @@ void UICommon::updateFileProgress(bool is_printing, float percent, const char *f
             last_elapsed_sec = elapsed_sec;
         }
         
-        // Calculate and update estimated time (delta check - only update if changed by 1+ second)
-        if (lbl_estimated_time && percent > 0.1f) {
-            uint32_t estimated_total_sec = (uint32_t)((elapsed_sec / percent) * 100.0f);
+        // Estimated total time from JobEta (time profile + feed override when the file was analyzed)
+        uint32_t estimated_total_sec = JobEta::getTotalSec();
+        uint32_t band_sec = JobEta::getBandSec();
+        if (lbl_estimated_time && estimated_total_sec > 0 &&
+            (estimated_total_sec != last_estimated_sec || band_sec != last_band_sec)) {
+            uint32_t est_hours = estimated_total_sec / 3600;
+            uint32_t est_minutes = (estimated_total_sec % 3600) / 60;
             
-            if (estimated_total_sec != last_estimated_sec) {
-                uint32_t est_hours = estimated_total_sec / 3600;
-                uint32_t est_minutes = (estimated_total_sec % 3600) / 60;
-                
-                char est_text[20];
+            char est_text[32];
+            if (band_sec > 0) {
+                // With a band the value carries its own units ("1h23m +/-4m") and the unit label is hidden
+                char band_text[12];
+                if (band_sec >= 60) snprintf(band_text, sizeof(band_text), "+/-%um", (band_sec + 30) / 60);
+                else snprintf(band_text, sizeof(band_text), "+/-%us", band_sec);
+                if (est_hours > 0) {
+                    snprintf(est_text, sizeof(est_text), "%uh%02um %s", est_hours, est_minutes, band_text);
+                } else {
+                    snprintf(est_text, sizeof(est_text), "%um%02us %s", est_minutes, estimated_total_sec % 60, band_text);
+                }
+                if (lbl_estimated_unit) lv_obj_add_flag(lbl_estimated_unit, LV_OBJ_FLAG_HIDDEN);
+            } else {
                 if (est_hours > 0) {
                     snprintf(est_text, sizeof(est_text), "%d:%02d", est_hours, est_minutes);
                     if (lbl_estimated_unit) lv_label_set_text(lbl_estimated_unit, "hr:min");
@@ -1512,9 +1446,11 @@ void UICommon::updateFileProgress(bool is_printing, float percent, const char *f
                     snprintf(est_text, sizeof(est_text), "%d:%02d", est_minutes, (int)(estimated_total_sec % 60));
                     if (lbl_estimated_unit) lv_label_set_text(lbl_estimated_unit, "min:sec");
                 }
-                lv_label_set_text(lbl_estimated_time, est_text);
-                last_estimated_sec = estimated_total_sec;
+                if (lbl_estimated_unit) lv_obj_clear_flag(lbl_estimated_unit, LV_OBJ_FLAG_HIDDEN);
             }
+            lv_label_set_text(lbl_estimated_time, est_text);
+            last_estimated_sec = estimated_total_sec;
+            last_band_sec = band_sec;
         }
     } else {
         // Hide job progress, show normal status/position display
@@ -1534,6 +1470,7 @@ void UICommon::updateFileProgress(bool is_printing, float percent, const char *f
         last_percent = -1.0f;
         last_elapsed_sec = 0xFFFFFFFF;
         last_estimated_sec = 0xFFFFFFFF;
+        last_band_sec = 0xFFFFFFFF;
     }
 }
 
@@ -0,0 +1,227 @@
+#include "ui/ui_dashboard.h"
+#include "ui/ui_theme.h"
+#include "network/fluidnc_client.h"
+#include "network/machine_sessions.h"
+#include "network/gcode_sender.h"
+#include "network/probe_sequencer.h"
+#include "config.h"
+
+// Static member initialization
+lv_obj_t *UIDashboard::overlay = nullptr;
+lv_obj_t *UIDashboard::lbl_message = nullptr;
+lv_obj_t *UIDashboard::cards[MAX_MACHINES] = {nullptr};
+lv_obj_t *UIDashboard::lbl_state[MAX_MACHINES] = {nullptr};
+lv_obj_t *UIDashboard::lbl_position[MAX_MACHINES] = {nullptr};
+lv_obj_t *UIDashboard::lbl_info[MAX_MACHINES] = {nullptr};
+uint32_t UIDashboard::last_update_ms = 0;
+
+static const uint32_t DASHBOARD_UPDATE_MS = 500;
+
+static const char* stateName(MachineState state) {
+    switch (state) {
+        case STATE_IDLE: return "IDLE";
+        case STATE_RUN: return "RUN";
+        case STATE_HOLD: return "HOLD";
+        case STATE_JOG: return "JOG";
+        case STATE_ALARM: return "ALARM";
+        case STATE_DOOR: return "DOOR";
+        case STATE_CHECK: return "CHECK";
+        case STATE_HOME: return "HOME";
+        case STATE_SLEEP: return "SLEEP";
+        default: return "OFFLINE";
+    }
+}
+
+static lv_color_t stateColor(MachineState state) {
+    switch (state) {
+        case STATE_IDLE: return UITheme::STATE_IDLE;
+        case STATE_RUN:
+        case STATE_JOG:
+        case STATE_HOME: return UITheme::STATE_RUN;
+        case STATE_HOLD:
+        case STATE_DOOR: return UITheme::STATE_HOLD;
+        case STATE_ALARM: return UITheme::STATE_ALARM;
+        default: return UITheme::STATE_UNKNOWN;
+    }
+}
+
+void UIDashboard::show() {
+    if (overlay) return;
+    MachineSessions::start();
+
+    overlay = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(overlay, SCREEN_WIDTH, SCREEN_HEIGHT);
+    lv_obj_set_pos(overlay, 0, 0);
+    lv_obj_set_style_bg_color(overlay, UITheme::BG_DARKER, 0);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_COVER, 0);
+    lv_obj_set_style_border_width(overlay, 0, 0);
+    lv_obj_set_style_radius(overlay, 0, 0);
+    lv_obj_set_style_pad_all(overlay, 10, 0);
+    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *title = lv_label_create(overlay);
+    lv_label_set_text(title, LV_SYMBOL_LIST " Machines");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(title, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 0, 8);
+
+    lbl_message = lv_label_create(overlay);
+    lv_label_set_text(lbl_message, "Tap a machine to switch to it");
+    lv_obj_set_style_text_font(lbl_message, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(lbl_message, UITheme::TEXT_MEDIUM, 0);
+    lv_obj_align(lbl_message, LV_ALIGN_TOP_MID, 0, 12);
+
+    lv_obj_t *btn_close = lv_btn_create(overlay);
+    lv_obj_set_size(btn_close, 60, 45);
+    lv_obj_align(btn_close, LV_ALIGN_TOP_RIGHT, 0, 0);
+    lv_obj_set_style_bg_color(btn_close, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(btn_close, onCloseClicked, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *lbl_close = lv_label_create(btn_close);
+    lv_label_set_text(lbl_close, LV_SYMBOL_CLOSE);
+    lv_obj_set_style_text_font(lbl_close, &lv_font_montserrat_20, 0);
+    lv_obj_center(lbl_close);
+
+    // Cards, two per row
+    lv_obj_t *list = lv_obj_create(overlay);
+    lv_obj_set_size(list, SCREEN_WIDTH - 20, SCREEN_HEIGHT - 75);
+    lv_obj_align(list, LV_ALIGN_TOP_LEFT, 0, 55);
+    lv_obj_set_style_bg_opa(list, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(list, 0, 0);
+    lv_obj_set_style_pad_all(list, 0, 0);
+    lv_obj_set_style_pad_gap(list, 10, 0);
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_ROW_WRAP);
+
+    int selected = MachineConfigManager::getSelectedMachineIndex();
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        cards[i] = nullptr;
+        const MachineSummary &machine = MachineConfigManager::getSummary(i);
+        if (!machine.is_configured) continue;
+
+        lv_obj_t *card = lv_obj_create(list);
+        lv_obj_set_size(card, 380, 165);
+        lv_obj_set_style_bg_color(card, UITheme::BG_MEDIUM, 0);
+        lv_obj_set_style_border_width(card, 3, 0);
+        lv_obj_set_style_border_color(card, i == selected ? UITheme::ACCENT_PRIMARY : UITheme::BORDER_MEDIUM, 0);
+        lv_obj_set_style_pad_all(card, 12, 0);
+        lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_flag(card, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(card, onCardClicked, LV_EVENT_CLICKED, (void*)(intptr_t)i);
+        cards[i] = card;
+
+        lv_obj_t *lbl_name = lv_label_create(card);
+        lv_label_set_text(lbl_name, machine.name);
+        lv_label_set_long_mode(lbl_name, LV_LABEL_LONG_DOT);
+        lv_obj_set_width(lbl_name, 240);
+        lv_obj_set_style_text_font(lbl_name, &lv_font_montserrat_20, 0);
+        lv_obj_set_style_text_color(lbl_name, UITheme::TEXT_LIGHT, 0);
+        lv_obj_align(lbl_name, LV_ALIGN_TOP_LEFT, 0, 0);
+
+        lbl_state[i] = lv_label_create(card);
+        lv_obj_set_style_text_font(lbl_state[i], &lv_font_montserrat_20, 0);
+        lv_obj_align(lbl_state[i], LV_ALIGN_TOP_RIGHT, 0, 0);
+
+        lbl_position[i] = lv_label_create(card);
+        lv_obj_set_style_text_font(lbl_position[i], &lv_font_montserrat_18, 0);
+        lv_obj_set_style_text_color(lbl_position[i], UITheme::POS_WORK, 0);
+        lv_obj_align(lbl_position[i], LV_ALIGN_TOP_LEFT, 0, 45);
+
+        lbl_info[i] = lv_label_create(card);
+        lv_label_set_long_mode(lbl_info[i], LV_LABEL_LONG_DOT);
+        lv_obj_set_width(lbl_info[i], 350);
+        lv_obj_set_style_text_font(lbl_info[i], &lv_font_montserrat_16, 0);
+        lv_obj_set_style_text_color(lbl_info[i], UITheme::TEXT_MEDIUM, 0);
+        lv_obj_align(lbl_info[i], LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    }
+
+    last_update_ms = 0;
+    update();
+}
+
+void UIDashboard::hide() {
+    if (!overlay) return;
+    lv_obj_del(overlay);
+    overlay = nullptr;
+    lbl_message = nullptr;
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        cards[i] = nullptr;
+    }
+}
+
+void UIDashboard::update() {
+    if (!overlay) return;
+    uint32_t now = millis();
+    if (last_update_ms != 0 && now - last_update_ms < DASHBOARD_UPDATE_MS) return;
+    last_update_ms = now;
+
+    int selected = MachineConfigManager::getSelectedMachineIndex();
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        if (!cards[i]) continue;
+
+        const FluidNCStatus *status = nullptr;
+        const char *info = "Offline - retrying";
+        if (i == selected) {
+            status = &FluidNCClient::getStatus();
+            info = "Focused";
+        } else {
+            const MachineSession *session = MachineSessions::getSession(i);
+            if (!MachineSessions::isReachable(MachineConfigManager::getSummary(i))) {
+                info = "On another network";
+            } else if (session && !session->hasAddress()) {
+                info = "Address unknown - connect to it once";
+            } else if (session && session->isConnected()) {
+                status = &session->getStatus();
+                info = "Tap to switch";
+            } else if (session && session->isOpen()) {
+                info = "Connecting...";
+            }
+        }
+
+        MachineState state = status && status->is_connected ? status->state : STATE_DISCONNECTED;
+        lv_label_set_text(lbl_state[i], stateName(state));
+        lv_obj_set_style_text_color(lbl_state[i], stateColor(state), 0);
+
+        if (state == STATE_DISCONNECTED) {
+            lv_label_set_text(lbl_position[i], "");
+            lv_label_set_text(lbl_info[i], info);
+            continue;
+        }
+        lv_label_set_text_fmt(lbl_position[i], "X %.2f   Y %.2f   Z %.2f", status->wpos_x, status->wpos_y, status->wpos_z);
+        if (status->is_sd_printing) {
+            lv_label_set_text_fmt(lbl_info[i], "%.0f%%  %s", status->sd_percent, status->sd_filename);
+        } else {
+            lv_label_set_text(lbl_info[i], info);
+        }
+    }
+}
+
+void UIDashboard::onCardClicked(lv_event_t *e) {
+    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    if (index == MachineConfigManager::getSelectedMachineIndex()) {
+        hide();
+        return;
+    }
+
+    const MachineSession *session = MachineSessions::getSession(index);
+    if (!session || !session->isConnected()) {
+        lv_label_set_text(lbl_message, "Not connected yet - can't switch");
+        lv_obj_set_style_text_color(lbl_message, UITheme::STATE_HOLD, 0);
+        return;
+    }
+    if (GCodeSender::isActive()) {
+        lv_label_set_text(lbl_message, "Display SD job streaming - can't switch");
+        lv_obj_set_style_text_color(lbl_message, UITheme::STATE_HOLD, 0);
+        return;
+    }
+    if (ProbeSequencer::isRunning()) {
+        lv_label_set_text(lbl_message, "Probe routine running - can't switch");
+        lv_obj_set_style_text_color(lbl_message, UITheme::STATE_HOLD, 0);
+        return;
+    }
+
+    hide();
+    MachineSessions::focus(index);
+}
+
+void UIDashboard::onCloseClicked(lv_event_t *e) {
+    hide();
+}
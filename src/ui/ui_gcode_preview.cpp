@@ -0,0 +1,324 @@
+#include "ui/ui_gcode_preview.h"
+#include "ui/ui_theme.h"
+#include "ui/gcode_cache.h"
+#include "ui/gcode_dry_run.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Static member initialization
+lv_obj_t *UIGCodePreview::dialog = nullptr;
+lv_obj_t *UIGCodePreview::canvas = nullptr;
+lv_obj_t *UIGCodePreview::stats_label = nullptr;
+lv_obj_t *UIGCodePreview::progress_bar = nullptr;
+lv_obj_t *UIGCodePreview::btn_dry_run = nullptr;
+uint16_t *UIGCodePreview::canvas_buf = nullptr;
+char UIGCodePreview::preview_path[256] = "";
+uint32_t UIGCodePreview::preview_size = 0;
+bool UIGCodePreview::preview_display_sd = false;
+bool UIGCodePreview::waiting = false;
+bool UIGCodePreview::dry_running = false;
+uint32_t UIGCodePreview::last_render_bytes = 0;
+
+static GCodeThumbnail thumbnail;
+
+static const int CANVAS_SIZE = 256;
+static const uint32_t RENDER_EVERY_BYTES = 64 * 1024;  // Redraw the thumbnail while analyzing
+static const int DRY_RUN_ISSUE_LINES = 5;               // Problems listed in the dialog (all are logged as counts)
+
+void UIGCodePreview::show(const char *path, bool display_sd, uint32_t size) {
+    if (dialog) {
+        lv_obj_delete(dialog);
+        dialog = nullptr;
+    }
+    if (dry_running) {
+        GCodeDryRun::cancel();
+        dry_running = false;
+    }
+
+    if (!canvas_buf) {
+        canvas_buf = (uint16_t*)heap_caps_malloc(CANVAS_SIZE * CANVAS_SIZE * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!canvas_buf) {
+            Serial.println("[Preview] Failed to allocate thumbnail buffer");
+            return;
+        }
+    }
+
+    // Create modal background
+    dialog = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(dialog, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(dialog, lv_color_make(0, 0, 0), 0);
+    lv_obj_set_style_bg_opa(dialog, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(dialog, 0, 0);
+    lv_obj_clear_flag(dialog, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Dialog content box
+    lv_obj_t *content = lv_obj_create(dialog);
+    lv_obj_set_size(content, 720, 400);
+    lv_obj_center(content);
+    lv_obj_set_style_bg_color(content, UITheme::BG_MEDIUM, 0);
+    lv_obj_set_style_border_color(content, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_set_style_border_width(content, 3, 0);
+    lv_obj_set_style_pad_all(content, 15, 0);
+    lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Title (file name only)
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    lv_obj_t *title = lv_label_create(content);
+    lv_label_set_text_fmt(title, LV_SYMBOL_EYE_OPEN " %s", name);
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(title, UITheme::ACCENT_PRIMARY, 0);
+    lv_label_set_long_mode(title, LV_LABEL_LONG_DOT);
+    lv_obj_set_width(title, 680);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    // Toolpath thumbnail
+    canvas = lv_canvas_create(content);
+    lv_canvas_set_buffer(canvas, canvas_buf, CANVAS_SIZE, CANVAS_SIZE, LV_COLOR_FORMAT_RGB565);
+    lv_canvas_fill_bg(canvas, UITheme::BG_BLACK, LV_OPA_COVER);
+    lv_obj_align(canvas, LV_ALIGN_TOP_LEFT, 0, 40);
+
+    // Statistics
+    stats_label = lv_label_create(content);
+    lv_obj_set_style_text_font(stats_label, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(stats_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_width(stats_label, 400);
+    lv_obj_align(stats_label, LV_ALIGN_TOP_LEFT, 280, 40);
+    lv_label_set_text(stats_label, "Analyzing...");
+
+    // Progress bar
+    progress_bar = lv_bar_create(content);
+    lv_obj_set_size(progress_bar, 400, 20);
+    lv_obj_align(progress_bar, LV_ALIGN_TOP_LEFT, 280, 250);
+    lv_bar_set_value(progress_bar, 0, LV_ANIM_OFF);
+    lv_obj_set_style_bg_color(progress_bar, UITheme::BG_DARKER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(progress_bar, UITheme::ACCENT_PRIMARY, LV_PART_INDICATOR);
+
+    // Close button
+    lv_obj_t *btn_close = lv_button_create(content);
+    lv_obj_set_size(btn_close, 180, 50);
+    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_set_style_bg_color(btn_close, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(btn_close, close_event_cb, LV_EVENT_CLICKED, nullptr);
+
+    lv_obj_t *lbl_close = lv_label_create(btn_close);
+    lv_label_set_text(lbl_close, "Close");
+    lv_obj_set_style_text_font(lbl_close, &lv_font_montserrat_18, 0);
+    lv_obj_center(lbl_close);
+
+    // Dry run button
+    btn_dry_run = lv_button_create(content);
+    lv_obj_set_size(btn_dry_run, 180, 50);
+    lv_obj_align(btn_dry_run, LV_ALIGN_BOTTOM_RIGHT, -195, 0);
+    lv_obj_set_style_bg_color(btn_dry_run, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_add_event_cb(btn_dry_run, dry_run_event_cb, LV_EVENT_CLICKED, nullptr);
+
+    lv_obj_t *lbl_dry_run = lv_label_create(btn_dry_run);
+    lv_label_set_text(lbl_dry_run, LV_SYMBOL_PLAY " Dry Run");
+    lv_obj_set_style_text_font(lbl_dry_run, &lv_font_montserrat_18, 0);
+    lv_obj_center(lbl_dry_run);
+
+    strncpy(preview_path, path, sizeof(preview_path) - 1);
+    preview_path[sizeof(preview_path) - 1] = '\0';
+    preview_size = size;
+    preview_display_sd = display_sd;
+    last_render_bytes = 0;
+
+    // Cached results are shown straight away, otherwise follow the analysis job
+    waiting = GCodeCache::analyze(path, display_sd, size);
+    if (!waiting) {
+        showResult();
+    } else if (!display_sd) {
+        // FluidNC serves one download at a time - dry run once the analysis has the file read
+        lv_obj_add_state(btn_dry_run, LV_STATE_DISABLED);
+    }
+}
+
+void UIGCodePreview::showResult() {
+    static GCodeAnalysis analysis;
+    if (GCodeCache::get(preview_path, preview_display_sd, preview_size, analysis, thumbnail)) {
+        renderThumbnail(analysis, thumbnail);
+        updateStats(analysis, true);
+        lv_bar_set_value(progress_bar, 100, LV_ANIM_OFF);
+    } else {
+        lv_label_set_text(stats_label, "Could not read file");
+        lv_obj_set_style_text_color(stats_label, UITheme::UI_WARNING, 0);
+    }
+}
+
+void UIGCodePreview::update() {
+    if (!dialog) return;
+    if (dry_running) {
+        updateDryRun();
+        return;
+    }
+    if (!waiting) return;
+
+    if (!GCodeCache::isAnalyzing(preview_path)) {
+        waiting = false;
+        lv_obj_clear_state(btn_dry_run, LV_STATE_DISABLED);
+        showResult();
+        return;
+    }
+
+    lv_bar_set_value(progress_bar, GCodeCache::getProgress(), LV_ANIM_OFF);
+
+    // Partial thumbnail and stats every RENDER_EVERY_BYTES
+    const GCodeAnalyzer &analyzer = GCodeCache::getAnalyzer();
+    if (analyzer.result().bytes - last_render_bytes >= RENDER_EVERY_BYTES) {
+        last_render_bytes = analyzer.result().bytes;
+        analyzer.getThumbnail(thumbnail);
+        renderThumbnail(analyzer.result(), thumbnail);
+        updateStats(analyzer.result(), false);
+    }
+}
+
+void UIGCodePreview::renderThumbnail(const GCodeAnalysis &r, const GCodeThumbnail &thumb) {
+    if (!canvas || !canvas_buf) return;
+
+    uint16_t bg = lv_color_to_u16(UITheme::BG_BLACK);
+    uint16_t fg = lv_color_to_u16(UITheme::ACCENT_SECONDARY);
+    for (int i = 0; i < CANVAS_SIZE * CANVAS_SIZE; i++) canvas_buf[i] = bg;
+
+    if (r.has_motion) {
+        // Fit the used part of the grid to the canvas, keeping the aspect ratio
+        const int G = GCodeThumbnail::GRID;
+        int gx0 = (int)((r.min_x - thumb.x0) / thumb.cell);
+        int gy0 = (int)((r.min_y - thumb.y0) / thumb.cell);
+        int gx1 = (int)((r.max_x - thumb.x0) / thumb.cell);
+        int gy1 = (int)((r.max_y - thumb.y0) / thumb.cell);
+        gx0 = constrain(gx0, 0, G - 1); gx1 = constrain(gx1, 0, G - 1);
+        gy0 = constrain(gy0, 0, G - 1); gy1 = constrain(gy1, 0, G - 1);
+
+        int span = max(gx1 - gx0 + 1, gy1 - gy0 + 1);
+        int px = CANVAS_SIZE / span;
+        if (px < 1) px = 1;
+        int off_x = (CANVAS_SIZE - (gx1 - gx0 + 1) * px) / 2;
+        int off_y = (CANVAS_SIZE - (gy1 - gy0 + 1) * px) / 2;
+
+        for (int gy = gy0; gy <= gy1; gy++) {
+            for (int gx = gx0; gx <= gx1; gx++) {
+                if (!thumb.get(gx, gy)) continue;
+                int x0 = off_x + (gx - gx0) * px;
+                int y0 = CANVAS_SIZE - 1 - off_y - (gy - gy0 + 1) * px + 1;  // +Y is up
+                for (int y = y0; y < y0 + px; y++) {
+                    if (y < 0 || y >= CANVAS_SIZE) continue;
+                    for (int x = x0; x < x0 + px && x < CANVAS_SIZE; x++) {
+                        canvas_buf[y * CANVAS_SIZE + x] = fg;
+                    }
+                }
+            }
+        }
+    }
+    lv_obj_invalidate(canvas);
+}
+
+void UIGCodePreview::updateStats(const GCodeAnalysis &r, bool complete) {
+    if (!stats_label) return;
+
+    char text[320];
+    if (!r.has_motion) {
+        snprintf(text, sizeof(text), "%s\nLines: %u", complete ? "No motion found" : "Analyzing...", r.line_count);
+    } else {
+        uint32_t secs = (uint32_t)(r.est_time_sec + 0.5f);
+        snprintf(text, sizeof(text),
+                 "X  %.2f to %.2f (%.2f)\n"
+                 "Y  %.2f to %.2f (%.2f)\n"
+                 "Z  %.2f to %.2f\n"
+                 "Cut: %.0f mm   Rapid: %.0f mm\n"
+                 "Lines: %u   Moves: %u\n"
+                 "%s %uh %02um %02us",
+                 r.min_x, r.max_x, r.max_x - r.min_x,
+                 r.min_y, r.max_y, r.max_y - r.min_y,
+                 r.min_z, r.max_z,
+                 r.cut_length_mm, r.rapid_length_mm,
+                 r.line_count, r.move_count,
+                 complete ? "Est. time:" : "Est. so far:",
+                 secs / 3600, (secs / 60) % 60, secs % 60);
+    }
+    lv_label_set_text(stats_label, text);
+}
+
+void UIGCodePreview::updateDryRun() {
+    static int last_progress = -1;
+    if (GCodeDryRun::isRunning()) {
+        int progress = GCodeDryRun::getState() == GCodeDryRun::State::QUERYING ? -1 : GCodeDryRun::getProgress();
+        if (progress == last_progress) return;
+        last_progress = progress;
+        lv_bar_set_value(progress_bar, progress < 0 ? 0 : progress, LV_ANIM_OFF);
+        if (progress < 0) {
+            lv_label_set_text(stats_label, "Dry run: reading offsets and limits...");
+        } else {
+            lv_label_set_text_fmt(stats_label, "Dry run: %d%%", progress);
+        }
+        return;
+    }
+
+    last_progress = -1;
+    dry_running = false;
+    lv_obj_clear_state(btn_dry_run, LV_STATE_DISABLED);
+    showDryRunReport();
+}
+
+void UIGCodePreview::showDryRunReport() {
+    if (GCodeDryRun::getState() != GCodeDryRun::State::DONE) {
+        lv_label_set_text(stats_label, "Dry run: could not read file");
+        lv_obj_set_style_text_color(stats_label, UITheme::UI_WARNING, 0);
+        return;
+    }
+    lv_bar_set_value(progress_bar, 100, LV_ANIM_OFF);
+
+    const GCodeSimReport &r = GCodeDryRun::getReport();
+    uint32_t total = r.total();
+    char text[512];
+    int len;
+    if (total == 0) {
+        len = snprintf(text, sizeof(text), "Dry run: no problems found\n%u lines, %u moves", r.line_count, r.move_count);
+    } else {
+        len = snprintf(text, sizeof(text), "Dry run: %u problem%s", total, total == 1 ? "" : "s");
+    }
+
+    // First problems of each kind, in kind order
+    int shown = 0;
+    for (int k = 0; k < SIM_KIND_COUNT; k++) {
+        for (int i = 0; i < r.stored(k) && shown < DRY_RUN_ISSUE_LINES; i++, shown++) {
+            len += snprintf(text + len, sizeof(text) - len, "\nLine %u: %s", r.issues[k][i].line, r.issues[k][i].text);
+        }
+    }
+    if (total > (uint32_t)shown) {
+        len += snprintf(text + len, sizeof(text) - len, "\n(+%u more)", total - shown);
+    }
+    if (!GCodeDryRun::hasMachineSetup()) {
+        snprintf(text + len, sizeof(text) - len, "\nMachine busy or offline: work offset only, no limits");
+    }
+
+    lv_label_set_text(stats_label, text);
+    lv_obj_set_style_text_color(stats_label, total == 0 ? UITheme::UI_SUCCESS : UITheme::UI_WARNING, 0);
+}
+
+void UIGCodePreview::dry_run_event_cb(lv_event_t *e) {
+    if (!GCodeDryRun::start(preview_path, preview_display_sd)) {
+        showDryRunReport();
+        return;
+    }
+    dry_running = true;
+    lv_obj_add_state(btn_dry_run, LV_STATE_DISABLED);
+    lv_obj_set_style_text_color(stats_label, UITheme::TEXT_LIGHT, 0);
+}
+
+void UIGCodePreview::close_event_cb(lv_event_t *e) {
+    // A running job keeps going and ends up in the cache - a dry run is only for this dialog
+    waiting = false;
+    if (dry_running) {
+        GCodeDryRun::cancel();
+        dry_running = false;
+    }
+    if (dialog) {
+        lv_obj_delete(dialog);
+        dialog = nullptr;
+        canvas = nullptr;
+        stats_label = nullptr;
+        progress_bar = nullptr;
+        btn_dry_run = nullptr;
+    }
+}
@@ -0,0 +1,332 @@
+#include "ui/ui_height_map.h"
+#include "ui/ui_theme.h"
+#include "ui/height_map_store.h"
+#include "ui/tabs/control/ui_tab_control_probe.h"
+#include "network/fluidnc_client.h"
+#include "network/probe_sequencer.h"
+#include "config.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Static member initialization
+lv_obj_t *UIHeightMap::dialog = nullptr;
+lv_obj_t *UIHeightMap::keyboard = nullptr;
+lv_obj_t *UIHeightMap::fields[UIHeightMap::FIELD_COUNT] = {nullptr};
+lv_obj_t *UIHeightMap::enable_switch = nullptr;
+lv_obj_t *UIHeightMap::status_label = nullptr;
+lv_obj_t *UIHeightMap::range_label = nullptr;
+lv_obj_t *UIHeightMap::canvas = nullptr;
+uint16_t *UIHeightMap::canvas_buf = nullptr;
+uint32_t UIHeightMap::shown_changes = 0;
+bool UIHeightMap::was_probing = false;
+
+static const int CANVAS_SIZE = 200;
+
+// Field order: X Start, Y Start, Width, Height, Points X, Points Y (two per row)
+static const char *FIELD_LABELS[6] = {"X Start:", "Y Start:", "Width:", "Height:", "Points X:", "Points Y:"};
+
+void UIHeightMap::show() {
+    if (dialog) return;
+    HeightMapStore::load();
+
+    if (!canvas_buf) {
+        canvas_buf = (uint16_t*)heap_caps_malloc(CANVAS_SIZE * CANVAS_SIZE * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!canvas_buf) {
+            Serial.println("[HeightMap] Failed to allocate heat map buffer");
+            return;
+        }
+    }
+
+    // Create modal background
+    dialog = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(dialog, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(dialog, lv_color_make(0, 0, 0), 0);
+    lv_obj_set_style_bg_opa(dialog, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(dialog, 0, 0);
+    lv_obj_clear_flag(dialog, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Dialog content box
+    lv_obj_t *content = lv_obj_create(dialog);
+    lv_obj_set_size(content, 700, 400);
+    lv_obj_center(content);
+    lv_obj_set_style_bg_color(content, UITheme::BG_MEDIUM, 0);
+    lv_obj_set_style_border_color(content, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_set_style_border_width(content, 3, 0);
+    lv_obj_set_style_pad_all(content, 15, 0);
+    lv_obj_clear_flag(content, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *title = lv_label_create(content);
+    lv_label_set_text(title, "Height Map");
+    lv_obj_set_style_text_font(title, &lv_font_montserrat_22, 0);
+    lv_obj_set_style_text_color(title, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    // Grid fields - defaults from the stored map
+    const HeightMap &map = HeightMapStore::getMap();
+    float values[FIELD_COUNT] = {0.0f, 0.0f, 50.0f, 50.0f, 5.0f, 5.0f};
+    if (map.isValid()) {
+        values[0] = map.getX0();
+        values[1] = map.getY0();
+        values[2] = map.getWidth();
+        values[3] = map.getHeight();
+        values[4] = (float)map.getNX();
+        values[5] = (float)map.getNY();
+    }
+
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        int x = (i % 2) * 195;
+        int y = 45 + (i / 2) * 55;
+
+        lv_obj_t *label = lv_label_create(content);
+        lv_label_set_text(label, FIELD_LABELS[i]);
+        lv_obj_set_style_text_font(label, &lv_font_montserrat_18, 0);
+        lv_obj_set_style_text_color(label, UITheme::TEXT_LIGHT, 0);
+        lv_obj_set_pos(label, x, y + 11);
+
+        bool count = i >= 4;
+        char buf[16];
+        snprintf(buf, sizeof(buf), count ? "%.0f" : "%.3f", values[i]);
+
+        lv_obj_t *ta = lv_textarea_create(content);
+        lv_textarea_set_one_line(ta, true);
+        lv_obj_set_style_text_font(ta, &lv_font_montserrat_18, 0);
+        lv_textarea_set_text(ta, buf);
+        lv_textarea_set_accepted_chars(ta, count ? "0123456789" : "0123456789.-");
+        lv_obj_set_size(ta, 85, 45);
+        lv_obj_set_pos(ta, x + 95, y);
+        lv_obj_clear_flag(ta, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_event_cb(ta, [](lv_event_t *e) {
+            lv_keyboard_set_textarea(keyboard, (lv_obj_t*)lv_event_get_target(e));
+            lv_obj_clear_flag(keyboard, LV_OBJ_FLAG_HIDDEN);
+        }, LV_EVENT_FOCUSED, nullptr);
+        fields[i] = ta;
+    }
+
+    // Compensation for Display SD jobs (only with a complete map)
+    enable_switch = lv_switch_create(content);
+    lv_obj_set_pos(enable_switch, 0, 215);
+    lv_obj_add_event_cb(enable_switch, [](lv_event_t *e) {
+        HeightMapStore::setEnabled(lv_obj_has_state(enable_switch, LV_STATE_CHECKED));
+    }, LV_EVENT_VALUE_CHANGED, nullptr);
+    lv_obj_t *enable_label = lv_label_create(content);
+    lv_label_set_text(enable_label, "Apply to Display SD jobs");
+    lv_obj_set_style_text_font(enable_label, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(enable_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(enable_label, 70, 217);
+
+    status_label = lv_label_create(content);
+    lv_obj_set_width(status_label, 380);
+    lv_obj_set_style_text_font(status_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(status_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_pos(status_label, 0, 260);
+
+    // Heat map
+    canvas = lv_canvas_create(content);
+    lv_canvas_set_buffer(canvas, canvas_buf, CANVAS_SIZE, CANVAS_SIZE, LV_COLOR_FORMAT_RGB565);
+    lv_obj_set_pos(canvas, 440, 40);
+
+    range_label = lv_label_create(content);
+    lv_obj_set_width(range_label, CANVAS_SIZE);
+    lv_obj_set_style_text_font(range_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(range_label, UITheme::TEXT_LIGHT, 0);
+    lv_obj_set_style_text_align(range_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_pos(range_label, 440, 245);
+
+    // Probe button
+    lv_obj_t *probe_btn = lv_button_create(content);
+    lv_obj_set_size(probe_btn, 180, 50);
+    lv_obj_align(probe_btn, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_obj_set_style_bg_color(probe_btn, UITheme::ACCENT_PRIMARY, 0);
+    lv_obj_add_event_cb(probe_btn, probe_event_cb, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *probe_lbl = lv_label_create(probe_btn);
+    lv_label_set_text(probe_lbl, "Probe Grid");
+    lv_obj_set_style_text_font(probe_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(probe_lbl);
+
+    // Close button
+    lv_obj_t *close_btn = lv_button_create(content);
+    lv_obj_set_size(close_btn, 150, 50);
+    lv_obj_align(close_btn, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_set_style_bg_color(close_btn, UITheme::BG_BUTTON, 0);
+    lv_obj_add_event_cb(close_btn, close_event_cb, LV_EVENT_CLICKED, nullptr);
+    lv_obj_t *close_lbl = lv_label_create(close_btn);
+    lv_label_set_text(close_lbl, "Close");
+    lv_obj_set_style_text_font(close_lbl, &lv_font_montserrat_18, 0);
+    lv_obj_center(close_lbl);
+
+    // Numeric keyboard for the grid fields (hidden until a field is focused)
+    keyboard = lv_keyboard_create(dialog);
+    lv_obj_set_size(keyboard, SCREEN_WIDTH, 220);
+    lv_obj_align(keyboard, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_text_font(keyboard, &lv_font_montserrat_20, 0);
+    lv_keyboard_set_mode(keyboard, LV_KEYBOARD_MODE_NUMBER);
+    lv_obj_add_flag(keyboard, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_event_cb(keyboard, [](lv_event_t *e) {
+        lv_obj_t *ta = lv_keyboard_get_textarea(keyboard);
+        lv_obj_add_flag(keyboard, LV_OBJ_FLAG_HIDDEN);
+        if (ta) lv_obj_clear_state(ta, LV_STATE_FOCUSED);
+    }, LV_EVENT_READY, nullptr);
+    lv_obj_add_event_cb(keyboard, [](lv_event_t *e) {
+        lv_obj_t *ta = lv_keyboard_get_textarea(keyboard);
+        lv_obj_add_flag(keyboard, LV_OBJ_FLAG_HIDDEN);
+        if (ta) lv_obj_clear_state(ta, LV_STATE_FOCUSED);
+    }, LV_EVENT_CANCEL, nullptr);
+
+    shown_changes = ProbeSequencer::getChangeCount();
+    was_probing = HeightMapStore::isProbing();
+    if (was_probing) lv_label_set_text(status_label, ProbeSequencer::getMessage());
+    updateMapInfo();
+}
+
+void UIHeightMap::update() {
+    if (!dialog) return;
+
+    uint32_t changes = ProbeSequencer::getChangeCount();
+    if (changes != shown_changes) {
+        shown_changes = changes;
+        if (was_probing || HeightMapStore::isProbing()) {
+            lv_label_set_text(status_label, ProbeSequencer::getMessage());
+        }
+    }
+
+    // Grid finished or stopped - HeightMapStore has saved it or gone back to the saved map
+    bool probing = HeightMapStore::isProbing();
+    if (was_probing && !probing) {
+        updateMapInfo();
+        lv_label_set_text(status_label, ProbeSequencer::getMessage());
+    }
+    was_probing = probing;
+}
+
+void UIHeightMap::updateMapInfo() {
+    const HeightMap &map = HeightMapStore::getMap();
+    bool complete = map.isComplete() && !HeightMapStore::isProbing();
+
+    if (complete) {
+        lv_obj_clear_state(enable_switch, LV_STATE_DISABLED);
+    } else {
+        lv_obj_add_state(enable_switch, LV_STATE_DISABLED);
+    }
+    if (HeightMapStore::isEnabled()) {
+        lv_obj_add_state(enable_switch, LV_STATE_CHECKED);
+    } else {
+        lv_obj_clear_state(enable_switch, LV_STATE_CHECKED);
+    }
+
+    if (complete) {
+        float min, max;
+        map.range(min, max);
+        lv_label_set_text_fmt(range_label, "%dx%d  Z %.3f .. %.3f", map.getNX(), map.getNY(), min, max);
+        if (!was_probing) {
+            lv_label_set_text_fmt(status_label, "Map %.1f x %.1f at X%.1f Y%.1f",
+                                  map.getWidth(), map.getHeight(), map.getX0(), map.getY0());
+        }
+    } else {
+        lv_label_set_text(range_label, "No height map");
+        if (!was_probing) lv_label_set_text(status_label, "Set Z0 on the surface, then probe the grid");
+    }
+    renderMap();
+}
+
+void UIHeightMap::renderMap() {
+    if (!canvas || !canvas_buf) return;
+
+    uint16_t bg = lv_color_to_u16(UITheme::BG_BLACK);
+    for (int i = 0; i < CANVAS_SIZE * CANVAS_SIZE; i++) canvas_buf[i] = bg;
+
+    const HeightMap &map = HeightMapStore::getMap();
+    if (map.isComplete() && !HeightMapStore::isProbing()) {
+        float min, max;
+        map.range(min, max);
+        float span = max - min;
+
+        // Fit the grid to the canvas, keeping the aspect ratio
+        float w = map.getWidth();
+        float h = map.getHeight();
+        float scale = (CANVAS_SIZE - 1) / (w > h ? w : h);
+        int pw = (int)(w * scale) + 1;
+        int ph = (int)(h * scale) + 1;
+        int off_x = (CANVAS_SIZE - pw) / 2;
+        int off_y = (CANVAS_SIZE - ph) / 2;
+
+        for (int py = 0; py < ph; py++) {
+            float y = map.getY0() + (ph - 1 - py) / scale;      // +Y is up
+            uint16_t *row = canvas_buf + (off_y + py) * CANVAS_SIZE + off_x;
+            for (int px = 0; px < pw; px++) {
+                float t = span > 0.0f ? (map.zAt(map.getX0() + px / scale, y) - min) / span : 0.5f;
+                // Blue (low) to red (high) through green
+                uint8_t r = (uint8_t)(t > 0.5f ? (t - 0.5f) * 510.0f : 0.0f);
+                uint8_t g = (uint8_t)(t < 0.5f ? t * 510.0f : (1.0f - t) * 510.0f);
+                uint8_t b = (uint8_t)(t < 0.5f ? (0.5f - t) * 510.0f : 0.0f);
+                row[px] = lv_color_to_u16(lv_color_make(r, g, b));
+            }
+        }
+
+        // Grid points
+        uint16_t dot = lv_color_to_u16(UITheme::TEXT_LIGHT);
+        for (int j = 0; j < map.getNY(); j++) {
+            for (int i = 0; i < map.getNX(); i++) {
+                int px = off_x + (int)((map.pointX(i) - map.getX0()) * scale);
+                int py = off_y + ph - 1 - (int)((map.pointY(j) - map.getY0()) * scale);
+                if (px >= 0 && px < CANVAS_SIZE && py >= 0 && py < CANVAS_SIZE) {
+                    canvas_buf[py * CANVAS_SIZE + px] = dot;
+                }
+            }
+        }
+    }
+    lv_obj_invalidate(canvas);
+}
+
+void UIHeightMap::probe_event_cb(lv_event_t *e) {
+    if (!FluidNCClient::isConnected()) {
+        lv_label_set_text(status_label, "Error: Not connected to FluidNC");
+        return;
+    }
+    if (ProbeSequencer::isRunning()) {
+        lv_label_set_text(status_label, "Error: A probe routine is running");
+        return;
+    }
+
+    ProbeParams params;
+    if (!UITabControlProbe::readParams(params)) {
+        lv_label_set_text(status_label, "Error: Invalid probe feed rate or distance");
+        return;
+    }
+
+    float values[FIELD_COUNT];
+    for (int i = 0; i < FIELD_COUNT; i++) values[i] = atof(lv_textarea_get_text(fields[i]));
+    int nx = (int)values[4];
+    int ny = (int)values[5];
+    if (nx < HeightMap::MIN_SIDE || nx > HeightMap::MAX_SIDE || ny < HeightMap::MIN_SIDE || ny > HeightMap::MAX_SIDE ||
+        values[2] <= 0.0f || values[3] <= 0.0f) {
+        lv_label_set_text_fmt(status_label, "Error: Size must be > 0 and points %d-%d",
+                              HeightMap::MIN_SIDE, HeightMap::MAX_SIDE);
+        return;
+    }
+
+    lv_obj_add_flag(keyboard, LV_OBJ_FLAG_HIDDEN);
+    if (!HeightMapStore::startProbe(values[0], values[1], values[2], values[3], nx, ny, params)) {
+        lv_label_set_text(status_label, "Error: Could not start grid probing");
+        return;
+    }
+
+    // The old map is gone while probing
+    was_probing = true;
+    shown_changes = ProbeSequencer::getChangeCount();
+    lv_label_set_text(status_label, ProbeSequencer::getMessage());
+    updateMapInfo();
+}
+
+void UIHeightMap::close_event_cb(lv_event_t *e) {
+    // Probing keeps going - the result shows up the next time the dialog opens
+    if (dialog) {
+        lv_obj_delete(dialog);
+        dialog = nullptr;
+        keyboard = nullptr;
+        for (int i = 0; i < FIELD_COUNT; i++) fields[i] = nullptr;
+        enable_switch = nullptr;
+        status_label = nullptr;
+        range_label = nullptr;
+        canvas = nullptr;
+    }
+}
@@ -9,16 +9,16 @@
 // Static member initialization
 lv_obj_t *UIMachineSelect::screen = nullptr;
 lv_display_t *UIMachineSelect::display = nullptr;
-MachineConfig UIMachineSelect::machines[MAX_MACHINES];
 bool UIMachineSelect::edit_mode = false;
 lv_obj_t *UIMachineSelect::edit_mode_button = nullptr;
 lv_obj_t *UIMachineSelect::list_container = nullptr;  // Machine list container
-lv_obj_t *UIMachineSelect::machine_buttons[MAX_MACHINES] = {nullptr};
-lv_obj_t *UIMachineSelect::edit_buttons[MAX_MACHINES] = {nullptr};
-lv_obj_t *UIMachineSelect::move_up_buttons[MAX_MACHINES] = {nullptr};
-lv_obj_t *UIMachineSelect::move_down_buttons[MAX_MACHINES] = {nullptr};
-lv_obj_t *UIMachineSelect::delete_buttons[MAX_MACHINES] = {nullptr};
+lv_obj_t *UIMachineSelect::rows[ROW_POOL] = {nullptr};
+int UIMachineSelect::row_bound[ROW_POOL] = {0};
+int UIMachineSelect::row_count = 0;
+int UIMachineSelect::visible[MAX_MACHINES] = {0};
+int UIMachineSelect::visible_count = 0;
 lv_obj_t *UIMachineSelect::add_button = nullptr;
+lv_obj_t *UIMachineSelect::ta_search = nullptr;
 lv_obj_t *UIMachineSelect::config_dialog = nullptr;
 lv_obj_t *UIMachineSelect::dialog_content = nullptr;
 lv_obj_t *UIMachineSelect::keyboard = nullptr;
@@ -32,6 +32,27 @@ lv_obj_t *UIMachineSelect::dd_connection_type = nullptr;
 lv_obj_t *UIMachineSelect::delete_dialog = nullptr;
 int UIMachineSelect::deleting_index = -1;
 
+// List geometry (list container is 760x395 with 20px padding)
+static const int LIST_VIEW_HEIGHT = 355;
+static const int CARD_WIDTH = 349;
+static const int CARD_HEIGHT = 167;
+static const int CARD_PITCH = CARD_HEIGHT + 20;   // Normal mode: 2 cards per row
+static const int EDIT_ROW_HEIGHT = 60;
+static const int EDIT_ROW_PITCH = EDIT_ROW_HEIGHT + 5;
+
+// Slot index stored in the user data of the clicked button
+static int eventIndex(lv_event_t *e) {
+    return (int)(intptr_t)lv_obj_get_user_data((lv_obj_t*)lv_event_get_current_target(e));
+}
+
+static bool containsNoCase(const char *text, const char *pattern) {
+    size_t n = strlen(pattern);
+    for (; *text; text++) {
+        if (strncasecmp(text, pattern, n) == 0) return true;
+    }
+    return n == 0;
+}
+
 void UIMachineSelect::show(lv_display_t *disp) {
     display = disp;
     Serial.println("UIMachineSelect: Creating machine selection screen");
@@ -39,8 +60,7 @@ void UIMachineSelect::show(lv_display_t *disp) {
     // Initialize edit mode to false
     edit_mode = false;
     
-    // Load machines from Preferences
-    MachineConfigManager::loadMachines(machines);
+    uint32_t start_ms = millis();
     
     // Create screen
     screen = lv_obj_create(nullptr);
@@ -53,6 +73,17 @@ void UIMachineSelect::show(lv_display_t *disp) {
     lv_obj_set_style_text_color(title, UITheme::TEXT_LIGHT, 0);
     lv_obj_align(title, LV_ALIGN_TOP_LEFT, 20, 15);
     
+    // Search field - filters by name or URL/IP, Enter jumps to a single match
+    ta_search = lv_textarea_create(screen);
+    lv_obj_set_size(ta_search, 250, 45);
+    lv_obj_set_pos(ta_search, 265, 11);
+    lv_textarea_set_one_line(ta_search, true);
+    lv_textarea_set_max_length(ta_search, 31);
+    lv_textarea_set_placeholder_text(ta_search, "Search name or IP");
+    lv_obj_set_style_text_font(ta_search, &lv_font_montserrat_18, 0);
+    lv_obj_add_event_cb(ta_search, onSearchChanged, LV_EVENT_VALUE_CHANGED, nullptr);
+    lv_obj_add_event_cb(ta_search, onSearchFocused, LV_EVENT_FOCUSED, nullptr);
+    
     // Button container for right-aligned buttons
     lv_obj_t *btn_container = lv_obj_create(screen);
     lv_obj_set_size(btn_container, LV_SIZE_CONTENT, 45);
@@ -111,7 +142,9 @@ void UIMachineSelect::show(lv_display_t *disp) {
     lv_obj_set_style_border_color(list_container, UITheme::BORDER_MEDIUM, 0);
     lv_obj_set_style_pad_all(list_container, 20, 0);  // Doubled padding (was 10, now 20)
     lv_obj_align(list_container, LV_ALIGN_BOTTOM_MID, 0, -20);  // Moved up 10px (was -10, now -20)
-    lv_obj_clear_flag(list_container, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(list_container, LV_DIR_VER);  // Scrolls once there are more than 4 machines
+    lv_obj_set_layout(list_container, LV_LAYOUT_NONE);   // Rows are positioned by updateRows()
+    lv_obj_add_event_cb(list_container, onListScroll, LV_EVENT_SCROLL, nullptr);
     
     refreshMachineList();
     
@@ -129,31 +162,27 @@ void UIMachineSelect::show(lv_display_t *disp) {
         lv_timer_set_repeat_count(timer, 1);
     }
     
-    Serial.println("UIMachineSelect: Machine selection screen displayed");
+    Serial.printf("UIMachineSelect: Machine selection screen displayed (%lu ms)\n", millis() - start_ms);
 }
 
 void UIMachineSelect::hide() {
+    hideKeyboard();
     if (screen) {
         lv_obj_del(screen);
         screen = nullptr;
+        ta_search = nullptr;
+        row_count = 0;
     }
 }
 
 void UIMachineSelect::refreshMachineList() {
-    Serial.println("UIMachineSelect::refreshMachineList: Starting refresh");
+    uint32_t start_us = micros();
     
-    // Clear existing buttons
+    // Clear existing rows
     lv_obj_clean(list_container);
     
     // Count configured machines
     int configured_count = getConfiguredMachineCount();
-    Serial.printf("UIMachineSelect: Found %d configured machines\n", configured_count);
-    
-    // Debug: Print each machine state
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        Serial.printf("  Machine %d: is_configured=%d, name='%s'\n", 
-                     i, machines[i].is_configured, machines[i].name);
-    }
     
     // Update Add button visibility (only show in edit mode)
     if (edit_mode && configured_count < MAX_MACHINES) {
@@ -167,202 +196,269 @@ void UIMachineSelect::refreshMachineList() {
     // Force flex container to recalculate layout
     lv_obj_update_layout(lv_obj_get_parent(add_button));
     
+    // Search only applies to the select list (edit mode shows the stored order)
     if (edit_mode) {
-        // EDIT MODE: Show control buttons with narrower machine buttons
-        // Clear flex layout for absolute positioning
-        lv_obj_set_layout(list_container, LV_LAYOUT_NONE);
-        
-        int displayed_index = 0;
-        for (int i = 0; i < MAX_MACHINES; i++) {
-            if (machines[i].is_configured) {
-                int y_pos = (displayed_index * 65); // 60px button + 5px gap (matches macro list)
-                
-                // Machine button - 30px shorter to accommodate control buttons
-                machine_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(machine_buttons[i], 458, 60);  // Reduced from 488 to 458 (-30px)
-                lv_obj_set_pos(machine_buttons[i], 0, y_pos);
-                lv_obj_set_style_bg_color(machine_buttons[i], UITheme::ACCENT_PRIMARY, 0);
-                lv_obj_set_style_bg_color(machine_buttons[i], UITheme::ACCENT_SECONDARY, LV_STATE_PRESSED);
-                // Don't add click event in edit mode - user should use Edit button instead
-                
-                // Machine label with symbol
-                lv_obj_t *label = lv_label_create(machine_buttons[i]);
-                const char *symbol = (machines[i].connection_type == CONN_WIRELESS) ? LV_SYMBOL_WIFI : LV_SYMBOL_USB;
-                String text = String(symbol) + " " + String(machines[i].name);
-                lv_label_set_text(label, text.c_str());
-                lv_obj_set_style_text_font(label, &lv_font_montserrat_22, 0);
-                lv_obj_align(label, LV_ALIGN_LEFT_MID, 10, 0);
-                
-                // Move Up button (5px gap from machine button)
-                move_up_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(move_up_buttons[i], 60, 60);  // Match macro list: 60×60
-                lv_obj_set_pos(move_up_buttons[i], 463, y_pos);  // 458 + 5px gap
-                lv_obj_set_style_bg_color(move_up_buttons[i], UITheme::BG_BUTTON, 0);
-                lv_obj_add_event_cb(move_up_buttons[i], onMoveUpMachine, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-                
-                // Disable if first item
-                if (displayed_index == 0) {
-                    lv_obj_add_state(move_up_buttons[i], LV_STATE_DISABLED);
-                }
-                
-                lv_obj_t *up_label = lv_label_create(move_up_buttons[i]);
-                lv_label_set_text(up_label, LV_SYMBOL_UP);
-                lv_obj_set_style_text_font(up_label, &lv_font_montserrat_22, 0);
-                lv_obj_center(up_label);
-                
-                // Move Down button (5px gap from up button)
-                move_down_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(move_down_buttons[i], 60, 60);  // Match macro list: 60×60
-                lv_obj_set_pos(move_down_buttons[i], 528, y_pos);  // 463 + 60 + 5px gap
-                lv_obj_set_style_bg_color(move_down_buttons[i], UITheme::BG_BUTTON, 0);
-                lv_obj_add_event_cb(move_down_buttons[i], onMoveDownMachine, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-                
-                // Disable if last item
-                if (displayed_index == configured_count - 1) {
-                    lv_obj_add_state(move_down_buttons[i], LV_STATE_DISABLED);
-                }
-                
-                lv_obj_t *down_label = lv_label_create(move_down_buttons[i]);
-                lv_label_set_text(down_label, LV_SYMBOL_DOWN);
-                lv_obj_set_style_text_font(down_label, &lv_font_montserrat_22, 0);
-                lv_obj_center(down_label);
-                
-                // Edit button (5px gap from down button)
-                edit_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(edit_buttons[i], 60, 60);  // Match macro list: 60×60
-                lv_obj_set_pos(edit_buttons[i], 593, y_pos);  // 528 + 60 + 5px gap
-                lv_obj_set_style_bg_color(edit_buttons[i], UITheme::ACCENT_SECONDARY, 0);
-                lv_obj_add_event_cb(edit_buttons[i], onEditMachine, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-                
-                lv_obj_t *edit_label = lv_label_create(edit_buttons[i]);
-                lv_label_set_text(edit_label, LV_SYMBOL_EDIT);
-                lv_obj_set_style_text_font(edit_label, &lv_font_montserrat_22, 0);
-                lv_obj_center(edit_label);
-                
-                // Delete button (5px gap from edit button)
-                delete_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(delete_buttons[i], 60, 60);  // Match macro list: 60×60
-                lv_obj_set_pos(delete_buttons[i], 658, y_pos);  // 593 + 60 + 5px gap
-                lv_obj_set_style_bg_color(delete_buttons[i], UITheme::STATE_ALARM, 0);
-                lv_obj_add_event_cb(delete_buttons[i], onDeleteMachine, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-                
-                lv_obj_t *del_label = lv_label_create(delete_buttons[i]);
-                lv_label_set_text(del_label, LV_SYMBOL_TRASH);
-                lv_obj_set_style_text_font(del_label, &lv_font_montserrat_20, 0);
-                lv_obj_center(del_label);
-                
-                displayed_index++;
-            }
-        }
+        lv_obj_add_flag(ta_search, LV_OBJ_FLAG_HIDDEN);
     } else {
-        // NORMAL MODE: Full-width machine buttons with flex layout
-        Serial.println("UIMachineSelect: NORMAL MODE - creating machine buttons");
-        
-        // Set list container to use flex layout
-        lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_ROW_WRAP);
-        lv_obj_set_flex_align(list_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
-        lv_obj_set_style_pad_gap(list_container, 20, 0);  // Doubled gap between buttons (was 10, now 20)
-        
-        // Display configured machines with flex layout
-        for (int i = 0; i < MAX_MACHINES; i++) {
-            if (machines[i].is_configured) {
-                Serial.printf("  Creating button for machine %d: %s\n", i, machines[i].name);
-                
-                // Machine button - sized for 2 rows of 2 buttons (4 machines total)
-                // Container: 720px usable (760 - 40 padding), with 20px gap = 340px per button (conservative)
-                machine_buttons[i] = lv_btn_create(list_container);
-                lv_obj_set_size(machine_buttons[i], 349, 167);  // Width: 349px (+1), Height: 167px
-                lv_obj_set_style_bg_color(machine_buttons[i], UITheme::ACCENT_PRIMARY, 0);
-                lv_obj_set_style_bg_color(machine_buttons[i], UITheme::ACCENT_SECONDARY, LV_STATE_PRESSED);
-                lv_obj_add_event_cb(machine_buttons[i], onMachineSelected, LV_EVENT_CLICKED, (void*)(intptr_t)i);
-                lv_obj_set_style_pad_all(machine_buttons[i], 20, 0);  // Double padding (was 10, now 20)
-                
-                // Line 1: Machine Name (centered, supports 2 lines)
-                lv_obj_t *name_label = lv_label_create(machine_buttons[i]);
-                lv_label_set_text(name_label, machines[i].name);
-                lv_obj_set_style_text_font(name_label, &lv_font_montserrat_32, 0);  // Large font
-                lv_obj_set_style_text_color(name_label, UITheme::TEXT_LIGHT, 0);
-                lv_label_set_long_mode(name_label, LV_LABEL_LONG_WRAP);  // Enable text wrapping
-                lv_obj_set_width(name_label, 309);  // Set width for wrapping (349 - 40px padding)
-                lv_obj_align(name_label, LV_ALIGN_TOP_MID, 0, 0);  // Centered horizontally
-                
-                // Line 2: Connection type symbol + SSID/Wired (bottom area)
-                lv_obj_t *connection_label = lv_label_create(machine_buttons[i]);
-                String connection_text;
-                if (machines[i].connection_type == CONN_WIRELESS) {
-                    connection_text = String(LV_SYMBOL_WIFI) + " " + String(machines[i].ssid);
-                } else {
-                    connection_text = String(LV_SYMBOL_USB) + " Wired";
-                }
-                lv_label_set_text(connection_label, connection_text.c_str());
-                lv_obj_set_style_text_font(connection_label, &lv_font_montserrat_26, 0);  // Larger font
-                lv_obj_set_style_text_color(connection_label, UITheme::UI_INFO, 0);
-                lv_obj_align(connection_label, LV_ALIGN_BOTTOM_LEFT, 0, -30);  // 30px from bottom
-                
-                // Line 3: FluidNC URL:Port (bottom area)
-                lv_obj_t *url_label = lv_label_create(machine_buttons[i]);
-                char url_text[128];
-                snprintf(url_text, sizeof(url_text), "%s:%d", 
-                        machines[i].fluidnc_url, machines[i].websocket_port);
-                lv_label_set_text(url_label, url_text);
-                lv_obj_set_style_text_font(url_label, &lv_font_montserrat_24, 0);  // Larger font
-                lv_obj_set_style_text_color(url_label, UITheme::TEXT_MEDIUM, 0);
-                lv_obj_align(url_label, LV_ALIGN_BOTTOM_LEFT, 0, 0);  // At bottom
-                
-                // Store null for control buttons (not displayed in normal mode)
-                move_up_buttons[i] = nullptr;
-                move_down_buttons[i] = nullptr;
-                edit_buttons[i] = nullptr;
-                delete_buttons[i] = nullptr;
+        lv_obj_clear_flag(ta_search, LV_OBJ_FLAG_HIDDEN);
+    }
+    
+    buildVisibleList();
+    
+    // Spacer gives the container the full content height; only the rows in view exist
+    int pitch = edit_mode ? EDIT_ROW_PITCH : CARD_PITCH;
+    int row_height = edit_mode ? EDIT_ROW_HEIGHT : CARD_HEIGHT;
+    int total_rows = edit_mode ? visible_count : (visible_count + 1) / 2;
+    lv_obj_t *spacer = lv_obj_create(list_container);
+    lv_obj_remove_style_all(spacer);
+    lv_obj_set_size(spacer, 1, total_rows > 0 ? (total_rows - 1) * pitch + row_height : 1);
+    lv_obj_set_pos(spacer, 0, 0);
+    lv_obj_clear_flag(spacer, LV_OBJ_FLAG_CLICKABLE);
+    
+    // Enough rows to cover the view while scrolling
+    row_count = LIST_VIEW_HEIGHT / pitch + 2;
+    if (row_count > ROW_POOL) row_count = ROW_POOL;
+    if (row_count > total_rows) row_count = total_rows;
+    for (int k = 0; k < row_count; k++) {
+        rows[k] = createRow();
+        row_bound[k] = -1;
+    }
+    
+    if (visible_count == 0 && configured_count > 0) {
+        lv_obj_t *lbl_empty = lv_label_create(list_container);
+        lv_label_set_text(lbl_empty, "No matching machines");
+        lv_obj_set_style_text_font(lbl_empty, &lv_font_montserrat_22, 0);
+        lv_obj_set_style_text_color(lbl_empty, UITheme::TEXT_MEDIUM, 0);
+        lv_obj_center(lbl_empty);
+    }
+    
+    lv_obj_update_layout(list_container);
+    updateRows();
+    Serial.printf("UIMachineSelect: %d of %d machines listed, %d rows built (%lu us)\n",
+                  visible_count, configured_count, row_count, micros() - start_us);
+}
+
+// Display order: recently used machines first (select mode only), then the stored order
+void UIMachineSelect::buildVisibleList() {
+    const char *filter = edit_mode ? "" : lv_textarea_get_text(ta_search);
+    bool listed[MAX_MACHINES] = {false};
+    visible_count = 0;
+    
+    if (!edit_mode) {
+        int recent[MACHINE_RECENT_COUNT];
+        int recent_count = MachineConfigManager::getRecentMachines(recent, MACHINE_RECENT_COUNT);
+        for (int k = 0; k < recent_count; k++) {
+            const MachineSummary &machine = MachineConfigManager::getSummary(recent[k]);
+            listed[recent[k]] = true;
+            if (containsNoCase(machine.name, filter) || containsNoCase(machine.fluidnc_url, filter)) {
+                visible[visible_count++] = recent[k];
             }
         }
     }
+    
+    for (int i = 0; i < MAX_MACHINES; i++) {
+        const MachineSummary &machine = MachineConfigManager::getSummary(i);
+        if (listed[i] || !machine.is_configured) continue;
+        if (containsNoCase(machine.name, filter) || containsNoCase(machine.fluidnc_url, filter)) {
+            visible[visible_count++] = i;
+        }
+    }
 }
 
-// Helper function: Count configured machines
-int UIMachineSelect::getConfiguredMachineCount() {
-    int count = 0;
-    for (int i = 0; i < MAX_MACHINES; i++) {
-        if (machines[i].is_configured) {
-            count++;
+// One pool row: two machine cards (select mode) or a machine button with controls (edit mode)
+lv_obj_t* UIMachineSelect::createRow() {
+    lv_obj_t *row = lv_obj_create(list_container);
+    lv_obj_remove_style_all(row);
+    lv_obj_set_size(row, 720, edit_mode ? EDIT_ROW_HEIGHT : CARD_HEIGHT);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+    
+    if (edit_mode) {
+        // Machine button - 30px shorter to accommodate control buttons
+        lv_obj_t *machine_btn = lv_btn_create(row);
+        lv_obj_set_size(machine_btn, 458, EDIT_ROW_HEIGHT);  // Reduced from 488 to 458 (-30px)
+        lv_obj_set_pos(machine_btn, 0, 0);
+        lv_obj_set_style_bg_color(machine_btn, UITheme::ACCENT_PRIMARY, 0);
+        lv_obj_set_style_bg_color(machine_btn, UITheme::ACCENT_SECONDARY, LV_STATE_PRESSED);
+        // Don't add click event in edit mode - user should use Edit button instead
+        
+        lv_obj_t *label = lv_label_create(machine_btn);
+        lv_obj_set_style_text_font(label, &lv_font_montserrat_22, 0);
+        lv_obj_align(label, LV_ALIGN_LEFT_MID, 10, 0);
+        
+        // Up, down, edit, delete - 60x60 with 5px gaps (matches macro list)
+        struct Control { const char *symbol; lv_color_t color; lv_event_cb_t cb; };
+        const Control controls[] = {
+            {LV_SYMBOL_UP, UITheme::BG_BUTTON, onMoveUpMachine},
+            {LV_SYMBOL_DOWN, UITheme::BG_BUTTON, onMoveDownMachine},
+            {LV_SYMBOL_EDIT, UITheme::ACCENT_SECONDARY, onEditMachine},
+            {LV_SYMBOL_TRASH, UITheme::STATE_ALARM, onDeleteMachine},
+        };
+        for (int c = 0; c < 4; c++) {
+            lv_obj_t *btn = lv_btn_create(row);
+            lv_obj_set_size(btn, 60, EDIT_ROW_HEIGHT);
+            lv_obj_set_pos(btn, 463 + c * 65, 0);
+            lv_obj_set_style_bg_color(btn, controls[c].color, 0);
+            lv_obj_add_event_cb(btn, controls[c].cb, LV_EVENT_CLICKED, nullptr);
+            
+            lv_obj_t *btn_label = lv_label_create(btn);
+            lv_label_set_text(btn_label, controls[c].symbol);
+            lv_obj_set_style_text_font(btn_label, c == 3 ? &lv_font_montserrat_20 : &lv_font_montserrat_22, 0);
+            lv_obj_center(btn_label);
         }
+        return row;
+    }
+    
+    for (int c = 0; c < 2; c++) {
+        lv_obj_t *card = lv_btn_create(row);
+        lv_obj_set_size(card, CARD_WIDTH, CARD_HEIGHT);
+        lv_obj_set_pos(card, c * (CARD_WIDTH + 20), 0);
+        lv_obj_set_style_bg_color(card, UITheme::ACCENT_PRIMARY, 0);
+        lv_obj_set_style_bg_color(card, UITheme::ACCENT_SECONDARY, LV_STATE_PRESSED);
+        lv_obj_add_event_cb(card, onMachineSelected, LV_EVENT_CLICKED, nullptr);
+        lv_obj_set_style_pad_all(card, 20, 0);  // Double padding (was 10, now 20)
+        
+        // Line 1: Machine Name (centered, supports 2 lines)
+        lv_obj_t *name_label = lv_label_create(card);
+        lv_obj_set_style_text_font(name_label, &lv_font_montserrat_32, 0);  // Large font
+        lv_obj_set_style_text_color(name_label, UITheme::TEXT_LIGHT, 0);
+        lv_label_set_long_mode(name_label, LV_LABEL_LONG_WRAP);  // Enable text wrapping
+        lv_obj_set_width(name_label, CARD_WIDTH - 40);  // Set width for wrapping (349 - 40px padding)
+        lv_obj_align(name_label, LV_ALIGN_TOP_MID, 0, 0);  // Centered horizontally
+        
+        // Line 2: Connection type symbol + SSID/Wired (bottom area)
+        lv_obj_t *connection_label = lv_label_create(card);
+        lv_obj_set_style_text_font(connection_label, &lv_font_montserrat_26, 0);  // Larger font
+        lv_obj_set_style_text_color(connection_label, UITheme::UI_INFO, 0);
+        lv_obj_align(connection_label, LV_ALIGN_BOTTOM_LEFT, 0, -30);  // 30px from bottom
+        
+        // Line 3: FluidNC URL:Port (bottom area)
+        lv_obj_t *url_label = lv_label_create(card);
+        lv_obj_set_style_text_font(url_label, &lv_font_montserrat_24, 0);  // Larger font
+        lv_obj_set_style_text_color(url_label, UITheme::TEXT_MEDIUM, 0);
+        lv_obj_align(url_label, LV_ALIGN_BOTTOM_LEFT, 0, 0);  // At bottom
     }
-    return count;
+    return row;
 }
 
-// Helper function: Swap two machines in the array
-void UIMachineSelect::swapMachines(int index1, int index2) {
-    if (index1 < 0 || index1 >= MAX_MACHINES || index2 < 0 || index2 >= MAX_MACHINES) {
-        Serial.printf("UIMachineSelect::swapMachines: Invalid indices %d, %d\n", index1, index2);
+// Show list row `row` (in visible[] order) in pool row `pool_index`
+void UIMachineSelect::bindRow(int pool_index, int row) {
+    lv_obj_t *obj = rows[pool_index];
+    row_bound[pool_index] = row;
+    lv_obj_set_pos(obj, 0, row * (edit_mode ? EDIT_ROW_PITCH : CARD_PITCH));
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    
+    if (edit_mode) {
+        int index = visible[row];
+        const MachineSummary &machine = MachineConfigManager::getSummary(index);
+        lv_obj_t *label = lv_obj_get_child(lv_obj_get_child(obj, 0), 0);
+        lv_label_set_text_fmt(label, "%s %s", machine.connection_type == CONN_WIRELESS ? LV_SYMBOL_WIFI : LV_SYMBOL_USB,
+                              machine.name);
+        for (int c = 1; c <= 4; c++) {
+            lv_obj_t *btn = lv_obj_get_child(obj, c);
+            lv_obj_set_user_data(btn, (void*)(intptr_t)index);
+            lv_obj_clear_state(btn, LV_STATE_DISABLED);
+        }
+        if (row == 0) lv_obj_add_state(lv_obj_get_child(obj, 1), LV_STATE_DISABLED);                  // First: no up
+        if (row == visible_count - 1) lv_obj_add_state(lv_obj_get_child(obj, 2), LV_STATE_DISABLED);  // Last: no down
         return;
     }
     
-    if (!machines[index1].is_configured || !machines[index2].is_configured) {
-        Serial.printf("UIMachineSelect::swapMachines: Cannot swap unconfigured machines\n");
-        return;
+    for (int c = 0; c < 2; c++) {
+        lv_obj_t *card = lv_obj_get_child(obj, c);
+        int item = row * 2 + c;
+        if (item >= visible_count) {
+            lv_obj_add_flag(card, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+        lv_obj_clear_flag(card, LV_OBJ_FLAG_HIDDEN);
+        
+        int index = visible[item];
+        const MachineSummary &machine = MachineConfigManager::getSummary(index);
+        lv_obj_set_user_data(card, (void*)(intptr_t)index);
+        lv_label_set_text(lv_obj_get_child(card, 0), machine.name);
+        if (machine.connection_type == CONN_WIRELESS) {
+            lv_label_set_text_fmt(lv_obj_get_child(card, 1), LV_SYMBOL_WIFI " %s", machine.ssid);
+        } else {
+            lv_label_set_text(lv_obj_get_child(card, 1), LV_SYMBOL_USB " Wired");
+        }
+        lv_label_set_text_fmt(lv_obj_get_child(card, 2), "%s:%d", machine.fluidnc_url, machine.websocket_port);
     }
+}
+
+// Rebind pool rows to the list rows in view - row r always uses pool row r % row_count
+void UIMachineSelect::updateRows() {
+    if (row_count == 0) return;
+    int pitch = edit_mode ? EDIT_ROW_PITCH : CARD_PITCH;
+    int total_rows = edit_mode ? visible_count : (visible_count + 1) / 2;
+    
+    int first = lv_obj_get_scroll_y(list_container) / pitch;
+    if (first > total_rows - row_count) first = total_rows - row_count;
+    if (first < 0) first = 0;
+    
+    for (int r = first; r < first + row_count; r++) {
+        int k = r % row_count;
+        if (row_bound[k] != r) bindRow(k, r);
+    }
+}
+
+void UIMachineSelect::onListScroll(lv_event_t *e) {
+    updateRows();
+}
+
+void UIMachineSelect::onSearchChanged(lv_event_t *e) {
+    lv_obj_scroll_to_y(list_container, 0, LV_ANIM_OFF);
+    refreshMachineList();
+}
+
+void UIMachineSelect::onSearchFocused(lv_event_t *e) {
+    if (keyboard) return;
+    keyboard = lv_keyboard_create(screen);
+    lv_obj_set_size(keyboard, SCREEN_WIDTH, 220);
+    lv_obj_align(keyboard, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_text_font(keyboard, &lv_font_montserrat_20, 0);
+    lv_keyboard_set_textarea(keyboard, ta_search);
+    lv_obj_add_event_cb(keyboard, onSearchReady, LV_EVENT_READY, nullptr);
+    lv_obj_add_event_cb(keyboard, [](lv_event_t *e) {
+        UIMachineSelect::hideKeyboard();
+    }, LV_EVENT_CANCEL, nullptr);
+}
+
+void UIMachineSelect::onSearchReady(lv_event_t *e) {
+    hideKeyboard();
+    lv_obj_clear_state(ta_search, LV_STATE_FOCUSED);
     
+    // Quick-jump: a search that leaves a single machine connects to it
+    if (visible_count == 1 && lv_textarea_get_text(ta_search)[0] != '\0') {
+        selectMachine(visible[0]);
+    }
+}
+
+// Helper function: Count configured machines
+int UIMachineSelect::getConfiguredMachineCount() {
+    return MachineConfigManager::getMachineCount();
+}
+
+// Helper function: Swap two machines in the catalog
+void UIMachineSelect::swapMachines(int index1, int index2) {
     Serial.printf("UIMachineSelect::swapMachines: Swapping %d <-> %d\n", index1, index2);
     
-    // Swap the machines
-    MachineConfig temp = machines[index1];
-    machines[index1] = machines[index2];
-    machines[index2] = temp;
-    
-    // Save to preferences
-    MachineConfigManager::saveMachines(machines);
+    if (!MachineConfigManager::swapMachines(index1, index2)) {
+        Serial.printf("UIMachineSelect::swapMachines: Cannot swap %d and %d\n", index1, index2);
+        return;
+    }
     
     // Refresh the display
     refreshMachineList();
 }
 
 void UIMachineSelect::onMoveUpMachine(lv_event_t *e) {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = eventIndex(e);
     
     // Find previous configured machine
     int prev_index = -1;
     for (int i = index - 1; i >= 0; i--) {
-        if (machines[i].is_configured) {
+        if (MachineConfigManager::getSummary(i).is_configured) {
             prev_index = i;
             break;
         }
@@ -375,12 +471,12 @@ void UIMachineSelect::onMoveUpMachine(lv_event_t *e) {
 }
 
 void UIMachineSelect::onMoveDownMachine(lv_event_t *e) {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = eventIndex(e);
     
     // Find next configured machine
     int next_index = -1;
     for (int i = index + 1; i < MAX_MACHINES; i++) {
-        if (machines[i].is_configured) {
+        if (MachineConfigManager::getSummary(i).is_configured) {
             next_index = i;
             break;
         }
@@ -409,16 +505,21 @@ void UIMachineSelect::onEditModeToggle(lv_event_t *e) {
     }
     
     // Refresh the machine list to show/hide control buttons
+    lv_obj_scroll_to_y(list_container, 0, LV_ANIM_OFF);
     refreshMachineList();
 }
 
 void UIMachineSelect::onMachineSelected(lv_event_t *e) {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    selectMachine(eventIndex(e));
+}
+
+void UIMachineSelect::selectMachine(int index) {
+    const MachineSummary &machine = MachineConfigManager::getSummary(index);
     
-    Serial.printf("UIMachineSelect: Machine selected: %s (index %d)\n", machines[index].name, index);
+    Serial.printf("UIMachineSelect: Machine selected: %s (index %d)\n", machine.name, index);
     
     // Check if WiFi password is set for wireless machines
-    if (machines[index].connection_type == CONN_WIRELESS && strlen(machines[index].password) == 0) {
+    if (machine.connection_type == CONN_WIRELESS && !machine.has_password) {
         Serial.println("UIMachineSelect: WiFi password not set!");
         
         // Create modal backdrop
@@ -456,7 +557,7 @@ void UIMachineSelect::onMachineSelected(lv_event_t *e) {
             "but none is configured.\n\n"
             "Please edit the machine configuration and set the\n"
             "WiFi password before attempting to connect.",
-            machines[index].name);
+            machine.name);
         lv_label_set_text(message, msg);
         lv_obj_set_style_text_font(message, &lv_font_montserrat_16, 0);
         lv_obj_set_style_text_color(message, UITheme::TEXT_LIGHT, 0);
@@ -503,7 +604,7 @@ void UIMachineSelect::onMachineSelected(lv_event_t *e) {
 }
 
 void UIMachineSelect::onEditMachine(lv_event_t *e) {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = eventIndex(e);
     Serial.printf("UIMachineSelect: Edit machine %d\n", index);
     showConfigDialog(index);
 }
@@ -512,7 +613,7 @@ void UIMachineSelect::onAddMachine(lv_event_t *e) {
     // Find first available unconfigured slot
     int index = -1;
     for (int i = 0; i < MAX_MACHINES; i++) {
-        if (!machines[i].is_configured) {
+        if (!MachineConfigManager::getSummary(i).is_configured) {
             index = i;
             break;
         }
@@ -527,7 +628,7 @@ void UIMachineSelect::onAddMachine(lv_event_t *e) {
 }
 
 void UIMachineSelect::onDeleteMachine(lv_event_t *e) {
-    int index = (int)(intptr_t)lv_event_get_user_data(e);
+    int index = eventIndex(e);
     Serial.printf("UIMachineSelect: Delete machine %d - showing confirmation\n", index);
     showDeleteConfirmDialog(index);
 }
@@ -536,7 +637,6 @@ void UIMachineSelect::onDeleteConfirm(lv_event_t *e) {
     Serial.printf("UIMachineSelect: Delete confirmed for machine %d\n", deleting_index);
     
     MachineConfigManager::deleteMachine(deleting_index);
-    MachineConfigManager::loadMachines(machines);
     
     hideDeleteConfirmDialog();
     refreshMachineList();
@@ -564,8 +664,13 @@ void UIMachineSelect::onConfigSave(lv_event_t *e) {
         return;
     }
     
-    // Create config
+    // Start from the stored config so jog/probe settings are kept
     MachineConfig config;
+    MachineConfigManager::getMachine(editing_index, config);
+    memset(config.name, 0, sizeof(config.name));
+    memset(config.ssid, 0, sizeof(config.ssid));
+    memset(config.password, 0, sizeof(config.password));
+    memset(config.fluidnc_url, 0, sizeof(config.fluidnc_url));
     strncpy(config.name, name, sizeof(config.name) - 1);
     config.connection_type = (sel == 0) ? CONN_WIRELESS : CONN_WIRED;
     strncpy(config.ssid, ssid, sizeof(config.ssid) - 1);
@@ -577,7 +682,6 @@ void UIMachineSelect::onConfigSave(lv_event_t *e) {
     
     // Save
     MachineConfigManager::saveMachine(editing_index, config);
-    MachineConfigManager::loadMachines(machines);
     
     hideConfigDialog();
     refreshMachineList();
@@ -608,7 +712,8 @@ void UIMachineSelect::updateConnectionFields() {
 
 void UIMachineSelect::showConfigDialog(int index) {
     editing_index = index;
-    bool is_new = !machines[index].is_configured;
+    MachineConfig machine;
+    bool is_new = !MachineConfigManager::getMachine(index, machine);
     
     // Create modal background
     config_dialog = lv_obj_create(lv_scr_act());
@@ -668,7 +773,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_textarea_set_one_line(ta_name, true);
     lv_textarea_set_max_length(ta_name, 31);
     lv_obj_set_style_text_font(ta_name, &lv_font_montserrat_18, 0);
-    if (!is_new) lv_textarea_set_text(ta_name, machines[index].name);
+    if (!is_new) lv_textarea_set_text(ta_name, machine.name);
     lv_obj_add_event_cb(ta_name, onTextareaFocused, LV_EVENT_FOCUSED, nullptr);
     
     // WiFi SSID field
@@ -682,7 +787,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_textarea_set_one_line(ta_ssid, true);
     lv_textarea_set_max_length(ta_ssid, 32);
     lv_obj_set_style_text_font(ta_ssid, &lv_font_montserrat_18, 0);
-    if (!is_new) lv_textarea_set_text(ta_ssid, machines[index].ssid);
+    if (!is_new) lv_textarea_set_text(ta_ssid, machine.ssid);
     lv_obj_add_event_cb(ta_ssid, onTextareaFocused, LV_EVENT_FOCUSED, nullptr);
     
     // FluidNC URL field
@@ -697,7 +802,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_textarea_set_max_length(ta_url, 127);
     lv_obj_set_style_text_font(ta_url, &lv_font_montserrat_18, 0);
     if (!is_new) {
-        lv_textarea_set_text(ta_url, machines[index].fluidnc_url);
+        lv_textarea_set_text(ta_url, machine.fluidnc_url);
     } else {
         lv_textarea_set_text(ta_url, "fluidnc.local");
     }
@@ -724,7 +829,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_obj_set_style_text_font(dd_connection_type, &lv_font_montserrat_18, 0);
     lv_obj_set_style_pad_top(dd_connection_type, 12, LV_PART_MAIN);  // Adjust top padding to vertically center text
     lv_dropdown_set_options(dd_connection_type, "Wireless");  // Wired option hidden for now, reserved for future
-    if (!is_new) lv_dropdown_set_selected(dd_connection_type, machines[index].connection_type);
+    if (!is_new) lv_dropdown_set_selected(dd_connection_type, machine.connection_type);
     lv_obj_add_event_cb(dd_connection_type, onConnectionTypeChanged, LV_EVENT_VALUE_CHANGED, nullptr);
     
     // Password field
@@ -739,7 +844,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_textarea_set_max_length(ta_password, 63);
     lv_textarea_set_password_mode(ta_password, true);
     lv_obj_set_style_text_font(ta_password, &lv_font_montserrat_18, 0);
-    if (!is_new) lv_textarea_set_text(ta_password, machines[index].password);
+    if (!is_new) lv_textarea_set_text(ta_password, machine.password);
     lv_obj_add_event_cb(ta_password, onTextareaFocused, LV_EVENT_FOCUSED, nullptr);
     
     // Port field
@@ -756,7 +861,7 @@ void UIMachineSelect::showConfigDialog(int index) {
     lv_obj_set_style_text_font(ta_port, &lv_font_montserrat_18, 0);
     if (!is_new) {
         char port_str[6];
-        snprintf(port_str, sizeof(port_str), "%d", machines[index].websocket_port);
+        snprintf(port_str, sizeof(port_str), "%d", machine.websocket_port);
         lv_textarea_set_text(ta_port, port_str);
     } else {
         lv_textarea_set_text(ta_port, "81");
@@ -839,7 +944,7 @@ void UIMachineSelect::showDeleteConfirmDialog(int index) {
     
     // Machine name
     lv_obj_t *name_label = lv_label_create(content);
-    lv_label_set_text_fmt(name_label, "\"%s\"", machines[index].name);
+    lv_label_set_text_fmt(name_label, "\"%s\"", MachineConfigManager::getSummary(index).name);
     lv_obj_set_style_text_font(name_label, &lv_font_montserrat_20, 0);
     lv_obj_set_style_text_color(name_label, UITheme::TEXT_LIGHT, 0);
     
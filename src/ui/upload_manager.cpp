@@ -1,6 +1,8 @@
 #include "ui/upload_manager.h"
 #include "config.h"
 #include "network/fluidnc_client.h"
+#include "network/connection_manager.h"
+#include "core/sd_card.h"
 #include <SD.h>
 #include <SPI.h>
 #include <HTTPClient.h>
@@ -66,37 +68,8 @@ bool UploadManager::ensureDirectoryExists(const String& machineIP, const String&
 }
 
 bool UploadManager::init() {
-    Serial.println("[UploadManager] Initializing SD card...");
-    
-#ifdef HARDWARE_ADVANCE
-    Serial.println("[UploadManager] Advance: SPI mode (MOSI=6, MISO=4, CLK=5, CS=0/GND)");
-    // CS is GPIO 0 per Elecrow example, though physically tied to GND
-    SPI.begin(SD_CLK, SD_MISO, SD_MOSI, SD_CS);
-    if (!SD.begin(SD_CS, SPI, 4000000, "/sd", 5, false)) {
-#else
-    Serial.println("[UploadManager] Basic: SPI mode (MOSI=11, MISO=13, CLK=12, CS=10)");
-    SPI.begin(SD_CLK, SD_MISO, SD_MOSI, SD_CS);
-    if (!SD.begin(SD_CS, SPI, 4000000, "/sd", 5, false)) {  // Use configured CS pin
-#endif
-        Serial.println("[UploadManager] SD Card mount failed");
-        return false;
-    }
-    
-    uint8_t cardType = SD.cardType();
-    if (cardType == CARD_NONE) {
-        Serial.println("[UploadManager] No SD card attached");
-        return false;
-    }
-    
-    Serial.printf("[UploadManager] SD Card Type: %s\n",
-                 cardType == CARD_MMC ? "MMC" :
-                 cardType == CARD_SD ? "SDSC" :
-                 cardType == CARD_SDHC ? "SDHC" : "UNKNOWN");
-    
-    uint64_t cardSize = SD.cardSize() / (1024 * 1024);
-    Serial.printf("[UploadManager] SD Card Size: %lluMB\n", cardSize);
-    
-    return true;
+    // Mounting and bus clock selection live in SDCard (cheap when already mounted)
+    return SDCard::mount();
 }
 
 bool UploadManager::uploadFile(const char* localPath, 
@@ -113,9 +86,9 @@ bool UploadManager::uploadFile(const char* localPath,
     
     Serial.printf("[UploadManager] Starting upload of %s\n", localPath);
     
-    // Open local file
-    File file = SD.open(localPath);
-    if (!file) {
+    // Open local file (through the block cache, like every other Display SD read)
+    SDReader file;
+    if (!file.open(localPath)) {
         Serial.println("[UploadManager] Failed to open local file");
         _uploading = false;
         if (onComplete) onComplete(false, "Failed to open local file");
@@ -156,6 +129,12 @@ bool UploadManager::uploadFile(const char* localPath,
         return false;
     }
     
+    // Reuse the address the WebSocket was opened to (already resolved, possibly from cache)
+    const char *resolvedHost = ConnectionManager::getResolvedHost();
+    if (resolvedHost[0] != '\0') {
+        machineIP = resolvedHost;
+    }
+    
     // Resolve hostname if needed
     IPAddress serverIP;
     if (machineIP.indexOf('.') == -1) {
@@ -269,11 +248,16 @@ bool UploadManager::uploadFile(const char* localPath,
     size_t lastReportedPercent = 0;
     bool success = true;
     
-    while (file.available()) {
-        size_t bytesRead = file.read(buffer, CHUNK_SIZE);
+    while (file.position() < file.size()) {
+        int bytesRead = file.read(buffer, CHUNK_SIZE);
+        if (bytesRead <= 0) {
+            Serial.println("[UploadManager] Read error");
+            success = false;
+            break;
+        }
         size_t bytesWritten = client.write(buffer, bytesRead);
         
-        if (bytesWritten != bytesRead) {
+        if (bytesWritten != (size_t)bytesRead) {
             Serial.println("[UploadManager] Write error");
             success = false;
             break;
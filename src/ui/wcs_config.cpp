@@ -1,12 +1,24 @@
 #include "ui/wcs_config.h"
 #include "ui/machine_config.h"
 #include "network/fluidnc_client.h"
+#include "ui/settings_store.h"
 #include <Preferences.h>
 
-void WCSConfig::loadWCSConfig(int machine_index, char names[6][32], bool locks[6]) {
+// In-RAM copy of one machine's WCS names/locks (read on every status update via
+// isCurrentWCSLocked/getCurrentWCSName; edits are written back by SettingsStore)
+static int cached_machine = -1;
+static char cached_names[6][32];
+static bool cached_locks[6];
+static bool cache_dirty = false;
+
+static void wcsNamespace(char *buf, size_t len, int machine_index) {
+    snprintf(buf, len, "machine_%d", machine_index);
+}
+
+static void readWCS(int machine_index, char names[6][32], bool locks[6]) {
     Preferences prefs;
     char namespace_name[32];
-    snprintf(namespace_name, sizeof(namespace_name), "machine_%d", machine_index);
+    wcsNamespace(namespace_name, sizeof(namespace_name), machine_index);
     
     prefs.begin(namespace_name, true);  // Read-only
     
@@ -31,10 +43,10 @@ void WCSConfig::loadWCSConfig(int machine_index, char names[6][32], bool locks[6
     prefs.end();
 }
 
-void WCSConfig::saveWCSConfig(int machine_index, const char names[6][32], const bool locks[6]) {
+static void writeWCS(int machine_index, const char names[6][32], const bool locks[6]) {
     Preferences prefs;
     char namespace_name[32];
-    snprintf(namespace_name, sizeof(namespace_name), "machine_%d", machine_index);
+    wcsNamespace(namespace_name, sizeof(namespace_name), machine_index);
     
     prefs.begin(namespace_name, false);  // Read-write
     
@@ -50,44 +62,61 @@ void WCSConfig::saveWCSConfig(int machine_index, const char names[6][32], const
     prefs.end();
 }
 
+// SettingsStore commit for edits made through saveWCSName/saveWCSLock
+static void commitWCS() {
+    if (!cache_dirty) return;
+    writeWCS(cached_machine, cached_names, cached_locks);
+    cache_dirty = false;
+}
+
+static void ensureCached(int machine_index) {
+    if (cached_machine == machine_index) return;
+    commitWCS();  // Edits of the previously cached machine
+    readWCS(machine_index, cached_names, cached_locks);
+    cached_machine = machine_index;
+}
+
+void WCSConfig::loadWCSConfig(int machine_index, char names[6][32], bool locks[6]) {
+    ensureCached(machine_index);
+    memcpy(names, cached_names, sizeof(cached_names));
+    memcpy(locks, cached_locks, sizeof(cached_locks));
+}
+
+void WCSConfig::saveWCSConfig(int machine_index, const char names[6][32], const bool locks[6]) {
+    // Bulk save (settings import) - written through
+    writeWCS(machine_index, names, locks);
+    if (cached_machine == machine_index) {
+        memcpy(cached_names, names, sizeof(cached_names));
+        memcpy(cached_locks, locks, sizeof(cached_locks));
+        cache_dirty = false;
+    }
+}
+
 void WCSConfig::saveWCSName(int machine_index, int wcs_index, const char* name) {
     if (wcs_index < 0 || wcs_index >= 6) return;
     
-    Preferences prefs;
-    char namespace_name[32];
-    snprintf(namespace_name, sizeof(namespace_name), "machine_%d", machine_index);
-    
-    prefs.begin(namespace_name, false);  // Read-write
-    
-    char key_name[16];
-    snprintf(key_name, sizeof(key_name), "wcs_g5%d_name", 4 + wcs_index);
-    prefs.putString(key_name, name);
-    
-    prefs.end();
+    ensureCached(machine_index);
+    if (strncmp(cached_names[wcs_index], name, 31) == 0) return;
+    strncpy(cached_names[wcs_index], name, 31);
+    cached_names[wcs_index][31] = '\0';
+    cache_dirty = true;
+    SettingsStore::schedule(commitWCS);
 }
 
 void WCSConfig::saveWCSLock(int machine_index, int wcs_index, bool locked) {
     if (wcs_index < 0 || wcs_index >= 6) return;
     
-    Preferences prefs;
-    char namespace_name[32];
-    snprintf(namespace_name, sizeof(namespace_name), "machine_%d", machine_index);
-    
-    prefs.begin(namespace_name, false);  // Read-write
-    
-    char key_lock[16];
-    snprintf(key_lock, sizeof(key_lock), "wcs_g5%d_lock", 4 + wcs_index);
-    prefs.putBool(key_lock, locked);
-    
-    prefs.end();
+    ensureCached(machine_index);
+    if (cached_locks[wcs_index] == locked) return;
+    cached_locks[wcs_index] = locked;
+    cache_dirty = true;
+    SettingsStore::schedule(commitWCS);
 }
 
 bool WCSConfig::isCurrentWCSLocked() {
     // Get current WCS from FluidNC status
     const FluidNCStatus& status = FluidNCClient::getStatus();
-    int wcs_index = getWCSIndex(status.modal_wcs);
-    
-    if (wcs_index < 0) return false;  // Invalid WCS
+    int wcs_index = status.modal.wcs;
     
     // Load WCS configuration for current machine
     int machine_index = MachineConfigManager::getSelectedMachineIndex();
@@ -101,12 +130,7 @@ bool WCSConfig::isCurrentWCSLocked() {
 void WCSConfig::getCurrentWCSName(char* name_out, size_t max_len) {
     // Get current WCS from FluidNC status
     const FluidNCStatus& status = FluidNCClient::getStatus();
-    int wcs_index = getWCSIndex(status.modal_wcs);
-    
-    if (wcs_index < 0) {
-        name_out[0] = '\0';
-        return;
-    }
+    int wcs_index = status.modal.wcs;
     
     // Load WCS configuration for current machine
     int machine_index = MachineConfigManager::getSelectedMachineIndex();
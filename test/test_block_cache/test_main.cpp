@@ -0,0 +1,207 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "core/block_cache.h"
+
+// BlockSource over a host file, counting the reads that reach it
+class HostFileSource : public BlockSource {
+public:
+    FILE *file = nullptr;
+    int reads = 0;
+
+    bool readAt(uint32_t offset, uint8_t *buf, size_t len) override {
+        reads++;
+        return fseek(file, offset, SEEK_SET) == 0 && fread(buf, 1, len, file) == len;
+    }
+};
+
+static const char *PATH = "test_block_cache.bin";
+static std::vector<uint8_t> storage((size_t)SD_CACHE_BLOCKS * SD_BLOCK_SIZE);
+static BlockCache cache;
+static HostFileSource source;
+
+static std::vector<uint8_t> pattern(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) data[i] = (uint8_t)(i * 31 + seed + i / 251);
+    return data;
+}
+
+static void writeFile(const std::vector<uint8_t> &data) {
+    if (source.file) fclose(source.file);
+    FILE *f = fopen(PATH, "wb");
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+    source.file = fopen(PATH, "rb");
+    source.reads = 0;
+}
+
+static std::vector<uint8_t> readAll(uint32_t size, size_t chunk, BlockCache::Stats &stats) {
+    std::vector<uint8_t> out(size);
+    uint32_t pos = 0;
+    while (pos < size) {
+        int n = cache.read(source, BlockCache::hashPath(PATH), size, pos, out.data() + pos, chunk, stats);
+        if (n <= 0) break;
+        pos += n;
+    }
+    out.resize(pos);
+    return out;
+}
+
+void setUp() {
+    cache.attach(storage.data());
+}
+
+void tearDown() {
+    if (source.file) fclose(source.file);
+    source.file = nullptr;
+    remove(PATH);
+}
+
+static void test_reads_match_file() {
+    // Odd size and chunk so reads straddle blocks and the last block is short
+    std::vector<uint8_t> data = pattern(3 * SD_BLOCK_SIZE + 123, 1);
+    writeFile(data);
+    BlockCache::Stats stats;
+    std::vector<uint8_t> out = readAll(data.size(), 1000, stats);
+    TEST_ASSERT_EQUAL_UINT32(data.size(), out.size());
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), data.size());
+    TEST_ASSERT_EQUAL_UINT32(4, stats.misses);
+    TEST_ASSERT_EQUAL_INT(4, source.reads);
+}
+
+static void test_second_pass_hits_cache() {
+    std::vector<uint8_t> data = pattern(2 * SD_BLOCK_SIZE, 2);
+    writeFile(data);
+    BlockCache::Stats stats;
+    readAll(data.size(), SD_BLOCK_SIZE, stats);
+    source.reads = 0;
+    std::vector<uint8_t> out = readAll(data.size(), 512, stats);
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), data.size());
+    TEST_ASSERT_EQUAL_INT(0, source.reads);
+}
+
+static void test_end_of_file() {
+    std::vector<uint8_t> data = pattern(100, 3);
+    writeFile(data);
+    BlockCache::Stats stats;
+    uint8_t buf[16];
+    TEST_ASSERT_EQUAL_INT(0, cache.read(source, BlockCache::hashPath(PATH), 100, 100, buf, sizeof(buf), stats));
+    TEST_ASSERT_EQUAL_INT(4, cache.read(source, BlockCache::hashPath(PATH), 100, 96, buf, sizeof(buf), stats));
+    TEST_ASSERT_EQUAL_MEMORY(data.data() + 96, buf, 4);
+}
+
+static void test_same_size_rewrite_needs_invalidate() {
+    std::vector<uint8_t> before = pattern(SD_BLOCK_SIZE + 10, 4);
+    std::vector<uint8_t> after = pattern(SD_BLOCK_SIZE + 10, 5);
+    writeFile(before);
+    BlockCache::Stats stats;
+    readAll(before.size(), 256, stats);
+
+    // Same path and size - the key can't tell the files apart
+    writeFile(after);
+    std::vector<uint8_t> stale = readAll(after.size(), 256, stats);
+    TEST_ASSERT_EQUAL_MEMORY(before.data(), stale.data(), before.size());
+
+    cache.invalidate(BlockCache::hashPath(PATH));
+    std::vector<uint8_t> fresh = readAll(after.size(), 256, stats);
+    TEST_ASSERT_EQUAL_MEMORY(after.data(), fresh.data(), after.size());
+}
+
+static void test_invalidate_keeps_other_paths() {
+    std::vector<uint8_t> data = pattern(SD_BLOCK_SIZE, 6);
+    writeFile(data);
+    BlockCache::Stats stats;
+    readAll(data.size(), SD_BLOCK_SIZE, stats);
+    TEST_ASSERT_EQUAL_INT(1, cache.usedBlocks());
+
+    cache.invalidate(BlockCache::hashPath("/other.nc"));
+    TEST_ASSERT_EQUAL_INT(1, cache.usedBlocks());
+    cache.invalidate(BlockCache::hashPath(PATH));
+    TEST_ASSERT_EQUAL_INT(0, cache.usedBlocks());
+}
+
+static void test_clear_flushes_everything() {
+    std::vector<uint8_t> data = pattern(4 * SD_BLOCK_SIZE, 7);
+    writeFile(data);
+    BlockCache::Stats stats;
+    readAll(data.size(), SD_BLOCK_SIZE, stats);
+    TEST_ASSERT_EQUAL_INT(4, cache.usedBlocks());
+
+    cache.clear();
+    TEST_ASSERT_EQUAL_INT(0, cache.usedBlocks());
+    source.reads = 0;
+    readAll(data.size(), SD_BLOCK_SIZE, stats);
+    TEST_ASSERT_EQUAL_INT(4, source.reads);
+}
+
+static void test_lru_eviction() {
+    std::vector<uint8_t> data = pattern((SD_CACHE_BLOCKS + 1) * SD_BLOCK_SIZE, 8);
+    writeFile(data);
+    uint32_t hash = BlockCache::hashPath(PATH);
+    BlockCache::Stats stats;
+    uint8_t buf[1];
+
+    // Fill the cache, then touch block 0 so block 1 is the oldest
+    for (uint32_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+        cache.read(source, hash, data.size(), i * SD_BLOCK_SIZE, buf, 1, stats);
+    }
+    cache.read(source, hash, data.size(), 0, buf, 1, stats);
+    TEST_ASSERT_EQUAL_INT(SD_CACHE_BLOCKS, cache.usedBlocks());
+
+    // One more block evicts block 1
+    cache.read(source, hash, data.size(), SD_CACHE_BLOCKS * SD_BLOCK_SIZE, buf, 1, stats);
+    source.reads = 0;
+    cache.read(source, hash, data.size(), 0, buf, 1, stats);
+    TEST_ASSERT_EQUAL_INT(0, source.reads);
+    cache.read(source, hash, data.size(), SD_BLOCK_SIZE, buf, 1, stats);
+    TEST_ASSERT_EQUAL_INT(1, source.reads);
+    TEST_ASSERT_EQUAL_UINT8(data[SD_BLOCK_SIZE], buf[0]);
+}
+
+static void test_prefetch_reads_ahead() {
+    std::vector<uint8_t> data = pattern(10 * SD_BLOCK_SIZE, 9);
+    writeFile(data);
+    uint32_t hash = BlockCache::hashPath(PATH);
+
+    int loaded = 0;
+    while (cache.prefetch(source, hash, data.size(), 0) > 0) loaded++;
+    TEST_ASSERT_EQUAL_INT(SD_READAHEAD_BLOCKS + 1, loaded);
+
+    BlockCache::Stats stats;
+    source.reads = 0;
+    std::vector<uint8_t> out((SD_READAHEAD_BLOCKS + 1) * SD_BLOCK_SIZE);
+    for (uint32_t pos = 0; pos < out.size(); pos += 700) {
+        size_t len = out.size() - pos < 700 ? out.size() - pos : 700;
+        cache.read(source, hash, data.size(), pos, out.data() + pos, len, stats);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(data.data(), out.data(), out.size());
+    TEST_ASSERT_EQUAL_INT(0, source.reads);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.misses);
+}
+
+static void test_read_error() {
+    std::vector<uint8_t> data = pattern(SD_BLOCK_SIZE, 10);
+    writeFile(data);
+    BlockCache::Stats stats;
+    uint8_t buf[16];
+
+    // Claims a bigger file than there is on disk
+    TEST_ASSERT_EQUAL_INT(-1, cache.read(source, BlockCache::hashPath(PATH), 2 * SD_BLOCK_SIZE,
+                                         SD_BLOCK_SIZE, buf, sizeof(buf), stats));
+    TEST_ASSERT_EQUAL_INT(0, cache.usedBlocks());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_match_file);
+    RUN_TEST(test_second_pass_hits_cache);
+    RUN_TEST(test_end_of_file);
+    RUN_TEST(test_same_size_rewrite_needs_invalidate);
+    RUN_TEST(test_invalidate_keeps_other_paths);
+    RUN_TEST(test_clear_flushes_everything);
+    RUN_TEST(test_lru_eviction);
+    RUN_TEST(test_prefetch_reads_ahead);
+    RUN_TEST(test_read_error);
+    return UNITY_END();
+}
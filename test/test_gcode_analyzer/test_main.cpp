@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <cstring>
+#include "gcode/gcode_analyzer.h"
+
+static GCodeAnalyzer analyzer;
+
+static const GCodeAnalysis &analyze(const char *program) {
+    analyzer.begin();
+    analyzer.feed(program, strlen(program));
+    analyzer.finish();
+    return analyzer.result();
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_cut_and_rapid_lengths() {
+    const GCodeAnalysis &a = analyze("G0 X10 Y20\nG1 X30 Y20 F600\nG0 X0 Y0\n");
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, a.cut_length_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 58.416f, a.rapid_length_mm);
+    TEST_ASSERT_EQUAL_UINT32(3, a.line_count);
+}
+
+static void test_words_without_spaces() {
+    // "0X10" must not be read as a hex number
+    const GCodeAnalysis &a = analyze("G0X10Y20\nG1X30Y20F600\nG0X0Y0\n");
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, a.cut_length_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, 58.416f, a.rapid_length_mm);
+}
+
+static void test_comments_and_case() {
+    const GCodeAnalysis &a = analyze("g1 x10 f600 (G1 X100)\nG1 X20 ; G1 X200\n%\n$H\n");
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, a.cut_length_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, a.max_x);
+}
+
+static void test_extents() {
+    const GCodeAnalysis &a = analyze("G0 X-5 Y2 Z5\nG1 Z-1 F100\nG1 X15 Y12\n");
+    TEST_ASSERT_TRUE(a.has_motion);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -5.0f, a.min_x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 15.0f, a.max_x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, a.min_y);   // Starts at the origin
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 12.0f, a.max_y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -1.0f, a.min_z);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 5.0f, a.max_z);
+}
+
+static void test_incremental_and_inches() {
+    const GCodeAnalysis &a = analyze("G91\nG1 X10 F600\nG1 X10\nG90 G20\nG1 X1\n");
+    // 10 + 10 mm incremental, then back to 1 inch absolute = 25.4 mm from X20
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f + 5.4f, a.cut_length_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 25.4f, a.max_x);
+}
+
+static void test_arc_length() {
+    // Quarter circle of radius 10 around (0,0), with I/J and with R
+    const GCodeAnalysis &ij = analyze("G0 X10 Y0\nG3 X0 Y10 I-10 J0 F600\n");
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 15.708f, ij.cut_length_mm);
+
+    const GCodeAnalysis &r = analyze("G0 X10 Y0\nG3 X0 Y10 R10 F600\n");
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 15.708f, r.cut_length_mm);
+}
+
+static void test_time_estimate() {
+    // 100 mm at 10 mm/s with 500 mm/s^2: 10 s cruise + v/a for the two ramps
+    const GCodeAnalysis &a = analyze("G1 X100 F600\n");
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.02f, a.est_time_sec);
+}
+
+static void test_dwell_adds_time() {
+    const GCodeAnalysis &a = analyze("G4 P2.5\n");
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.5f, a.est_time_sec);
+    TEST_ASSERT_FALSE(a.has_motion);
+}
+
+static void test_non_motion_axis_words() {
+    // G10/G28/G92 carry axis words but don't move
+    const GCodeAnalysis &a = analyze("G10 L20 P1 X50\nG92 X0\nG28 X0 Y0\n");
+    TEST_ASSERT_FALSE(a.has_motion);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, a.rapid_length_mm);
+}
+
+static void test_chunked_feed_matches() {
+    const char *program = "G0 X10 Y20\nG1 X30 Y20 F600\nG2 X40 Y10 I0 J-10\nG0 X0 Y0\n";
+    const GCodeAnalysis &whole = analyze(program);
+    float cut = whole.cut_length_mm;
+    float time = whole.est_time_sec;
+
+    analyzer.begin();
+    for (const char *p = program; *p; p++) analyzer.feed(p, 1);
+    analyzer.finish();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, cut, analyzer.result().cut_length_mm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, time, analyzer.result().est_time_sec);
+}
+
+static void test_thumbnail_marks_cuts_only() {
+    analyze("G0 X50 Y50\nG1 X100 Y50 F600\n");
+    GCodeThumbnail thumb;
+    analyzer.getThumbnail(thumb);
+
+    // Cell of the cut midpoint is set, the rapid's start cell is not
+    int gx = (int)((75.0f - thumb.x0) / thumb.cell);
+    int gy = (int)((50.0f - thumb.y0) / thumb.cell);
+    TEST_ASSERT_TRUE(thumb.get(gx, gy));
+    TEST_ASSERT_FALSE(thumb.get(0, 0));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cut_and_rapid_lengths);
+    RUN_TEST(test_words_without_spaces);
+    RUN_TEST(test_comments_and_case);
+    RUN_TEST(test_extents);
+    RUN_TEST(test_incremental_and_inches);
+    RUN_TEST(test_arc_length);
+    RUN_TEST(test_time_estimate);
+    RUN_TEST(test_dwell_adds_time);
+    RUN_TEST(test_non_motion_axis_words);
+    RUN_TEST(test_chunked_feed_matches);
+    RUN_TEST(test_thumbnail_marks_cuts_only);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <cstdio>
+#include "gcode/gcode_modal.h"
+
+static GCodeModal modal;
+
+void setUp() {
+    modal = GCodeModal();
+}
+
+void tearDown() {}
+
+// Motion words must be read as whole words - "G0" is not a match inside "G90"
+static void test_motion_next_to_distance() {
+    TEST_ASSERT_TRUE(modal.parse("[GC:G1 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]"));
+    TEST_ASSERT_EQUAL_STRING("G1", modal.motionName());
+    TEST_ASSERT_EQUAL_STRING("G90", modal.distanceName());
+
+    modal.parse("[GC:G2 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G2", modal.motionName());
+
+    modal.parse("[GC:G3 G54 G17 G21 G91 G94 M5 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G3", modal.motionName());
+    TEST_ASSERT_TRUE(modal.isIncremental());
+
+    modal.parse("[GC:G0 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G0", modal.motionName());
+    TEST_ASSERT_FALSE(modal.isIncremental());
+}
+
+// Probe motion has a decimal code that must not collapse to G38
+static void test_probe_motion() {
+    modal.parse("[GC:G38.2 G54 G17 G21 G91 G94 M5 M9 T0 F100 S0]");
+    TEST_ASSERT_EQUAL(ModalMotion::G38_2, modal.motion);
+    TEST_ASSERT_EQUAL_STRING("G38.2", modal.motionName());
+
+    modal.parse("[GC:G38.5 G54 G17 G21 G91 G94 M5 M9 T0 F100 S0]");
+    TEST_ASSERT_EQUAL_STRING("G38.5", modal.motionName());
+
+    modal.parse("[GC:G80 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G80", modal.motionName());
+}
+
+static void test_work_coordinate_systems() {
+    const char *names[] = {"G54", "G55", "G56", "G57", "G58", "G59"};
+    char report[64];
+    for (int i = 0; i < 6; i++) {
+        snprintf(report, sizeof(report), "[GC:G0 %s G17 G21 G90 G94 M5 M9 T0 F0 S0]", names[i]);
+        TEST_ASSERT_TRUE(modal.parse(report));
+        TEST_ASSERT_EQUAL(i, modal.wcs);
+        TEST_ASSERT_EQUAL_STRING(names[i], modal.wcsName());
+    }
+}
+
+static void test_plane_units_feed_mode_spindle() {
+    modal.parse("[GC:G0 G54 G18 G20 G90 G93 M3 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G18", modal.planeName());
+    TEST_ASSERT_TRUE(modal.isInches());
+    TEST_ASSERT_EQUAL_STRING("G93", modal.feedModeName());
+    TEST_ASSERT_EQUAL_STRING("M3", modal.spindleName());
+
+    modal.parse("[GC:G0 G54 G19 G21 G90 G95 M4 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL_STRING("G19", modal.planeName());
+    TEST_ASSERT_FALSE(modal.isInches());
+    TEST_ASSERT_EQUAL_STRING("G95", modal.feedModeName());
+    TEST_ASSERT_EQUAL_STRING("M4", modal.spindleName());
+}
+
+// Coolant is reported in full every time - words missing from a report are off
+static void test_coolant_bits() {
+    modal.parse("[GC:G0 G54 G17 G21 G90 G94 M5 M7 T0 F0 S0]");
+    TEST_ASSERT_EQUAL(COOLANT_MIST, modal.coolant);
+    TEST_ASSERT_EQUAL_STRING("M7", modal.coolantName());
+
+    modal.parse("[GC:G0 G54 G17 G21 G90 G94 M5 M7 M8 T0 F0 S0]");
+    TEST_ASSERT_EQUAL(COOLANT_MIST | COOLANT_FLOOD, modal.coolant);
+    TEST_ASSERT_EQUAL_STRING("M7 M8", modal.coolantName());
+
+    modal.parse("[GC:G0 G54 G17 G21 G90 G94 M5 M8 T0 F0 S0]");
+    TEST_ASSERT_EQUAL(COOLANT_FLOOD, modal.coolant);
+    TEST_ASSERT_EQUAL_STRING("M8", modal.coolantName());
+
+    modal.parse("[GC:G0 G54 G17 G21 G90 G94 M5 M9 T0 F0 S0]");
+    TEST_ASSERT_EQUAL(0, modal.coolant);
+    TEST_ASSERT_EQUAL_STRING("M9", modal.coolantName());
+}
+
+static void test_tool_feed_speed() {
+    modal.parse("[GC:G1 G54 G17 G21 G90 G94 M3 M9 T7 F1250.5 S18000]");
+    TEST_ASSERT_EQUAL(7, modal.tool);
+    TEST_ASSERT_EQUAL_FLOAT(1250.5f, modal.feed);
+    TEST_ASSERT_EQUAL_FLOAT(18000.0f, modal.speed);
+
+    // Brackets are optional
+    TEST_ASSERT_TRUE(modal.parse("G1 G54 G17 G21 G90 G94 M3 M9 T2 F300 S1000"));
+    TEST_ASSERT_EQUAL(2, modal.tool);
+    TEST_ASSERT_EQUAL_FLOAT(300.0f, modal.feed);
+}
+
+// Words the display doesn't show are skipped without touching the known groups
+static void test_unknown_words() {
+    TEST_ASSERT_TRUE(modal.parse("[GC:G1 G55 G17 G21 G90 G91.1 G94 G40 G49 M5 M56 M9 T1 F200 S0]"));
+    TEST_ASSERT_EQUAL_STRING("G1", modal.motionName());
+    TEST_ASSERT_EQUAL_STRING("G55", modal.wcsName());
+    TEST_ASSERT_EQUAL_STRING("G90", modal.distanceName());
+    TEST_ASSERT_EQUAL_STRING("M5", modal.spindleName());
+    TEST_ASSERT_EQUAL_STRING("M9", modal.coolantName());
+    TEST_ASSERT_EQUAL(1, modal.tool);
+    TEST_ASSERT_EQUAL_FLOAT(200.0f, modal.feed);
+
+    // Unreadable words are skipped too
+    TEST_ASSERT_TRUE(modal.parse("[GC:G2 Gx M8 T3]"));
+    TEST_ASSERT_EQUAL_STRING("G2", modal.motionName());
+    TEST_ASSERT_EQUAL_STRING("M8", modal.coolantName());
+    TEST_ASSERT_EQUAL(3, modal.tool);
+}
+
+// Groups missing from a report keep their value; a report without words changes nothing
+static void test_partial_and_empty_reports() {
+    modal.parse("[GC:G1 G56 G18 G20 G91 G93 M3 M8 T4 F100 S500]");
+    GCodeModal before = modal;
+
+    TEST_ASSERT_FALSE(modal.parse("[GC:]"));
+    TEST_ASSERT_TRUE(modal == before);
+
+    TEST_ASSERT_TRUE(modal.parse("[GC:G0 M8]"));
+    TEST_ASSERT_EQUAL_STRING("G0", modal.motionName());
+    TEST_ASSERT_EQUAL_STRING("G56", modal.wcsName());
+    TEST_ASSERT_EQUAL_STRING("G18", modal.planeName());
+    TEST_ASSERT_TRUE(modal.isIncremental());
+    TEST_ASSERT_TRUE(modal != before);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_motion_next_to_distance);
+    RUN_TEST(test_probe_motion);
+    RUN_TEST(test_work_coordinate_systems);
+    RUN_TEST(test_plane_units_feed_mode_spindle);
+    RUN_TEST(test_coolant_bits);
+    RUN_TEST(test_tool_feed_speed);
+    RUN_TEST(test_unknown_words);
+    RUN_TEST(test_partial_and_empty_reports);
+    return UNITY_END();
+}
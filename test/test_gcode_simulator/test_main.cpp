@@ -0,0 +1,197 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include "gcode/gcode_simulator.h"
+
+static GCodeSimulator sim;
+static GCodeSimSetup machine;
+
+// Spindle on with a feed rate, so only the issue under test is reported
+static const char *READY = "M3 S10000 F500\n";
+
+static const GCodeSimReport &run(const char *program) {
+    sim.begin(machine);
+    sim.feed(program, strlen(program));
+    sim.finish();
+    return sim.report();
+}
+
+static const GCodeSimReport &runReady(const char *program) {
+    static char buf[512];
+    snprintf(buf, sizeof(buf), "%s%s", READY, program);
+    return run(buf);
+}
+
+// 100 x 100 x 50 envelope with the origin at the front left, Z down from 0
+static void setEnvelope() {
+    for (int a = 0; a < 3; a++) machine.has_envelope[a] = true;
+    machine.min[0] = 0.0f;   machine.max[0] = 100.0f;
+    machine.min[1] = 0.0f;   machine.max[1] = 100.0f;
+    machine.min[2] = -50.0f; machine.max[2] = 0.0f;
+}
+
+void setUp() {
+    machine.reset();
+}
+
+void tearDown() {}
+
+static void test_envelope_linear() {
+    setEnvelope();
+    const GCodeSimReport &r = runReady("G0 X50 Y50\nG1 X120\nG1 X50 Z-60\n");
+    TEST_ASSERT_EQUAL(2, r.counts[SIM_ENVELOPE]);
+    TEST_ASSERT_EQUAL(3, r.issues[SIM_ENVELOPE][0].line);
+    TEST_ASSERT_EQUAL_STRING("X 120.000 above max 100.000", r.issues[SIM_ENVELOPE][0].text);
+    TEST_ASSERT_EQUAL(4, r.issues[SIM_ENVELOPE][1].line);
+    TEST_ASSERT_EQUAL_STRING("Z -60.000 below min -50.000", r.issues[SIM_ENVELOPE][1].text);
+    TEST_ASSERT_EQUAL_FLOAT(120.0f, r.max[0]);
+    TEST_ASSERT_EQUAL(3, r.move_count);
+}
+
+// An arc with both ends inside can still bulge out through a quadrant point
+static void test_envelope_arc_quadrant() {
+    setEnvelope();
+    // Half circle from (10,50) to (30,50) around (20,50): clockwise passes the top (Y 60)
+    machine.max[1] = 55.0f;
+    const GCodeSimReport &cw = runReady("G0 X10 Y50\nG2 X30 Y50 I10 J0\n");
+    TEST_ASSERT_EQUAL(1, cw.counts[SIM_ENVELOPE]);
+    TEST_ASSERT_EQUAL(3, cw.issues[SIM_ENVELOPE][0].line);
+    TEST_ASSERT_EQUAL_STRING("Y 60.000 above max 55.000", cw.issues[SIM_ENVELOPE][0].text);
+
+    // Counter-clockwise takes the bottom (Y 40) and stays inside
+    const GCodeSimReport &ccw = runReady("G0 X10 Y50\nG3 X30 Y50 I10 J0\n");
+    TEST_ASSERT_EQUAL(0, ccw.total());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 40.0f, ccw.min[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 50.0f, ccw.max[1]);
+}
+
+static void test_work_offsets() {
+    machine.wcs[0][0] = 10.0f;
+    machine.wcs[1][0] = 40.0f;
+
+    // G54 from the setup, then G55 changed with G10 L2
+    const GCodeSimReport &r = run("G0 X5\nG10 L2 P2 X60\nG55 G0 X5\n");
+    TEST_ASSERT_EQUAL(0, r.total());
+    TEST_ASSERT_EQUAL_FLOAT(15.0f, r.min[0]);
+    TEST_ASSERT_EQUAL_FLOAT(65.0f, r.max[0]);
+
+    // G92 makes the current position the given work position, G92.1 clears it
+    const GCodeSimReport &g92 = run("G0 X20\nG92 X0\nG0 X5\nG92.1\nG0 X0\n");
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, g92.min[0]);
+    TEST_ASSERT_EQUAL_FLOAT(35.0f, g92.max[0]);
+
+    // G43.1 shifts Z by the tool length offset until G49
+    const GCodeSimReport &tlo = run("G43.1 Z-3\nG0 Z0\nG49\nG0 Z1\n");
+    TEST_ASSERT_EQUAL_FLOAT(-3.0f, tlo.min[2]);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, tlo.max[2]);
+}
+
+static void test_g10_unsupported_forms() {
+    const GCodeSimReport &r = run("G10 L1 P1 Z2\nG10 L2 P9 X0\n");
+    TEST_ASSERT_EQUAL(2, r.counts[SIM_UNSUPPORTED]);
+    TEST_ASSERT_EQUAL_STRING("G10 L1 not supported", r.issues[SIM_UNSUPPORTED][0].text);
+    TEST_ASSERT_EQUAL_STRING("G10 P9 out of range", r.issues[SIM_UNSUPPORTED][1].text);
+}
+
+static void test_g28_and_g53() {
+    machine.wcs[0][0] = 50.0f;
+    machine.g28[0] = 90.0f;
+    machine.g28[1] = 80.0f;
+    machine.g28[2] = -1.0f;
+    setEnvelope();
+
+    // G53 ignores the work offset
+    const GCodeSimReport &g53 = run("G53 G0 X2\n");
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, g53.max[0]);
+
+    // G28 without axes goes straight to the stored position
+    const GCodeSimReport &home = run("G28\n");
+    TEST_ASSERT_EQUAL(1, home.move_count);
+    TEST_ASSERT_EQUAL_FLOAT(90.0f, home.max[0]);
+    TEST_ASSERT_EQUAL_FLOAT(80.0f, home.max[1]);
+
+    // With axes: through the intermediate work point, then only those axes home -
+    // the intermediate X 60 work = 110 machine is outside the envelope
+    const GCodeSimReport &via = run("G28 X60\n");
+    TEST_ASSERT_EQUAL(2, via.move_count);
+    TEST_ASSERT_EQUAL(1, via.counts[SIM_ENVELOPE]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, via.max[1]);
+}
+
+static void test_missing_feed_and_spindle() {
+    const GCodeSimReport &r = run("G0 X10\nG1 X20\nM3 S0\nG1 X30 F100\n");
+    TEST_ASSERT_EQUAL(1, r.counts[SIM_NO_FEED]);
+    TEST_ASSERT_EQUAL(2, r.issues[SIM_NO_FEED][0].line);
+    TEST_ASSERT_EQUAL_STRING("G1 without feed rate", r.issues[SIM_NO_FEED][0].text);
+
+    TEST_ASSERT_EQUAL(2, r.counts[SIM_NO_SPINDLE]);
+    TEST_ASSERT_EQUAL_STRING("G1 with spindle off", r.issues[SIM_NO_SPINDLE][0].text);
+    TEST_ASSERT_EQUAL_STRING("G1 at S0", r.issues[SIM_NO_SPINDLE][1].text);
+    TEST_ASSERT_EQUAL(4, r.issues[SIM_NO_SPINDLE][1].line);
+
+    // Probes need a feed rate too, but no spindle
+    const GCodeSimReport &probe = run("G38.2 Z-10\n");
+    TEST_ASSERT_EQUAL(1, probe.counts[SIM_NO_FEED]);
+    TEST_ASSERT_EQUAL_STRING("Probe without feed rate", probe.issues[SIM_NO_FEED][0].text);
+    TEST_ASSERT_EQUAL(0, probe.counts[SIM_NO_SPINDLE]);
+
+    // Inverse time needs F on every cutting line
+    const GCodeSimReport &g93 = runReady("G93 G1 X10 F2\nG1 X20\n");
+    TEST_ASSERT_EQUAL(1, g93.counts[SIM_NO_FEED]);
+    TEST_ASSERT_EQUAL(3, g93.issues[SIM_NO_FEED][0].line);
+}
+
+static void test_bad_arcs() {
+    const GCodeSimReport &r = runReady("G2 X10 Y0 R2\nG2 X10 Y0 R5\nG3 X20 Y0 I3 J0\nG2 X30 Y0\n");
+    TEST_ASSERT_EQUAL(4, r.counts[SIM_BAD_ARC]);
+    TEST_ASSERT_EQUAL_STRING("Radius 2.000 shorter than half chord", r.issues[SIM_BAD_ARC][0].text);
+    TEST_ASSERT_EQUAL(2, r.issues[SIM_BAD_ARC][0].line);
+    TEST_ASSERT_EQUAL_STRING("R arc ends where it starts", r.issues[SIM_BAD_ARC][1].text);
+    TEST_ASSERT_EQUAL_STRING("Arc radius mismatch 4.000", r.issues[SIM_BAD_ARC][2].text);
+    TEST_ASSERT_EQUAL_STRING("Arc without offsets in plane", r.issues[SIM_BAD_ARC][3].text);
+
+    // A valid R arc is not flagged
+    const GCodeSimReport &ok = runReady("G2 X10 Y0 R5\n");
+    TEST_ASSERT_EQUAL(0, ok.total());
+}
+
+// Blank lines (LF or CRLF) still count, whether the file comes in one piece or byte by byte
+static void test_line_numbers() {
+    const char *program = "\n\r\n(comment only)\nG1 X1\n\n\r\nG1 X2\n;end";
+    const GCodeSimReport &r = run(program);
+    TEST_ASSERT_EQUAL(8, r.line_count);
+    TEST_ASSERT_EQUAL(2, r.counts[SIM_NO_FEED]);
+    TEST_ASSERT_EQUAL(4, r.issues[SIM_NO_FEED][0].line);
+    TEST_ASSERT_EQUAL(7, r.issues[SIM_NO_FEED][1].line);
+
+    sim.begin(machine);
+    for (const char *p = program; *p; p++) sim.feed(p, 1);
+    sim.finish();
+    TEST_ASSERT_EQUAL(8, sim.report().line_count);
+    TEST_ASSERT_EQUAL(4, sim.report().issues[SIM_NO_FEED][0].line);
+    TEST_ASSERT_EQUAL(7, sim.report().issues[SIM_NO_FEED][1].line);
+}
+
+static void test_unsupported_words() {
+    const GCodeSimReport &r = run("G5 X1\nM100\n#1=2\nG91.1\nW3\n");
+    TEST_ASSERT_EQUAL(4, r.counts[SIM_UNSUPPORTED]);
+    TEST_ASSERT_EQUAL_STRING("G5 not supported", r.issues[SIM_UNSUPPORTED][0].text);
+    TEST_ASSERT_EQUAL_STRING("M100 not supported", r.issues[SIM_UNSUPPORTED][1].text);
+    TEST_ASSERT_EQUAL_STRING("Expression not simulated", r.issues[SIM_UNSUPPORTED][2].text);
+    TEST_ASSERT_EQUAL_STRING("Word W not supported", r.issues[SIM_UNSUPPORTED][3].text);
+    TEST_ASSERT_EQUAL(5, r.issues[SIM_UNSUPPORTED][3].line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_envelope_linear);
+    RUN_TEST(test_envelope_arc_quadrant);
+    RUN_TEST(test_work_offsets);
+    RUN_TEST(test_g10_unsupported_forms);
+    RUN_TEST(test_g28_and_g53);
+    RUN_TEST(test_missing_feed_and_spindle);
+    RUN_TEST(test_bad_arcs);
+    RUN_TEST(test_line_numbers);
+    RUN_TEST(test_unsupported_words);
+    return UNITY_END();
+}
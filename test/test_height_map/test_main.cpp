@@ -0,0 +1,206 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gcode/height_map.h"
+#include "gcode/gcode_leveler.h"
+
+static HeightMap map;
+static GCodeLeveler leveler;
+
+// Tilted plane: bilinear interpolation reproduces it exactly
+static float plane(float x, float y) { return 0.01f * x + 0.02f * y; }
+
+static void setupPlane() {
+    map.setup(0.0f, 0.0f, 100.0f, 100.0f, 3, 3);
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 3; i++) map.set(i, j, plane(map.pointX(i), map.pointY(j)));
+    }
+}
+
+static std::vector<std::string> level(const char *line) {
+    std::vector<std::string> out;
+    TEST_ASSERT_TRUE(leveler.setLine(line));
+    char buf[GCodeLeveler::MAX_LINE];
+    while (leveler.next(buf, sizeof(buf))) out.push_back(buf);
+    return out;
+}
+
+// Axis word value from an output line (NAN when missing)
+static float word(const std::string &line, char letter) {
+    size_t at = line.find(letter);
+    return at == std::string::npos ? NAN : strtof(line.c_str() + at + 1, nullptr);
+}
+
+void setUp() {
+    setupPlane();
+    leveler.begin(&map, 25.0f);
+}
+
+void tearDown() {}
+
+// === HeightMap::zAt ===
+
+static void test_zat_grid_points() {
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 3; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-5f, map.get(i, j), map.zAt(map.pointX(i), map.pointY(j)));
+        }
+    }
+}
+
+static void test_zat_bilinear() {
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(25.0f, 75.0f), map.zAt(25.0f, 75.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(99.0f, 1.0f), map.zAt(99.0f, 1.0f));
+
+    // Saddle: only the far corner of the first cell raised
+    HeightMap saddle;
+    saddle.setup(0.0f, 0.0f, 10.0f, 10.0f, 2, 2);
+    saddle.set(0, 0, 0.0f);
+    saddle.set(1, 0, 0.0f);
+    saddle.set(0, 1, 0.0f);
+    saddle.set(1, 1, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, saddle.zAt(5.0f, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, saddle.zAt(10.0f, 5.0f));
+}
+
+static void test_zat_holds_edges() {
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(0.0f, 0.0f), map.zAt(-20.0f, -5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(100.0f, 100.0f), map.zAt(150.0f, 300.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(40.0f, 100.0f), map.zAt(40.0f, 120.0f));
+}
+
+static void test_zat_offset_grid() {
+    HeightMap shifted;
+    shifted.setup(-50.0f, 20.0f, 40.0f, 40.0f, 5, 3);
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 5; i++) shifted.set(i, j, plane(shifted.pointX(i), shifted.pointY(j)));
+    }
+    TEST_ASSERT_TRUE(shifted.isComplete());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, plane(-33.0f, 47.0f), shifted.zAt(-33.0f, 47.0f));
+}
+
+static void test_zat_unset_map() {
+    HeightMap empty;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, empty.zAt(10.0f, 10.0f));
+}
+
+static void test_encode_decode() {
+    std::vector<uint8_t> buf(map.encodedSize());
+    TEST_ASSERT_EQUAL_UINT32(buf.size(), map.encode(buf.data(), buf.size()));
+    HeightMap copy;
+    TEST_ASSERT_TRUE(copy.decode(buf.data(), buf.size()));
+    TEST_ASSERT_TRUE(copy.isComplete());
+    // Stored in micrometers
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, map.zAt(33.0f, 66.0f), copy.zAt(33.0f, 66.0f));
+    TEST_ASSERT_FALSE(copy.decode(buf.data(), buf.size() - 1));
+}
+
+// === GCodeLeveler ===
+
+static void test_passes_through_until_position_known() {
+    std::vector<std::string> out = level("G1 X10 Y10 F500");
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_EQUAL_STRING("G1 X10 Y10 F500", out[0].c_str());
+
+    // Z given - position now known, the next move is compensated
+    out = level("G1 Z0");
+    TEST_ASSERT_EQUAL_STRING("G1 Z0", out[0].c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, leveler.getCompensatedMoves());
+}
+
+static void test_splits_and_offsets_g1() {
+    level("G0 X10 Y10 Z0");
+    std::vector<std::string> out = level("G1 X60 F600");
+    // 50 mm at 25 mm segments
+    TEST_ASSERT_EQUAL_UINT32(2, out.size());
+    TEST_ASSERT_EQUAL_STRING("G1 F600 X35.000 Y10.000 Z0.550", out[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("X60.000 Y10.000 Z0.800", out[1].c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, leveler.getCompensatedMoves());
+}
+
+static void test_rapids_and_arcs_not_split() {
+    level("G0 X0 Y0 Z5");
+    std::vector<std::string> out = level("G0 X100 Y100");
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 5.0f + plane(100.0f, 100.0f), word(out[0], 'Z'));
+
+    out = level("G2 X50 Y50 I-50 J0");
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_TRUE(out[0].find("I-50") != std::string::npos);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 5.0f + plane(50.0f, 50.0f), word(out[0], 'Z'));
+}
+
+static void test_incremental_moves() {
+    level("G0 X0 Y0 Z0");
+    level("G91");
+    std::vector<std::string> out = level("G1 X50 F600");
+    TEST_ASSERT_EQUAL_UINT32(2, out.size());
+    // Increments add up to the move plus the change in offset
+    float dx = 0.0f, dz = 0.0f;
+    for (const std::string &line : out) {
+        dx += word(line, 'X');
+        dz += word(line, 'Z');
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 50.0f, dx);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, plane(50.0f, 0.0f) - plane(0.0f, 0.0f), dz);
+}
+
+static void test_inch_offsets() {
+    level("G20");
+    level("G0 X0 Y0 Z0");
+    std::vector<std::string> out = level("G1 X2 F20");   // 50.8 mm - three segments
+    TEST_ASSERT_EQUAL_UINT32(3, out.size());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, plane(50.8f, 0.0f) / 25.4f, word(out[2], 'Z'));
+}
+
+static void test_untracked_lines_reset_position() {
+    level("G0 X0 Y0 Z0");
+    std::vector<std::string> out = level("G92 X0 Y0 Z0");
+    TEST_ASSERT_EQUAL_STRING("G92 X0 Y0 Z0", out[0].c_str());
+    out = level("G1 X50 F600");
+    TEST_ASSERT_EQUAL_UINT32(1, out.size());
+    TEST_ASSERT_EQUAL_STRING("G1 X50 F600", out[0].c_str());
+
+    level("G0 X0 Y0 Z1");
+    level("G55");
+    out = level("G1 X10");
+    TEST_ASSERT_EQUAL_STRING("G1 X10", out[0].c_str());
+}
+
+static void test_comments_and_commands_unchanged() {
+    level("G0 X0 Y0 Z0");
+    const char *lines[] = {"(setup) ; comment", "$H", "%", "M3 S1000", ""};
+    for (const char *line : lines) {
+        std::vector<std::string> out = level(line);
+        TEST_ASSERT_EQUAL_UINT32(1, out.size());
+        TEST_ASSERT_EQUAL_STRING(line, out[0].c_str());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, leveler.getCompensatedMoves());
+}
+
+static void test_overlong_line_rejected() {
+    std::string line = "G1 X1 (" + std::string(GCodeLeveler::MAX_LINE, 'c') + ")";
+    TEST_ASSERT_FALSE(leveler.setLine(line.c_str()));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_zat_grid_points);
+    RUN_TEST(test_zat_bilinear);
+    RUN_TEST(test_zat_holds_edges);
+    RUN_TEST(test_zat_offset_grid);
+    RUN_TEST(test_zat_unset_map);
+    RUN_TEST(test_encode_decode);
+    RUN_TEST(test_passes_through_until_position_known);
+    RUN_TEST(test_splits_and_offsets_g1);
+    RUN_TEST(test_rapids_and_arcs_not_split);
+    RUN_TEST(test_incremental_moves);
+    RUN_TEST(test_inch_offsets);
+    RUN_TEST(test_untracked_lines_reset_position);
+    RUN_TEST(test_comments_and_commands_unchanged);
+    RUN_TEST(test_overlong_line_rejected);
+    return UNITY_END();
+}
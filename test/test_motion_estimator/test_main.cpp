@@ -0,0 +1,115 @@
+#include <unity.h>
+#include "core/motion_estimator.h"
+#include "config.h"
+
+// Status report as FluidNCClient would leave it after parsing
+static FluidNCStatus report(MachineState state, float x, float y, float feed, uint32_t ms) {
+    FluidNCStatus status;
+    status.is_connected = true;
+    status.state = state;
+    status.mpos_x = x;
+    status.mpos_y = y;
+    status.feed_rate = feed;
+    status.last_update_ms = ms;
+    return status;
+}
+
+void setUp() {
+    MotionEstimator::reset();
+}
+
+void tearDown() {}
+
+static void test_single_report_does_not_move() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    TEST_ASSERT_FALSE(MotionEstimator::isMoving());
+
+    float offset[4];
+    MotionEstimator::getOffset(1050, offset);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, offset[0]);
+}
+
+static void test_extrapolates_at_reported_feed() {
+    // 600 mm/min along X = 0.01 mm/ms, whatever the sampled distance says
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 2.0f, 0.0f, 600.0f, 1100));
+    TEST_ASSERT_TRUE(MotionEstimator::isMoving());
+
+    float offset[4];
+    MotionEstimator::getOffset(1150, offset);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, offset[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, offset[1]);
+}
+
+static void test_direction_follows_samples() {
+    // Diagonal move: feed is split between X and Y
+    MotionEstimator::update(report(STATE_JOG, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_JOG, 3.0f, 4.0f, 600.0f, 1100));
+
+    float offset[4];
+    MotionEstimator::getOffset(1200, offset);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.6f, offset[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.8f, offset[1]);
+}
+
+static void test_offset_clamped_to_report_gap() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 1.0f, 0.0f, 600.0f, 1100));
+
+    // A late report never moves the estimate further than one gap (100 ms)
+    float offset[4];
+    MotionEstimator::getOffset(5000, offset);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, offset[0]);
+}
+
+static void test_measured_rate_without_feed() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 0.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 1.0f, 0.0f, 0.0f, 1100));
+
+    float offset[4];
+    MotionEstimator::getOffset(1150, offset);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, offset[0]);
+}
+
+static void test_idle_freezes() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 1.0f, 0.0f, 600.0f, 1100));
+    MotionEstimator::update(report(STATE_IDLE, 1.0f, 0.0f, 0.0f, 1200));
+    TEST_ASSERT_FALSE(MotionEstimator::isMoving());
+
+    float offset[4];
+    MotionEstimator::getOffset(1250, offset);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, offset[0]);
+}
+
+static void test_large_gap_not_extrapolated() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 5.0f, 0.0f, 600.0f, 1000 + MOTION_SAMPLE_MAX_GAP_MS + 1));
+    TEST_ASSERT_FALSE(MotionEstimator::isMoving());
+}
+
+static void test_disconnect_resets() {
+    MotionEstimator::update(report(STATE_RUN, 0.0f, 0.0f, 600.0f, 1000));
+    MotionEstimator::update(report(STATE_RUN, 1.0f, 0.0f, 600.0f, 1100));
+
+    FluidNCStatus offline;
+    MotionEstimator::update(offline);
+    TEST_ASSERT_FALSE(MotionEstimator::isMoving());
+
+    // The next report starts a fresh pair of samples
+    MotionEstimator::update(report(STATE_RUN, 2.0f, 0.0f, 600.0f, 1200));
+    TEST_ASSERT_FALSE(MotionEstimator::isMoving());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_report_does_not_move);
+    RUN_TEST(test_extrapolates_at_reported_feed);
+    RUN_TEST(test_direction_follows_samples);
+    RUN_TEST(test_offset_clamped_to_report_gap);
+    RUN_TEST(test_measured_rate_without_feed);
+    RUN_TEST(test_idle_freezes);
+    RUN_TEST(test_large_gap_not_extrapolated);
+    RUN_TEST(test_disconnect_resets);
+    return UNITY_END();
+}
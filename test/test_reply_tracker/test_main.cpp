@@ -0,0 +1,110 @@
+#include <unity.h>
+#include "network/reply_tracker.h"
+
+static ReplyTracker replies;
+
+void setUp() {
+    replies.reset();
+}
+
+void tearDown() {}
+
+static void test_own_line_alone() {
+    replies.sentOwn();
+    TEST_ASSERT_TRUE(replies.isAwaiting());
+    TEST_ASSERT_TRUE(replies.onReply());
+    TEST_ASSERT_FALSE(replies.isAwaiting());
+    // Stray reply with nothing outstanding
+    TEST_ASSERT_FALSE(replies.onReply());
+}
+
+static void test_report_interval_between_steps() {
+    // Step 1 answered, the machine goes Run -> Idle and the client sends
+    // $Report/Interval before step 2 goes out
+    replies.sentOwn();
+    TEST_ASSERT_TRUE(replies.onReply());
+    replies.sentForeign(ReplyTracker::countLines("$Report/Interval=250\n"), 1000);
+    replies.sentOwn();
+
+    // Its error: (firmware without auto-reporting) is not step 2's answer
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_TRUE(replies.isAwaiting());
+    TEST_ASSERT_TRUE(replies.onReply());
+}
+
+static void test_report_interval_during_step() {
+    // Sent while a G38.2 is in flight - answered after it
+    replies.sentOwn();
+    replies.sentForeign(1, 1000);
+    TEST_ASSERT_TRUE(replies.onReply());
+    TEST_ASSERT_EQUAL_INT(1, replies.getForeignPending());
+
+    // The late ok is not taken for the next step's answer
+    replies.sentOwn();
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_TRUE(replies.onReply());
+    TEST_ASSERT_EQUAL_INT(0, replies.getForeignPending());
+}
+
+static void test_reply_outstanding_before_routine() {
+    // $Report/Interval sent just before the routine starts, reply not yet in
+    replies.sentForeign(1, 1000);
+    replies.dropStale(1100, 5000);
+    replies.sentOwn();
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_TRUE(replies.onReply());
+}
+
+static void test_idle_replies_drain_count() {
+    replies.sentForeign(2, 1000);
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_EQUAL_INT(0, replies.getForeignPending());
+    replies.sentOwn();
+    TEST_ASSERT_TRUE(replies.onReply());
+}
+
+static void test_stale_count_dropped() {
+    replies.sentForeign(1, 1000);
+    replies.dropStale(2000, 5000);
+    TEST_ASSERT_EQUAL_INT(1, replies.getForeignPending());
+    replies.dropStale(7000, 5000);
+    TEST_ASSERT_EQUAL_INT(0, replies.getForeignPending());
+    replies.sentOwn();
+    TEST_ASSERT_TRUE(replies.onReply());
+}
+
+static void test_cancelled_step_reply_skipped() {
+    // Routine stopped with a step in flight - its reply still arrives later
+    replies.sentOwn();
+    replies.sentForeign(1, 1000);
+    replies.cancelOwn(1200);
+    TEST_ASSERT_FALSE(replies.isAwaiting());
+    TEST_ASSERT_EQUAL_INT(2, replies.getForeignPending());
+
+    replies.sentOwn();
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_FALSE(replies.onReply());
+    TEST_ASSERT_TRUE(replies.onReply());
+}
+
+static void test_count_lines() {
+    TEST_ASSERT_EQUAL_INT(1, ReplyTracker::countLines("$G\n"));
+    TEST_ASSERT_EQUAL_INT(1, ReplyTracker::countLines("G0 X1"));
+    TEST_ASSERT_EQUAL_INT(3, ReplyTracker::countLines("G91\nG0 X1\n\nG90\n"));
+    TEST_ASSERT_EQUAL_INT(0, ReplyTracker::countLines("\n\n"));
+    TEST_ASSERT_EQUAL_INT(0, ReplyTracker::countLines(""));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_own_line_alone);
+    RUN_TEST(test_report_interval_between_steps);
+    RUN_TEST(test_report_interval_during_step);
+    RUN_TEST(test_reply_outstanding_before_routine);
+    RUN_TEST(test_idle_replies_drain_count);
+    RUN_TEST(test_stale_count_dropped);
+    RUN_TEST(test_cancelled_step_reply_skipped);
+    RUN_TEST(test_count_lines);
+    return UNITY_END();
+}
@@ -0,0 +1,251 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ui/settings_stream.h"
+
+// In-memory backup file
+class MemorySink : public SettingsSink {
+public:
+    std::string data;
+    std::vector<size_t> writes;
+    size_t fail_after = (size_t)-1;   // Bytes accepted before writes fail
+
+    size_t write(const uint8_t *buf, size_t len) override {
+        writes.push_back(len);
+        if (data.size() + len > fail_after) return 0;
+        data.append((const char*)buf, len);
+        return len;
+    }
+};
+
+class MemorySource : public SettingsSource {
+public:
+    std::string data;
+    size_t pos = 0;
+    size_t chunk = 7;   // Short reads, like a file ending mid-buffer
+
+    int read(uint8_t *buf, size_t len) override {
+        size_t n = data.size() - pos;
+        if (n > len) n = len;
+        if (n > chunk) n = chunk;
+        memcpy(buf, data.data() + pos, n);
+        pos += n;
+        return (int)n;
+    }
+};
+
+// Stand-in for deserializeJson(): one balanced JSON value, as read from the file
+static bool readRawValue(SettingsFileReader &in, std::string &out) {
+    out.clear();
+    if (in.next() < 0) return false;
+    int depth = 0;
+    bool in_string = false;
+    while (true) {
+        int c = in.peek();
+        if (c < 0) return depth == 0 && !in_string && !out.empty();
+        if (!in_string && depth == 0 && !out.empty() && (c == ',' || c == '}' || c == ']')) return true;
+        c = in.read();
+        if (c < 0) return false;
+        out += (char)c;
+        if (in_string) {
+            if (c == '\\') {
+                if ((c = in.read()) < 0) return false;
+                out += (char)c;
+            } else if (c == '"') {
+                in_string = false;
+                if (depth == 0) return true;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return true;
+        }
+    }
+}
+
+static std::string machineRecord(int i) {
+    std::string name(40, (char)('a' + i));
+    return "{\"name\":\"" + name + "\",\"fluidnc_url\":\"192.168.1." + std::to_string(i) +
+           "\",\"jog\":{\"xy_steps\":\"100,50,10,1,0.1\"},\"wcs\":[{\"name\":\"G54 \\\"top\\\"\"}]}";
+}
+
+static std::string exportDocument(MemorySink &sink, int machines) {
+    SettingsFileWriter out(sink);
+    out.printf("{\n  \"version\": \"%s\",\n  \"exported\": \"uptime_%lu_ms\",\n", "1.0", 1234UL);
+    out.print("  \"machines\": [");
+    for (int i = 0; i < machines; i++) {
+        out.print(i > 0 ? ",\n    " : "\n    ");
+        std::string record = machineRecord(i);
+        out.write((const uint8_t*)record.data(), record.size());
+    }
+    out.print(machines > 0 ? "\n  ],\n" : "],\n");
+    out.print("  \"system\": {\"ui\":{\"folders_on_top\":true}}");
+    out.print("\n}\n");
+    TEST_ASSERT_TRUE(out.flushBuffer());
+    TEST_ASSERT_EQUAL_UINT32(sink.data.size(), out.total);
+    return sink.data;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_writer_buffers_output() {
+    MemorySink sink;
+    SettingsFileWriter out(sink);
+    std::string text(3 * SETTINGS_IO_BUFFER_SIZE + 17, 'x');
+    out.write((const uint8_t*)text.data(), text.size());
+    TEST_ASSERT_EQUAL_UINT32(3, sink.writes.size());
+    TEST_ASSERT_TRUE(out.flushBuffer());
+    TEST_ASSERT_EQUAL_UINT32(4, sink.writes.size());
+    for (size_t n : sink.writes) TEST_ASSERT_TRUE(n <= SETTINGS_IO_BUFFER_SIZE);
+    TEST_ASSERT_TRUE(sink.data == text);
+}
+
+static void test_writer_reports_failure() {
+    MemorySink sink;
+    sink.fail_after = SETTINGS_IO_BUFFER_SIZE;
+    SettingsFileWriter out(sink);
+    std::string text(2 * SETTINGS_IO_BUFFER_SIZE + 1, 'y');
+    out.write((const uint8_t*)text.data(), text.size());
+    TEST_ASSERT_FALSE(out.flushBuffer());
+    TEST_ASSERT_TRUE(out.failed);
+}
+
+static void test_round_trip() {
+    MemorySink sink;
+    MemorySource source;
+    source.data = exportDocument(sink, 12);
+    TEST_ASSERT_TRUE(source.data.size() > 2 * SETTINGS_IO_BUFFER_SIZE);
+
+    // The walk readSettingsFile() does
+    SettingsFileReader in(source);
+    std::string value, version, system;
+    int machines = 0;
+    char key[32];
+    TEST_ASSERT_TRUE(in.consume('{'));
+    bool first = true;
+    while (!in.consume('}')) {
+        if (!first) TEST_ASSERT_TRUE(in.consume(','));
+        first = false;
+        TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+
+        if (strcmp(key, "machines") == 0 && in.next() == '[') {
+            in.consume('[');
+            bool first_machine = true;
+            while (!in.consume(']')) {
+                if (!first_machine) TEST_ASSERT_TRUE(in.consume(','));
+                first_machine = false;
+                in.beginRecord();
+                TEST_ASSERT_TRUE(readRawValue(in, value));
+                TEST_ASSERT_TRUE(in.endRecord());
+                TEST_ASSERT_TRUE(value == machineRecord(machines));
+                machines++;
+            }
+            continue;
+        }
+        TEST_ASSERT_TRUE(readRawValue(in, value));
+        if (strcmp(key, "version") == 0) version = value;
+        if (strcmp(key, "system") == 0) system = value;
+    }
+    TEST_ASSERT_EQUAL_INT(12, machines);
+    TEST_ASSERT_EQUAL_STRING("\"1.0\"", version.c_str());
+    TEST_ASSERT_EQUAL_STRING("{\"ui\":{\"folders_on_top\":true}}", system.c_str());
+    TEST_ASSERT_EQUAL_INT(-1, in.next());
+}
+
+static void test_empty_machine_list() {
+    MemorySink sink;
+    MemorySource source;
+    source.data = exportDocument(sink, 0);
+    SettingsFileReader in(source);
+    char key[32];
+    std::string value;
+    TEST_ASSERT_TRUE(in.consume('{'));
+    TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+    TEST_ASSERT_TRUE(readRawValue(in, value));
+    TEST_ASSERT_TRUE(in.consume(','));
+    TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+    TEST_ASSERT_TRUE(readRawValue(in, value));
+    TEST_ASSERT_TRUE(in.consume(','));
+    TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING("machines", key);
+    TEST_ASSERT_TRUE(in.consume('['));
+    TEST_ASSERT_TRUE(in.consume(']'));
+}
+
+static void test_key_escapes_and_truncation() {
+    MemorySource source;
+    source.data = " { \"a\\\"b\" :1, \"a_very_long_key_that_does_not_fit\":2 }";
+    SettingsFileReader in(source);
+    char key[8];
+    std::string value;
+    TEST_ASSERT_TRUE(in.consume('{'));
+    TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING("a\"b", key);
+    TEST_ASSERT_TRUE(readRawValue(in, value));
+    TEST_ASSERT_TRUE(in.consume(','));
+    TEST_ASSERT_TRUE(in.readKey(key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING("a_very_", key);
+}
+
+static void test_malformed_key() {
+    MemorySource source;
+    source.data = "{\"unterminated";
+    SettingsFileReader in(source);
+    char key[32];
+    TEST_ASSERT_TRUE(in.consume('{'));
+    TEST_ASSERT_FALSE(in.readKey(key, sizeof(key)));
+
+    MemorySource no_colon;
+    no_colon.data = "{\"key\" 1}";
+    SettingsFileReader in2(no_colon);
+    TEST_ASSERT_TRUE(in2.consume('{'));
+    TEST_ASSERT_FALSE(in2.readKey(key, sizeof(key)));
+}
+
+static void test_record_limit() {
+    MemorySource source;
+    source.data = "\"" + std::string(SETTINGS_MAX_RECORD_BYTES, 'z') + "\", \"next\"";
+    SettingsFileReader in(source);
+    std::string value;
+    in.beginRecord();
+    TEST_ASSERT_FALSE(readRawValue(in, value));
+    TEST_ASSERT_FALSE(in.endRecord());
+    TEST_ASSERT_EQUAL_UINT32(SETTINGS_MAX_RECORD_BYTES, value.size());
+
+    // A value that fits passes
+    MemorySource small;
+    small.data = "\"" + std::string(100, 'z') + "\"";
+    SettingsFileReader in2(small);
+    in2.beginRecord();
+    TEST_ASSERT_TRUE(readRawValue(in2, value));
+    TEST_ASSERT_TRUE(in2.endRecord());
+}
+
+static void test_read_bytes() {
+    MemorySource source;
+    source.data = "0123456789";
+    SettingsFileReader in(source);
+    char buf[16];
+    TEST_ASSERT_EQUAL_UINT32(4, in.readBytes(buf, 4));
+    TEST_ASSERT_EQUAL_MEMORY("0123", buf, 4);
+    TEST_ASSERT_EQUAL_UINT32(6, in.readBytes(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("456789", buf, 6);
+    TEST_ASSERT_EQUAL_INT(-1, in.read());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_writer_buffers_output);
+    RUN_TEST(test_writer_reports_failure);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_empty_machine_list);
+    RUN_TEST(test_key_escapes_and_truncation);
+    RUN_TEST(test_malformed_key);
+    RUN_TEST(test_record_limit);
+    RUN_TEST(test_read_bytes);
+    return UNITY_END();
+}
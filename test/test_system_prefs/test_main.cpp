@@ -0,0 +1,75 @@
+#include <unity.h>
+#include <cstring>
+#include "ui/system_pref_keys.h"
+
+// NVS keys and types older firmware wrote - changing one orphans users' settings
+static const PrefDef EXPECTED[] = {
+    {"show_mach_sel",  PrefType::BOOL, 1},
+    {"folders_on_top", PrefType::BOOL, 0},
+    {"display_rot",    PrefType::U8,   0},
+    {"term_log",       PrefType::BOOL, 0},
+    {"clean_shutdown", PrefType::BOOL, 0},
+    {"pm_enabled",     PrefType::BOOL, 1},
+    {"pm_dim_to",      PrefType::U32,  30},
+    {"pm_sleep_to",    PrefType::U32,  300},
+    {"pm_deepsleep",   PrefType::U32,  900},
+    {"pm_norm_bri",    PrefType::U8,   100},
+    {"pm_dim_bri",     PrefType::U8,   25},
+    {"probe_tip_um",   PrefType::U32,  0},
+};
+
+static const int NVS_KEY_MAX = 15;   // NVS key length limit (without the terminator)
+
+void setUp() {}
+void tearDown() {}
+
+static void test_every_key_is_listed() {
+    TEST_ASSERT_EQUAL_INT((int)SysPref::COUNT, (int)(sizeof(EXPECTED) / sizeof(EXPECTED[0])));
+    // SystemPrefs tracks dirty keys in a 32-bit mask
+    TEST_ASSERT_TRUE((int)SysPref::COUNT <= 32);
+}
+
+static void test_keys_types_and_defaults() {
+    for (int i = 0; i < (int)SysPref::COUNT; i++) {
+        const PrefDef &d = sysPrefDef((SysPref)i);
+        TEST_ASSERT_EQUAL_STRING(EXPECTED[i].key, d.key);
+        TEST_ASSERT_EQUAL_INT((int)EXPECTED[i].type, (int)d.type);
+        TEST_ASSERT_EQUAL_UINT32(EXPECTED[i].def, d.def);
+    }
+}
+
+static void test_keys_fit_nvs_and_are_unique() {
+    for (int i = 0; i < (int)SysPref::COUNT; i++) {
+        const char *key = sysPrefDef((SysPref)i).key;
+        TEST_ASSERT_TRUE(strlen(key) > 0);
+        TEST_ASSERT_TRUE(strlen(key) <= NVS_KEY_MAX);
+        for (int j = i + 1; j < (int)SysPref::COUNT; j++) {
+            TEST_ASSERT_TRUE(strcmp(key, sysPrefDef((SysPref)j).key) != 0);
+        }
+    }
+}
+
+static void test_defaults_fit_their_type() {
+    for (int i = 0; i < (int)SysPref::COUNT; i++) {
+        const PrefDef &d = sysPrefDef((SysPref)i);
+        TEST_ASSERT_EQUAL_UINT32(d.def, sysPrefValue((SysPref)i, d.def));
+    }
+}
+
+static void test_values_stored_as_their_type() {
+    TEST_ASSERT_EQUAL_UINT32(1, sysPrefValue(SysPref::FOLDERS_ON_TOP, 7));
+    TEST_ASSERT_EQUAL_UINT32(0, sysPrefValue(SysPref::FOLDERS_ON_TOP, 0));
+    TEST_ASSERT_EQUAL_UINT32(255, sysPrefValue(SysPref::PM_NORMAL_BRIGHTNESS, 1000));
+    TEST_ASSERT_EQUAL_UINT32(80, sysPrefValue(SysPref::PM_NORMAL_BRIGHTNESS, 80));
+    TEST_ASSERT_EQUAL_UINT32(86400, sysPrefValue(SysPref::PM_DEEP_SLEEP_TIMEOUT, 86400));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_key_is_listed);
+    RUN_TEST(test_keys_types_and_defaults);
+    RUN_TEST(test_keys_fit_nvs_and_are_unique);
+    RUN_TEST(test_defaults_fit_their_type);
+    RUN_TEST(test_values_stored_as_their_type);
+    return UNITY_END();
+}